@@ -28,14 +28,14 @@ real_t cosmo_power_spectrum(real_t k, real_t A, real_t k0)
   return A/(1.0 + pow(fabs(k)/k0, 4.0)/3.0)/pow(fabs(k)/k0, 3.0);
 }
 
-void set_gaussian_random_Phi_N(arr_t & field, Fourier *fourier,
+void set_gaussian_random_Phi_N(SimContext * ctx, arr_t & field, Fourier *fourier,
   real_t A, real_t p0, real_t p_cut)
 {
-  set_gaussian_random_Phi_N(field, fourier, A, p0, p_cut, false);
+  set_gaussian_random_Phi_N(ctx, field, fourier, A, p0, p_cut, false);
 }
 
 // set a field to an arbitrary gaussian random field
-void set_gaussian_random_Phi_N(arr_t & field, Fourier *fourier,
+void set_gaussian_random_Phi_N(SimContext * ctx, arr_t & field, Fourier *fourier,
   real_t A, real_t p0, real_t p_cut, bool fix_amplitude)
 {
   idx_t i, j, k;
@@ -46,7 +46,7 @@ void set_gaussian_random_Phi_N(arr_t & field, Fourier *fourier,
 
   // populate "field" with random values
   std::random_device rd;
-  const real_t seed = stod(_config("mt19937_seed", "9"));
+  const real_t seed = stod(ctx->config("mt19937_seed", "9"));
   std::mt19937 gen(seed);
   std::normal_distribution<real_t> gaussian_distribution; // zero mean, unit variance
   std::uniform_real_distribution<double> angular_distribution(0.0, 2.0*PI);
@@ -54,6 +54,13 @@ void set_gaussian_random_Phi_N(arr_t & field, Fourier *fourier,
   gaussian_distribution(gen);
   angular_distribution(gen);
 
+#if USE_MPI
+  DistributedFourier * dfft = fourier->distributed;
+  DistributedFourier::fft_ct * f_field = dfft->f_field;
+#else
+  Fourier::fft_ct * f_field = fourier->f_field;
+#endif
+
   // scale amplitudes in fourier space
   // don't expect to run at >512^3 anytime soon; loop over all momenta out to that resolution.
   // this won't work for a larger grid.
@@ -78,13 +85,20 @@ void set_gaussian_random_Phi_N(arr_t & field, Fourier *fourier,
         real_t rand_phase = angular_distribution(gen);
 
         // only store momentum values for relevant bins
-        if( fabs(px) < (real_t) NX/2+1 + 0.01 && fabs(py) < (real_t) NY/2+1 + 0.01 && fabs(pz) < (real_t) NZ/2+1 + 0.01 )
+        if( fabs(px) < (real_t) GLOBAL_NX/2+1 + 0.01 && fabs(py) < (real_t) NY/2+1 + 0.01 && fabs(pz) < (real_t) NZ/2+1 + 0.01 )
         {
-          idx_t fft_index = FFT_NP_INDEX(
-            px > -0.5 ? ROUND_2_IDXT(px) : NX + ROUND_2_IDXT(px),
-            py > -0.5 ? ROUND_2_IDXT(py) : NY + ROUND_2_IDXT(py),
-            pz > -0.5 ? ROUND_2_IDXT(pz) : NZ + ROUND_2_IDXT(pz)
-          );
+          idx_t ii = px > -0.5 ? ROUND_2_IDXT(px) : GLOBAL_NX + ROUND_2_IDXT(px);
+          idx_t jj = py > -0.5 ? ROUND_2_IDXT(py) : NY + ROUND_2_IDXT(py);
+          idx_t kk = pz > -0.5 ? ROUND_2_IDXT(pz) : NZ + ROUND_2_IDXT(pz);
+#if USE_MPI
+          // every process draws all modes, but only stores its own
+          jj -= dfft->ky_begin;
+          kk -= dfft->kz_begin;
+          if(jj < 0 || jj >= dfft->ny_k || kk < 0 || kk >= dfft->nz_k || ii >= GLOBAL_NX)
+            continue;
+          idx_t fft_index = dfft->k_index(jj, kk, ii);
+#else
+          idx_t fft_index = FFT_NP_INDEX(ii, jj, kk);
           real_t max_fft_index = NX*NY*(NZ/2+1) - 1;
           if(fft_index > max_fft_index)
           {
@@ -92,6 +106,7 @@ void set_gaussian_random_Phi_N(arr_t & field, Fourier *fourier,
               << max_fft_index << ")." << std::endl;
             fft_index = max_fft_index;
           }
+#endif
 
           p_mag = sqrt( pw2(px) + pw2(py) + pw2(pz) );
 
@@ -103,16 +118,29 @@ void set_gaussian_random_Phi_N(arr_t & field, Fourier *fourier,
           );
           scale = signA*cutoff*std::sqrt(cosmo_power_spectrum(p_mag, absA, p0));
 
-          (fourier->f_field)[fft_index][0] = scale*rand_mag*cos(rand_phase);
-          (fourier->f_field)[fft_index][1] = scale*rand_mag*sin(rand_phase);
+          f_field[fft_index][0] = scale*rand_mag*cos(rand_phase);
+          f_field[fft_index][1] = scale*rand_mag*sin(rand_phase);
         }
       }
     }
   }
 
+#if USE_MPI
   // zero-mode (mean density)... set this to something later
-  (fourier->f_field)[FFT_NP_INDEX(0,0,0)][0] = 0;
-  (fourier->f_field)[FFT_NP_INDEX(0,0,0)][1] = 0;
+  if(dfft->ky_begin == 0 && dfft->kz_begin == 0)
+  {
+    f_field[0][0] = 0;
+    f_field[0][1] = 0;
+  }
+
+  // FFT back and fill halos
+  dfft->backward(field._array);
+  std::vector<arr_t *> halo_fields = { &field };
+  decomposition_exchange_halos(halo_fields);
+#else
+  // zero-mode (mean density)... set this to something later
+  f_field[FFT_NP_INDEX(0,0,0)][0] = 0;
+  f_field[FFT_NP_INDEX(0,0,0)][1] = 0;
 
   // FFT back; 'field' array should now be populated with a gaussian random
   // field and power spectrum given by cosmo_power_spectrum.
@@ -128,6 +156,7 @@ void set_gaussian_random_Phi_N(arr_t & field, Fourier *fourier,
   for(idx_t i=0; i<POINTS; ++i)
     field._array[i] = (real_t) double_field[i];
   delete [] double_field;
+#endif
 #endif
 
   return;
@@ -141,28 +170,30 @@ void set_gaussian_random_Phi_N(arr_t & field, Fourier *fourier,
  * 
  * @param rays reference to RayTrace class rays should belong to
  */
-void init_ray_vector(std::vector<RayTrace<real_t, idx_t> *> * rays)
+void init_ray_vector(SimContext * ctx,
+  std::vector<RayTrace<real_t, idx_t> *> * rays)
 {
-  std::string ray_ic_type = _config("ray_ic_type", "");
+  std::string ray_ic_type = ctx->config("ray_ic_type", "");
   if(ray_ic_type == "healpix")
   {
-    init_healpix_ray_vectors(rays);
+    init_healpix_ray_vectors(ctx, rays);
     std::cout << "Setting healpix vectors...\n";
   }
   else
   {
-    init_random_ray_vectors(rays);
+    init_random_ray_vectors(ctx, rays);
   }
 }
 
-void init_healpix_ray_vectors(std::vector<RayTrace<real_t, idx_t> *> * rays)
+void init_healpix_ray_vectors(SimContext * ctx,
+  std::vector<RayTrace<real_t, idx_t> *> * rays)
 {
   RaytraceData<real_t> rd = {0};
 
   // ray position starts at an observer centered in the box
-  rd.x[0] = (NX - 0.5)*dx/2.0;
-  rd.x[1] = (NY - 0.5)*dx/2.0;
-  rd.x[2] = (NZ - 0.5)*dx/2.0;
+  rd.x[0] = (NX - 0.5)*ctx->dx/2.0;
+  rd.x[1] = (NY - 0.5)*ctx->dx/2.0;
+  rd.x[2] = (NZ - 0.5)*ctx->dx/2.0;
 
   // energy, angle in arb. units
   rd.E = 1.0;
@@ -171,7 +202,7 @@ void init_healpix_ray_vectors(std::vector<RayTrace<real_t, idx_t> *> * rays)
   // read in healpix vectors
   // generated by performing, eg:
   // numpy.savetxt("nside_<NSIDE>.vecs", [hp.pix2vec(<NSIDE>, p) for p in range(hp.nside2npix(<NSIDE>))])
-  std::ifstream vecFile (_config["healpix_vecs_file"]);
+  std::ifstream vecFile (ctx->config["healpix_vecs_file"]);
 
   while (!vecFile.eof())
   {
@@ -180,12 +211,13 @@ void init_healpix_ray_vectors(std::vector<RayTrace<real_t, idx_t> *> * rays)
     vecFile >> rd.V[2];
 
     RayTrace<real_t, idx_t> * ray;
-    ray = new RayTrace<real_t, idx_t> (-std::fabs(dt), dx, rd);
+    ray = new RayTrace<real_t, idx_t> (-std::fabs(ctx->dt), ctx->dx, rd);
     rays->push_back( ray );
   }
 }
 
-void init_random_ray_vectors(std::vector<RayTrace<real_t, idx_t> *> * rays)
+void init_random_ray_vectors(SimContext * ctx,
+  std::vector<RayTrace<real_t, idx_t> *> * rays)
 {
   idx_t i = 0;
   idx_t n_rays = 3000;
@@ -203,21 +235,21 @@ void init_random_ray_vectors(std::vector<RayTrace<real_t, idx_t> *> * rays)
     real_t X0, Y0, Z0;
     if(i<n_rays/3)
     {
-      X0 = 0.382813*COSMO_N*dx;
-      Y0 = 0.476563*COSMO_N*dx;
-      Z0 = 0.351563*COSMO_N*dx;
+      X0 = 0.382813*COSMO_N*ctx->dx;
+      Y0 = 0.476563*COSMO_N*ctx->dx;
+      Z0 = 0.351563*COSMO_N*ctx->dx;
     }
     else if(i<2*n_rays/3)
     {
-      X0 = 0.460938*COSMO_N*dx;
-      Y0 = 0.554688*COSMO_N*dx;
-      Z0 = 0.492188*COSMO_N*dx;
+      X0 = 0.460938*COSMO_N*ctx->dx;
+      Y0 = 0.554688*COSMO_N*ctx->dx;
+      Z0 = 0.492188*COSMO_N*ctx->dx;
     }
     else
     {
-      X0 = 0.0429688*COSMO_N*dx;
-      Y0 = 0.0360625*COSMO_N*dx;
-      Z0 = 0.0390625*COSMO_N*dx;
+      X0 = 0.0429688*COSMO_N*ctx->dx;
+      Y0 = 0.0360625*COSMO_N*ctx->dx;
+      Z0 = 0.0390625*COSMO_N*ctx->dx;
     }
     // ray position starts at an observer (integrating back in time...)
     rd.x[0] = X0;
@@ -234,7 +266,7 @@ void init_random_ray_vectors(std::vector<RayTrace<real_t, idx_t> *> * rays)
     rd.Phi = -1.0;
 
     RayTrace<real_t, idx_t> * ray;
-    ray = new RayTrace<real_t, idx_t> (-std::fabs(dt), dx, rd);
+    ray = new RayTrace<real_t, idx_t> (-std::fabs(ctx->dt), ctx->dx, rd);
     rays->push_back( ray );
   }
 }
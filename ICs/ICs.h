@@ -3,7 +3,7 @@
 
 #include "../cosmo_includes.h"
 #include "../cosmo_types.h"
-#include "../cosmo_globals.h"
+#include "../utils/SimContext.h"
 
 #include "../utils/Fourier.h"
 
@@ -15,15 +15,18 @@ namespace cosmo
 {
 
 real_t cosmo_power_spectrum(real_t k, real_t A, real_t k0);
-void set_gaussian_random_Phi_N(arr_t & field, Fourier *fourier,
+void set_gaussian_random_Phi_N(SimContext * ctx, arr_t & field, Fourier *fourier,
   real_t A, real_t k0, real_t p_cut);
-void set_gaussian_random_Phi_N(arr_t & field, Fourier *fourier,
+void set_gaussian_random_Phi_N(SimContext * ctx, arr_t & field, Fourier *fourier,
   real_t A, real_t p0, real_t p_cut, bool fix_amplitude);
 
 #if USE_COSMOTRACE
-void init_ray_vector(std::vector<RayTrace<real_t, idx_t> *> * rays);
-void init_healpix_ray_vectors(std::vector<RayTrace<real_t, idx_t> *> * rays);
-void init_random_ray_vectors(std::vector<RayTrace<real_t, idx_t> *> * rays);
+void init_ray_vector(SimContext * ctx,
+  std::vector<RayTrace<real_t, idx_t> *> * rays);
+void init_healpix_ray_vectors(SimContext * ctx,
+  std::vector<RayTrace<real_t, idx_t> *> * rays);
+void init_random_ray_vectors(SimContext * ctx,
+  std::vector<RayTrace<real_t, idx_t> *> * rays);
 #endif
 
 } // namespace cosmo
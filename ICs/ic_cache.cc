@@ -0,0 +1,409 @@
+#include "ic_cache.h"
+#include <cstdint>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define IC_CACHE_MAGIC "COSMOIC1"
+
+namespace cosmo
+{
+
+namespace
+{
+
+/**
+ * Parameters that only affect evolution or output, and so do not
+ * change the generated initial conditions.
+ */
+const char * ic_cache_excluded_keys[] = {
+  "steps", "dt_frac", "output_dir", "omp_num_threads",
+  "lapse", "shift", "KO_damping_coefficient", "a_adj_amp", "k_damping_amp",
+  "gd_eta", "gd_c", "GN_eta", "dw_mu_l", "dw_mu_s", "dw_p",
+  "exp_sync_gauge_c", "k_driver_coeff",
+  "expansion_goal", "stop_at_expansion_goal",
+  "use_bardeen", "use_ML_scale_factor",
+  "ray_integrate", "ray_flip_step", "simple_raytrace",
+  "raysheet_flip_step", "raysheet_flip_omega_L",
+  "SVT_constraint_interval", "dump_file", "axis", "xoffset", "yoffset",
+  "deposit_strategy", "deposit_tile_size",
+  "sheet_metric_derivatives",
+  "sheet_sort_interval", "sheet_sort_log",
+  "fft_pencil_columns",
+  "task_graph", "task_tile_width",
+  "dust_substeps", "ray_substeps", "sheet_substeps", "scalar_substeps",
+  "ic_cache_dir", "ic_cache_ignore_keys"
+};
+
+bool ic_cache_key_excluded(const std::string & key,
+  const std::vector<std::string> & extra_keys)
+{
+  if(key.compare(0, 3, "IO_") == 0)
+    return true;
+  for(const char * excluded : ic_cache_excluded_keys)
+    if(key == excluded)
+      return true;
+  for(const std::string & excluded : extra_keys)
+    if(key == excluded)
+      return true;
+  return false;
+}
+
+// 64-bit FNV-1a
+void fnv1a_update(uint64_t & h, const std::string & s)
+{
+  for(unsigned char c : s)
+  {
+    h ^= (uint64_t) c;
+    h *= 1099511628211ULL;
+  }
+}
+
+void write_string(std::ofstream & out, const std::string & s)
+{
+  uint32_t len = (uint32_t) s.size();
+  out.write((const char *) &len, sizeof(len));
+  out.write(s.data(), len);
+}
+
+bool read_string(std::ifstream & in, std::string & s)
+{
+  uint32_t len = 0;
+  if(!in.read((char *) &len, sizeof(len)))
+    return false;
+  s.resize(len);
+  return (bool) in.read(&s[0], len);
+}
+
+} // anonymous namespace
+
+ICCache::ICCache(SimContext * ctx_in, IOData * iodata_in)
+{
+  ctx = ctx_in;
+  iodata = iodata_in;
+  cache_dir = ctx->config("ic_cache_dir", "");
+  enabled = (cache_dir != "");
+  loading = false;
+  load_failed = false;
+
+  if(enabled)
+  {
+    mkdir(cache_dir.c_str(), 0755);
+    hash_str = computeHash();
+  }
+}
+
+ICCache::~ICCache()
+{
+  if(cache_in.is_open())
+    cache_in.close();
+}
+
+/**
+ * @brief      Hash IC-relevant config parameters, grid size, dx, precision
+ *
+ * @return     Hex string of the hash
+ */
+std::string ICCache::computeHash()
+{
+  std::vector<std::string> extra_keys;
+  std::stringstream ignore_keys(ctx->config("ic_cache_ignore_keys", ""));
+  std::string key;
+  while(std::getline(ignore_keys, key, ','))
+    if(key != "")
+      extra_keys.push_back(key);
+
+  uint64_t h = 14695981039346656037ULL;
+  fnv1a_update(h, IC_CACHE_MAGIC);
+  fnv1a_update(h, "NX=" + std::to_string(NX) + ";NY=" + std::to_string(NY)
+    + ";NZ=" + std::to_string(NZ) + ";real_t=" + std::to_string(sizeof(real_t)) + ";");
+
+  char dx_str[64];
+  sprintf(dx_str, "dx=%.17g;", (double) ctx->dx);
+  fnv1a_update(h, dx_str);
+
+  for(auto it = ctx->config.begin(); it != ctx->config.end(); ++it)
+    if(!ic_cache_key_excluded(it->first, extra_keys))
+      fnv1a_update(h, it->first + "=" + it->second + ";");
+
+  std::stringstream ss;
+  ss << std::hex << std::setw(16) << std::setfill('0') << h;
+  return ss.str();
+}
+
+std::string ICCache::cacheFileName()
+{
+  return cache_dir + "/ic_" + hash_str + ".bin";
+}
+
+/**
+ * @brief      Open the cache file for the current hash, if one exists.
+ * @details    Reads scalars and an index of array offsets; array data is
+ *  read directly into registered arrays by syncArray.
+ *
+ * @return     true if a valid cache file was found
+ */
+bool ICCache::load()
+{
+  if(!enabled)
+    return false;
+
+  cache_in.open(cacheFileName().c_str(), std::ios::in | std::ios::binary);
+  if(!cache_in)
+  {
+    iodata->log("No IC cache entry found for hash " + hash_str + ".");
+    return false;
+  }
+
+  std::string magic, file_hash;
+  int32_t real_size = 0;
+  idx_t n_scalars = 0, n_arrays = 0;
+  bool ok = read_string(cache_in, magic) && read_string(cache_in, file_hash)
+    && cache_in.read((char *) &real_size, sizeof(real_size))
+    && cache_in.read((char *) &n_scalars, sizeof(n_scalars));
+  ok = ok && magic == IC_CACHE_MAGIC && file_hash == hash_str
+    && real_size == (int32_t) sizeof(real_t);
+
+  for(idx_t n=0; ok && n<n_scalars; ++n)
+  {
+    std::string name;
+    real_t val = 0;
+    ok = read_string(cache_in, name) && cache_in.read((char *) &val, sizeof(val));
+    scalars[name] = val;
+  }
+
+  ok = ok && cache_in.read((char *) &n_arrays, sizeof(n_arrays));
+  for(idx_t n=0; ok && n<n_arrays; ++n)
+  {
+    std::string name;
+    idx_t pts = 0;
+    ok = read_string(cache_in, name) && cache_in.read((char *) &pts, sizeof(pts));
+    if(ok)
+    {
+      array_offsets[name] = cache_in.tellg();
+      array_sizes[name] = pts;
+      ok = (bool) cache_in.seekg(pts*sizeof(real_t), std::ios::cur);
+    }
+  }
+
+  if(!ok)
+  {
+    iodata->log("IC cache entry " + cacheFileName() + " is unreadable; ignoring it.");
+    cache_in.close();
+    scalars.clear();
+    array_offsets.clear();
+    array_sizes.clear();
+    return false;
+  }
+
+  loading = true;
+  load_failed = false;
+  return true;
+}
+
+/**
+ * @brief      Close the cache file after loading. If any field could not be
+ *  restored, zero any arrays already read so setICs() starts from scratch.
+ */
+void ICCache::finishLoad()
+{
+  if(load_failed)
+  {
+    for(auto & named_arr : arrays)
+    {
+      arr_t * arr = named_arr.second;
+      idx_t i;
+#     pragma omp parallel for
+      for(i=0; i<arr->pts; ++i)
+        arr->_array[i] = 0.0;
+    }
+  }
+
+  if(cache_in.is_open())
+    cache_in.close();
+  loading = false;
+  scalars.clear();
+  arrays.clear();
+  array_offsets.clear();
+  array_sizes.clear();
+}
+
+/**
+ * @brief      Write all registered scalars and arrays to the cache directory.
+ * @details    Data is written to a temporary file and renamed into place, so
+ *  concurrent runs never see a partially-written entry.
+ */
+void ICCache::store()
+{
+  if(!enabled)
+    return;
+
+  std::string fname = cacheFileName();
+  std::string tmp_fname = fname + ".tmp." + std::to_string((long) getpid());
+  std::ofstream out(tmp_fname.c_str(), std::ios::out | std::ios::binary);
+  if(!out)
+  {
+    iodata->log("Unable to write IC cache file " + tmp_fname + ".");
+    return;
+  }
+
+  write_string(out, IC_CACHE_MAGIC);
+  write_string(out, hash_str);
+  int32_t real_size = (int32_t) sizeof(real_t);
+  out.write((const char *) &real_size, sizeof(real_size));
+
+  idx_t n_scalars = scalars.size();
+  out.write((const char *) &n_scalars, sizeof(n_scalars));
+  for(auto & scalar : scalars)
+  {
+    write_string(out, scalar.first);
+    out.write((const char *) &scalar.second, sizeof(real_t));
+  }
+
+  idx_t n_arrays = arrays.size();
+  out.write((const char *) &n_arrays, sizeof(n_arrays));
+  for(auto & named_arr : arrays)
+  {
+    arr_t * arr = named_arr.second;
+    write_string(out, named_arr.first);
+    out.write((const char *) &arr->pts, sizeof(idx_t));
+    out.write((const char *) arr->_array, arr->pts*sizeof(real_t));
+  }
+
+  out.close();
+  if(!out || std::rename(tmp_fname.c_str(), fname.c_str()) != 0)
+  {
+    iodata->log("Unable to write IC cache file " + fname + ".");
+    std::remove(tmp_fname.c_str());
+    return;
+  }
+
+  iodata->log("Stored ICs in cache file " + fname + ".");
+  scalars.clear();
+  arrays.clear();
+}
+
+/**
+ * @brief      Register an array; read it from the cache when loading.
+ */
+void ICCache::syncArray(std::string name, arr_t & arr)
+{
+  if(!loading)
+  {
+    arrays.emplace_back(name, &arr);
+    return;
+  }
+
+  if(load_failed)
+    return;
+
+  if(array_offsets.find(name) == array_offsets.end()
+    || array_sizes[name] != arr.pts)
+  {
+    iodata->log("IC cache entry is missing field " + name + ".");
+    load_failed = true;
+    return;
+  }
+
+  cache_in.seekg(array_offsets[name]);
+  if(!cache_in.read((char *) arr._array, arr.pts*sizeof(real_t)))
+  {
+    iodata->log("IC cache entry is truncated at field " + name + ".");
+    load_failed = true;
+    return;
+  }
+  arrays.emplace_back(name, &arr);
+}
+
+/**
+ * @brief      Register a scalar value; set it from the cache when loading.
+ */
+void ICCache::syncScalar(std::string name, real_t & val)
+{
+  if(!loading)
+  {
+    scalars[name] = val;
+    return;
+  }
+
+  if(scalars.find(name) == scalars.end())
+  {
+    iodata->log("IC cache entry is missing value " + name + ".");
+    load_failed = true;
+    return;
+  }
+  val = scalars[name];
+}
+
+/**
+ * @brief      Sync all fields in a map, except RK "_c"/"_f" registers
+ *  (which are scratch space) and derived Bardeen fields.
+ */
+void ICCache::syncFields(map_t & fields)
+{
+  for(auto & field : fields)
+  {
+    const std::string & name = field.first;
+    std::string suffix = name.size() > 2 ? name.substr(name.size() - 2) : "";
+    if(suffix == "_c" || suffix == "_f" || name.compare(0, 8, "Bardeen_") == 0)
+      continue;
+    syncArray(name, *field.second);
+  }
+}
+
+void ICCache::syncRegister(std::string name, register_t & reg)
+{
+  syncArray(name + "_p", reg._array_p);
+  syncArray(name + "_a", reg._array_a);
+}
+
+/**
+ * @brief      Sync FRW reference metric state. When loading, the FRW
+ *  instance is only modified if all values are present in the cache.
+ */
+void ICCache::syncFRW(FRW<real_t> * frw)
+{
+  if(!loading)
+  {
+    real_t phi = frw->get_phi(), K = frw->get_K(), alpha = frw->get_alpha();
+    real_t num_fluids = frw->get_num_fluids();
+    syncScalar("FRW_phi", phi);
+    syncScalar("FRW_K", K);
+    syncScalar("FRW_alpha", alpha);
+    syncScalar("FRW_num_fluids", num_fluids);
+    for(int n=0; n<frw->get_num_fluids(); ++n)
+    {
+      std::pair<real_t, real_t> fluid = frw->get_fluid(n);
+      syncScalar("FRW_fluid_rho_" + std::to_string(n), fluid.first);
+      syncScalar("FRW_fluid_w_" + std::to_string(n), fluid.second);
+    }
+    return;
+  }
+
+  if(load_failed)
+    return;
+
+  real_t phi, K, alpha, num_fluids;
+  syncScalar("FRW_phi", phi);
+  syncScalar("FRW_K", K);
+  syncScalar("FRW_alpha", alpha);
+  syncScalar("FRW_num_fluids", num_fluids);
+  if(load_failed)
+    return;
+
+  std::vector< std::pair<real_t, real_t> > fluids((int) num_fluids);
+  for(int n=0; n<(int) num_fluids; ++n)
+  {
+    syncScalar("FRW_fluid_rho_" + std::to_string(n), fluids[n].first);
+    syncScalar("FRW_fluid_w_" + std::to_string(n), fluids[n].second);
+  }
+  if(load_failed)
+    return;
+
+  frw->set_phi(phi);
+  frw->set_K(K);
+  frw->set_alpha(alpha);
+  for(auto & fluid : fluids)
+    frw->addFluid(fluid.first, fluid.second);
+}
+
+} // namespace cosmo
@@ -0,0 +1,67 @@
+#ifndef COSMO_IC_CACHE_H
+#define COSMO_IC_CACHE_H
+
+#include "../cosmo_includes.h"
+#include "../cosmo_types.h"
+#include "../utils/SimContext.h"
+
+#include "../utils/FRW.h"
+#include "../IO/IOData.h"
+
+namespace cosmo
+{
+
+/**
+ * @brief Cache of generated initial conditions, keyed by a configuration hash
+ * @details The hash covers all config parameters except those in an
+ *  exclusion list of evolution/output settings (plus any listed in the
+ *  comma-separated "ic_cache_ignore_keys" parameter), the grid size, dx,
+ *  and the precision of real_t. Enable by setting "ic_cache_dir".
+ *
+ *  A simulation registers its IC state through syncArray / syncScalar. When
+ *  a cache file was found (isLoading()), these read data into the given
+ *  references; otherwise they record the references so that store() can
+ *  write them out after setICs() has run.
+ */
+class ICCache
+{
+  SimContext * ctx;
+  IOData * iodata;
+  std::string cache_dir;
+  std::string hash_str;
+  bool enabled;
+  bool loading;
+  bool load_failed;
+
+  std::ifstream cache_in;
+  std::map<std::string, std::streampos> array_offsets;
+  std::map<std::string, idx_t> array_sizes;
+  std::map<std::string, real_t> scalars;
+  std::vector< std::pair<std::string, arr_t *> > arrays;
+
+  std::string computeHash();
+
+public:
+  ICCache(SimContext * ctx_in, IOData * iodata_in);
+  ~ICCache();
+
+  bool isEnabled() { return enabled; }
+  bool isLoading() { return loading; }
+  bool loadFailed() { return load_failed; }
+  std::string getHash() { return hash_str; }
+  std::string cacheFileName();
+
+  bool load();
+  void store();
+  void finishLoad();
+
+  void syncArray(std::string name, arr_t & arr);
+  void syncScalar(std::string name, real_t & val);
+  void syncFields(map_t & fields);
+  void syncRegister(std::string name, register_t & reg);
+  void syncFRW(FRW<real_t> * frw);
+};
+
+} // namespace cosmo
+
+#endif
@@ -6,6 +6,10 @@
 #include <iomanip>
 #include <sys/stat.h>
 #include <fstream>
+#include <thread>
+#include <atomic>
+
+#include "../utils/SimContext.h"
 
 #define COSMO_IODATA_VERBOSITY_OFF 0
 #define COSMO_IODATA_VERBOSITY_ON 1
@@ -70,18 +74,41 @@ class IOData
     }
 
   public:
-    IOData(std::string output_dir_in)
+    SimContext * ctx; ///< context of the simulation being output
+
+    std::thread particle_writer; ///< asynchronous particle snapshot output
+    std::atomic<bool> particle_writer_failed {false};
+
+    IOData(SimContext * ctx_in, std::string output_dir_in)
     {
+      ctx = ctx_in;
       _init(output_dir_in, COSMO_IODATA_VERBOSITY_ON);
     }
 
-    IOData(std::string output_dir_in, int verbosity_in)
+    IOData(SimContext * ctx_in, std::string output_dir_in, int verbosity_in)
     {
+      ctx = ctx_in;
       _init(output_dir_in, verbosity_in);
     }
 
+    /**
+     * @brief Use an existing output directory (eg, one created by another
+     *  MPI process), logging to log_filename within it
+     */
+    IOData(SimContext * ctx_in, std::string output_dir_in, int verbosity_in,
+      std::string log_filename)
+    {
+      ctx = ctx_in;
+      output_dir = output_dir_in;
+      verbosity = verbosity_in;
+      logfile.open(output_dir + log_filename);
+      log("Log file open.");
+    }
+
     ~IOData()
     {
+      if(particle_writer.joinable())
+        particle_writer.join();
       logfile.close();
     }
 
@@ -4,14 +4,18 @@
 #include <zlib.h>
 #include <sys/stat.h>
 #include <sstream>
+#include <thread>
+#include <memory>
 
 #define DETAILS(field) \
   real_t avg_##field = conformal_average(*bssn_fields[#field "_a"], *bssn_fields["DIFFphi_a"], phi_FRW); \
-  sprintf(data, "%.15g\t", (double) avg_##field); \
-  gzwrite(datafile, data, strlen(data)); \
   real_t std_##field = conformal_standard_deviation(*bssn_fields[#field "_a"], *bssn_fields["DIFFphi_a"], phi_FRW, avg_##field); \
-  sprintf(data, "%.15g\t", (double) std_##field); \
-  gzwrite(datafile, data, strlen(data));
+  if(datafile != Z_NULL) { \
+    sprintf(data, "%.15g\t", (double) avg_##field); \
+    gzwrite(datafile, data, strlen(data)); \
+    sprintf(data, "%.15g\t", (double) std_##field); \
+    gzwrite(datafile, data, strlen(data)); \
+  }
 
 
 #define STRINGIFY_STRINGIFIER(function) #function
@@ -34,8 +38,8 @@ void log_defines(IOData *iodata)
   iodata->log( "Running with NX = " + stringify(NX)
                         + ", NY = " + stringify(NY)
                         + ", NZ = " + stringify(NZ) );
-  iodata->log( "Running with dt = " + stringify(dt) );
-  iodata->log( "Running with dx = " + stringify(dx) );
+  iodata->log( "Running with dt = " + stringify(iodata->ctx->dt) );
+  iodata->log( "Running with dx = " + stringify(iodata->ctx->dx) );
 
   iodata->log( "Other parameters:");
   iodata->log( "  H_LEN_FRAC = " + stringify(H_LEN_FRAC) );
@@ -48,6 +52,17 @@ void log_defines(IOData *iodata)
   iodata->log( "  USE_GAMMA_DRIVER = " + stringify(USE_GAMMA_DRIVER) );
   iodata->log( "  USE_COSMO_CONST_POTENTIAL = " + stringify(USE_COSMO_CONST_POTENTIAL) );
   iodata->log( "  USE_BSSN_SHIFT = " + stringify(USE_BSSN_SHIFT) );
+  iodata->log( "  USE_MPI = " + stringify(USE_MPI) );
+#if USE_MPI
+  iodata->log( "  COSMO_MPI_RANKS = " + stringify(COSMO_MPI_RANKS)
+    + " (global NX = " + stringify(GLOBAL_NX)
+    + ", halo width = " + stringify(COSMO_HALO_WIDTH) + ")" );
+# ifdef H5_HAVE_PARALLEL
+  iodata->log( "  3D output: parallel HDF5" );
+# else
+  iodata->log( "  3D output: gathered to rank 0 (serial HDF5)" );
+# endif
+#endif
 }
 
 /**
@@ -110,13 +125,13 @@ void io_bssn_fields_snapshot(IOData *iodata, idx_t step,
   bool output_step = false;
   bool output_this_step = false;
 
-  output_step = ( std::stoi(_config("IO_3D_grid_interval", "0")) > 0 );
-  output_this_step = ( 0 == step % std::stoi(_config("IO_3D_grid_interval", "1")) );
+  output_step = ( std::stoi(iodata->ctx->config("IO_3D_grid_interval", "0")) > 0 );
+  output_this_step = ( 0 == step % std::stoi(iodata->ctx->config("IO_3D_grid_interval", "1")) );
   if( output_step && output_this_step )
   {
     for ( const auto &field_reg : bssn_fields ) {
       // look for names of the form: "IO_3D_field_r"
-      if( std::stoi(_config( "IO_3D_" + field_reg.first , "0")) )
+      if( std::stoi(iodata->ctx->config( "IO_3D_" + field_reg.first , "0")) )
       {
         io_dump_3dslice(iodata, *bssn_fields[field_reg.first],
           "3D_" + (field_reg.first) + step_str);
@@ -124,13 +139,13 @@ void io_bssn_fields_snapshot(IOData *iodata, idx_t step,
     }
   }
   
-  output_step = ( std::stoi(_config("IO_2D_grid_interval", "0")) > 0 );
-  output_this_step = ( 0 == step % std::stoi(_config("IO_2D_grid_interval", "1")) );
+  output_step = ( std::stoi(iodata->ctx->config("IO_2D_grid_interval", "0")) > 0 );
+  output_this_step = ( 0 == step % std::stoi(iodata->ctx->config("IO_2D_grid_interval", "1")) );
   if( output_step && output_this_step )
   {
     for ( const auto &field_reg : bssn_fields ) {
       // look for names of the form: "IO_2D_field_r"
-      if( std::stoi(_config( "IO_2D_" + field_reg.first , "0")) )
+      if( std::stoi(iodata->ctx->config( "IO_2D_" + field_reg.first , "0")) )
       {
         io_dump_2dslice(iodata, *bssn_fields[field_reg.first],
           "2D_" + (field_reg.first) + step_str);
@@ -138,20 +153,20 @@ void io_bssn_fields_snapshot(IOData *iodata, idx_t step,
     }
   }
   
-  output_step = ( std::stoi(_config("IO_1D_grid_interval", "0")) > 0 );
-  output_this_step = ( 0 == step % std::stoi(_config("IO_1D_grid_interval", "1")) );
+  output_step = ( std::stoi(iodata->ctx->config("IO_1D_grid_interval", "0")) > 0 );
+  output_this_step = ( 0 == step % std::stoi(iodata->ctx->config("IO_1D_grid_interval", "1")) );
    
   if( output_step && output_this_step )
   {
     for ( const auto &field_reg : bssn_fields ) {
       // look for names of the form: "IO_1D_field_r"
-      if( std::stoi(_config( "IO_1D_" + field_reg.first , "0")) )
+      if( std::stoi(iodata->ctx->config( "IO_1D_" + field_reg.first , "0")) )
       {
         io_dump_strip(iodata, *bssn_fields[field_reg.first],
           "1D_" + (field_reg.first),
-          std::stoi(_config( "IO_1D_" + field_reg.first + "_axis" , "1")),
-          std::stoi(_config( "IO_1D_" + field_reg.first + "_xoffset" , "0")),
-          std::stoi(_config( "IO_1D_" + field_reg.first + "_yoffset" , "0"))
+          std::stoi(iodata->ctx->config( "IO_1D_" + field_reg.first + "_axis" , "1")),
+          std::stoi(iodata->ctx->config( "IO_1D_" + field_reg.first + "_xoffset" , "0")),
+          std::stoi(iodata->ctx->config( "IO_1D_" + field_reg.first + "_yoffset" , "0"))
         );
       }
     }
@@ -167,9 +182,9 @@ void io_bssn_fields_snapshot(IOData *iodata, idx_t step,
 void io_bssn_fields_powerdump(IOData *iodata, idx_t step,
   map_t & bssn_fields, Fourier *fourier)
 {
-  bool output_step = ( std::stoi(_config("IO_powerspec_interval", "0")) > 0 );
+  bool output_step = ( std::stoi(iodata->ctx->config("IO_powerspec_interval", "0")) > 0 );
   if(!output_step) return;
-  bool output_this_step = (0 == step % std::stoi(_config("IO_powerspec_interval", "1")));
+  bool output_this_step = (0 == step % std::stoi(iodata->ctx->config("IO_powerspec_interval", "1")));
   if( output_step && output_this_step )
   {
     fourier->powerDump(bssn_fields["DIFFphi_a"]->_array, iodata);
@@ -182,14 +197,19 @@ void io_bssn_fields_powerdump(IOData *iodata, idx_t step,
  */
 void io_bssn_constraint_violation(IOData *iodata, idx_t step, BSSN * bssnSim)
 {
-  bool output_step = ( std::stoi(_config("IO_constraint_interval", "0")) > 0 );
+  bool output_step = ( std::stoi(iodata->ctx->config("IO_constraint_interval", "0")) > 0 );
   if(!output_step) return;
 
-  bool output_this_step = (0 == step % std::stoi(_config("IO_constraint_interval", "1")));
+  bool output_this_step = (0 == step % std::stoi(iodata->ctx->config("IO_constraint_interval", "1")));
 
   // whether dump 1D constraint everywhere
-  //  bool dump_1d_hamiltonian_constraint = ( std::stoi(_config("IO_1D_hamiltonian_constraint", "0")) > 0 );
-  bool output_constraint_snapshot = (0 == step % std::stoi(_config("IO_constraint_snapshot_interval", "999999999")));
+  //  bool dump_1d_hamiltonian_constraint = ( std::stoi(iodata->ctx->config("IO_1D_hamiltonian_constraint", "0")) > 0 );
+  bool output_constraint_snapshot = (0 == step % std::stoi(iodata->ctx->config("IO_constraint_snapshot_interval", "999999999")));
+
+#if USE_MPI
+  // 1D constraint output is not distributed
+  output_constraint_snapshot = false;
+#endif
 
   if(output_step && output_constraint_snapshot)
   {
@@ -279,14 +299,14 @@ void io_bssn_constraint_violation(IOData *iodata, idx_t step, BSSN * bssnSim)
   }
 
 
-  bool output_g11m1 = ( std::stoi(_config("IO_constraint_g11m1", "0")) > 0 );
+  bool output_g11m1 = ( std::stoi(iodata->ctx->config("IO_constraint_g11m1", "0")) > 0 );
   if( output_step && output_this_step && output_g11m1 )
   {
     arr_t & Dg11 = *bssnSim->fields["DIFFphi_a"];
     idx_t i, j, k;
     real_t mean = 0, stdev = 0, max = 0;
 #   pragma omp parallel for default(shared) private(i, j, k) reduction(+:mean)
-    LOOP3(i, j, k)
+    OWNED_LOOP3(i, j, k)
     {
       idx_t idx = NP_INDEX(i,j,k);
       mean += Dg11[idx];
@@ -295,14 +315,15 @@ void io_bssn_constraint_violation(IOData *iodata, idx_t step, BSSN * bssnSim)
         max = max > std::fabs(Dg11[idx]) ? max : std::fabs(Dg11[idx]);
       }
     }
-    mean /= POINTS;
+    mean = decomposition_sum(mean)/GLOBAL_POINTS;
+    max = decomposition_max(max);
 #   pragma omp parallel for default(shared) private(i, j, k) reduction(+:stdev)
-    LOOP3(i, j, k)
+    OWNED_LOOP3(i, j, k)
     {
       idx_t idx = NP_INDEX(i,j,k);
       stdev += std::pow(mean - Dg11[idx], 2.0);
     }
-    stdev = std::sqrt(stdev/(POINTS-1));
+    stdev = std::sqrt(decomposition_sum(stdev)/(GLOBAL_POINTS-1));
     io_dump_value(iodata, stdev, "g11_violations", "\t");
     io_dump_value(iodata, mean, "g11_violations", "\t");
     io_dump_value(iodata, max, "g11_violations", "\n");
@@ -341,46 +362,55 @@ void io_print_constraint_violation(IOData *iodata, BSSN * bssnSim)
 void io_bssn_dump_statistics(IOData *iodata, idx_t step,
   map_t & bssn_fields, FRW<real_t> *frw)
 {
-  bool output_step = ( std::stoi(_config("IO_bssnstats_interval", "0")) > 0 );
+  bool output_step = ( std::stoi(iodata->ctx->config("IO_bssnstats_interval", "0")) > 0 );
   if(!output_step) return;
 
-  bool output_this_step = (0 == step % std::stoi(_config("IO_bssnstats_interval", "1")));
+  bool output_this_step = (0 == step % std::stoi(iodata->ctx->config("IO_bssnstats_interval", "1")));
   if( !output_step || !output_this_step )
     return;
 
-  std::string filename = _config["dump_file"];
+  std::string filename = iodata->ctx->config["dump_file"];
   char data[35];
+  // with MPI, statistics are computed collectively and written by rank 0
+  bool io_root = (decomposition_rank() == 0);
+  real_t phi_FRW = frw->get_phi();
 
   // dump FRW quantities
   std::string dump_filename = iodata->dir() + filename + ".frwdat.gz";
-  gzFile datafile = gzopen(dump_filename.c_str(), "ab");
-  if(datafile == Z_NULL) {
-    iodata->log("Error opening file: " + dump_filename);
-    return;
-  }
-
-  real_t phi_FRW = frw->get_phi();
-  sprintf(data, "%.15g\t", (double) phi_FRW);
-  gzwrite(datafile, data, strlen(data));
-  real_t K_FRW = frw->get_K();
-  sprintf(data, "%.15g\t", (double) K_FRW);
-  gzwrite(datafile, data, strlen(data));
-  real_t rho_FRW = frw->get_rho();
-  sprintf(data, "%.15g\t", (double) rho_FRW);
-  gzwrite(datafile, data, strlen(data));
-  real_t S_FRW = frw->get_S();
-  sprintf(data, "%.15g\t", (double) S_FRW);
-  gzwrite(datafile, data, strlen(data));
+  if(io_root)
+  {
+    gzFile datafile = gzopen(dump_filename.c_str(), "ab");
+    if(datafile == Z_NULL)
+    {
+      iodata->log("Error opening file: " + dump_filename);
+    }
+    else
+    {
+      sprintf(data, "%.15g\t", (double) phi_FRW);
+      gzwrite(datafile, data, strlen(data));
+      real_t K_FRW = frw->get_K();
+      sprintf(data, "%.15g\t", (double) K_FRW);
+      gzwrite(datafile, data, strlen(data));
+      real_t rho_FRW = frw->get_rho();
+      sprintf(data, "%.15g\t", (double) rho_FRW);
+      gzwrite(datafile, data, strlen(data));
+      real_t S_FRW = frw->get_S();
+      sprintf(data, "%.15g\t", (double) S_FRW);
+      gzwrite(datafile, data, strlen(data));
 
-  gzwrite(datafile, "\n", strlen("\n"));
-  gzclose(datafile);
+      gzwrite(datafile, "\n", strlen("\n"));
+      gzclose(datafile);
+    }
+  }
 
   // output misc. info about simulation here.
   dump_filename = iodata->dir() + filename + ".dat.gz";
-  datafile = gzopen(dump_filename.c_str(), "ab");
-  if(datafile == Z_NULL) {
-    iodata->log("Error opening file: " + dump_filename);
-    return;
+  gzFile datafile = Z_NULL;
+  if(io_root)
+  {
+    datafile = gzopen(dump_filename.c_str(), "ab");
+    if(datafile == Z_NULL)
+      iodata->log("Error opening file: " + dump_filename);
   }
 
   // phi output
@@ -396,11 +426,15 @@ void io_bssn_dump_statistics(IOData *iodata, idx_t step,
   DETAILS(expN)
 #endif
   // average volume
-  sprintf(data, "%.15g\t", (double) volume_average(*bssn_fields["DIFFphi_a"], phi_FRW));
-  gzwrite(datafile, data, strlen(data));
+  real_t avg_vol = volume_average(*bssn_fields["DIFFphi_a"], phi_FRW);
+  if(datafile != Z_NULL)
+  {
+    sprintf(data, "%.15g\t", (double) avg_vol);
+    gzwrite(datafile, data, strlen(data));
 
-  gzwrite(datafile, "\n", strlen("\n"));
-  gzclose(datafile);
+    gzwrite(datafile, "\n", strlen("\n"));
+    gzclose(datafile);
+  }
 }
 
 #if USE_COSMOTRACE
@@ -414,7 +448,7 @@ void io_raytrace_dump(IOData *iodata, idx_t step,
   std::vector<RayTrace<real_t, idx_t> *> const * rays)
 {
   /* no output if not @ correct interval */
-  if( step % std::stoi(_config["IO_raytrace_interval"]) != 0 )
+  if( step % std::stoi(iodata->ctx->config["IO_raytrace_interval"]) != 0 )
     return;
   
   idx_t num_values = 9;
@@ -489,24 +523,24 @@ void io_scalar_snapshot(IOData *iodata, idx_t step, Scalar * scalar)
   bool output_step = false;
   bool output_this_step = false;
 
-  output_step = ( std::stoi(_config("IO_3D_grid_interval", "0")) > 0 );
-  output_this_step = ( 0 == step % std::stoi(_config("IO_3D_grid_interval", "1")) );
+  output_step = ( std::stoi(iodata->ctx->config("IO_3D_grid_interval", "0")) > 0 );
+  output_this_step = ( 0 == step % std::stoi(iodata->ctx->config("IO_3D_grid_interval", "1")) );
   if( output_step && output_this_step )
   {
     io_dump_3dslice(iodata, scalar->phi._array_a, "3D_scalar_phi." + step_str);
     io_dump_3dslice(iodata, scalar->Pi._array_a, "3D_scalar_Pi." + step_str);
   }
   
-  output_step = ( std::stoi(_config("IO_2D_grid_interval", "0")) > 0 );
-  output_this_step = ( 0 == step % std::stoi(_config("IO_2D_grid_interval", "1")) );
+  output_step = ( std::stoi(iodata->ctx->config("IO_2D_grid_interval", "0")) > 0 );
+  output_this_step = ( 0 == step % std::stoi(iodata->ctx->config("IO_2D_grid_interval", "1")) );
   if( output_step && output_this_step )
   {
     io_dump_2dslice(iodata, scalar->phi._array_a, "2D_scalar_phi." + step_str);
     io_dump_2dslice(iodata, scalar->Pi._array_a, "2D_scalar_Pi." + step_str);
   }
   
-  output_step = ( std::stoi(_config("IO_1D_grid_interval", "0")) > 0 );
-  output_this_step = ( 0 == step % std::stoi(_config("IO_1D_grid_interval", "1")) );
+  output_step = ( std::stoi(iodata->ctx->config("IO_1D_grid_interval", "0")) > 0 );
+  output_this_step = ( 0 == step % std::stoi(iodata->ctx->config("IO_1D_grid_interval", "1")) );
 
   if( output_step && output_this_step )
   {
@@ -521,15 +555,15 @@ void io_sheets_snapshot(IOData *iodata, idx_t step, Sheet * sheets)
   bool output_step = false;
   bool output_this_step = false;
 
-  output_step = ( std::stoi(_config("IO_3D_grid_interval", "0")) > 0 );
-  output_this_step = ( 0 == step % std::stoi(_config("IO_3D_grid_interval", "1")) );
-  bool output_Dx = (std::stoi(_config("IO_sheets_displacement_x", "0")) > 0);
-  bool output_Dy = (std::stoi(_config("IO_sheets_displacement_y", "0")) > 0);
-  bool output_Dz = (std::stoi(_config("IO_sheets_displacement_z", "0")) > 0);
+  output_step = ( std::stoi(iodata->ctx->config("IO_3D_grid_interval", "0")) > 0 );
+  output_this_step = ( 0 == step % std::stoi(iodata->ctx->config("IO_3D_grid_interval", "1")) );
+  bool output_Dx = (std::stoi(iodata->ctx->config("IO_sheets_displacement_x", "0")) > 0);
+  bool output_Dy = (std::stoi(iodata->ctx->config("IO_sheets_displacement_y", "0")) > 0);
+  bool output_Dz = (std::stoi(iodata->ctx->config("IO_sheets_displacement_z", "0")) > 0);
 
-  bool output_vx = (std::stoi(_config("IO_sheets_velocity_x", "0")) > 0);
-  bool output_vy = (std::stoi(_config("IO_sheets_velocity_y", "0")) > 0);
-  bool output_vz = (std::stoi(_config("IO_sheets_velocity_z", "0")) > 0);
+  bool output_vx = (std::stoi(iodata->ctx->config("IO_sheets_velocity_x", "0")) > 0);
+  bool output_vy = (std::stoi(iodata->ctx->config("IO_sheets_velocity_y", "0")) > 0);
+  bool output_vz = (std::stoi(iodata->ctx->config("IO_sheets_velocity_z", "0")) > 0);
 
   
   if( output_step && output_this_step )
@@ -549,8 +583,8 @@ void io_sheets_snapshot(IOData *iodata, idx_t step, Sheet * sheets)
       io_dump_3dslice(iodata, sheets->vz._array_a, "3D_sheets_vz." + step_str);
   }
   
-  output_step = ( std::stoi(_config("IO_2D_grid_interval", "0")) > 0 );
-  output_this_step = ( 0 == step % std::stoi(_config("IO_2D_grid_interval", "1")) );
+  output_step = ( std::stoi(iodata->ctx->config("IO_2D_grid_interval", "0")) > 0 );
+  output_this_step = ( 0 == step % std::stoi(iodata->ctx->config("IO_2D_grid_interval", "1")) );
   if( output_step && output_this_step )
   {
     if(output_Dx)
@@ -569,14 +603,14 @@ void io_sheets_snapshot(IOData *iodata, idx_t step, Sheet * sheets)
 
   }
   
-  output_step = ( std::stoi(_config("IO_1D_grid_interval", "0")) > 0 );
-  output_this_step = ( 0 == step % std::stoi(_config("IO_1D_grid_interval", "1")) );
+  output_step = ( std::stoi(iodata->ctx->config("IO_1D_grid_interval", "0")) > 0 );
+  output_this_step = ( 0 == step % std::stoi(iodata->ctx->config("IO_1D_grid_interval", "1")) );
 
   if( output_step && output_this_step )
   {
-    int _axis = std::stoi(_config("axis", "1"));
-    int _xoffset = std::stoi(_config("xoffset", "0"));
-    int _yoffset = std::stoi(_config("yoffset", "0"));
+    int _axis = std::stoi(iodata->ctx->config("axis", "1"));
+    int _xoffset = std::stoi(iodata->ctx->config("xoffset", "0"));
+    int _yoffset = std::stoi(iodata->ctx->config("yoffset", "0"));
 
 
     if(output_Dx)
@@ -646,21 +680,13 @@ bool io_read_3dslice(IOData *iodata, arr_t & field, std::string filename)
   
   
 /**
- * @brief      Write full 3D slice to a file.
- *
- * @param      iodata    initialized IOData
- * @param      field     Field to write
- * @param[in]  filename  filename to write to (minus suffix)
+ * @brief      Write a dims[0]*dims[1]*dims[2] array to a (compressed) HDF5 file.
  */
-void io_dump_3dslice(IOData *iodata, arr_t & field, std::string filename)
+static void io_write_3d_h5(std::string dump_filename, hsize_t dims[3], real_t * data)
 {
-  // dump all NX*NY*NZ points
-  std::string dump_filename = iodata->dir() + filename + ".3d_grid.h5.gz";
-
   hid_t       file, space, dset, dcpl;  /* Handles */
   herr_t      status;
-  hsize_t     dims[3] = {(hsize_t) field.nx, (hsize_t) field.ny, (hsize_t) field.nz},
-              maxdims[3] = {H5S_UNLIMITED, H5S_UNLIMITED, H5S_UNLIMITED},
+  hsize_t     maxdims[3] = {H5S_UNLIMITED, H5S_UNLIMITED, H5S_UNLIMITED},
               chunk[3] = {6, 6, 6};
 
   file = H5Fcreate (dump_filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
@@ -670,7 +696,7 @@ void io_dump_3dslice(IOData *iodata, arr_t & field, std::string filename)
   status = H5Pset_chunk (dcpl, 3, chunk);
   dset = H5Dcreate2 (file, "DS1", H5T_ALLOC, space, H5P_DEFAULT, dcpl, H5P_DEFAULT);
 
-  status = H5Dwrite (dset, H5T_TO_USE, H5S_ALL, H5S_ALL, H5P_DEFAULT, field._array);
+  status = H5Dwrite (dset, H5T_TO_USE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
 
   status = H5Pclose (dcpl);
   status = H5Dclose (dset);
@@ -681,6 +707,79 @@ void io_dump_3dslice(IOData *iodata, arr_t & field, std::string filename)
   return;
 }
 
+#if USE_MPI
+/**
+ * @brief      Write the owned planes of a distributed field to a single
+ *  GLOBAL_NX*NY*NZ dataset.
+ * @details    Uses parallel HDF5 when available; otherwise the owned planes
+ *  are gathered to rank 0, which writes the file.
+ */
+static void io_dump_3dslice_mpi(std::string dump_filename, arr_t & field)
+{
+  hsize_t dims[3] = {(hsize_t) GLOBAL_NX, (hsize_t) NY, (hsize_t) NZ};
+
+# ifdef H5_HAVE_PARALLEL
+  hid_t       file, space, mem_space, dset, fapl, dxpl;  /* Handles */
+  herr_t      status;
+  hsize_t     local_dims[3] = {(hsize_t) NX, (hsize_t) NY, (hsize_t) NZ},
+              owned_dims[3] = {(hsize_t) (OWNED_X_END - OWNED_X_BEGIN), (hsize_t) NY, (hsize_t) NZ},
+              local_start[3] = {(hsize_t) OWNED_X_BEGIN, 0, 0},
+              global_start[3] = {(hsize_t) decomposition_x_offset(), 0, 0};
+
+  fapl = H5Pcreate (H5P_FILE_ACCESS);
+  status = H5Pset_fapl_mpio (fapl, MPI_COMM_WORLD, MPI_INFO_NULL);
+  file = H5Fcreate (dump_filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, fapl);
+
+  // filters are not used, as not all HDF5 versions support them for parallel writes
+  space = H5Screate_simple (3, dims, NULL);
+  dset = H5Dcreate2 (file, "DS1", H5T_ALLOC, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  status = H5Sselect_hyperslab (space, H5S_SELECT_SET, global_start, NULL, owned_dims, NULL);
+  mem_space = H5Screate_simple (3, local_dims, NULL);
+  status = H5Sselect_hyperslab (mem_space, H5S_SELECT_SET, local_start, NULL, owned_dims, NULL);
+
+  dxpl = H5Pcreate (H5P_DATASET_XFER);
+  status = H5Pset_dxpl_mpio (dxpl, H5FD_MPIO_COLLECTIVE);
+  status = H5Dwrite (dset, H5T_TO_USE, mem_space, space, dxpl, field._array);
+
+  status = H5Pclose (dxpl);
+  status = H5Pclose (fapl);
+  status = H5Dclose (dset);
+  status = H5Sclose (mem_space);
+  status = H5Sclose (space);
+  status = H5Fclose (file);
+
+  status = status; // suppress "unused" warning
+# else
+  bool io_root = (decomposition_rank() == 0);
+  std::vector<real_t> global(io_root ? GLOBAL_POINTS : 0);
+  decomposition_gather_x(field._array + NP_INDEX(OWNED_X_BEGIN,0,0), NY*NZ,
+    io_root ? &global[0] : NULL);
+  if(io_root)
+    io_write_3d_h5(dump_filename, dims, &global[0]);
+# endif
+}
+#endif
+
+/**
+ * @brief      Write full 3D slice to a file.
+ *
+ * @param      iodata    initialized IOData
+ * @param      field     Field to write
+ * @param[in]  filename  filename to write to (minus suffix)
+ */
+void io_dump_3dslice(IOData *iodata, arr_t & field, std::string filename)
+{
+  // dump all NX*NY*NZ points
+  std::string dump_filename = iodata->dir() + filename + ".3d_grid.h5.gz";
+
+#if USE_MPI
+  io_dump_3dslice_mpi(dump_filename, field);
+#else
+  hsize_t dims[3] = {(hsize_t) field.nx, (hsize_t) field.ny, (hsize_t) field.nz};
+  io_write_3d_h5(dump_filename, dims, field._array);
+#endif
+}
+
 /**
  * @brief      Write a 2D slice of a field to a file.
  *
@@ -690,7 +789,10 @@ void io_dump_3dslice(IOData *iodata, arr_t & field, std::string filename)
  */
 void io_dump_2dslice(IOData *iodata, arr_t & field, std::string filename)
 {
-  // dump the first NY*NZ points (a 2-d slice on a boundary)
+  // dump the first NY*NZ points (a 2-d slice on a boundary);
+  // with MPI, this plane is owned by rank 0
+  if(decomposition_rank() != 0)
+    return;
   std::string dump_filename = iodata->dir() + filename + ".2d_grid.h5.gz";
 
   hid_t       file, space, dset, dcpl;  /* Handles */
@@ -706,7 +808,8 @@ void io_dump_2dslice(IOData *iodata, arr_t & field, std::string filename)
   status = H5Pset_chunk (dcpl, 2, chunk);
   dset = H5Dcreate2 (file, "Dataset1", H5T_ALLOC, space, H5P_DEFAULT, dcpl, H5P_DEFAULT);
 
-  status = H5Dwrite (dset, H5T_TO_USE, H5S_ALL, H5S_ALL, H5P_DEFAULT, field._array);
+  status = H5Dwrite (dset, H5T_TO_USE, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+    field._array + NP_INDEX(OWNED_X_BEGIN,0,0));
 
   status = H5Pclose (dcpl);
   status = H5Dclose (dset);
@@ -733,6 +836,39 @@ void io_dump_strip(IOData *iodata, arr_t & field, std::string file,
   std::string filename = iodata->dir() + file + ".strip.dat.gz";
   char data[35];
 
+#if USE_MPI
+  if(axis == 1)
+  {
+    // gather strips along x to rank 0
+    bool io_root = (decomposition_rank() == 0);
+    std::vector<real_t> owned, global(io_root ? GLOBAL_NX : 0);
+    for(idx_t i=OWNED_X_BEGIN; i<OWNED_X_END; i++)
+      owned.push_back(field(i,n1,n2));
+    decomposition_gather_x(&owned[0], 1, io_root ? &global[0] : NULL);
+    if(!io_root)
+      return;
+
+    gzFile datafile = gzopen(filename.c_str(), "ab");
+    if(datafile == Z_NULL) {
+      iodata->log("Error opening file: " + filename);
+      return;
+    }
+    for(idx_t i=0; i<GLOBAL_NX; i++)
+    {
+      sprintf(data, "%.15g\t", (double) global[i]);
+      gzwrite(datafile, data, strlen(data));
+    }
+    gzwrite(datafile, "\n", strlen("\n"));
+    gzclose(datafile);
+    return;
+  }
+
+  // other strips are written by the process owning the x = n1 plane
+  n1 = n1 - decomposition_x_offset() + OWNED_X_BEGIN;
+  if(n1 < OWNED_X_BEGIN || n1 >= OWNED_X_END)
+    return;
+#endif
+
   gzFile datafile = gzopen(filename.c_str(), "ab");
   if(datafile == Z_NULL) {
     iodata->log("Error opening file: " + filename);
@@ -813,6 +949,10 @@ void io_print_strip(IOData *iodata, arr_t & field,
 void io_dump_value(IOData *iodata, real_t value, std::string filename,
   std::string delimiter)
 {
+  // with MPI, values are global and written by rank 0
+  if(decomposition_rank() != 0)
+    return;
+
   // output misc. info about simulation here.
   char data[35];
   std::string dump_filename = iodata->dir() + filename + ".dat.gz";
@@ -868,23 +1008,231 @@ void io_dump_2d_array(IOData *iodata, real_t * array, idx_t n_x, idx_t n_y,
   return;
 }
 
+namespace
+{
+
+const char * particle_snapshot_names[6] = { "x", "y", "z", "vx", "vy", "vz" };
+
+/**
+ * @brief Particle positions and velocities gathered for output, in order
+ * of (subsampled) particle ID
+ */
+struct ParticleSnapshot
+{
+  std::string filename;
+  long long step;
+  hsize_t n_out;
+  bool use_float;
+  std::vector<double> data[6];
+  std::vector<float> fdata[6];
+};
+
+/**
+ * @brief Append one row to a 2D (step x particle) extendible dataset,
+ * creating it if necessary.
+ */
+bool io_append_particle_dataset(hid_t file, const char * name, hsize_t row,
+  hsize_t n_out, hid_t mem_type, hid_t file_type, const void * buf)
+{
+  hid_t dset;
+  herr_t status = 0;
+  hsize_t dims[2] = {row + 1, n_out};
+
+  if(H5Lexists(file, name, H5P_DEFAULT) > 0)
+  {
+    dset = H5Dopen(file, name, H5P_DEFAULT);
+    if(dset >= 0)
+      status = H5Dset_extent(dset, dims);
+  }
+  else
+  {
+    hsize_t maxdims[2] = {H5S_UNLIMITED, n_out},
+            chunk[2] = {1, std::min(n_out, (hsize_t) 65536)};
+    hid_t space = H5Screate_simple(2, dims, maxdims);
+    hid_t dcpl = H5Pcreate(H5P_DATASET_CREATE);
+    H5Pset_chunk(dcpl, 2, chunk);
+    dset = H5Dcreate2(file, name, file_type, space, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+    H5Pclose(dcpl);
+    H5Sclose(space);
+  }
+  if(dset < 0 || status < 0)
+    return false;
+
+  hid_t filespace = H5Dget_space(dset);
+  hsize_t start[2] = {row, 0}, count[2] = {1, n_out};
+  H5Sselect_hyperslab(filespace, H5S_SELECT_SET, start, NULL, count, NULL);
+  hid_t memspace = H5Screate_simple(1, &n_out, NULL);
+  status = H5Dwrite(dset, mem_type, memspace, filespace, H5P_DEFAULT, buf);
+
+  H5Sclose(memspace);
+  H5Sclose(filespace);
+  H5Dclose(dset);
+
+  return status >= 0;
+}
+
+/**
+ * @brief Write a snapshot as the next row of the datasets in its file
+ */
+bool io_write_particle_snapshot(const ParticleSnapshot * snap)
+{
+  hid_t file;
+  if(std::ifstream(snap->filename))
+    file = H5Fopen(snap->filename.c_str(), H5F_ACC_RDWR, H5P_DEFAULT);
+  else
+    file = H5Fcreate(snap->filename.c_str(), H5F_ACC_EXCL, H5P_DEFAULT, H5P_DEFAULT);
+  if(file < 0)
+    return false;
+
+  // row to write is the number of steps already written
+  hsize_t row = 0;
+  if(H5Lexists(file, "step", H5P_DEFAULT) > 0)
+  {
+    hid_t dset = H5Dopen(file, "step", H5P_DEFAULT);
+    hid_t space = H5Dget_space(dset);
+    H5Sget_simple_extent_dims(space, &row, NULL);
+    H5Sclose(space);
+    H5Dclose(dset);
+  }
+
+  bool ok = true;
+  hid_t mem_type = snap->use_float ? H5T_NATIVE_FLOAT : H5T_NATIVE_DOUBLE;
+  hid_t file_type = snap->use_float ? H5T_IEEE_F32LE : H5T_IEEE_F64LE;
+  for(int c=0; c<6; ++c)
+  {
+    const void * buf = snap->use_float ? (const void *) snap->fdata[c].data()
+      : (const void *) snap->data[c].data();
+    ok = ok && io_append_particle_dataset(file, particle_snapshot_names[c],
+      row, snap->n_out, mem_type, file_type, buf);
+  }
+
+  // "step" is stored as a 1-column 2D dataset, appended last
+  ok = ok && io_append_particle_dataset(file, "step", row, 1,
+    H5T_NATIVE_LLONG, H5T_STD_I64LE, &snap->step);
+
+  H5Fclose(file);
+  return ok;
+}
+
+} // anonymous namespace
+
+/**
+ * @brief Output particle positions and velocities to particles.h5
+ * @details Each of x, y, z, vx, vy, vz is an extendible (step x particle)
+ * dataset, with one row appended per output step and the corresponding
+ * simulation step stored in "step". Columns are in order of particle ID,
+ * keeping every IO_particles_stride'th particle. Data is written as
+ * float32 if IO_particles_float is set, and on a background thread if
+ * IO_particles_async is set (and the HDF5 library is thread-safe), in
+ * which case the simulation only waits for the previous snapshot.
+ */
+void io_particles_snapshot_h5(IOData *iodata, idx_t step, Particles *particles)
+{
+  idx_t stride = std::max(1L, std::stol(iodata->ctx->config("IO_particles_stride", "1")));
+  bool use_float = (std::stoi(iodata->ctx->config("IO_particles_float", "0")) > 0);
+  bool async = (std::stoi(iodata->ctx->config("IO_particles_async", "0")) > 0);
+
+  if(async)
+  {
+    hbool_t is_ts = 0;
+    H5is_library_threadsafe(&is_ts);
+    if(!is_ts)
+    {
+      iodata->log("HDF5 library is not thread-safe; writing particles synchronously.");
+      async = false;
+    }
+  }
+
+  std::shared_ptr<ParticleSnapshot> snap (new ParticleSnapshot());
+  snap->filename = iodata->dir() + "particles.h5";
+  snap->step = step;
+  snap->use_float = use_float;
+
+  particle_vec * p_vec = particles->getParticleVec();
+  idx_t n_particles = p_vec->size();
+  snap->n_out = (n_particles + stride - 1)/stride;
+  if(snap->n_out == 0)
+    return;
+
+  for(int c=0; c<6; ++c)
+    if(use_float)
+      snap->fdata[c].resize(snap->n_out);
+    else
+      snap->data[c].resize(snap->n_out);
+
+  idx_t n;
+# pragma omp parallel for
+  for(n=0; n<n_particles; ++n)
+  {
+    idx_t id = p_vec->id[n];
+    if(id % stride != 0)
+      continue;
+    idx_t o = id/stride;
+    for(int d=0; d<3; ++d)
+    {
+      if(use_float)
+      {
+        snap->fdata[d][o] = (float) p_vec->p_a.X[d][n];
+        snap->fdata[3+d][o] = (float) p_vec->p_a.U[d][n];
+      }
+      else
+      {
+        snap->data[d][o] = (double) p_vec->p_a.X[d][n];
+        snap->data[3+d][o] = (double) p_vec->p_a.U[d][n];
+      }
+    }
+  }
+
+  // wait for (and check) any previous write before starting another
+  io_finish_particle_output(iodata);
+
+  if(async)
+  {
+    iodata->particle_writer = std::thread([snap, iodata]() {
+      if(!io_write_particle_snapshot(snap.get()))
+        iodata->particle_writer_failed = true;
+    });
+  }
+  else if(!io_write_particle_snapshot(snap.get()))
+  {
+    iodata->log("Error writing particle snapshot to " + snap->filename);
+  }
+}
+
+/**
+ * @brief Wait for any asynchronous particle snapshot still being written,
+ * logging an error if the write failed
+ */
+void io_finish_particle_output(IOData *iodata)
+{
+  if(iodata->particle_writer.joinable())
+    iodata->particle_writer.join();
+  if(iodata->particle_writer_failed.exchange(false))
+    iodata->log("Error writing particle snapshot to " + iodata->dir() + "particles.h5");
+}
+
 void io_print_particles(IOData *iodata, idx_t step, Particles *particles)
 {
-  bool output_step = ( std::stoi(_config("IO_particles", "0")) > 0 );
+  bool output_step = ( std::stoi(iodata->ctx->config("IO_particles", "0")) > 0 );
   if(!output_step) return;
 
-  bool output_this_step = (0 == step % std::stoi(_config("IO_particles", "1")));
-  bool output_phase_diagram = (0 == step % std::stoi(_config("IO_particles_diagram", "1")));
+  bool output_this_step = (0 == step % std::stoi(iodata->ctx->config("IO_particles", "1")));
+  bool output_phase_diagram = (0 == step % std::stoi(iodata->ctx->config("IO_particles_diagram", "1")));
 
-  bool output_x = (std::stoi(_config("IO_particles_x", "0")) > 0);
-  bool output_y = (std::stoi(_config("IO_particles_y", "0")) > 0);
-  bool output_z = (std::stoi(_config("IO_particles_z", "0")) > 0);
+  bool output_x = (std::stoi(iodata->ctx->config("IO_particles_x", "0")) > 0);
+  bool output_y = (std::stoi(iodata->ctx->config("IO_particles_y", "0")) > 0);
+  bool output_z = (std::stoi(iodata->ctx->config("IO_particles_z", "0")) > 0);
 
-  bool output_vx = (std::stoi(_config("IO_particles_vx", "0")) > 0);
-  bool output_vy = (std::stoi(_config("IO_particles_vy", "0")) > 0);
-  bool output_vz = (std::stoi(_config("IO_particles_vz", "0")) > 0);
+  bool output_vx = (std::stoi(iodata->ctx->config("IO_particles_vx", "0")) > 0);
+  bool output_vy = (std::stoi(iodata->ctx->config("IO_particles_vy", "0")) > 0);
+  bool output_vz = (std::stoi(iodata->ctx->config("IO_particles_vz", "0")) > 0);
 
-  if( output_step && output_this_step )
+  if( output_step && output_this_step
+      && iodata->ctx->config("IO_particles_format", "text") == "hdf5" )
+  {
+    io_particles_snapshot_h5(iodata, step, particles);
+  }
+  else if( output_step && output_this_step )
   {
     // output misc. info about simulation here.
     char data[35];
@@ -896,13 +1244,15 @@ void io_print_particles(IOData *iodata, idx_t step, Particles *particles)
       return;
     }
 
+    // write particles in ID order, as storage order changes when sorting
     particle_vec * p_vec = particles->getParticleVec();
-    for(particle_vec::iterator it = p_vec->begin(); it != p_vec->end(); ++it) {
-      sprintf(data, "%.15g\t", (double) it->p_a.X[0]);
+    std::vector<idx_t> id_order = p_vec->idOrder();
+    for(idx_t n : id_order) {
+      sprintf(data, "%.15g\t", (double) p_vec->p_a.X[0][n]);
       gzwrite(datafile, data, strlen(data));
-      sprintf(data, "%.15g\t", (double) it->p_a.X[1]);
+      sprintf(data, "%.15g\t", (double) p_vec->p_a.X[1][n]);
       gzwrite(datafile, data, strlen(data));
-      sprintf(data, "%.15g\t", (double) it->p_a.X[2]);
+      sprintf(data, "%.15g\t", (double) p_vec->p_a.X[2][n]);
       gzwrite(datafile, data, strlen(data));
     }
 
@@ -916,21 +1266,23 @@ void io_print_particles(IOData *iodata, idx_t step, Particles *particles)
     const real_t TOL = 0.01;
     std::vector<double> x_cache, y_cache, z_cache, vx_cache, vy_cache, vz_cache;
     particle_vec * p_vec = particles->getParticleVec();
-    for(particle_vec::iterator it = p_vec->begin(); it != p_vec->end(); ++it)
+    std::vector<idx_t> id_order = p_vec->idOrder();
+    for(idx_t n : id_order)
     {
-      if(output_x && std::fabs(pw2(it->p_a.X[1]) + pw2(it->p_a.X[2])) < TOL)
-        x_cache.push_back(it->p_a.X[0]);
-      if(output_y && std::fabs(pw2(it->p_a.X[0]) + pw2(it->p_a.X[2])) < TOL)
-        y_cache.push_back(it->p_a.X[1]);
-      if(output_z && std::fabs(pw2(it->p_a.X[1]) + pw2(it->p_a.X[0])) < TOL)
-        z_cache.push_back(it->p_a.X[2]);
-
-      if(output_vx && std::fabs(pw2(it->p_a.X[1]) + pw2(it->p_a.X[2])) < TOL)
-        vx_cache.push_back(it->p_a.U[0]);
-      if(output_vy && std::fabs(pw2(it->p_a.X[0]) + pw2(it->p_a.X[2])) < TOL)
-        vy_cache.push_back(it->p_a.U[1]);
-      if(output_vz && std::fabs(pw2(it->p_a.X[1]) + pw2(it->p_a.X[0])) < TOL)
-        vz_cache.push_back(it->p_a.U[2]);
+      Particle<real_t> p_a = p_vec->p_a.get(n);
+      if(output_x && std::fabs(pw2(p_a.X[1]) + pw2(p_a.X[2])) < TOL)
+        x_cache.push_back(p_a.X[0]);
+      if(output_y && std::fabs(pw2(p_a.X[0]) + pw2(p_a.X[2])) < TOL)
+        y_cache.push_back(p_a.X[1]);
+      if(output_z && std::fabs(pw2(p_a.X[1]) + pw2(p_a.X[0])) < TOL)
+        z_cache.push_back(p_a.X[2]);
+
+      if(output_vx && std::fabs(pw2(p_a.X[1]) + pw2(p_a.X[2])) < TOL)
+        vx_cache.push_back(p_a.U[0]);
+      if(output_vy && std::fabs(pw2(p_a.X[0]) + pw2(p_a.X[2])) < TOL)
+        vy_cache.push_back(p_a.U[1]);
+      if(output_vz && std::fabs(pw2(p_a.X[1]) + pw2(p_a.X[0])) < TOL)
+        vz_cache.push_back(p_a.U[2]);
     }
 
     if(output_x)
@@ -1084,11 +1436,11 @@ void io_raytrace_bardeen_dump(IOData *iodata, idx_t step,
   {
     RaytraceData<real_t> tmp_rd = {0};
     tmp_rd = (*rays)[n]->getRaytraceData();
-    Phis[n] = interp(tmp_rd.x[0]/dx, tmp_rd.x[1]/dx, tmp_rd.x[2]/dx,
+    Phis[n] = interp(tmp_rd.x[0]/iodata->ctx->dx, tmp_rd.x[1]/iodata->ctx->dx, tmp_rd.x[2]/iodata->ctx->dx,
       NX, NY, NZ, bardeen->Phi);
-    Psis[n] = interp(tmp_rd.x[0]/dx, tmp_rd.x[1]/dx, tmp_rd.x[2]/dx,
+    Psis[n] = interp(tmp_rd.x[0]/iodata->ctx->dx, tmp_rd.x[1]/iodata->ctx->dx, tmp_rd.x[2]/iodata->ctx->dx,
       NX, NY, NZ, bardeen->Psi);
-    dt_Bs[n] = interp(tmp_rd.x[0]/dx, tmp_rd.x[1]/dx, tmp_rd.x[2]/dx,
+    dt_Bs[n] = interp(tmp_rd.x[0]/iodata->ctx->dx, tmp_rd.x[1]/iodata->ctx->dx, tmp_rd.x[2]/iodata->ctx->dx,
       NX, NY, NZ, bardeen->dt_B);
   }
 
@@ -1116,10 +1468,10 @@ void io_raytrace_bardeen_dump(IOData *iodata, idx_t step,
 void io_svt_violation(IOData *iodata, idx_t step, Bardeen * bardeen, real_t t)
 {
   // potentials should be set per sim call to prepBSSNOutput
-  bool output_step = ( std::stoi(_config("SVT_constraint_interval", "0")) > 0 );
+  bool output_step = ( std::stoi(iodata->ctx->config("SVT_constraint_interval", "0")) > 0 );
   if(!output_step) return;
 
-  bool output_this_step = (0 == step % std::stoi(_config("SVT_constraint_interval", "1")));
+  bool output_this_step = (0 == step % std::stoi(iodata->ctx->config("SVT_constraint_interval", "1")));
   if( output_step && output_this_step )
   {
     real_t SVT_calcs[NUM_BARDEEN_VIOLS] = {0};
@@ -1135,11 +1487,11 @@ void io_svt_violation(IOData *iodata, idx_t step, Bardeen * bardeen, real_t t)
 void io_raysheet_dump(IOData *iodata, idx_t step,
   Sheet * raySheet, BSSN *bssnSim, Lambda * lambda)
 {
-  bool output_step = ( std::stoi(_config("IO_raysheet_interval", "0")) > 0 );
+  bool output_step = ( std::stoi(iodata->ctx->config("IO_raysheet_interval", "0")) > 0 );
   if(!output_step) return;
 
-  bool output_this_step = (0 == step % std::stoi(_config("IO_raysheet_interval", "1")));
-  bool output_minimalwrite = !!std::stoi(_config("IO_raysheet_minimalwrite", "1"));
+  bool output_this_step = (0 == step % std::stoi(iodata->ctx->config("IO_raysheet_interval", "1")));
+  bool output_minimalwrite = !!std::stoi(iodata->ctx->config("IO_raysheet_minimalwrite", "1"));
   if( output_step && output_this_step )
   {
     // output misc. info about simulation here.
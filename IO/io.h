@@ -3,7 +3,6 @@
 
 #include "../cosmo_includes.h"
 #include "../cosmo_types.h"
-#include "../cosmo_globals.h"
 
 #include "../utils/Fourier.h"
 #include "../utils/FRW.h"
@@ -57,6 +56,8 @@ void io_dump_value(IOData *iodata, real_t value, std::string filename,
 void io_dump_2d_array(IOData *iodata, real_t * array, idx_t n_x, idx_t n_y,
   std::string filename, std::string dataset_name);
 
+void io_particles_snapshot_h5(IOData *iodata, idx_t step, Particles *particles);
+void io_finish_particle_output(IOData *iodata);
 void io_print_particles(IOData *iodata, idx_t step, Particles *particles);
 
 #if USE_COSMOTRACE
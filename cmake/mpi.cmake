@@ -0,0 +1,20 @@
+# MPI domain decomposition (optional)
+if(COSMO_USE_MPI)
+  find_package(MPI REQUIRED)
+  add_definitions(-DUSE_MPI=1)
+  message(STATUS "${Cyan}Setting USE_MPI=1.${ColorReset}")
+
+  # Number of MPI processes (slabs) the code will be run with
+  if(DEFINED COSMO_MPI_RANKS)
+    add_definitions(-DCOSMO_MPI_RANKS=${COSMO_MPI_RANKS})
+    message(STATUS "${Cyan}Setting COSMO_MPI_RANKS=${COSMO_MPI_RANKS}.${ColorReset}")
+  endif()
+
+  include_directories(${MPI_CXX_INCLUDE_PATH})
+  set(MPI_LINK_LIBRARY "${MPI_CXX_LIBRARIES}")
+  message(STATUS " MPI_CXX_LIBRARIES: ${MPI_CXX_LIBRARIES}")
+endif()
+
+# Remove these from cache
+unset(COSMO_USE_MPI CACHE)
+unset(COSMO_MPI_RANKS CACHE)
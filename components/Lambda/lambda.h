@@ -3,12 +3,13 @@
 
 #include "../../cosmo_types.h"
 #include "../bssn/bssn.h"
+#include "../matter/MatterComponent.h"
 
 namespace cosmo
 {
 
 /** Lambda class **/
-class Lambda
+class Lambda : public MatterComponent
 {
   real_t lambda; /* CC energy density*/ 
 
@@ -19,7 +20,9 @@ public:
 
   void setLambda(real_t lambda_in);
   real_t getLambda();
-  void addBSSNSource(BSSN *bssn);
+
+  // MatterComponent interface
+  void addBSSNSrcOffset(BSSNData *offset);
 
 };
 
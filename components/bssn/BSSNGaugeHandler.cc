@@ -1,7 +1,6 @@
 #include "BSSNGaugeHandler.h"
 #include "bssn.h"
 #include "../../cosmo_types.h"
-#include "../../cosmo_globals.h"
 #include <map>
 #include <cmath>
 #include "../../utils/math.h"
@@ -5,14 +5,14 @@
 namespace cosmo
 {
 
-real_t abs_dder(idx_t i, idx_t j, idx_t k, arr_t & field)
+real_t abs_dder(idx_t i, idx_t j, idx_t k, arr_t & field, real_t inv_dx)
 {
-  return std::abs(double_derivative(i,j,k,1,1,field))
-   + std::abs(double_derivative(i,j,k,1,2,field))
-   + std::abs(double_derivative(i,j,k,1,3,field))
-   + std::abs(double_derivative(i,j,k,2,2,field))
-   + std::abs(double_derivative(i,j,k,2,3,field))
-   + std::abs(double_derivative(i,j,k,3,3,field));
+  return std::abs(double_derivative(i,j,k,1,1,field,inv_dx))
+   + std::abs(double_derivative(i,j,k,1,2,field,inv_dx))
+   + std::abs(double_derivative(i,j,k,1,3,field,inv_dx))
+   + std::abs(double_derivative(i,j,k,2,2,field,inv_dx))
+   + std::abs(double_derivative(i,j,k,2,3,field,inv_dx))
+   + std::abs(double_derivative(i,j,k,3,3,field,inv_dx));
 }
 
 /**
@@ -23,6 +23,7 @@ real_t abs_dder(idx_t i, idx_t j, idx_t k, arr_t & field)
 void Bardeen::setPotentials(real_t elapsed_sim_time)
 {
   idx_t i, j, k;
+  const real_t inv_dx = bssn->ctx->inv_dx;
 
   if( bssn->frw->get_K() != 0 || bssn->frw->get_phi() != 0)
   {
@@ -111,7 +112,7 @@ void Bardeen::setPotentials(real_t elapsed_sim_time)
     bssn->set_bd_values(i, j, k, &bd);
 
     real_t dkbetak = bd.d1beta1 + bd.d2beta2 + bd.d3beta3;
-    real_t dkdtbetak = derivative(i,j,k,1,dt_beta1) + derivative(i,j,k,2,dt_beta2) + derivative(i,j,k,3,dt_beta3);
+    real_t dkdtbetak = derivative(i,j,k,1,dt_beta1,inv_dx) + derivative(i,j,k,2,dt_beta2,inv_dx) + derivative(i,j,k,3,dt_beta3,inv_dx);
     real_t dtalpha = bssn->ev_DIFFalpha(&bd);
 
     // stores d^2/dt^2 \bar{\gamma}_ij, incl. Macro for calc.
@@ -120,11 +121,11 @@ void Bardeen::setPotentials(real_t elapsed_sim_time)
 #define dt_g32 dt_g23
 #define D2T_g(I,J) -2.0*dtalpha*bd.A##I##J - 2.0*bd.alpha*bssn->ev_A##I##J(&bd) \
       + dt_beta1[idx]*bd.d1g##I##J + dt_beta2[idx]*bd.d2g##I##J + dt_beta3[idx]*bd.d3g##I##J \
-      + bd.beta1*derivative(i,j,k,1,dt_g##I##J) + bd.beta2*derivative(i,j,k,2,dt_g##I##J) + bd.beta3*derivative(i,j,k,3,dt_g##I##J) \
+      + bd.beta1*derivative(i,j,k,1,dt_g##I##J,inv_dx) + bd.beta2*derivative(i,j,k,2,dt_g##I##J,inv_dx) + bd.beta3*derivative(i,j,k,3,dt_g##I##J,inv_dx) \
       + dt_g##I##1[idx]*bd.d##J##beta1 + dt_g##I##2[idx]*bd.d##J##beta2 + dt_g##I##3[idx]*bd.d##J##beta3 \
       + dt_g##J##1[idx]*bd.d##I##beta1 + dt_g##J##2[idx]*bd.d##I##beta2 + dt_g##J##3[idx]*bd.d##I##beta3 \
-      + bd.gamma##I##1*derivative(i,j,k,J,dt_beta1) + bd.gamma##I##2*derivative(i,j,k,J,dt_beta2) + bd.gamma##I##3*derivative(i,j,k,J,dt_beta3) \
-      + bd.gamma##J##1*derivative(i,j,k,I,dt_beta1) + bd.gamma##J##2*derivative(i,j,k,I,dt_beta2) + bd.gamma##J##3*derivative(i,j,k,I,dt_beta3) \
+      + bd.gamma##I##1*derivative(i,j,k,J,dt_beta1,inv_dx) + bd.gamma##I##2*derivative(i,j,k,J,dt_beta2,inv_dx) + bd.gamma##I##3*derivative(i,j,k,J,dt_beta3,inv_dx) \
+      + bd.gamma##J##1*derivative(i,j,k,I,dt_beta1,inv_dx) + bd.gamma##J##2*derivative(i,j,k,I,dt_beta2,inv_dx) + bd.gamma##J##3*derivative(i,j,k,I,dt_beta3,inv_dx) \
       - 2.0/3.0*( dt_g##I##J[idx]*dkbetak + bd.gamma##I##J*dkdtbetak )
 
     d2t_g11[idx] = D2T_g(1, 1);
@@ -138,12 +139,12 @@ void Bardeen::setPotentials(real_t elapsed_sim_time)
 #if USE_Z4c_DAMPING
     d2t_phi[idx] = -1.0/6.0*( dtalpha*(bd.K + 2.0 * bd.theta) + bd.alpha*(bssn->ev_DIFFK(&bd) + 2.0 * bssn->ev_theta(&bd)))
       + dt_beta1[idx]*bd.d1phi + dt_beta2[idx]*bd.d2phi + dt_beta3[idx]*bd.d3phi
-      + bd.beta1*derivative(i,j,k,1,dt_phi) + bd.beta2*derivative(i,j,k,2,dt_phi) + bd.beta3*derivative(i,j,k,3,dt_phi)
+      + bd.beta1*derivative(i,j,k,1,dt_phi,inv_dx) + bd.beta2*derivative(i,j,k,2,dt_phi,inv_dx) + bd.beta3*derivative(i,j,k,3,dt_phi,inv_dx)
       + 1.0/6.0*dkdtbetak;
 #else
     d2t_phi[idx] = -1.0/6.0*( dtalpha*bd.K + bd.alpha*bssn->ev_DIFFK(&bd))
       + dt_beta1[idx]*bd.d1phi + dt_beta2[idx]*bd.d2phi + dt_beta3[idx]*bd.d3phi
-      + bd.beta1*derivative(i,j,k,1,dt_phi) + bd.beta2*derivative(i,j,k,2,dt_phi) + bd.beta3*derivative(i,j,k,3,dt_phi)
+      + bd.beta1*derivative(i,j,k,1,dt_phi,inv_dx) + bd.beta2*derivative(i,j,k,2,dt_phi,inv_dx) + bd.beta3*derivative(i,j,k,3,dt_phi,inv_dx)
       + 1.0/6.0*dkdtbetak;    
 #endif
     
@@ -160,7 +161,7 @@ void Bardeen::setPotentials(real_t elapsed_sim_time)
     idx_t idx = NP_INDEX(i,j,k);
 
     BSSNData bd = {0};
-    bssn->set_bd_values(i, j, k, &bd); // TODO: remove redundant computations here?
+    bssn->set_bd_values<BD_LOCAL>(i, j, k, &bd);
 
     real_t e4phi = std::exp(4.0*bd.phi);
 
@@ -222,16 +223,16 @@ void Bardeen::setPotentials(real_t elapsed_sim_time)
   {
     idx_t idx = NP_INDEX(i,j,k);
     A[idx] = (
-      double_derivative(i, j, k, 1, 1, h11) + double_derivative(i, j, k, 2, 2, h22) + double_derivative(i, j, k, 3, 3, h33)
-      + 2.0*(double_derivative(i, j, k, 1, 2, h12) + double_derivative(i, j, k, 1, 3, h13) + double_derivative(i, j, k, 2, 3, h23))
+      double_derivative(i, j, k, 1, 1, h11, inv_dx) + double_derivative(i, j, k, 2, 2, h22, inv_dx) + double_derivative(i, j, k, 3, 3, h33, inv_dx)
+      + 2.0*(double_derivative(i, j, k, 1, 2, h12, inv_dx) + double_derivative(i, j, k, 1, 3, h13, inv_dx) + double_derivative(i, j, k, 2, 3, h23, inv_dx))
     );
     dt_A[idx] = (
-      double_derivative(i, j, k, 1, 1, dt_h11) + double_derivative(i, j, k, 2, 2, dt_h22) + double_derivative(i, j, k, 3, 3, dt_h33)
-      + 2.0*(double_derivative(i, j, k, 1, 2, dt_h12) + double_derivative(i, j, k, 1, 3, dt_h13) + double_derivative(i, j, k, 2, 3, dt_h23))
+      double_derivative(i, j, k, 1, 1, dt_h11, inv_dx) + double_derivative(i, j, k, 2, 2, dt_h22, inv_dx) + double_derivative(i, j, k, 3, 3, dt_h33, inv_dx)
+      + 2.0*(double_derivative(i, j, k, 1, 2, dt_h12, inv_dx) + double_derivative(i, j, k, 1, 3, dt_h13, inv_dx) + double_derivative(i, j, k, 2, 3, dt_h23, inv_dx))
     );
     d2t_A[idx] = (
-      double_derivative(i, j, k, 1, 1, d2t_h11) + double_derivative(i, j, k, 2, 2, d2t_h22) + double_derivative(i, j, k, 3, 3, d2t_h33)
-      + 2.0*(double_derivative(i, j, k, 1, 2, d2t_h12) + double_derivative(i, j, k, 1, 3, d2t_h13) + double_derivative(i, j, k, 2, 3, d2t_h23))
+      double_derivative(i, j, k, 1, 1, d2t_h11, inv_dx) + double_derivative(i, j, k, 2, 2, d2t_h22, inv_dx) + double_derivative(i, j, k, 3, 3, d2t_h33, inv_dx)
+      + 2.0*(double_derivative(i, j, k, 1, 2, d2t_h12, inv_dx) + double_derivative(i, j, k, 1, 3, d2t_h13, inv_dx) + double_derivative(i, j, k, 2, 3, d2t_h23, inv_dx))
     );
   }
   // (A.2) compute inverse laplacian of (A.1)
@@ -316,9 +317,9 @@ void Bardeen::setPotentials(real_t elapsed_sim_time)
     idx_t idx = NP_INDEX(i,j,k);
 
     // d^2 F
-    F[idx] = ( derivative(i,j,k,1,h01) + derivative(i,j,k,2,h02) + derivative(i,j,k,3,h03) ) / a;
+    F[idx] = ( derivative(i,j,k,1,h01,inv_dx) + derivative(i,j,k,2,h02,inv_dx) + derivative(i,j,k,3,h03,inv_dx) ) / a;
     // d^2 F'
-    dt_F[idx] = ( derivative(i,j,k,1,dt_h01) + derivative(i,j,k,2,dt_h02) + derivative(i,j,k,3,dt_h03) ) / a
+    dt_F[idx] = ( derivative(i,j,k,1,dt_h01,inv_dx) + derivative(i,j,k,2,dt_h02,inv_dx) + derivative(i,j,k,3,dt_h03,inv_dx) ) / a
       - H*F[idx];
   }
   fourier->inverseLaplacian <idx_t, real_t> (F._array);
@@ -346,31 +347,31 @@ void Bardeen::setPotentials(real_t elapsed_sim_time)
     idx_t idx = NP_INDEX(i,j,k);
 
     // G components
-    G1[idx] = derivative(i,j,k,1,F) - h01[idx]/a;
-    G2[idx] = derivative(i,j,k,2,F) - h02[idx]/a;
-    G3[idx] = derivative(i,j,k,3,F) - h03[idx]/a;
+    G1[idx] = derivative(i,j,k,1,F,inv_dx) - h01[idx]/a;
+    G2[idx] = derivative(i,j,k,2,F,inv_dx) - h02[idx]/a;
+    G3[idx] = derivative(i,j,k,3,F,inv_dx) - h03[idx]/a;
 
     // d^2 C_i
-    C1[idx] = ( derivative(i,j,k,2,h12) + derivative(i,j,k,3,h13)
-      - derivative(i,j,k,1,h22) - derivative(i,j,k,1,h33) )/a/a
-      + 2.0*derivative(i,j,k,1,A);
-    C2[idx] = ( derivative(i,j,k,1,h12) + derivative(i,j,k,3,h23)
-      - derivative(i,j,k,2,h11) - derivative(i,j,k,2,h33) )/a/a
-      + 2.0*derivative(i,j,k,2,A);
-    C3[idx] = ( derivative(i,j,k,1,h13) + derivative(i,j,k,2,h23)
-      - derivative(i,j,k,3,h11) - derivative(i,j,k,3,h22) )/a/a
-      + 2.0*derivative(i,j,k,3,A);
+    C1[idx] = ( derivative(i,j,k,2,h12,inv_dx) + derivative(i,j,k,3,h13,inv_dx)
+      - derivative(i,j,k,1,h22,inv_dx) - derivative(i,j,k,1,h33,inv_dx) )/a/a
+      + 2.0*derivative(i,j,k,1,A,inv_dx);
+    C2[idx] = ( derivative(i,j,k,1,h12,inv_dx) + derivative(i,j,k,3,h23,inv_dx)
+      - derivative(i,j,k,2,h11,inv_dx) - derivative(i,j,k,2,h33,inv_dx) )/a/a
+      + 2.0*derivative(i,j,k,2,A,inv_dx);
+    C3[idx] = ( derivative(i,j,k,1,h13,inv_dx) + derivative(i,j,k,2,h23,inv_dx)
+      - derivative(i,j,k,3,h11,inv_dx) - derivative(i,j,k,3,h22,inv_dx) )/a/a
+      + 2.0*derivative(i,j,k,3,A,inv_dx);
 
     // d^2 d_t C_i
-    dt_C1[idx] = ( derivative(i,j,k,2,dt_h12) + derivative(i,j,k,3,dt_h13)
-        - derivative(i,j,k,1,dt_h22) - derivative(i,j,k,1,dt_h33) )/a/a
-      - 2.0*H*( C1[idx] - 2.0*derivative(i,j,k,1,A) ) + 2.0*derivative(i,j,k,1,dt_A);
-    dt_C2[idx] = ( derivative(i,j,k,1,dt_h12) + derivative(i,j,k,3,dt_h23)
-        - derivative(i,j,k,2,dt_h11) - derivative(i,j,k,2,dt_h33) )/a/a
-      - 2.0*H*( C2[idx] - 2.0*derivative(i,j,k,2,A) ) + 2.0*derivative(i,j,k,2,dt_A);
-    dt_C3[idx] = ( derivative(i,j,k,1,dt_h13) + derivative(i,j,k,2,dt_h23)
-        - derivative(i,j,k,3,dt_h11) - derivative(i,j,k,3,dt_h22) )/a/a
-      - 2.0*H*( C3[idx] - 2.0*derivative(i,j,k,3,A) ) + 2.0*derivative(i,j,k,3,dt_A);
+    dt_C1[idx] = ( derivative(i,j,k,2,dt_h12,inv_dx) + derivative(i,j,k,3,dt_h13,inv_dx)
+        - derivative(i,j,k,1,dt_h22,inv_dx) - derivative(i,j,k,1,dt_h33,inv_dx) )/a/a
+      - 2.0*H*( C1[idx] - 2.0*derivative(i,j,k,1,A,inv_dx) ) + 2.0*derivative(i,j,k,1,dt_A,inv_dx);
+    dt_C2[idx] = ( derivative(i,j,k,1,dt_h12,inv_dx) + derivative(i,j,k,3,dt_h23,inv_dx)
+        - derivative(i,j,k,2,dt_h11,inv_dx) - derivative(i,j,k,2,dt_h33,inv_dx) )/a/a
+      - 2.0*H*( C2[idx] - 2.0*derivative(i,j,k,2,A,inv_dx) ) + 2.0*derivative(i,j,k,2,dt_A,inv_dx);
+    dt_C3[idx] = ( derivative(i,j,k,1,dt_h13,inv_dx) + derivative(i,j,k,2,dt_h23,inv_dx)
+        - derivative(i,j,k,3,dt_h11,inv_dx) - derivative(i,j,k,3,dt_h22,inv_dx) )/a/a
+      - 2.0*H*( C3[idx] - 2.0*derivative(i,j,k,3,A,inv_dx) ) + 2.0*derivative(i,j,k,3,dt_A,inv_dx);
   }
   fourier->inverseLaplacian <idx_t, real_t> (C1._array);
   fourier->inverseLaplacian <idx_t, real_t> (C2._array);
@@ -394,8 +395,8 @@ void Bardeen::setPotentials(real_t elapsed_sim_time)
   {
     idx_t idx = NP_INDEX(i,j,k);
 
-#define DIJ(I,J) h##I##J[idx]/a/a - (I==J?1.0:0.0)*A[idx] - double_derivative(i,j,k,I,J,B) \
-          - derivative(i,j,k,I,C##J) - derivative(i,j,k,J,C##I)
+#define DIJ(I,J) h##I##J[idx]/a/a - (I==J?1.0:0.0)*A[idx] - double_derivative(i,j,k,I,J,B,inv_dx) \
+          - derivative(i,j,k,I,C##J,inv_dx) - derivative(i,j,k,J,C##I,inv_dx)
     D11[idx] = DIJ(1,1);
     D12[idx] = DIJ(1,2);
     D13[idx] = DIJ(1,3);
@@ -416,15 +417,15 @@ void Bardeen::setPotentials(real_t elapsed_sim_time)
     lin_viol_mag[idx] = std::sqrt( pw2(E[idx]) + pw2(A[idx]) + pw2(a*a*d2t_B[idx])
       + pw2(3.0*a*dadt*dt_B[idx]) + pw2(2.0*a*dt_F[idx]) + pw2(4.0*dadt*F[idx]) );
 
-    lin_viol_der_mag[idx] = abs_dder(i,j,k,E) + abs_dder(i,j,k,A)
-      + a*a*abs_dder(i,j,k,d2t_B) + std::abs(3.0*a*dadt)*abs_dder(i,j,k,dt_B)
-      + 2.0*a*abs_dder(i,j,k,dt_F) + std::abs(4.0*dadt)*abs_dder(i,j,k,F);
+    lin_viol_der_mag[idx] = abs_dder(i,j,k,E,inv_dx) + abs_dder(i,j,k,A,inv_dx)
+      + a*a*abs_dder(i,j,k,d2t_B,inv_dx) + std::abs(3.0*a*dadt)*abs_dder(i,j,k,dt_B,inv_dx)
+      + 2.0*a*abs_dder(i,j,k,dt_F,inv_dx) + std::abs(4.0*dadt)*abs_dder(i,j,k,F,inv_dx);
   }
 #pragma omp parallel for default(shared) private(i, j, k)
   LOOP3(i,j,k)
   {
     idx_t idx = NP_INDEX(i,j,k);
-    lin_viol_der[idx] = abs_dder(i,j,k,lin_viol);
+    lin_viol_der[idx] = abs_dder(i,j,k,lin_viol,inv_dx);
   }
 
   real_t mean_viol_der = average(lin_viol_der);
@@ -1,5 +1,5 @@
 #include "bssn.h"
-#include "../../cosmo_globals.h"
+#include "../matter/MatterComponent.h"
 #include "../../utils/math.h"
 
 namespace cosmo
@@ -10,8 +10,11 @@ namespace cosmo
  * @details Allocate memory for fields, add fields to map,
  * create reference FRW integrator, and call BSSN::init.
  */
-BSSN::BSSN(ConfigParser * config, Fourier * fourier_in)
+BSSN::BSSN(SimContext * ctx_in, Fourier * fourier_in)
 {
+  ctx = ctx_in;
+  ConfigParser * config = &ctx->config;
+
   KO_damping_coefficient = std::stod((*config)("KO_damping_coefficient", "0.0"));
   a_adj_amp = std::stod((*config)("a_adj_amp", "0.0"));
   k_damping_amp = std::stod((*config)("k_damping_amp", "0.0"));
@@ -27,8 +30,12 @@ BSSN::BSSN(ConfigParser * config, Fourier * fourier_in)
   fourier = fourier_in;
 
   // BSSN fields
-  BSSN_APPLY_TO_FIELDS(RK4_ARRAY_ALLOC)
+  BSSN_APPLY_TO_FIELDS_ARGS(RK4_ARRAY_ALLOC, ctx->dt)
   BSSN_APPLY_TO_FIELDS(RK4_ARRAY_ADDMAP)
+  BSSN_APPLY_TO_FIELDS(BSSN_ADD_HALO_FIELD)
+  halos_current = false;
+  BSSN_APPLY_TO_FIELDS(BSSN_ADD_STEP_FIELD)
+  frw_start = NULL;
 
   // BSSN source fields
   BSSN_APPLY_TO_SOURCES(GEN1_ARRAY_ALLOC)
@@ -49,6 +56,10 @@ BSSN::~BSSN()
   BSSN_APPLY_TO_SOURCES(GEN1_ARRAY_DELETE)
   BSSN_APPLY_TO_GEN1_EXTRAS(GEN1_ARRAY_DELETE)
 
+  for(arr_t * start : step_start)
+    delete start;
+  delete frw_start;
+
   delete gaugeHandler;
   delete frw;
 }
@@ -177,7 +188,7 @@ void BSSN::setExtraFieldData()
   LOOP3(i, j, k)
   {
     BSSNData bd = {0};
-    set_bd_values(i, j, k, &bd);
+    set_bd_values<BD_RICCI>(i, j, k, &bd);
     idx_t idx = bd.idx;
 
     GNricciTF11_a[idx] = bd.ricciTF11;
@@ -192,12 +203,12 @@ void BSSN::setExtraFieldData()
   LOOP3(i, j, k)
   {
     idx_t idx = NP_INDEX(i,j,k);
-    GNDiDjRijTFoD2_a[idx] = double_derivative(i, j, k, 1, 1, GNricciTF11_a)
-     + double_derivative(i, j, k, 2, 2, GNricciTF22_a)
-     + double_derivative(i, j, k, 3, 3, GNricciTF33_a)
-     + 2.0 * ( double_derivative(i, j, k, 1, 2, GNricciTF12_a)
-               + double_derivative(i, j, k, 1, 3, GNricciTF13_a)
-               + double_derivative(i, j, k, 2, 3, GNricciTF23_a) );
+    GNDiDjRijTFoD2_a[idx] = double_derivative(i, j, k, 1, 1, GNricciTF11_a, ctx->inv_dx)
+     + double_derivative(i, j, k, 2, 2, GNricciTF22_a, ctx->inv_dx)
+     + double_derivative(i, j, k, 3, 3, GNricciTF33_a, ctx->inv_dx)
+     + 2.0 * ( double_derivative(i, j, k, 1, 2, GNricciTF12_a, ctx->inv_dx)
+               + double_derivative(i, j, k, 1, 3, GNricciTF13_a, ctx->inv_dx)
+               + double_derivative(i, j, k, 2, 3, GNricciTF23_a, ctx->inv_dx) );
   }
 
   fourier->inverseLaplacian <idx_t, real_t> (GNDiDjRijTFoD2_a._array);
@@ -206,7 +217,7 @@ void BSSN::setExtraFieldData()
   LOOP3(i, j, k)
   {
     idx_t idx = NP_INDEX(i,j,k);
-    GND2Alpha_a[idx] = laplacian(i, j, k, DIFFalpha->_array_a);
+    GND2Alpha_a[idx] = laplacian(i, j, k, DIFFalpha->_array_a, ctx->inv_dx);
   }
 #endif
 
@@ -223,22 +234,60 @@ void BSSN::stepInit()
 
   if(normalize_metric)
     set_DIFFgamma_Aij_norm(); // norms metric in _a register
+
+  // output and source routines read halos before the first RKEvolve
+  halos_current = false;
+  exchangeHalos();
+}
+
+/**
+ * @brief Fill halos of the _a register from neighboring MPI processes
+ * @details Blocks until halos are current; a no-op if they already are, or
+ * without MPI. Must be called before derivatives are taken outside of
+ * BSSN::RKEvolve (which overlaps the exchange with computation).
+ */
+void BSSN::exchangeHalos()
+{
+#if USE_MPI
+  if(halos_current) return;
+
+  ctx->timer["halo_exchange"].start();
+  decomposition_exchange_halos(halo_fields);
+  ctx->timer["halo_exchange"].stop();
+#endif
+  halos_current = true;
+}
+
+/**
+ * @brief Append fields with stale halos to a list of fields to be exchanged
+ * @details Halos are considered current afterwards, so the caller must
+ * complete the exchange (eg. using decomposition_loop_overlapping_halos)
+ * before they are read.
+ */
+void BSSN::addStaleHaloFields(std::vector<arr_t *> & fields)
+{
+  if(!halos_current)
+    fields.insert(fields.end(), halo_fields.begin(), halo_fields.end());
+  halos_current = true;
 }
 
 /**
  * @brief Call BSSN::RKEvolvePt for all points
+ * @details Any pending halo exchange is overlapped with evolution of
+ * interior points.
  */
 void BSSN::RKEvolve()
 {
-  idx_t i, j, k;
-
   if(rescale_metric) scaleMetricPerturbations(rescale_metric);
-# pragma omp parallel for default(shared) private(i, j, k)
-  LOOP3(i, j, k)
-  {
-    BSSNData bd = {0};
-    RKEvolvePt(i, j, k, &bd);
-  }
+
+  std::vector<arr_t *> exchange_fields;
+  addStaleHaloFields(exchange_fields);
+  decomposition_loop_overlapping_halos(ctx->timer, exchange_fields,
+    [&](idx_t i, idx_t j, idx_t k) {
+      BSSNData bd = {0};
+      RKEvolvePt(i, j, k, &bd);
+    });
+
   if(rescale_metric) scaleMetricPerturbations(1.0 / rescale_metric);
 }
 
@@ -257,18 +306,146 @@ void BSSN::RKEvolve()
 void BSSN::RKEvolvePt(idx_t i, idx_t j, idx_t k, BSSNData * bd)
 {
   set_bd_values(i, j, k, bd);
+  RKEvolvePt(bd);
+}
+
+/**
+ * @brief Compute the BSSN evolution functions from a populated BSSNData
+ * struct, see BSSN::RKEvolvePt(i, j, k, bd)
+ */
+void BSSN::RKEvolvePt(BSSNData * bd)
+{
   BSSN_RK_EVOLVE_PT; // macro stores ev_field to _c register for all fields
 }
 
+/**
+ * @brief Evolve BSSN fields and matter components in a single sweep
+ * @details BSSNData is computed once per point. If set_sources, sources
+ * are assembled (see BSSN::assembleSrcPt) and stored before the BSSN RHS is
+ * computed. Components then evaluate their own RHS from the same bd.
+ *
+ * If the metric is rescaled for the BSSN RHS, matter components still see
+ * the unscaled metric; BSSN fields are then evolved in a separate sweep.
+ *
+ * @param components matter components evolved in the sweep
+ * @param sources matter components contributing sources (including
+ * components), in the order sources are added
+ * @param set_sources recompute sources; otherwise current ones are used
+ */
+void BSSN::RKEvolve(std::vector<MatterComponent *> & components,
+  std::vector<MatterComponent *> & sources, bool set_sources)
+{
+  BSSNSrcAssembly sa;
+  if(set_sources)
+    prepareSrc(sources, &sa);
+
+  std::vector<arr_t *> exchange_fields;
+  addStaleHaloFields(exchange_fields);
+  for(MatterComponent * component : sources)
+    component->addStaleHaloFields(exchange_fields);
+
+  const bool evolve_bssn = !rescale_metric;
+  decomposition_loop_overlapping_halos(ctx->timer, exchange_fields,
+    [&](idx_t i, idx_t j, idx_t k) {
+      BSSNData bd = {0};
+      set_bd_values(i, j, k, &bd);
+
+      if(set_sources)
+      {
+        assembleSrcPt(sources, &sa, &bd);
+        bd.H = hamiltonianConstraintCalc(&bd);
+      }
+
+      if(evolve_bssn)
+        RKEvolvePt(&bd);
+      for(MatterComponent * component : components)
+        component->RKEvolvePt(&bd);
+    });
+
+  if(!evolve_bssn)
+    RKEvolve();
+}
+
+/**
+ * @brief Compute the RHS of matter components without evolving BSSN fields
+ * @details Used for components subcycled within a BSSN step (see
+ * MatterDriver), with the metric set by BSSN::setInterpolatedMetric. Only
+ * BD_DERIVS members of BSSNData are computed; sources are not updated.
+ */
+void BSSN::RKEvolveMatter(std::vector<MatterComponent *> & components)
+{
+  std::vector<arr_t *> exchange_fields;
+  addStaleHaloFields(exchange_fields);
+  for(MatterComponent * component : components)
+    component->addStaleHaloFields(exchange_fields);
+
+  decomposition_loop_overlapping_halos(ctx->timer, exchange_fields,
+    [&](idx_t i, idx_t j, idx_t k) {
+      BSSNData bd = {0};
+      set_bd_values<BD_DERIVS>(i, j, k, &bd);
+      for(MatterComponent * component : components)
+        component->RKEvolvePt(&bd);
+    });
+}
+
+/**
+ * @brief Store evolved fields and the reference FRW integrator at the start
+ * of a step, for use by BSSN::setInterpolatedMetric
+ */
+void BSSN::storeStepStart()
+{
+  if(step_start.empty())
+  {
+    for(register_t * field : step_fields)
+      step_start.push_back(new arr_t(field->_array_p.nx, field->_array_p.ny, field->_array_p.nz));
+    frw_start = new FRW<real_t>(*frw);
+  }
+
+  for(size_t f=0; f<step_fields.size(); ++f)
+  {
+    arr_t & start = *step_start[f];
+    arr_t & field_p = step_fields[f]->_array_p;
+    idx_t idx;
+#   pragma omp parallel for default(shared) private(idx)
+    for(idx=0; idx<start.pts; ++idx)
+      start[idx] = field_p[idx];
+  }
+  *frw_start = *frw;
+}
+
+/**
+ * @brief Set the _a register of evolved fields (and reference FRW values) to
+ * a linear interpolation between the start (theta = 0) and end (theta = 1)
+ * of the last step
+ * @details BSSN::storeStepStart must be called before the step. Setting
+ * theta = 1 exactly restores the end of the step.
+ */
+void BSSN::setInterpolatedMetric(real_t theta)
+{
+  for(size_t f=0; f<step_fields.size(); ++f)
+  {
+    arr_t & start = *step_start[f];
+    arr_t & field_p = step_fields[f]->_array_p;
+    arr_t & field_a = step_fields[f]->_array_a;
+    idx_t idx;
+#   pragma omp parallel for default(shared) private(idx)
+    for(idx=0; idx<start.pts; ++idx)
+      field_a[idx] = (1.0 - theta)*start[idx] + theta*field_p[idx];
+  }
+  frw->set_interpolated(*frw_start, theta);
+  halos_current = false;
+}
+
 /**
  * @brief Call RK4Register::K1Finalize finalization routine for BSSN fields,
  * call FRW::P1_step for reference FRW integrator
  */
 void BSSN::K1Finalize()
 {
-  frw->P1_step(dt);
+  frw->P1_step(ctx->dt);
   BSSN_FINALIZE_K(1);
   setExtraFieldData();
+  halos_current = false;
 }
 
 /**
@@ -277,9 +454,10 @@ void BSSN::K1Finalize()
  */
 void BSSN::K2Finalize()
 {
-  frw->P2_step(dt);
+  frw->P2_step(ctx->dt);
   BSSN_FINALIZE_K(2);
   setExtraFieldData();
+  halos_current = false;
 }
 
 /**
@@ -288,9 +466,10 @@ void BSSN::K2Finalize()
  */
 void BSSN::K3Finalize()
 {
-  frw->P3_step(dt);
+  frw->P3_step(ctx->dt);
   BSSN_FINALIZE_K(3);
   setExtraFieldData();
+  halos_current = false;
 }
 
 /**
@@ -299,9 +478,10 @@ void BSSN::K3Finalize()
  */
 void BSSN::K4Finalize()
 {
-  frw->RK_total_step(dt);
+  frw->RK_total_step(ctx->dt);
   BSSN_FINALIZE_K(4);
   setExtraFieldData();
+  halos_current = false;
 }
 
 /**
@@ -318,6 +498,119 @@ void BSSN::clearSrc()
   }
 }
 
+/**
+ * @brief Prepare assembly of BSSN sources from matter components
+ * @details Components that deposit sources do so here, after source arrays
+ * are cleared (arrays are otherwise not cleared). Constant contributions
+ * are collected into sa->offset.
+ */
+void BSSN::prepareSrc(std::vector<MatterComponent *> & components, BSSNSrcAssembly *sa)
+{
+  sa->deposited = false;
+  sa->tracefree = false;
+  zero_bd_sources(&sa->offset);
+
+  for(MatterComponent * component : components)
+  {
+    if(component->depositsBSSNSrc())
+    {
+      if(!sa->deposited)
+        clearSrc();
+      sa->deposited = true;
+      component->depositBSSNSrc(this);
+    }
+    sa->tracefree = sa->tracefree || component->tracefreeBSSNSrc();
+    component->addBSSNSrcOffset(&sa->offset);
+  }
+}
+
+/**
+ * @brief Set BSSN sources from matter components in a single pass
+ */
+void BSSN::setSrc(std::vector<MatterComponent *> & components)
+{
+  BSSNSrcAssembly sa;
+  prepareSrc(components, &sa);
+
+  std::vector<arr_t *> exchange_fields;
+  addStaleHaloFields(exchange_fields);
+  for(MatterComponent * component : components)
+    component->addStaleHaloFields(exchange_fields);
+
+  decomposition_loop_overlapping_halos(ctx->timer, exchange_fields,
+    [&](idx_t i, idx_t j, idx_t k) {
+      BSSNData bd = {0};
+      set_bd_values<BD_LOCAL>(i, j, k, &bd);
+      assembleSrcPt(components, &sa, &bd);
+    });
+}
+
+/**
+ * @brief Set BSSN sources in x-planes [x_begin, x_end), for use within a
+ * task; BSSN::prepareSrc must have been called.
+ */
+void BSSN::setSrc(std::vector<MatterComponent *> & components, BSSNSrcAssembly *sa,
+  idx_t x_begin, idx_t x_end)
+{
+  idx_t i, j, k;
+  for(i=x_begin; i<x_end; ++i)
+    for(j=0; j<NY; ++j)
+      for(k=0; k<NZ; ++k)
+      {
+        BSSNData bd = {0};
+        set_bd_values<BD_LOCAL>(i, j, k, &bd);
+        assembleSrcPt(components, sa, &bd);
+      }
+}
+
+/**
+ * @brief Call BSSN::RKEvolvePt for points in x-planes [x_begin, x_end)
+ * @details Reads the _a register (and sources) of neighboring planes, so
+ * must not run concurrently with anything modifying those. Does not rescale
+ * the metric or exchange halos.
+ */
+void BSSN::RKEvolveTile(idx_t x_begin, idx_t x_end)
+{
+  idx_t i, j, k;
+  for(i=x_begin; i<x_end; ++i)
+    for(j=0; j<NY; ++j)
+      for(k=0; k<NZ; ++k)
+      {
+        BSSNData bd = {0};
+        RKEvolvePt(i, j, k, &bd);
+      }
+}
+
+/**
+ * @brief Apply the RK4Register::K<n>Finalize update to BSSN fields in
+ * x-planes [x_begin, x_end)
+ * @details Only the _p, _c and _f registers of these points are modified;
+ * BSSN::KFinalizeComplete must be called once all points are finalized.
+ */
+void BSSN::KFinalizeTile(int n, idx_t x_begin, idx_t x_end)
+{
+  BSSN_FINALIZE_K_POINTS(n, NP_INDEX(x_begin,0,0), NP_INDEX(x_end,0,0));
+}
+
+/**
+ * @brief Complete an RK substep finalized with BSSN::KFinalizeTile: step the
+ * FRW integrator, swap registers, and compute reductions; equivalent to the
+ * remainder of BSSN::K<n>Finalize.
+ */
+void BSSN::KFinalizeComplete(int n)
+{
+  switch(n)
+  {
+    case 1: frw->P1_step(ctx->dt); break;
+    case 2: frw->P2_step(ctx->dt); break;
+    case 3: frw->P3_step(ctx->dt); break;
+    case 4: frw->RK_total_step(ctx->dt); break;
+  }
+  BSSN_SWAP_A_C;
+  setExtraFieldData();
+  halos_current = false;
+}
+
 /**
  * @brief Call Perform a full RK4 step, minus initialization.
  * @details Calls:
@@ -350,76 +643,48 @@ void BSSN::step()
 
 
 /**
- * @brief Populate values in a BSSNData struct
- * @details Compute all of them, except full metric m (TODO)
- * 
- * @param i x-index
- * @param j y-index
- * @param k z-index
- * @param bd BSSNData struct to populate
+ * @brief Zero source values in a BSSNData struct (but not source arrays)
  */
-void BSSN::set_bd_values(idx_t i, idx_t j, idx_t k, BSSNData *bd)
-{
-  bd->i = i;
-  bd->j = j;
-  bd->k = k;
-  bd->idx = NP_INDEX(i,j,k);
-
-  // need to set FRW quantities first
-  bd->phi_FRW = frw->get_phi();
-  bd->K_FRW = frw->get_K();
-  bd->rho_FRW = frw->get_rho();
-  bd->S_FRW = frw->get_S();
-
-  // average K
-  bd->K_avg = K_avg;
-  bd->avg_vol = avg_vol;
-  bd->rho_avg = rho_avg;
-
-  // draw data from cache
-  set_local_vals(bd);
-  set_gammai_values(i, j, k, bd);
-
-  // non-DIFF quantities
-  bd->phi      =   bd->DIFFphi + bd->phi_FRW;
-  bd->K        =   bd->DIFFK + bd->K_FRW;
-  bd->gamma11  =   bd->DIFFgamma11 + 1.0;
-  bd->gamma12  =   bd->DIFFgamma12;
-  bd->gamma13  =   bd->DIFFgamma13;
-  bd->gamma22  =   bd->DIFFgamma22 + 1.0;
-  bd->gamma23  =   bd->DIFFgamma23;
-  bd->gamma33  =   bd->DIFFgamma33 + 1.0;
-  bd->r        =   bd->DIFFr + bd->rho_FRW;
-  bd->S        =   bd->DIFFS + bd->S_FRW;
-  bd->alpha    =   bd->DIFFalpha + 1.0;
-
-  // pre-compute re-used quantities
-  // gammas & derivs first
-  calculate_Acont(bd);
-  calculate_dgamma(bd);
-  calculate_ddgamma(bd);
-  calculate_dalpha_dphi(bd);
-  calculate_dK(bd);
-# if USE_Z4c_DAMPING
-    calculate_dtheta(bd);
-# endif
-# if USE_BSSN_SHIFT
-    calculate_dbeta(bd);
-    calculate_dexpN(bd);
-# endif
+void BSSN::zero_bd_sources(BSSNData *bd)
+{
+  BSSN_APPLY_TO_SOURCES(BSSN_ZERO_BD_SOURCE);
+}
+
+/**
+ * @brief Assemble BSSN sources at a point and store them
+ * @details Source members of bd start from deposited values, or from zero
+ * (so source arrays need not be cleared first). Pointwise contributions of
+ * components and then constant offsets are added, STF is made trace-free if
+ * needed, and the result is stored.
+ */
+void BSSN::assembleSrcPt(std::vector<MatterComponent *> & components,
+  BSSNSrcAssembly *sa, BSSNData *bd)
+{
+  if(!sa->deposited)
+    zero_bd_sources(bd);
+
+  for(MatterComponent * component : components)
+    component->addBSSNSrcPt(this, bd);
 
-  // Christoffels depend on metric & derivs.
-  calculate_conformal_christoffels(bd);
-  // DDw depend on christoffels, metric, and derivs
-  calculateDDphi(bd);
-  calculateDDalphaTF(bd);
-  // Ricci depends on DDphi
-  calculateRicciTF(bd);
+  BSSN_APPLY_TO_SOURCES(BSSN_ADD_BD_SOURCE_OFFSET);
 
-  // Hamiltonian constraint
-  bd->H = hamiltonianConstraintCalc(bd);
+  if(sa->tracefree)
+    enforceTFSIJ(bd);
+
+  store_bd_sources(bd);
 }
 
+/**
+ * @brief Store source values in a BSSNData struct to source arrays, and
+ * update r and S in the struct (but not H, see BSSN::RKEvolve)
+ */
+void BSSN::store_bd_sources(BSSNData *bd)
+{
+  BSSN_APPLY_TO_SOURCES(BSSN_STORE_BD_SOURCE);
+
+  bd->r = bd->DIFFr + bd->rho_FRW;
+  bd->S = bd->DIFFS + bd->S_FRW;
+}
 
 /**
  * @brief Set "local values"; set BSSNData values corresponding to field
@@ -502,22 +767,30 @@ void BSSN::calculate_ddgamma(BSSNData *bd)
 void BSSN::calculate_dalpha_dphi(BSSNData *bd)
 {
   // normal derivatives of phi
-  bd->d1phi = derivative(bd->i, bd->j, bd->k, 1, DIFFphi->_array_a);
-  bd->d2phi = derivative(bd->i, bd->j, bd->k, 2, DIFFphi->_array_a);
-  bd->d3phi = derivative(bd->i, bd->j, bd->k, 3, DIFFphi->_array_a);
-
-  // second derivatives of phi
-  bd->d1d1phi = double_derivative(bd->i, bd->j, bd->k, 1, 1, DIFFphi->_array_a);
-  bd->d2d2phi = double_derivative(bd->i, bd->j, bd->k, 2, 2, DIFFphi->_array_a);
-  bd->d3d3phi = double_derivative(bd->i, bd->j, bd->k, 3, 3, DIFFphi->_array_a);
-  bd->d1d2phi = double_derivative(bd->i, bd->j, bd->k, 1, 2, DIFFphi->_array_a);
-  bd->d1d3phi = double_derivative(bd->i, bd->j, bd->k, 1, 3, DIFFphi->_array_a);
-  bd->d2d3phi = double_derivative(bd->i, bd->j, bd->k, 2, 3, DIFFphi->_array_a);
+  bd->d1phi = derivative(bd->i, bd->j, bd->k, 1, DIFFphi->_array_a, ctx->inv_dx);
+  bd->d2phi = derivative(bd->i, bd->j, bd->k, 2, DIFFphi->_array_a, ctx->inv_dx);
+  bd->d3phi = derivative(bd->i, bd->j, bd->k, 3, DIFFphi->_array_a, ctx->inv_dx);
 
   // normal derivatives of alpha
-  bd->d1a = derivative(bd->i, bd->j, bd->k, 1, DIFFalpha->_array_a);
-  bd->d2a = derivative(bd->i, bd->j, bd->k, 2, DIFFalpha->_array_a);
-  bd->d3a = derivative(bd->i, bd->j, bd->k, 3, DIFFalpha->_array_a);
+  bd->d1a = derivative(bd->i, bd->j, bd->k, 1, DIFFalpha->_array_a, ctx->inv_dx);
+  bd->d2a = derivative(bd->i, bd->j, bd->k, 2, DIFFalpha->_array_a, ctx->inv_dx);
+  bd->d3a = derivative(bd->i, bd->j, bd->k, 3, DIFFalpha->_array_a, ctx->inv_dx);
+}
+
+/**
+ * @brief Compute second partial derivatives of the conformal factor, store
+ * in a BSSNData instance
+ *
+ * @param bd BSSNData struct reference
+ */
+void BSSN::calculate_ddphi(BSSNData *bd)
+{
+  bd->d1d1phi = double_derivative(bd->i, bd->j, bd->k, 1, 1, DIFFphi->_array_a, ctx->inv_dx);
+  bd->d2d2phi = double_derivative(bd->i, bd->j, bd->k, 2, 2, DIFFphi->_array_a, ctx->inv_dx);
+  bd->d3d3phi = double_derivative(bd->i, bd->j, bd->k, 3, 3, DIFFphi->_array_a, ctx->inv_dx);
+  bd->d1d2phi = double_derivative(bd->i, bd->j, bd->k, 1, 2, DIFFphi->_array_a, ctx->inv_dx);
+  bd->d1d3phi = double_derivative(bd->i, bd->j, bd->k, 1, 3, DIFFphi->_array_a, ctx->inv_dx);
+  bd->d2d3phi = double_derivative(bd->i, bd->j, bd->k, 2, 3, DIFFphi->_array_a, ctx->inv_dx);
 }
 
 /**
@@ -529,39 +802,39 @@ void BSSN::calculate_dalpha_dphi(BSSNData *bd)
 void BSSN::calculate_dK(BSSNData *bd)
 {
   // normal derivatives of K
-  bd->d1K = derivative(bd->i, bd->j, bd->k, 1, DIFFK->_array_a);
-  bd->d2K = derivative(bd->i, bd->j, bd->k, 2, DIFFK->_array_a);
-  bd->d3K = derivative(bd->i, bd->j, bd->k, 3, DIFFK->_array_a);
+  bd->d1K = derivative(bd->i, bd->j, bd->k, 1, DIFFK->_array_a, ctx->inv_dx);
+  bd->d2K = derivative(bd->i, bd->j, bd->k, 2, DIFFK->_array_a, ctx->inv_dx);
+  bd->d3K = derivative(bd->i, bd->j, bd->k, 3, DIFFK->_array_a, ctx->inv_dx);
 }
 
 #if USE_Z4c_DAMPING
 void BSSN::calculate_dtheta(BSSNData *bd)
 {
   // normal derivatives of phi
-  bd->d1theta = derivative(bd->i, bd->j, bd->k, 1, theta->_array_a);
-  bd->d2theta = derivative(bd->i, bd->j, bd->k, 2, theta->_array_a);
-  bd->d3theta = derivative(bd->i, bd->j, bd->k, 3, theta->_array_a);
+  bd->d1theta = derivative(bd->i, bd->j, bd->k, 1, theta->_array_a, ctx->inv_dx);
+  bd->d2theta = derivative(bd->i, bd->j, bd->k, 2, theta->_array_a, ctx->inv_dx);
+  bd->d3theta = derivative(bd->i, bd->j, bd->k, 3, theta->_array_a, ctx->inv_dx);
 }
 #endif
 
 #if USE_BSSN_SHIFT
 void BSSN::calculate_dbeta(BSSNData *bd)
 {
-  bd->d1beta1 = derivative(bd->i, bd->j, bd->k, 1, beta1->_array_a);
-  bd->d1beta2 = derivative(bd->i, bd->j, bd->k, 1, beta2->_array_a);
-  bd->d1beta3 = derivative(bd->i, bd->j, bd->k, 1, beta3->_array_a);
-  bd->d2beta1 = derivative(bd->i, bd->j, bd->k, 2, beta1->_array_a);
-  bd->d2beta2 = derivative(bd->i, bd->j, bd->k, 2, beta2->_array_a);
-  bd->d2beta3 = derivative(bd->i, bd->j, bd->k, 2, beta3->_array_a);
-  bd->d3beta1 = derivative(bd->i, bd->j, bd->k, 3, beta1->_array_a);
-  bd->d3beta2 = derivative(bd->i, bd->j, bd->k, 3, beta2->_array_a);
-  bd->d3beta3 = derivative(bd->i, bd->j, bd->k, 3, beta3->_array_a);
+  bd->d1beta1 = derivative(bd->i, bd->j, bd->k, 1, beta1->_array_a, ctx->inv_dx);
+  bd->d1beta2 = derivative(bd->i, bd->j, bd->k, 1, beta2->_array_a, ctx->inv_dx);
+  bd->d1beta3 = derivative(bd->i, bd->j, bd->k, 1, beta3->_array_a, ctx->inv_dx);
+  bd->d2beta1 = derivative(bd->i, bd->j, bd->k, 2, beta1->_array_a, ctx->inv_dx);
+  bd->d2beta2 = derivative(bd->i, bd->j, bd->k, 2, beta2->_array_a, ctx->inv_dx);
+  bd->d2beta3 = derivative(bd->i, bd->j, bd->k, 2, beta3->_array_a, ctx->inv_dx);
+  bd->d3beta1 = derivative(bd->i, bd->j, bd->k, 3, beta1->_array_a, ctx->inv_dx);
+  bd->d3beta2 = derivative(bd->i, bd->j, bd->k, 3, beta2->_array_a, ctx->inv_dx);
+  bd->d3beta3 = derivative(bd->i, bd->j, bd->k, 3, beta3->_array_a, ctx->inv_dx);
 }
 void BSSN::calculate_dexpN(BSSNData *bd)
 {
-  bd->d1expN = derivative(bd->i, bd->j, bd->k, 1, expN->_array_a);
-  bd->d2expN = derivative(bd->i, bd->j, bd->k, 2, expN->_array_a);
-  bd->d3expN = derivative(bd->i, bd->j, bd->k, 3, expN->_array_a);
+  bd->d1expN = derivative(bd->i, bd->j, bd->k, 1, expN->_array_a, ctx->inv_dx);
+  bd->d2expN = derivative(bd->i, bd->j, bd->k, 2, expN->_array_a, ctx->inv_dx);
+  bd->d3expN = derivative(bd->i, bd->j, bd->k, 3, expN->_array_a, ctx->inv_dx);
 }
 #endif
 
@@ -675,20 +948,17 @@ void BSSN::calculateRicciTF(BSSNData *bd)
 
 void BSSN::enforceTFSIJ(BSSNData *bd)
 {
-  idx_t idx = bd->idx;
   real_t trS = exp(-4.0*bd->phi)*(
-      STF11_a[idx]*bd->gammai11 + STF22_a[idx]*bd->gammai22 + STF33_a[idx]*bd->gammai33
-      + 2.0*(STF12_a[idx]*bd->gammai12 + STF13_a[idx]*bd->gammai13 + STF23_a[idx]*bd->gammai23)
+      bd->STF11*bd->gammai11 + bd->STF22*bd->gammai22 + bd->STF33*bd->gammai33
+      + 2.0*(bd->STF12*bd->gammai12 + bd->STF13*bd->gammai13 + bd->STF23*bd->gammai23)
     );
 
-  STF11_a[idx] -= (1.0/3.0)*exp(4.0*bd->phi)*bd->gamma11*trS;
-  STF12_a[idx] -= (1.0/3.0)*exp(4.0*bd->phi)*bd->gamma12*trS;
-  STF13_a[idx] -= (1.0/3.0)*exp(4.0*bd->phi)*bd->gamma13*trS;
-  STF22_a[idx] -= (1.0/3.0)*exp(4.0*bd->phi)*bd->gamma22*trS;
-  STF23_a[idx] -= (1.0/3.0)*exp(4.0*bd->phi)*bd->gamma23*trS;
-  STF33_a[idx] -= (1.0/3.0)*exp(4.0*bd->phi)*bd->gamma33*trS;
-
-  BSSN_APPLY_TO_SOURCES(GEN1_SET_LOCAL_VALUES);
+  bd->STF11 -= (1.0/3.0)*exp(4.0*bd->phi)*bd->gamma11*trS;
+  bd->STF12 -= (1.0/3.0)*exp(4.0*bd->phi)*bd->gamma12*trS;
+  bd->STF13 -= (1.0/3.0)*exp(4.0*bd->phi)*bd->gamma13*trS;
+  bd->STF22 -= (1.0/3.0)*exp(4.0*bd->phi)*bd->gamma22*trS;
+  bd->STF23 -= (1.0/3.0)*exp(4.0*bd->phi)*bd->gamma23*trS;
+  bd->STF33 -= (1.0/3.0)*exp(4.0*bd->phi)*bd->gamma33*trS;
 }
 
 
@@ -745,23 +1015,23 @@ Evolution equation calculations
 ******************************************************************************
 */
 
-real_t BSSN::ev_DIFFgamma11(BSSNData *bd) { return BSSN_DT_DIFFGAMMAIJ(1, 1) + 0.5*a_adj_amp*dt*bd->H*bd->DIFFgamma11 - KO_dissipation_Q(bd->i, bd->j, bd->k, DIFFgamma11->_array_a, KO_damping_coefficient); }
-real_t BSSN::ev_DIFFgamma12(BSSNData *bd) { return BSSN_DT_DIFFGAMMAIJ(1, 2) + 0.5*a_adj_amp*dt*bd->H*bd->DIFFgamma12 - KO_dissipation_Q(bd->i, bd->j, bd->k, DIFFgamma12->_array_a, KO_damping_coefficient); }
-real_t BSSN::ev_DIFFgamma13(BSSNData *bd) { return BSSN_DT_DIFFGAMMAIJ(1, 3) + 0.5*a_adj_amp*dt*bd->H*bd->DIFFgamma13 - KO_dissipation_Q(bd->i, bd->j, bd->k, DIFFgamma13->_array_a, KO_damping_coefficient); }
-real_t BSSN::ev_DIFFgamma22(BSSNData *bd) { return BSSN_DT_DIFFGAMMAIJ(2, 2) + 0.5*a_adj_amp*dt*bd->H*bd->DIFFgamma22 - KO_dissipation_Q(bd->i, bd->j, bd->k, DIFFgamma22->_array_a, KO_damping_coefficient); }
-real_t BSSN::ev_DIFFgamma23(BSSNData *bd) { return BSSN_DT_DIFFGAMMAIJ(2, 3) + 0.5*a_adj_amp*dt*bd->H*bd->DIFFgamma23 - KO_dissipation_Q(bd->i, bd->j, bd->k, DIFFgamma23->_array_a, KO_damping_coefficient); }
-real_t BSSN::ev_DIFFgamma33(BSSNData *bd) { return BSSN_DT_DIFFGAMMAIJ(3, 3) + 0.5*a_adj_amp*dt*bd->H*bd->DIFFgamma33 - KO_dissipation_Q(bd->i, bd->j, bd->k, DIFFgamma33->_array_a, KO_damping_coefficient); }
+real_t BSSN::ev_DIFFgamma11(BSSNData *bd) { return BSSN_DT_DIFFGAMMAIJ(1, 1) + 0.5*a_adj_amp*ctx->dt*bd->H*bd->DIFFgamma11 - KO_dissipation_Q(bd->i, bd->j, bd->k, DIFFgamma11->_array_a, KO_damping_coefficient, ctx->inv_dx); }
+real_t BSSN::ev_DIFFgamma12(BSSNData *bd) { return BSSN_DT_DIFFGAMMAIJ(1, 2) + 0.5*a_adj_amp*ctx->dt*bd->H*bd->DIFFgamma12 - KO_dissipation_Q(bd->i, bd->j, bd->k, DIFFgamma12->_array_a, KO_damping_coefficient, ctx->inv_dx); }
+real_t BSSN::ev_DIFFgamma13(BSSNData *bd) { return BSSN_DT_DIFFGAMMAIJ(1, 3) + 0.5*a_adj_amp*ctx->dt*bd->H*bd->DIFFgamma13 - KO_dissipation_Q(bd->i, bd->j, bd->k, DIFFgamma13->_array_a, KO_damping_coefficient, ctx->inv_dx); }
+real_t BSSN::ev_DIFFgamma22(BSSNData *bd) { return BSSN_DT_DIFFGAMMAIJ(2, 2) + 0.5*a_adj_amp*ctx->dt*bd->H*bd->DIFFgamma22 - KO_dissipation_Q(bd->i, bd->j, bd->k, DIFFgamma22->_array_a, KO_damping_coefficient, ctx->inv_dx); }
+real_t BSSN::ev_DIFFgamma23(BSSNData *bd) { return BSSN_DT_DIFFGAMMAIJ(2, 3) + 0.5*a_adj_amp*ctx->dt*bd->H*bd->DIFFgamma23 - KO_dissipation_Q(bd->i, bd->j, bd->k, DIFFgamma23->_array_a, KO_damping_coefficient, ctx->inv_dx); }
+real_t BSSN::ev_DIFFgamma33(BSSNData *bd) { return BSSN_DT_DIFFGAMMAIJ(3, 3) + 0.5*a_adj_amp*ctx->dt*bd->H*bd->DIFFgamma33 - KO_dissipation_Q(bd->i, bd->j, bd->k, DIFFgamma33->_array_a, KO_damping_coefficient, ctx->inv_dx); }
 
-real_t BSSN::ev_A11(BSSNData *bd) { return BSSN_DT_AIJ(1, 1) - 1.0*a_adj_amp*dt*bd->A11*bd->H - KO_dissipation_Q(bd->i, bd->j, bd->k, A11->_array_a, KO_damping_coefficient); }
-real_t BSSN::ev_A12(BSSNData *bd) { return BSSN_DT_AIJ(1, 2) - 1.0*a_adj_amp*dt*bd->A12*bd->H - KO_dissipation_Q(bd->i, bd->j, bd->k, A12->_array_a, KO_damping_coefficient); }
-real_t BSSN::ev_A13(BSSNData *bd) { return BSSN_DT_AIJ(1, 3) - 1.0*a_adj_amp*dt*bd->A13*bd->H - KO_dissipation_Q(bd->i, bd->j, bd->k, A13->_array_a, KO_damping_coefficient); }
-real_t BSSN::ev_A22(BSSNData *bd) { return BSSN_DT_AIJ(2, 2) - 1.0*a_adj_amp*dt*bd->A22*bd->H - KO_dissipation_Q(bd->i, bd->j, bd->k, A22->_array_a, KO_damping_coefficient); }
-real_t BSSN::ev_A23(BSSNData *bd) { return BSSN_DT_AIJ(2, 3) - 1.0*a_adj_amp*dt*bd->A23*bd->H - KO_dissipation_Q(bd->i, bd->j, bd->k, A23->_array_a, KO_damping_coefficient); }
-real_t BSSN::ev_A33(BSSNData *bd) { return BSSN_DT_AIJ(3, 3) - 1.0*a_adj_amp*dt*bd->A33*bd->H - KO_dissipation_Q(bd->i, bd->j, bd->k, A33->_array_a, KO_damping_coefficient); }
+real_t BSSN::ev_A11(BSSNData *bd) { return BSSN_DT_AIJ(1, 1) - 1.0*a_adj_amp*ctx->dt*bd->A11*bd->H - KO_dissipation_Q(bd->i, bd->j, bd->k, A11->_array_a, KO_damping_coefficient, ctx->inv_dx); }
+real_t BSSN::ev_A12(BSSNData *bd) { return BSSN_DT_AIJ(1, 2) - 1.0*a_adj_amp*ctx->dt*bd->A12*bd->H - KO_dissipation_Q(bd->i, bd->j, bd->k, A12->_array_a, KO_damping_coefficient, ctx->inv_dx); }
+real_t BSSN::ev_A13(BSSNData *bd) { return BSSN_DT_AIJ(1, 3) - 1.0*a_adj_amp*ctx->dt*bd->A13*bd->H - KO_dissipation_Q(bd->i, bd->j, bd->k, A13->_array_a, KO_damping_coefficient, ctx->inv_dx); }
+real_t BSSN::ev_A22(BSSNData *bd) { return BSSN_DT_AIJ(2, 2) - 1.0*a_adj_amp*ctx->dt*bd->A22*bd->H - KO_dissipation_Q(bd->i, bd->j, bd->k, A22->_array_a, KO_damping_coefficient, ctx->inv_dx); }
+real_t BSSN::ev_A23(BSSNData *bd) { return BSSN_DT_AIJ(2, 3) - 1.0*a_adj_amp*ctx->dt*bd->A23*bd->H - KO_dissipation_Q(bd->i, bd->j, bd->k, A23->_array_a, KO_damping_coefficient, ctx->inv_dx); }
+real_t BSSN::ev_A33(BSSNData *bd) { return BSSN_DT_AIJ(3, 3) - 1.0*a_adj_amp*ctx->dt*bd->A33*bd->H - KO_dissipation_Q(bd->i, bd->j, bd->k, A33->_array_a, KO_damping_coefficient, ctx->inv_dx); }
 
-real_t BSSN::ev_Gamma1(BSSNData *bd) { return BSSN_DT_GAMMAI(1) - KO_dissipation_Q(bd->i, bd->j, bd->k, Gamma1->_array_a, KO_damping_coefficient); }
-real_t BSSN::ev_Gamma2(BSSNData *bd) { return BSSN_DT_GAMMAI(2) - KO_dissipation_Q(bd->i, bd->j, bd->k, Gamma2->_array_a, KO_damping_coefficient); }
-real_t BSSN::ev_Gamma3(BSSNData *bd) { return BSSN_DT_GAMMAI(3) - KO_dissipation_Q(bd->i, bd->j, bd->k, Gamma3->_array_a, KO_damping_coefficient); }
+real_t BSSN::ev_Gamma1(BSSNData *bd) { return BSSN_DT_GAMMAI(1) - KO_dissipation_Q(bd->i, bd->j, bd->k, Gamma1->_array_a, KO_damping_coefficient, ctx->inv_dx); }
+real_t BSSN::ev_Gamma2(BSSNData *bd) { return BSSN_DT_GAMMAI(2) - KO_dissipation_Q(bd->i, bd->j, bd->k, Gamma2->_array_a, KO_damping_coefficient, ctx->inv_dx); }
+real_t BSSN::ev_Gamma3(BSSNData *bd) { return BSSN_DT_GAMMAI(3) - KO_dissipation_Q(bd->i, bd->j, bd->k, Gamma3->_array_a, KO_damping_coefficient, ctx->inv_dx); }
 
 real_t BSSN::ev_DIFFK(BSSNData *bd)
 {
@@ -784,13 +1054,13 @@ real_t BSSN::ev_DIFFK(BSSNData *bd)
     + 4.0*PI*bd->alpha*(bd->DIFFr + bd->DIFFS)
     + 4.0*PI*bd->DIFFalpha*(bd->rho_FRW + bd->S_FRW)
 #if USE_BSSN_SHIFT
-    + upwind_derivative(bd->i, bd->j, bd->k, 1, DIFFK->_array_a,  bd->beta1)
-    + upwind_derivative(bd->i, bd->j, bd->k, 2, DIFFK->_array_a,  bd->beta2)
-    + upwind_derivative(bd->i, bd->j, bd->k, 3, DIFFK->_array_a,  bd->beta3)
+    + upwind_derivative(bd->i, bd->j, bd->k, 1, DIFFK->_array_a,  bd->beta1, ctx->inv_dx)
+    + upwind_derivative(bd->i, bd->j, bd->k, 2, DIFFK->_array_a,  bd->beta2, ctx->inv_dx)
+    + upwind_derivative(bd->i, bd->j, bd->k, 3, DIFFK->_array_a,  bd->beta3, ctx->inv_dx)
 #endif
     - 1.0*k_damping_amp*bd->H*exp(-5.0*bd->phi)
     + Z4c_K1_DAMPING_AMPLITUDE*(1.0 - Z4c_K2_DAMPING_AMPLITUDE)*bd->theta
-    - KO_dissipation_Q(bd->i, bd->j, bd->k, DIFFK->_array_a, KO_damping_coefficient)
+    - KO_dissipation_Q(bd->i, bd->j, bd->k, DIFFK->_array_a, KO_damping_coefficient, ctx->inv_dx)
   );
 }
 
@@ -804,18 +1074,18 @@ real_t BSSN::ev_DIFFphi(BSSNData *bd)
 #endif
 
   return (
-    0.1*a_adj_amp*dt*bd->H
+    0.1*a_adj_amp*ctx->dt*bd->H
     -1.0/6.0*(
       bd->alpha*(bd->DIFFK + 2.0*bd->theta)
       + bd->DIFFalpha*bd->K_FRW
       - ( bd->d1beta1 + bd->d2beta2 + bd->d3beta3 )
     )
 #if USE_BSSN_SHIFT
-    + upwind_derivative(bd->i, bd->j, bd->k, 1, DIFFphi->_array_a,  bd->beta1)
-    + upwind_derivative(bd->i, bd->j, bd->k, 2, DIFFphi->_array_a,  bd->beta2)
-    + upwind_derivative(bd->i, bd->j, bd->k, 3, DIFFphi->_array_a,  bd->beta3)
+    + upwind_derivative(bd->i, bd->j, bd->k, 1, DIFFphi->_array_a,  bd->beta1, ctx->inv_dx)
+    + upwind_derivative(bd->i, bd->j, bd->k, 2, DIFFphi->_array_a,  bd->beta2, ctx->inv_dx)
+    + upwind_derivative(bd->i, bd->j, bd->k, 3, DIFFphi->_array_a,  bd->beta3, ctx->inv_dx)
 #endif
-    - KO_dissipation_Q(bd->i, bd->j, bd->k, DIFFphi->_array_a, KO_damping_coefficient)
+    - KO_dissipation_Q(bd->i, bd->j, bd->k, DIFFphi->_array_a, KO_damping_coefficient, ctx->inv_dx)
   );
 }
 
@@ -823,11 +1093,11 @@ real_t BSSN::ev_DIFFalpha(BSSNData *bd)
 {
   return gaugeHandler->ev_lapse(bd)
 #if USE_BSSN_SHIFT
-    + upwind_derivative(bd->i, bd->j, bd->k, 1, DIFFalpha->_array_a, bd->beta1)
-    + upwind_derivative(bd->i, bd->j, bd->k, 2, DIFFalpha->_array_a, bd->beta2)
-    + upwind_derivative(bd->i, bd->j, bd->k, 3, DIFFalpha->_array_a, bd->beta3)
+    + upwind_derivative(bd->i, bd->j, bd->k, 1, DIFFalpha->_array_a, bd->beta1, ctx->inv_dx)
+    + upwind_derivative(bd->i, bd->j, bd->k, 2, DIFFalpha->_array_a, bd->beta2, ctx->inv_dx)
+    + upwind_derivative(bd->i, bd->j, bd->k, 3, DIFFalpha->_array_a, bd->beta3, ctx->inv_dx)
 #endif
-    - KO_dissipation_Q(bd->i, bd->j, bd->k, DIFFalpha->_array_a, KO_damping_coefficient);
+    - KO_dissipation_Q(bd->i, bd->j, bd->k, DIFFalpha->_array_a, KO_damping_coefficient, ctx->inv_dx);
 }
 
 #if USE_Z4c_DAMPING
@@ -840,12 +1110,12 @@ real_t BSSN::ev_theta(BSSNData *bd)
     - bd->alpha*Z4c_K1_DAMPING_AMPLITUDE*(2.0 + Z4c_K2_DAMPING_AMPLITUDE)*bd->theta
     //    + bd->beta1*bd->d1theta + bd->beta2*bd->d2theta + bd->beta2*bd->d2theta
 #if USE_BSSN_SHIFT
-    + upwind_derivative(bd->i, bd->j, bd->k, 1, theta->_array_a, bd->beta1)
-    + upwind_derivative(bd->i, bd->j, bd->k, 2, theta->_array_a, bd->beta2)
-    + upwind_derivative(bd->i, bd->j, bd->k, 3, theta->_array_a, bd->beta3)
+    + upwind_derivative(bd->i, bd->j, bd->k, 1, theta->_array_a, bd->beta1, ctx->inv_dx)
+    + upwind_derivative(bd->i, bd->j, bd->k, 2, theta->_array_a, bd->beta2, ctx->inv_dx)
+    + upwind_derivative(bd->i, bd->j, bd->k, 3, theta->_array_a, bd->beta3, ctx->inv_dx)
 #endif
 
-  ) - KO_dissipation_Q(bd->i, bd->j, bd->k, theta->_array_a, KO_damping_coefficient);
+  ) - KO_dissipation_Q(bd->i, bd->j, bd->k, theta->_array_a, KO_damping_coefficient, ctx->inv_dx);
 }
 #endif
 
@@ -853,19 +1123,19 @@ real_t BSSN::ev_theta(BSSNData *bd)
 real_t BSSN::ev_beta1(BSSNData *bd)
 {
   return gaugeHandler->ev_shift1(bd)
-    - KO_dissipation_Q(bd->i, bd->j, bd->k, beta1->_array_a, KO_damping_coefficient);
+    - KO_dissipation_Q(bd->i, bd->j, bd->k, beta1->_array_a, KO_damping_coefficient, ctx->inv_dx);
 }
 
 real_t BSSN::ev_beta2(BSSNData *bd)
 {
   return gaugeHandler->ev_shift2(bd)
-    - KO_dissipation_Q(bd->i, bd->j, bd->k, beta2->_array_a, KO_damping_coefficient);
+    - KO_dissipation_Q(bd->i, bd->j, bd->k, beta2->_array_a, KO_damping_coefficient, ctx->inv_dx);
 }
 
 real_t BSSN::ev_beta3(BSSNData *bd)
 {
   return gaugeHandler->ev_shift3(bd)
-    - KO_dissipation_Q(bd->i, bd->j, bd->k, beta3->_array_a, KO_damping_coefficient);
+    - KO_dissipation_Q(bd->i, bd->j, bd->k, beta3->_array_a, KO_damping_coefficient, ctx->inv_dx);
 }
 
 real_t BSSN::ev_expN(BSSNData *bd)
@@ -903,6 +1173,8 @@ Constraint violtion calculations
 void BSSN::set1DConstraintOutput(
   real_t H_values[], real_t M_values[], int axis, idx_t n1, idx_t n2)
 {
+  exchangeHalos();
+
   switch (axis)
   {
   case 1:
@@ -973,10 +1245,12 @@ void BSSN::setConstraintCalcs(real_t H_values[8], real_t M_values[8],
   BSSN_INITIALIZE_CONSTRAINT_STAT_VARS(S);
   real_t H_L2 = 0, M_L2 = 0;
 
+  exchangeHalos();
+
 # pragma omp parallel for default(shared) private(i, j, k) reduction(+:mean_H,\
 mean_H_scale,mean_H_scaled,mean_M,mean_M_scale,mean_M_scaled,mean_G,mean_G_scale,\
 mean_G_scaled,mean_A,mean_A_scale,mean_A_scaled,mean_S,mean_S_scale,mean_S_scaled,H_L2,M_L2)
-  LOOP3(i,j,k)
+  OWNED_LOOP3(i,j,k)
   {
     // populate BSSNData struct
     BSSNData bd = {0};
@@ -986,12 +1260,12 @@ mean_G_scaled,mean_A,mean_A_scale,mean_A_scaled,mean_S,mean_S_scale,mean_S_scale
     BSSN_COMPUTE_CONSTRAINT_STAT_VARS(H, hamiltonianConstraintCalc, hamiltonianConstraintScale);
     BSSN_COMPUTE_CONSTRAINT_MEAN_VARS(H);
 
-    H_L2 += H_val * H_val * dx * dx * dx;
+    H_L2 += H_val * H_val * ctx->dx * ctx->dx * ctx->dx;
     // momentum constraint calculations
     BSSN_COMPUTE_CONSTRAINT_STAT_VARS_VEC(M, momentumConstraintCalc, momentumConstraintScale);
     BSSN_COMPUTE_CONSTRAINT_MEAN_VARS(M);
 
-    M_L2 += M_val * M_val * dx * dx * dx;
+    M_L2 += M_val * M_val * ctx->dx * ctx->dx * ctx->dx;
     
     // Christoffel constraint calculations
     BSSN_COMPUTE_CONSTRAINT_STAT_VARS_VEC(G, christoffelConstraintCalc, christoffelConstraintScale);
@@ -1015,6 +1289,14 @@ mean_G_scaled,mean_A,mean_A_scale,mean_A_scaled,mean_S,mean_S_scale,mean_S_scale
       BSSN_COMPUTE_CONSTRAINT_MAXES(S);
     }
   }
+  BSSN_REDUCE_CONSTRAINT_MEAN_VARS(H);
+  BSSN_REDUCE_CONSTRAINT_MEAN_VARS(M);
+  BSSN_REDUCE_CONSTRAINT_MEAN_VARS(G);
+  BSSN_REDUCE_CONSTRAINT_MEAN_VARS(A);
+  BSSN_REDUCE_CONSTRAINT_MEAN_VARS(S);
+  H_L2 = decomposition_sum(H_L2);
+  M_L2 = decomposition_sum(M_L2);
+
   // total -> mean
   BSSN_NORMALIZE_MEAN(H);
   BSSN_NORMALIZE_MEAN(M);
@@ -1026,7 +1308,7 @@ mean_G_scaled,mean_A,mean_A_scale,mean_A_scaled,mean_S,mean_S_scale,mean_S_scale
 # pragma omp parallel for default(shared) private(i, j, k) reduction(+:stdev_H,\
 stdev_H_scaled,stdev_M,stdev_M_scaled,stdev_G,stdev_G_scaled,stdev_A,\
 stdev_A_scaled,stdev_S,stdev_S_scaled)
-  LOOP3(i,j,k)
+  OWNED_LOOP3(i,j,k)
   {
     // populate BSSNData struct
     BSSNData bd = {0};
@@ -1052,6 +1334,11 @@ stdev_A_scaled,stdev_S,stdev_S_scaled)
     BSSN_COMPUTE_CONSTRAINT_STAT_VARS(S, unitDetConstraintCalc, unitDetConstraintScale);
     BSSN_COMPUTE_CONSTRAINT_STDEV_VARS(S);
   }
+  BSSN_REDUCE_CONSTRAINT_STDEV_VARS(H);
+  BSSN_REDUCE_CONSTRAINT_STDEV_VARS(M);
+  BSSN_REDUCE_CONSTRAINT_STDEV_VARS(G);
+  BSSN_REDUCE_CONSTRAINT_STDEV_VARS(A);
+  BSSN_REDUCE_CONSTRAINT_STDEV_VARS(S);
   BSSN_NORMALIZE_STDEV(H);
   BSSN_NORMALIZE_STDEV(M);
   BSSN_NORMALIZE_STDEV(G);
@@ -1242,9 +1529,9 @@ void BSSN::setRaytraceCornerPrimitives(RayTrace<real_t, idx_t> *rt)
 
   struct RaytracePrimitives<real_t> corner_rp[2][2][2];
 
-  idx_t x_idx = rt->getRayIDX(1, dx, NX);
-  idx_t y_idx = rt->getRayIDX(2, dx, NY);
-  idx_t z_idx = rt->getRayIDX(3, dx, NZ);
+  idx_t x_idx = rt->getRayIDX(1, ctx->dx, NX);
+  idx_t y_idx = rt->getRayIDX(2, ctx->dx, NY);
+  idx_t z_idx = rt->getRayIDX(3, ctx->dx, NZ);
 
   set_bd_values(x_idx, y_idx, z_idx, &bd);
   corner_rp[0][0][0] = getRaytraceData(&bd);
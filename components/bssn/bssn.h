@@ -9,7 +9,7 @@
 #include "../../utils/Array.h"
 #include "../../utils/FRW.h"
 #include "../../utils/Fourier.h"
-#include "../../utils/ConfigParser.h"
+#include "../../utils/SimContext.h"
 
 #if USE_COSMOTRACE
 #include "../cosmotrace/raytrace.h"
@@ -18,6 +18,17 @@
 namespace cosmo
 {
 
+class MatterComponent; // forward declaration, see MatterComponent.h
+
+/**
+ * @brief State of BSSN source assembly during a substep, see BSSN::prepareSrc
+ */
+typedef struct {
+  bool deposited; ///< source arrays hold deposited contributions (otherwise they are overwritten)
+  bool tracefree; ///< make STF trace-free after all contributions are added
+  BSSNData offset; ///< source contributions that are the same at every point
+} BSSNSrcAssembly;
+
 /**
  * @brief BSSN Class: evolves BSSN metric fields, computes derived quantities
  */
@@ -36,9 +47,17 @@ class BSSN
   real_t rescale_metric;
   int normalize_metric; ///< Normalize A_ij and \gamma_ij? Default: 1 (true)
 
+  std::vector<arr_t *> halo_fields; ///< _a registers exchanged between MPI processes
+  bool halos_current; ///< whether halos of halo_fields hold neighbor data
+
+  std::vector<register_t *> step_fields; ///< evolved fields, see BSSN::storeStepStart
+  std::vector<arr_t *> step_start; ///< step_fields at the start of a step (allocated when used)
+  FRW<real_t> * frw_start; ///< reference FRW integrator at the start of a step
+
   Fourier * fourier;
   
 public:
+  SimContext * ctx; ///< context of the simulation
   BSSNGaugeHandler * gaugeHandler;
   map_t fields; ///< Public map from names to internal arrays
 
@@ -50,7 +69,7 @@ public:
 
   real_t cur_t;
 
-  BSSN(ConfigParser * config, Fourier * fourier_in);
+  BSSN(SimContext * ctx_in, Fourier * fourier_in);
   ~BSSN();
 
   void init();
@@ -61,19 +80,43 @@ public:
   /* RK integrator functions */
     void setExtraFieldData();
     void stepInit();
+    void exchangeHalos();
+    void addStaleHaloFields(std::vector<arr_t *> & fields);
     void RKEvolve();
+    void RKEvolve(std::vector<MatterComponent *> & components,
+      std::vector<MatterComponent *> & sources, bool set_sources);
     void RKEvolvePt(idx_t i, idx_t j, idx_t k, BSSNData * bd);
+    void RKEvolvePt(BSSNData * bd);
     void K1Finalize();
     void K2Finalize();
     void K3Finalize();
     void K4Finalize();
     void clearSrc();
+    void prepareSrc(std::vector<MatterComponent *> & components, BSSNSrcAssembly *sa);
+    void setSrc(std::vector<MatterComponent *> & components);
+    void setSrc(std::vector<MatterComponent *> & components, BSSNSrcAssembly *sa,
+      idx_t x_begin, idx_t x_end);
     void step();
 
+  /* tile-based (x-range) variants for use within tasks; see DustSim */
+    void RKEvolveTile(idx_t x_begin, idx_t x_end);
+    void KFinalizeTile(int n, idx_t x_begin, idx_t x_end);
+    void KFinalizeComplete(int n);
+
     void scaleMetricPerturbations(real_t multiplier);
 
+  /* multirate integration, see MatterDriver */
+    void storeStepStart();
+    void setInterpolatedMetric(real_t theta);
+    void RKEvolveMatter(std::vector<MatterComponent *> & components);
+
   /* calculating quantities during an RK step */
+    template<int profile = BD_FULL>
     void set_bd_values(idx_t i, idx_t j, idx_t k, BSSNData *bd);
+    void zero_bd_sources(BSSNData *bd);
+    void store_bd_sources(BSSNData *bd);
+    void assembleSrcPt(std::vector<MatterComponent *> & components,
+      BSSNSrcAssembly *sa, BSSNData *bd);
 
     /* set current local field values */
       void set_local_vals(BSSNData *bd);
@@ -85,6 +128,7 @@ public:
       void calculate_dgamma(BSSNData *bd);
       void calculate_ddgamma(BSSNData *bd);
       void calculate_dalpha_dphi(BSSNData *bd);
+      void calculate_ddphi(BSSNData *bd);
       void calculate_dK(BSSNData *bd);
 #     if USE_Z4c_DAMPING
         void calculate_dtheta(BSSNData *bd);
@@ -177,6 +221,95 @@ public:
 
 };
 
+/**
+ * @brief Populate values in a BSSNData struct
+ * @details Compute the members in a BSSNDataProfile (by default, all of
+ * them except full metric m (TODO)); ricci_a and AijAij_a are only stored
+ * if BD_RICCI or BD_ACONT are computed.
+ *
+ * @tparam profile BSSNDataProfile flags for the members needed
+ * @param i x-index
+ * @param j y-index
+ * @param k z-index
+ * @param bd BSSNData struct to populate
+ */
+template<int profile>
+void BSSN::set_bd_values(idx_t i, idx_t j, idx_t k, BSSNData *bd)
+{
+  const bool hamiltonian = profile & BD_HAMILTONIAN;
+  const bool ricci = hamiltonian || (profile & BD_RICCI);
+  const bool acont = hamiltonian || (profile & BD_ACONT);
+  const bool derivs = ricci || (profile & BD_DERIVS);
+
+  bd->i = i;
+  bd->j = j;
+  bd->k = k;
+  bd->idx = NP_INDEX(i,j,k);
+
+  // need to set FRW quantities first
+  bd->phi_FRW = frw->get_phi();
+  bd->K_FRW = frw->get_K();
+  bd->rho_FRW = frw->get_rho();
+  bd->S_FRW = frw->get_S();
+
+  // average K
+  bd->K_avg = K_avg;
+  bd->avg_vol = avg_vol;
+  bd->rho_avg = rho_avg;
+
+  // draw data from cache
+  set_local_vals(bd);
+  set_gammai_values(i, j, k, bd);
+
+  // non-DIFF quantities
+  bd->phi      =   bd->DIFFphi + bd->phi_FRW;
+  bd->K        =   bd->DIFFK + bd->K_FRW;
+  bd->gamma11  =   bd->DIFFgamma11 + 1.0;
+  bd->gamma12  =   bd->DIFFgamma12;
+  bd->gamma13  =   bd->DIFFgamma13;
+  bd->gamma22  =   bd->DIFFgamma22 + 1.0;
+  bd->gamma23  =   bd->DIFFgamma23;
+  bd->gamma33  =   bd->DIFFgamma33 + 1.0;
+  bd->r        =   bd->DIFFr + bd->rho_FRW;
+  bd->S        =   bd->DIFFS + bd->S_FRW;
+  bd->alpha    =   bd->DIFFalpha + 1.0;
+
+  // pre-compute re-used quantities
+  // gammas & derivs first
+  if(acont)
+    calculate_Acont(bd);
+  if(derivs)
+  {
+    calculate_dgamma(bd);
+    calculate_dalpha_dphi(bd);
+    calculate_dK(bd);
+#   if USE_Z4c_DAMPING
+      calculate_dtheta(bd);
+#   endif
+#   if USE_BSSN_SHIFT
+      calculate_dbeta(bd);
+      calculate_dexpN(bd);
+#   endif
+  }
+
+  if(ricci)
+  {
+    calculate_ddgamma(bd);
+    calculate_ddphi(bd);
+    // Christoffels depend on metric & derivs.
+    calculate_conformal_christoffels(bd);
+    // DDw depend on christoffels, metric, and derivs
+    calculateDDphi(bd);
+    calculateDDalphaTF(bd);
+    // Ricci depends on DDphi
+    calculateRicciTF(bd);
+  }
+
+  // Hamiltonian constraint
+  if(hamiltonian)
+    bd->H = hamiltonianConstraintCalc(bd);
+}
+
 }
 
 #endif
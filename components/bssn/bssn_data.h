@@ -276,6 +276,22 @@ typedef struct {
 
 } BSSNData;
 
+/**
+ * @brief Groups of BSSNData members computed by BSSN::set_bd_values
+ * @details Profiles may be combined bitwise; members a group depends on are
+ * also computed, eg. BD_RICCI implies BD_DERIVS. BD_LOCAL (field and FRW
+ * values, inverse and full conformal metric) is always computed.
+ */
+enum BSSNDataProfile
+{
+  BD_LOCAL = 0, ///< values at the point only
+  BD_DERIVS = 1, ///< first derivatives of fields
+  BD_ACONT = 2, ///< A^ij and A_ijA^ij (also stored to AijAij_a)
+  BD_RICCI = 4, ///< second derivatives, Christoffels, D_iD_j phi and alpha, Ricci (also stored to ricci_a)
+  BD_HAMILTONIAN = 8, ///< Hamiltonian constraint, H
+  BD_FULL = BD_DERIVS | BD_ACONT | BD_RICCI | BD_HAMILTONIAN
+};
+
 } /* namespace cosmo */
 
 #endif
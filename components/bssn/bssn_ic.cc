@@ -1,6 +1,7 @@
 #include "bssn_ic.h"
 #include "../../cosmo_types.h"
-#include "../../cosmo_globals.h"
+#include "../../utils/FASMultigrid.h"
+#include "../../utils/Decomposition.h"
 
 namespace cosmo
 {
@@ -16,9 +17,10 @@ void bssn_ic_awa_stability(BSSN * bssn, real_t A)
   idx_t i, j, k;
 
   std::random_device rd;
-  std::mt19937 gen(7.0 /*rd()*/);
+  // distinct (but reproducible) noise on each MPI process
+  std::mt19937 gen(7.0 /*rd()*/ + decomposition_rank());
   std::uniform_real_distribution<real_t> dist(
-      -A*50/NX*50/NX, A*50/NX*50/NX
+      -A*50/GLOBAL_NX*50/GLOBAL_NX, A*50/GLOBAL_NX*50/GLOBAL_NX
     );
 
   arr_t & DIFFgamma11_p = *bssn->fields["DIFFgamma11_p"];
@@ -95,21 +97,21 @@ void bssn_ic_awa_linear_wave(BSSN * bssn, real_t A, int dir)
     switch(dir)
     {
       case 1 :
-        w = ((real_t) i)*dx;
+        w = ((real_t) GLOBAL_X_INDEX(i))*bssn->ctx->dx;
         DIFFgamma22_p[NP_INDEX(i,j,k)] = A*sin( 2.0*PI*w );
         DIFFgamma33_p[NP_INDEX(i,j,k)] = -A*sin( 2.0*PI*w );
         A22_p[NP_INDEX(i,j,k)] = PI*A*cos( 2.0*PI*w );
         A33_p[NP_INDEX(i,j,k)] = -PI*A*cos( 2.0*PI*w );
         break;
       case 2 :
-        w = ((real_t) j)*dx;
+        w = ((real_t) j)*bssn->ctx->dx;
         DIFFgamma11_p[NP_INDEX(i,j,k)] = A*sin( 2.0*PI*w );
         DIFFgamma33_p[NP_INDEX(i,j,k)] = -A*sin( 2.0*PI*w );
         A11_p[NP_INDEX(i,j,k)] = PI*A*cos( 2.0*PI*w );
         A33_p[NP_INDEX(i,j,k)] = -PI*A*cos( 2.0*PI*w );
         break;
       case 3 :
-        w = ((real_t) k)*dx;
+        w = ((real_t) k)*bssn->ctx->dx;
         DIFFgamma11_p[NP_INDEX(i,j,k)] = A*sin( 2.0*PI*w );
         DIFFgamma22_p[NP_INDEX(i,j,k)] = -A*sin( 2.0*PI*w );
         A11_p[NP_INDEX(i,j,k)] = PI*A*cos( 2.0*PI*w );
@@ -205,13 +207,13 @@ void bssn_ic_awa_gauge_wave(BSSN * bssn, int dir)
     switch(dir)
     {
       case 1 :
-        w = ((real_t) i)*dx;
+        w = ((real_t) GLOBAL_X_INDEX(i))*bssn->ctx->dx;
         break;
       case 2 :
-        w = ((real_t) j)*dx;
+        w = ((real_t) j)*bssn->ctx->dx;
         break;
       case 3 :
-        w = ((real_t) k)*dx;
+        w = ((real_t) k)*bssn->ctx->dx;
         break;
     }
 
@@ -304,13 +306,13 @@ void bssn_ic_awa_shifted_gauge_wave(BSSN * bssn, int dir)
     switch(dir)
     {
       case 1 :
-        w = ((real_t) i)*dx;
+        w = ((real_t) GLOBAL_X_INDEX(i))*bssn->ctx->dx;
         break;
       case 2 :
-        w = ((real_t) j)*dx;
+        w = ((real_t) j)*bssn->ctx->dx;
         break;
       case 3 :
-        w = ((real_t) k)*dx;
+        w = ((real_t) k)*bssn->ctx->dx;
         break;
     }
 
@@ -409,4 +411,106 @@ void bssn_ic_kasner(BSSN * bssn, real_t px)
 }
 
 
+/**
+ * @brief      Solve the Hamiltonian constraint for a conformally flat metric
+ *             using the multigrid solver.
+ * @details    Solves the Lichnerowicz equation with York's scaling,
+ *   lap(psi) = K^2/12 psi^5 - \tilde{A}_{ij}\tilde{A}^{ij}/8 psi^-7
+ *              - 2 pi \tilde{rho} psi^-3,
+ *  for psi = e^phi, with K = K_FRW + DIFFK_p, conformal (CTT) \tilde{A}_{ij}
+ *  read from the A_ij_p fields, and \tilde{rho} = psi^8 rho. The initial guess
+ *  is psi = exp(DIFFphi_p). On return, DIFFphi_p/_a hold ln(psi), A_ij_p hold
+ *  the BSSN A_ij = psi^-6 \tilde{A}_{ij}, and rho holds the physical density.
+ *  The momentum constraint is not solved: it holds for any psi as long as K
+ *  is constant, \tilde{A}_{ij} is transverse-traceless in the flat conformal
+ *  metric, and the matter is at rest (eg, the static shell ICs, which use
+ *  K = K_FRW and A_ij = 0).
+ *
+ * @param      bssn    BSSN instance
+ * @param      rho     conformal density on input, physical density on output
+ * @param[in]  K_FRW   background extrinsic curvature
+ */
+void bssn_ic_solve_hamiltonian_constraint(BSSN * bssn, arr_t & rho,
+  real_t K_FRW, IOData * iodata)
+{
+  idx_t i, j, k;
+
+  arr_t & DIFFphi_p = *bssn->fields["DIFFphi_p"];
+  arr_t & DIFFphi_a = *bssn->fields["DIFFphi_a"];
+  arr_t & DIFFK_p = *bssn->fields["DIFFK_p"];
+  arr_t & A11_p = *bssn->fields["A11_p"];
+  arr_t & A12_p = *bssn->fields["A12_p"];
+  arr_t & A13_p = *bssn->fields["A13_p"];
+  arr_t & A22_p = *bssn->fields["A22_p"];
+  arr_t & A23_p = *bssn->fields["A23_p"];
+  arr_t & A33_p = *bssn->fields["A33_p"];
+
+  idx_t relax_iters = std::stoi(bssn->ctx->config("multigrid_relax_iters", "2"));
+  if(relax_iters < 1)
+  {
+    iodata->log("Error: multigrid_relax_iters must be at least 1.");
+    throw -1;
+  }
+
+  arr_t * psi = new arr_t [1];
+  psi[0].init(NX, NY, NZ);
+
+  idx_t molecule_n[] = {4};
+  FASMultigrid multigrid(iodata, psi, 1, molecule_n,
+    std::stoi(bssn->ctx->config("multigrid_depth", "6")), relax_iters,
+    std::stod(bssn->ctx->config("relaxation_tolerance", "1e-8")));
+  atom atom_tmp = {0};
+
+  // lap(psi)
+  multigrid.eqns[0][0].init(1, 1.0);
+  atom_tmp.type = multigrid.atom_type::lap;
+  atom_tmp.u_id = 0;
+  multigrid.eqns[0][0].add_atom(atom_tmp);
+
+  // - K^2/12 psi^5, + AijAij/8 psi^-7, + 2 pi rho psi^-3
+  real_t powers[3] = {5.0, -7.0, -3.0};
+  real_t coefs[3] = {-1.0/12.0, 1.0/8.0, 2.0*PI};
+  for(int m=1; m<=3; ++m)
+  {
+    multigrid.eqns[0][m].init(2, coefs[m-1]);
+    atom_tmp.type = multigrid.atom_type::const_f;
+    multigrid.eqns[0][m].add_atom(atom_tmp);
+    atom_tmp.type = multigrid.atom_type::poly;
+    atom_tmp.value = powers[m-1];
+    multigrid.eqns[0][m].add_atom(atom_tmp);
+  }
+
+  LOOP3(i,j,k)
+  {
+    idx_t idx = NP_INDEX(i,j,k);
+    real_t K = K_FRW + DIFFK_p[idx];
+    real_t AijAij = pw2(A11_p[idx]) + pw2(A22_p[idx]) + pw2(A33_p[idx])
+      + 2.0*( pw2(A12_p[idx]) + pw2(A13_p[idx]) + pw2(A23_p[idx]) );
+
+    multigrid.setPolySrcAtPt(0, 1, i, j, k, K*K);
+    multigrid.setPolySrcAtPt(0, 2, i, j, k, AijAij);
+    multigrid.setPolySrcAtPt(0, 3, i, j, k, rho[idx]);
+    psi[0][idx] = std::exp(DIFFphi_p[idx]);
+  }
+
+  real_t res = multigrid.solve(bssn->ctx->config("multigrid_cycle_type", "V"),
+    std::stoi(bssn->ctx->config("num_v_cycles", "20")));
+  iodata->log("Hamiltonian constraint solved with residual " + stringify(res) + ".");
+
+# pragma omp parallel for default(shared) private(i,j,k)
+  LOOP3(i,j,k)
+  {
+    idx_t idx = NP_INDEX(i,j,k);
+    real_t psi_pt = psi[0][idx];
+    real_t psim6 = std::pow(psi_pt, -6.0);
+
+    DIFFphi_p[idx] = DIFFphi_a[idx] = std::log(psi_pt);
+    A11_p[idx] *= psim6; A12_p[idx] *= psim6; A13_p[idx] *= psim6;
+    A22_p[idx] *= psim6; A23_p[idx] *= psim6; A33_p[idx] *= psim6;
+    rho[idx] *= std::pow(psi_pt, -8.0);
+  }
+
+  delete [] psi;
+}
+
 } // namespace cosmo
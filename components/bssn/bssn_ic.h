@@ -8,6 +8,7 @@
 #define COSMO_BSSN_ICS
 
 #include "bssn.h"
+#include "../../IO/IOData.h"
 
 namespace cosmo
 {
@@ -22,6 +23,9 @@ void bssn_ic_awa_shifted_gauge_wave(BSSN * bssn);
 void bssn_ic_awa_shifted_gauge_wave(BSSN * bssn, int dir);
 void bssn_ic_kasner(BSSN * bssn, real_t px);
 
+void bssn_ic_solve_hamiltonian_constraint(BSSN * bssn, arr_t & rho,
+  real_t K_FRW, IOData * iodata);
+
 }
 
 #endif
@@ -181,6 +181,16 @@
 #define BSSN_ZERO_SOURCES() \
   BSSN_APPLY_TO_SOURCES(BSSN_ZERO_GEN1_FIELD)
 
+// source values in a BSSNData struct
+#define BSSN_ZERO_BD_SOURCE(field) \
+  bd->field = 0.0
+
+#define BSSN_STORE_BD_SOURCE(field) \
+  field##_a[bd->idx] = bd->field
+
+#define BSSN_ADD_BD_SOURCE_OFFSET(field) \
+  bd->field += sa->offset.field
+
 
 // Initialize all fields
 #define BSSN_RK_INITIALIZE_FIELD(field) \
@@ -189,6 +199,14 @@
 #define BSSN_RK_INITIALIZE \
   BSSN_APPLY_TO_FIELDS(BSSN_RK_INITIALIZE_FIELD)
 
+// Evolved fields needing halos when running with MPI
+#define BSSN_ADD_HALO_FIELD(field) \
+  halo_fields.push_back(&field->_array_a);
+
+// Evolved fields stored at the start of a step for multirate integration
+#define BSSN_ADD_STEP_FIELD(field) \
+  step_fields.push_back(field);
+
 
 // Evolve all fields
 #define BSSN_RK_EVOLVE_PT_FIELD(field) \
@@ -205,6 +223,19 @@
 #define BSSN_FINALIZE_K(n) \
   BSSN_APPLY_TO_FIELDS_ARGS(BSSN_FINALIZE_K_FIELD, n)
 
+// Finalize an RK step for points in a range, and swap registers afterward
+#define BSSN_FINALIZE_K_POINTS_FIELD(field, n, begin, end) \
+  field->KFinalizePoints(n, begin, end);
+
+#define BSSN_FINALIZE_K_POINTS(n, begin, end) \
+  BSSN_APPLY_TO_FIELDS_ARGS(BSSN_FINALIZE_K_POINTS_FIELD, n, begin, end)
+
+#define BSSN_SWAP_A_C_FIELD(field) \
+  field->swap_a_c();
+
+#define BSSN_SWAP_A_C \
+  BSSN_APPLY_TO_FIELDS(BSSN_SWAP_A_C_FIELD)
+
 
 // Initialize all fields
 #define BSSN_SET_DT_FIELD(field, dt) \
@@ -228,7 +259,7 @@
     bd->d##J##g##K##I + bd->d##K##g##J##I - bd->d##I##g##J##K \
   )
 
-#define BSSN_CALCULATE_DGAMMA(I, J, K) bd->d##I##g##J##K = derivative(bd->i, bd->j, bd->k, I, DIFFgamma##J##K->_array_a);
+#define BSSN_CALCULATE_DGAMMA(I, J, K) bd->d##I##g##J##K = derivative(bd->i, bd->j, bd->k, I, DIFFgamma##J##K->_array_a, ctx->inv_dx);
 
 #define BSSN_CALCULATE_ACONT(I, J) bd->Acont##I##J = ( \
     bd->gammai##I##1*bd->gammai##J##1*bd->A11 + bd->gammai##I##2*bd->gammai##J##1*bd->A21 + bd->gammai##I##3*bd->gammai##J##1*bd->A31 \
@@ -238,7 +269,7 @@
 
 // needs the gamma*ldlphi vars defined:
 // not actually trace free yet!
-#define BSSN_CALCULATE_DIDJALPHA(I, J) bd->D##I##D##J##aTF = double_derivative(bd->i, bd->j, bd->k, I, J, DIFFalpha->_array_a) - ( \
+#define BSSN_CALCULATE_DIDJALPHA(I, J) bd->D##I##D##J##aTF = double_derivative(bd->i, bd->j, bd->k, I, J, DIFFalpha->_array_a, ctx->inv_dx) - ( \
     (bd->G1##I##J + 2.0*( (1==I)*bd->d##J##phi + (1==J)*bd->d##I##phi - bd->gamma##I##J*gammai1ldlphi))*bd->d1a + \
     (bd->G2##I##J + 2.0*( (2==I)*bd->d##J##phi + (2==J)*bd->d##I##phi - bd->gamma##I##J*gammai2ldlphi))*bd->d2a + \
     (bd->G3##I##J + 2.0*( (3==I)*bd->d##J##phi + (3==J)*bd->d##I##phi - bd->gamma##I##J*gammai3ldlphi))*bd->d3a \
@@ -249,7 +280,7 @@
   bd->gammai##K##L*bd->d##K##d##L##g##I##J
 
 #define BSSN_CALCULATE_RICCI_UNITARY_TERM2(K, I, J) \
-  bd->gamma##K##I*derivative(bd->i, bd->j, bd->k, J, Gamma##K->_array_a)
+  bd->gamma##K##I*derivative(bd->i, bd->j, bd->k, J, Gamma##K->_array_a, ctx->inv_dx)
 
 #define BSSN_CALCULATE_RICCI_UNITARY_TERM3(K, I, J) \
   bd->Gammad##K*bd->GL##I##J##K
@@ -277,12 +308,12 @@
   );
 
 #define BSSN_CALCULATE_DIDJGAMMA_PERMS(I, J)           \
-  bd->d##I##d##J##g11 = double_derivative(bd->i, bd->j, bd->k, I, J, DIFFgamma11->_array_a); \
-  bd->d##I##d##J##g12 = double_derivative(bd->i, bd->j, bd->k, I, J, DIFFgamma12->_array_a); \
-  bd->d##I##d##J##g13 = double_derivative(bd->i, bd->j, bd->k, I, J, DIFFgamma13->_array_a); \
-  bd->d##I##d##J##g22 = double_derivative(bd->i, bd->j, bd->k, I, J, DIFFgamma22->_array_a); \
-  bd->d##I##d##J##g23 = double_derivative(bd->i, bd->j, bd->k, I, J, DIFFgamma23->_array_a); \
-  bd->d##I##d##J##g33 = double_derivative(bd->i, bd->j, bd->k, I, J, DIFFgamma33->_array_a)
+  bd->d##I##d##J##g11 = double_derivative(bd->i, bd->j, bd->k, I, J, DIFFgamma11->_array_a, ctx->inv_dx); \
+  bd->d##I##d##J##g12 = double_derivative(bd->i, bd->j, bd->k, I, J, DIFFgamma12->_array_a, ctx->inv_dx); \
+  bd->d##I##d##J##g13 = double_derivative(bd->i, bd->j, bd->k, I, J, DIFFgamma13->_array_a, ctx->inv_dx); \
+  bd->d##I##d##J##g22 = double_derivative(bd->i, bd->j, bd->k, I, J, DIFFgamma22->_array_a, ctx->inv_dx); \
+  bd->d##I##d##J##g23 = double_derivative(bd->i, bd->j, bd->k, I, J, DIFFgamma23->_array_a, ctx->inv_dx); \
+  bd->d##I##d##J##g33 = double_derivative(bd->i, bd->j, bd->k, I, J, DIFFgamma33->_array_a, ctx->inv_dx)
 
 
 /*
@@ -293,9 +324,9 @@
 #define BSSN_DT_DIFFGAMMAIJ(I, J) ( \
     - 2.0*bd->alpha*bd->A##I##J \
     /* + bd->beta1 * bd->d1g##I##J + bd->beta2 * bd->d2g##I##J + bd->beta3 * bd->d3g##I##J \  */ \
-    + upwind_derivative(bd->i, bd->j, bd->k, 1, DIFFgamma##I##J->_array_a, bd->beta1) \
-    + upwind_derivative(bd->i, bd->j, bd->k, 2, DIFFgamma##I##J->_array_a, bd->beta2) \
-    + upwind_derivative(bd->i, bd->j, bd->k, 3, DIFFgamma##I##J->_array_a, bd->beta3) \
+    + upwind_derivative(bd->i, bd->j, bd->k, 1, DIFFgamma##I##J->_array_a, bd->beta1, ctx->inv_dx) \
+    + upwind_derivative(bd->i, bd->j, bd->k, 2, DIFFgamma##I##J->_array_a, bd->beta2, ctx->inv_dx) \
+    + upwind_derivative(bd->i, bd->j, bd->k, 3, DIFFgamma##I##J->_array_a, bd->beta3, ctx->inv_dx) \
     + bd->gamma##I##1*bd->d##J##beta1 + bd->gamma##I##2*bd->d##J##beta2 + bd->gamma##I##3*bd->d##J##beta3 \
     + bd->gamma##J##1*bd->d##I##beta1 + bd->gamma##J##2*bd->d##I##beta2 + bd->gamma##J##3*bd->d##I##beta3 \
     - (2.0/3.0)*bd->gamma##I##J*(bd->d1beta1 + bd->d2beta2 + bd->d3beta3) \
@@ -320,12 +351,12 @@
 #define BSSN_DT_AIJ(I, J) ( \
     exp(-4.0*bd->phi)*( bd->alpha*(bd->ricciTF##I##J - 8.0*PI*bd->STF##I##J) - bd->D##I##D##J##aTF ) \
     + bd->alpha*(BSSN_DT_AIJ_SECOND_ORDER_KA(I,J) - 2.0*BSSN_DT_AIJ_SECOND_ORDER_AA(I,J)) \
-    /* + bd->beta1*derivative(bd->i, bd->j, bd->k, 1, A##I##J->_array_a) \ */ \
-    /* + bd->beta2*derivative(bd->i, bd->j, bd->k, 2, A##I##J->_array_a) \ */ \
-    /* + bd->beta3*derivative(bd->i, bd->j, bd->k, 3, A##I##J->_array_a) \ */ \
-       + upwind_derivative(bd->i, bd->j, bd->k, 1, A##I##J->_array_a, bd->beta1)     \
-       + upwind_derivative(bd->i, bd->j, bd->k, 2, A##I##J->_array_a, bd->beta2)     \
-       + upwind_derivative(bd->i, bd->j, bd->k, 3, A##I##J->_array_a, bd->beta3)     \
+    /* + bd->beta1*derivative(bd->i, bd->j, bd->k, 1, A##I##J->_array_a, ctx->inv_dx) \ */ \
+    /* + bd->beta2*derivative(bd->i, bd->j, bd->k, 2, A##I##J->_array_a, ctx->inv_dx) \ */ \
+    /* + bd->beta3*derivative(bd->i, bd->j, bd->k, 3, A##I##J->_array_a, ctx->inv_dx) \ */ \
+       + upwind_derivative(bd->i, bd->j, bd->k, 1, A##I##J->_array_a, bd->beta1, ctx->inv_dx)     \
+       + upwind_derivative(bd->i, bd->j, bd->k, 2, A##I##J->_array_a, bd->beta2, ctx->inv_dx)     \
+       + upwind_derivative(bd->i, bd->j, bd->k, 3, A##I##J->_array_a, bd->beta3, ctx->inv_dx)     \
     + bd->A##I##1*bd->d##J##beta1 + bd->A##I##2*bd->d##J##beta2 + bd->A##I##3*bd->d##J##beta3 \
     + bd->A##J##1*bd->d##I##beta1 + bd->A##J##2*bd->d##I##beta2 + bd->A##J##3*bd->d##I##beta3 \
     - (2.0/3.0)*bd->A##I##J*(bd->d1beta1 + bd->d2beta2 + bd->d3beta3) \
@@ -362,22 +393,22 @@
 
 #if USE_BSSN_SHIFT
 #define BSSN_DT_GAMMAI_SHIFT(I) ( \
-    /* + bd->beta1*derivative(bd->i, bd->j, bd->k, 1, Gamma##I->_array_a) \ */ \
-    /* + bd->beta2*derivative(bd->i, bd->j, bd->k, 2, Gamma##I->_array_a) \ */ \
-    /* + bd->beta3*derivative(bd->i, bd->j, bd->k, 3, Gamma##I->_array_a) \ */ \
-    + upwind_derivative(bd->i, bd->j, bd->k, 1, Gamma##I->_array_a, bd->beta1) \
-    + upwind_derivative(bd->i, bd->j, bd->k, 2, Gamma##I->_array_a, bd->beta2) \
-    + upwind_derivative(bd->i, bd->j, bd->k, 3, Gamma##I->_array_a, bd->beta3) \
+    /* + bd->beta1*derivative(bd->i, bd->j, bd->k, 1, Gamma##I->_array_a, ctx->inv_dx) \ */ \
+    /* + bd->beta2*derivative(bd->i, bd->j, bd->k, 2, Gamma##I->_array_a, ctx->inv_dx) \ */ \
+    /* + bd->beta3*derivative(bd->i, bd->j, bd->k, 3, Gamma##I->_array_a, ctx->inv_dx) \ */ \
+    + upwind_derivative(bd->i, bd->j, bd->k, 1, Gamma##I->_array_a, bd->beta1, ctx->inv_dx) \
+    + upwind_derivative(bd->i, bd->j, bd->k, 2, Gamma##I->_array_a, bd->beta2, ctx->inv_dx) \
+    + upwind_derivative(bd->i, bd->j, bd->k, 3, Gamma##I->_array_a, bd->beta3, ctx->inv_dx) \
     - bd->Gammad1*bd->d1beta##I - bd->Gammad2*bd->d2beta##I - bd->Gammad3*bd->d3beta##I \
     + (2.0/3.0) * bd->Gammad##I * (bd->d1beta1 + bd->d2beta2 + bd->d3beta3) \
     + (1.0/3.0) * ( \
-        bd->gammai##I##1*double_derivative(bd->i, bd->j, bd->k, 1, 1, beta1->_array_a) + bd->gammai##I##1*double_derivative(bd->i, bd->j, bd->k, 2, 1, beta2->_array_a) + bd->gammai##I##1*double_derivative(bd->i, bd->j, bd->k, 3, 1, beta3->_array_a) +  \
-        bd->gammai##I##2*double_derivative(bd->i, bd->j, bd->k, 1, 2, beta1->_array_a) + bd->gammai##I##2*double_derivative(bd->i, bd->j, bd->k, 2, 2, beta2->_array_a) + bd->gammai##I##2*double_derivative(bd->i, bd->j, bd->k, 3, 2, beta3->_array_a) +  \
-        bd->gammai##I##3*double_derivative(bd->i, bd->j, bd->k, 1, 3, beta1->_array_a) + bd->gammai##I##3*double_derivative(bd->i, bd->j, bd->k, 2, 3, beta2->_array_a) + bd->gammai##I##3*double_derivative(bd->i, bd->j, bd->k, 3, 3, beta3->_array_a) \
+        bd->gammai##I##1*double_derivative(bd->i, bd->j, bd->k, 1, 1, beta1->_array_a, ctx->inv_dx) + bd->gammai##I##1*double_derivative(bd->i, bd->j, bd->k, 2, 1, beta2->_array_a, ctx->inv_dx) + bd->gammai##I##1*double_derivative(bd->i, bd->j, bd->k, 3, 1, beta3->_array_a, ctx->inv_dx) +  \
+        bd->gammai##I##2*double_derivative(bd->i, bd->j, bd->k, 1, 2, beta1->_array_a, ctx->inv_dx) + bd->gammai##I##2*double_derivative(bd->i, bd->j, bd->k, 2, 2, beta2->_array_a, ctx->inv_dx) + bd->gammai##I##2*double_derivative(bd->i, bd->j, bd->k, 3, 2, beta3->_array_a, ctx->inv_dx) +  \
+        bd->gammai##I##3*double_derivative(bd->i, bd->j, bd->k, 1, 3, beta1->_array_a, ctx->inv_dx) + bd->gammai##I##3*double_derivative(bd->i, bd->j, bd->k, 2, 3, beta2->_array_a, ctx->inv_dx) + bd->gammai##I##3*double_derivative(bd->i, bd->j, bd->k, 3, 3, beta3->_array_a, ctx->inv_dx) \
       ) \
     + ( \
-        bd->gammai11*double_derivative(bd->i, bd->j, bd->k, 1, 1, beta##I->_array_a) + bd->gammai22*double_derivative(bd->i, bd->j, bd->k, 2, 2, beta##I->_array_a) + bd->gammai33*double_derivative(bd->i, bd->j, bd->k, 3, 3, beta##I->_array_a) \
-        + 2.0*(bd->gammai12*double_derivative(bd->i, bd->j, bd->k, 1, 2, beta##I->_array_a) + bd->gammai13*double_derivative(bd->i, bd->j, bd->k, 1, 3, beta##I->_array_a) + bd->gammai23*double_derivative(bd->i, bd->j, bd->k, 2, 3, beta##I->_array_a)) \
+        bd->gammai11*double_derivative(bd->i, bd->j, bd->k, 1, 1, beta##I->_array_a, ctx->inv_dx) + bd->gammai22*double_derivative(bd->i, bd->j, bd->k, 2, 2, beta##I->_array_a, ctx->inv_dx) + bd->gammai33*double_derivative(bd->i, bd->j, bd->k, 3, 3, beta##I->_array_a, ctx->inv_dx) \
+        + 2.0*(bd->gammai12*double_derivative(bd->i, bd->j, bd->k, 1, 2, beta##I->_array_a, ctx->inv_dx) + bd->gammai13*double_derivative(bd->i, bd->j, bd->k, 1, 3, beta##I->_array_a, ctx->inv_dx) + bd->gammai23*double_derivative(bd->i, bd->j, bd->k, 2, 3, beta##I->_array_a, ctx->inv_dx)) \
       ) \
   )
 #else
@@ -460,7 +491,7 @@
 
 #define BSSN_RP_DK(I,J,L) \
   P*( \
-    4.0*(bd->A##I##J + 1.0/3.0*bd->gamma##I##J*bd->K)*bd->d##L##phi + derivative(bd->i, bd->j, bd->k, L, A##I##J->_array_a) \
+    4.0*(bd->A##I##J + 1.0/3.0*bd->gamma##I##J*bd->K)*bd->d##L##phi + derivative(bd->i, bd->j, bd->k, L, A##I##J->_array_a, ctx->inv_dx) \
     + 1.0/3.0*bd->K*bd->d##L##g##I##J + 1.0/3.0*bd->gamma##I##J*bd->d##L##K \
   )
 
@@ -495,9 +526,9 @@
       + bd->gammai13*bd->A1##I*bd->d3phi + bd->gammai23*bd->A2##I*bd->d3phi + bd->gammai33*bd->A3##I*bd->d3phi \
     ) + ( \
       /* (gamma^jk D_j A_ki) */ \
-      bd->gammai11*derivative(bd->i, bd->j, bd->k, 1, A1##I->_array_a) + bd->gammai12*derivative(bd->i, bd->j, bd->k, 2, A1##I->_array_a) + bd->gammai13*derivative(bd->i, bd->j, bd->k, 3, A1##I->_array_a) \
-      + bd->gammai21*derivative(bd->i, bd->j, bd->k, 1, A2##I->_array_a) + bd->gammai22*derivative(bd->i, bd->j, bd->k, 2, A2##I->_array_a) + bd->gammai23*derivative(bd->i, bd->j, bd->k, 3, A2##I->_array_a) \
-      + bd->gammai31*derivative(bd->i, bd->j, bd->k, 1, A3##I->_array_a) + bd->gammai32*derivative(bd->i, bd->j, bd->k, 2, A3##I->_array_a) + bd->gammai33*derivative(bd->i, bd->j, bd->k, 3, A3##I->_array_a) \
+      bd->gammai11*derivative(bd->i, bd->j, bd->k, 1, A1##I->_array_a, ctx->inv_dx) + bd->gammai12*derivative(bd->i, bd->j, bd->k, 2, A1##I->_array_a, ctx->inv_dx) + bd->gammai13*derivative(bd->i, bd->j, bd->k, 3, A1##I->_array_a, ctx->inv_dx) \
+      + bd->gammai21*derivative(bd->i, bd->j, bd->k, 1, A2##I->_array_a, ctx->inv_dx) + bd->gammai22*derivative(bd->i, bd->j, bd->k, 2, A2##I->_array_a, ctx->inv_dx) + bd->gammai23*derivative(bd->i, bd->j, bd->k, 3, A2##I->_array_a, ctx->inv_dx) \
+      + bd->gammai31*derivative(bd->i, bd->j, bd->k, 1, A3##I->_array_a, ctx->inv_dx) + bd->gammai32*derivative(bd->i, bd->j, bd->k, 2, A3##I->_array_a, ctx->inv_dx) + bd->gammai33*derivative(bd->i, bd->j, bd->k, 3, A3##I->_array_a, ctx->inv_dx) \
       - bd->Gammad1*bd->A1##I - bd->Gammad2*bd->A2##I - bd->Gammad3*bd->A3##I \
       - bd->GL11##I*bd->Acont11 - bd->GL21##I*bd->Acont21 - bd->GL31##I*bd->Acont31 \
       - bd->GL12##I*bd->Acont12 - bd->GL22##I*bd->Acont22 - bd->GL32##I*bd->Acont32 \
@@ -516,9 +547,9 @@
       + bd->gammai13*bd->A1##I*bd->d3phi + bd->gammai23*bd->A2##I*bd->d3phi + bd->gammai33*bd->A3##I*bd->d3phi \
     ) + std::abs( \
       /* (gamma^jk D_j A_ki) */ \
-      bd->gammai11*derivative(bd->i, bd->j, bd->k, 1, A1##I->_array_a) + bd->gammai12*derivative(bd->i, bd->j, bd->k, 2, A1##I->_array_a) + bd->gammai13*derivative(bd->i, bd->j, bd->k, 3, A1##I->_array_a) \
-      + bd->gammai21*derivative(bd->i, bd->j, bd->k, 1, A2##I->_array_a) + bd->gammai22*derivative(bd->i, bd->j, bd->k, 2, A2##I->_array_a) + bd->gammai23*derivative(bd->i, bd->j, bd->k, 3, A2##I->_array_a) \
-      + bd->gammai31*derivative(bd->i, bd->j, bd->k, 1, A3##I->_array_a) + bd->gammai32*derivative(bd->i, bd->j, bd->k, 2, A3##I->_array_a) + bd->gammai33*derivative(bd->i, bd->j, bd->k, 3, A3##I->_array_a) \
+      bd->gammai11*derivative(bd->i, bd->j, bd->k, 1, A1##I->_array_a, ctx->inv_dx) + bd->gammai12*derivative(bd->i, bd->j, bd->k, 2, A1##I->_array_a, ctx->inv_dx) + bd->gammai13*derivative(bd->i, bd->j, bd->k, 3, A1##I->_array_a, ctx->inv_dx) \
+      + bd->gammai21*derivative(bd->i, bd->j, bd->k, 1, A2##I->_array_a, ctx->inv_dx) + bd->gammai22*derivative(bd->i, bd->j, bd->k, 2, A2##I->_array_a, ctx->inv_dx) + bd->gammai23*derivative(bd->i, bd->j, bd->k, 3, A2##I->_array_a, ctx->inv_dx) \
+      + bd->gammai31*derivative(bd->i, bd->j, bd->k, 1, A3##I->_array_a, ctx->inv_dx) + bd->gammai32*derivative(bd->i, bd->j, bd->k, 2, A3##I->_array_a, ctx->inv_dx) + bd->gammai33*derivative(bd->i, bd->j, bd->k, 3, A3##I->_array_a, ctx->inv_dx) \
       - bd->Gammad1*bd->A1##I - bd->Gammad2*bd->A2##I - bd->Gammad3*bd->A3##I \
       - bd->GL11##I*bd->Acont11 - bd->GL21##I*bd->Acont21 - bd->GL31##I*bd->Acont31 \
       - bd->GL12##I*bd->Acont12 - bd->GL22##I*bd->Acont22 - bd->GL32##I*bd->Acont32 \
@@ -537,12 +568,23 @@
 
 
 #define BSSN_NORMALIZE_STDEV(C) \
-  stdev_##C = sqrt(stdev_##C/(POINTS-1.0)); \
-  stdev_##C##_scaled = sqrt(stdev_##C##_scaled/(POINTS-1.0));
+  stdev_##C = sqrt(stdev_##C/(GLOBAL_POINTS-1.0)); \
+  stdev_##C##_scaled = sqrt(stdev_##C##_scaled/(GLOBAL_POINTS-1.0));
 
 #define BSSN_NORMALIZE_MEAN(C) \
-  mean_##C /= POINTS; \
-  mean_##C##_scaled /= POINTS;
+  mean_##C /= GLOBAL_POINTS; \
+  mean_##C##_scaled /= GLOBAL_POINTS;
+
+#define BSSN_REDUCE_CONSTRAINT_MEAN_VARS(C) \
+  mean_##C = decomposition_sum(mean_##C); \
+  mean_##C##_scale = decomposition_sum(mean_##C##_scale); \
+  mean_##C##_scaled = decomposition_sum(mean_##C##_scaled); \
+  max_##C = decomposition_max(max_##C); \
+  max_##C##_scaled = decomposition_max(max_##C##_scaled);
+
+#define BSSN_REDUCE_CONSTRAINT_STDEV_VARS(C) \
+  stdev_##C = decomposition_sum(stdev_##C); \
+  stdev_##C##_scaled = decomposition_sum(stdev_##C##_scaled);
 
 #define BSSN_INITIALIZE_CONSTRAINT_STAT_VARS(C) \
   real_t mean_##C = 0.0, stdev_##C = 0.0, max_##C = 0.0; \
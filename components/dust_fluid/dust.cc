@@ -1,7 +1,6 @@
 #include "dust.h"
 #include "../../utils/math.h"
 #include "../../cosmo_includes.h"
-#include "../../cosmo_globals.h"
 
 namespace cosmo
 {
@@ -9,10 +8,11 @@ namespace cosmo
 
 /**
  * @brief Constructor: initialize fields needed for dust evolution,
- * set timestep according to global `dt`.
+ * set timestep according to the `dt` of the simulation context.
  * Doesn't work with a shift! (For now?)
  */
-Dust::Dust():
+Dust::Dust(SimContext * ctx_in):
+  ctx(ctx_in),
   D(), S1(), S2(), S3(),
   aDv1(), aDv2(), aDv3(),
   aS1v1(), aS1v2(), aS1v3(),
@@ -22,12 +22,12 @@ Dust::Dust():
   detg(), g11(), g12(), g13(), g22(), g23(), g33(),
   W()
 {
-  std::cout << "Creating dust class with dt=" << dt << "\n";
+  std::cout << "Creating dust class with dt=" << ctx->dt << "\n";
 
-  D.init(NX, NY, NZ, dt);
-  S1.init(NX, NY, NZ, dt);
-  S2.init(NX, NY, NZ, dt);
-  S3.init(NX, NY, NZ, dt);
+  D.init(NX, NY, NZ, ctx->dt);
+  S1.init(NX, NY, NZ, ctx->dt);
+  S2.init(NX, NY, NZ, ctx->dt);
+  S3.init(NX, NY, NZ, ctx->dt);
 
   aDv1.init(NX, NY, NZ); aDv2.init(NX, NY, NZ); aDv3.init(NX, NY, NZ);
 
@@ -41,6 +41,13 @@ Dust::Dust():
   g22.init(NX, NY, NZ); g23.init(NX, NY, NZ); g33.init(NX, NY, NZ);
 
   W.init(NX, NY, NZ);
+
+  flux_fields = {
+    &aDv1, &aDv2, &aDv3,
+    &aS1v1, &aS1v2, &aS1v3,
+    &aS2v1, &aS2v2, &aS2v3,
+    &aS3v1, &aS3v2, &aS3v3
+  };
 }
 
 Dust::~Dust()
@@ -71,6 +78,18 @@ void Dust::stepInit(BSSN *bssn)
   populateDerivedFields(bssn);
 }
 
+/**
+ * @brief Call RK4Register::stepInit for fields; derived fields are computed
+ * in the subsequent sweep.
+ */
+void Dust::subcycleInit(BSSN *bssn)
+{
+  D.stepInit();
+  S1.stepInit();
+  S2.stepInit();
+  S3.stepInit();
+}
+
 /**
  * @brief Call RK4Register::K1Finalize for fields.
  */
@@ -107,70 +126,153 @@ void Dust::K4Finalize()
 }
 
 void Dust::populateDerivedFields(BSSN *bssn)
+{
+  idx_t i;
+  bssn->exchangeHalos();
+
+  #pragma omp parallel for default(shared) private(i)
+  for(i=0; i<NX; ++i)
+    populateDerivedFields(bssn, i, i+1);
+}
+
+/**
+ * @brief Compute flux arrays, sources, and metric quantities in x-planes
+ * [x_begin, x_end); BSSN halos must be current.
+ */
+void Dust::populateDerivedFields(BSSN *bssn, idx_t x_begin, idx_t x_end)
 {
   idx_t i, j, k;
-  #pragma omp parallel for default(shared) private(i, j, k)
-  LOOP3(i,j,k)
-  {
-    idx_t idx = NP_INDEX(i,j,k);
-
-    BSSNData bd = {0};
-    bssn->set_bd_values(i, j, k, &bd); // TODO: get only relevant variables here
-    DustData dd = getDustData(&bd);
-
-    aDv1[idx] = bd.alpha*D[idx]*dd.v1;
-    aDv2[idx] = bd.alpha*D[idx]*dd.v2;
-    aDv3[idx] = bd.alpha*D[idx]*dd.v3;
-
-    aS1v1[idx] = bd.alpha*S1[idx]*dd.v1;
-    aS1v2[idx] = bd.alpha*S1[idx]*dd.v2;
-    aS1v3[idx] = bd.alpha*S1[idx]*dd.v3;
-    aS2v1[idx] = bd.alpha*S2[idx]*dd.v1;
-    aS2v2[idx] = bd.alpha*S2[idx]*dd.v2;
-    aS2v3[idx] = bd.alpha*S2[idx]*dd.v3;
-    aS3v1[idx] = bd.alpha*S3[idx]*dd.v1;
-    aS3v2[idx] = bd.alpha*S3[idx]*dd.v2;
-    aS3v3[idx] = bd.alpha*S3[idx]*dd.v3;
-
-    S1src[idx] = 1.0/2.0 * bd.alpha * dd.W * D[idx] * std::exp(4.0*bd.phi) *(
-        dd.v1*dd.v1*(4.0*bd.gamma11*bd.d1phi + bd.d1g11)  + dd.v2*dd.v2*(4.0*bd.gamma22*bd.d1phi + bd.d1g22) + dd.v3*dd.v3*(4.0*bd.gamma33*bd.d1phi + bd.d1g33)
-        + 2.0*( dd.v1*dd.v2*(4.0*bd.gamma12*bd.d1phi + bd.d1g12)  + dd.v1*dd.v3*(4.0*bd.gamma13*bd.d1phi + bd.d1g13) + dd.v2*dd.v3*(4.0*bd.gamma23*bd.d1phi + bd.d1g23) )
-      ) - dd.W*D[idx]*bd.d1a;
-    S2src[idx] = 1.0/2.0 * bd.alpha * dd.W * D[idx] * std::exp(4.0*bd.phi) *(
-        dd.v1*dd.v1*(4.0*bd.gamma11*bd.d2phi + bd.d2g11)  + dd.v2*dd.v2*(4.0*bd.gamma22*bd.d2phi + bd.d2g22) + dd.v3*dd.v3*(4.0*bd.gamma33*bd.d2phi + bd.d2g33)
-        + 2.0*( dd.v1*dd.v2*(4.0*bd.gamma12*bd.d2phi + bd.d2g12)  + dd.v1*dd.v3*(4.0*bd.gamma13*bd.d2phi + bd.d2g13) + dd.v2*dd.v3*(4.0*bd.gamma23*bd.d2phi + bd.d2g23) )
-      ) - dd.W*D[idx]*bd.d2a;
-    S3src[idx] = 1.0/2.0 * bd.alpha * dd.W * D[idx] * std::exp(4.0*bd.phi) *(
-        dd.v1*dd.v1*(4.0*bd.gamma11*bd.d3phi + bd.d3g11)  + dd.v2*dd.v2*(4.0*bd.gamma22*bd.d3phi + bd.d3g22) + dd.v3*dd.v3*(4.0*bd.gamma33*bd.d3phi + bd.d3g33)
-        + 2.0*( dd.v1*dd.v2*(4.0*bd.gamma12*bd.d3phi + bd.d3g12)  + dd.v1*dd.v3*(4.0*bd.gamma13*bd.d3phi + bd.d3g13) + dd.v2*dd.v3*(4.0*bd.gamma23*bd.d3phi + bd.d3g23) )
-      ) - dd.W*D[idx]*bd.d3a;
-
-    real_t e4phi = std::exp(4.0*bd.phi);
-    detg[idx] = std::exp(6.0*bd.phi);
-    g11[idx] = e4phi*bd.gamma11;
-    g12[idx] = e4phi*bd.gamma12;
-    g13[idx] = e4phi*bd.gamma13;
-    g22[idx] = e4phi*bd.gamma22;
-    g23[idx] = e4phi*bd.gamma23;
-    g33[idx] = e4phi*bd.gamma33;
-    W[idx] = dd.W;
-  }
+
+  for(i=x_begin; i<x_end; ++i)
+    for(j=0; j<NY; ++j)
+      for(k=0; k<NZ; ++k)
+      {
+        BSSNData bd = {0};
+        bssn->set_bd_values<BD_DERIVS>(i, j, k, &bd);
+        populateDerivedFieldsPt(&bd);
+      }
+}
+
+/**
+ * @brief Compute flux arrays, sources, and metric quantities at a point
+ */
+void Dust::populateDerivedFieldsPt(BSSNData *bd)
+{
+  idx_t idx = bd->idx;
+  DustData dd = getDustData(bd);
+
+  aDv1[idx] = bd->alpha*D[idx]*dd.v1;
+  aDv2[idx] = bd->alpha*D[idx]*dd.v2;
+  aDv3[idx] = bd->alpha*D[idx]*dd.v3;
+
+  aS1v1[idx] = bd->alpha*S1[idx]*dd.v1;
+  aS1v2[idx] = bd->alpha*S1[idx]*dd.v2;
+  aS1v3[idx] = bd->alpha*S1[idx]*dd.v3;
+  aS2v1[idx] = bd->alpha*S2[idx]*dd.v1;
+  aS2v2[idx] = bd->alpha*S2[idx]*dd.v2;
+  aS2v3[idx] = bd->alpha*S2[idx]*dd.v3;
+  aS3v1[idx] = bd->alpha*S3[idx]*dd.v1;
+  aS3v2[idx] = bd->alpha*S3[idx]*dd.v2;
+  aS3v3[idx] = bd->alpha*S3[idx]*dd.v3;
+
+  S1src[idx] = 1.0/2.0 * bd->alpha * dd.W * D[idx] * std::exp(4.0*bd->phi) *(
+      dd.v1*dd.v1*(4.0*bd->gamma11*bd->d1phi + bd->d1g11)  + dd.v2*dd.v2*(4.0*bd->gamma22*bd->d1phi + bd->d1g22) + dd.v3*dd.v3*(4.0*bd->gamma33*bd->d1phi + bd->d1g33)
+      + 2.0*( dd.v1*dd.v2*(4.0*bd->gamma12*bd->d1phi + bd->d1g12)  + dd.v1*dd.v3*(4.0*bd->gamma13*bd->d1phi + bd->d1g13) + dd.v2*dd.v3*(4.0*bd->gamma23*bd->d1phi + bd->d1g23) )
+    ) - dd.W*D[idx]*bd->d1a;
+  S2src[idx] = 1.0/2.0 * bd->alpha * dd.W * D[idx] * std::exp(4.0*bd->phi) *(
+      dd.v1*dd.v1*(4.0*bd->gamma11*bd->d2phi + bd->d2g11)  + dd.v2*dd.v2*(4.0*bd->gamma22*bd->d2phi + bd->d2g22) + dd.v3*dd.v3*(4.0*bd->gamma33*bd->d2phi + bd->d2g33)
+      + 2.0*( dd.v1*dd.v2*(4.0*bd->gamma12*bd->d2phi + bd->d2g12)  + dd.v1*dd.v3*(4.0*bd->gamma13*bd->d2phi + bd->d2g13) + dd.v2*dd.v3*(4.0*bd->gamma23*bd->d2phi + bd->d2g23) )
+    ) - dd.W*D[idx]*bd->d2a;
+  S3src[idx] = 1.0/2.0 * bd->alpha * dd.W * D[idx] * std::exp(4.0*bd->phi) *(
+      dd.v1*dd.v1*(4.0*bd->gamma11*bd->d3phi + bd->d3g11)  + dd.v2*dd.v2*(4.0*bd->gamma22*bd->d3phi + bd->d3g22) + dd.v3*dd.v3*(4.0*bd->gamma33*bd->d3phi + bd->d3g33)
+      + 2.0*( dd.v1*dd.v2*(4.0*bd->gamma12*bd->d3phi + bd->d3g12)  + dd.v1*dd.v3*(4.0*bd->gamma13*bd->d3phi + bd->d3g13) + dd.v2*dd.v3*(4.0*bd->gamma23*bd->d3phi + bd->d3g23) )
+    ) - dd.W*D[idx]*bd->d3a;
+
+  real_t e4phi = std::exp(4.0*bd->phi);
+  detg[idx] = std::exp(6.0*bd->phi);
+  g11[idx] = e4phi*bd->gamma11;
+  g12[idx] = e4phi*bd->gamma12;
+  g13[idx] = e4phi*bd->gamma13;
+  g22[idx] = e4phi*bd->gamma22;
+  g23[idx] = e4phi*bd->gamma23;
+  g33[idx] = e4phi*bd->gamma33;
+  W[idx] = dd.W;
 }
 
+/**
+ * @brief Compute flux arrays, then evolve fields; flux halos are exchanged
+ * while interior points are evolved.
+ */
 void Dust::RKEvolve(BSSN *bssn)
 {
-  idx_t i, j, k;
   populateDerivedFields(bssn);
+  RKEvolveNonlocal(bssn);
+}
 
-  #pragma omp parallel for default(shared) private(i, j, k)
-  LOOP3(i,j,k)
-  {
-    idx_t idx = NP_INDEX(i,j,k);
-    D._array_c[idx] = dt_D(i,j,k);
-    S1._array_c[idx] = dt_S1(i,j,k);
-    S2._array_c[idx] = dt_S2(i,j,k);
-    S3._array_c[idx] = dt_S3(i,j,k);
-  }
+/**
+ * @brief Flux arrays are computed in the BSSN sweep, see MatterComponent
+ */
+void Dust::RKEvolvePt(BSSNData *bd)
+{
+  populateDerivedFieldsPt(bd);
+}
+
+/**
+ * @brief Evolve fields using flux arrays computed by
+ * Dust::populateDerivedFields(Pt); flux halos are exchanged while interior
+ * points are evolved.
+ */
+void Dust::RKEvolveNonlocal(BSSN *bssn)
+{
+  decomposition_loop_overlapping_halos(ctx->timer, flux_fields,
+    [&](idx_t i, idx_t j, idx_t k) {
+      idx_t idx = NP_INDEX(i,j,k);
+      D._array_c[idx] = dt_D(i,j,k);
+      S1._array_c[idx] = dt_S1(i,j,k);
+      S2._array_c[idx] = dt_S2(i,j,k);
+      S3._array_c[idx] = dt_S3(i,j,k);
+    });
+}
+
+/**
+ * @brief Evolve fields in x-planes [x_begin, x_end) using flux arrays
+ * computed by Dust::populateDerivedFields; fluxes are read from
+ * neighboring planes.
+ */
+void Dust::RKEvolveTile(idx_t x_begin, idx_t x_end)
+{
+  idx_t i, j, k;
+  for(i=x_begin; i<x_end; ++i)
+    for(j=0; j<NY; ++j)
+      for(k=0; k<NZ; ++k)
+      {
+        idx_t idx = NP_INDEX(i,j,k);
+        D._array_c[idx] = dt_D(i,j,k);
+        S1._array_c[idx] = dt_S1(i,j,k);
+        S2._array_c[idx] = dt_S2(i,j,k);
+        S3._array_c[idx] = dt_S3(i,j,k);
+      }
+}
+
+/**
+ * @brief Call RK4Register::KFinalizePoints for fields in x-planes
+ * [x_begin, x_end); Dust::KFinalizeComplete must be called afterward.
+ */
+void Dust::KFinalizeTile(int n, idx_t x_begin, idx_t x_end)
+{
+  idx_t begin = NP_INDEX(x_begin,0,0), end = NP_INDEX(x_end,0,0);
+  D.KFinalizePoints(n, begin, end);
+  S1.KFinalizePoints(n, begin, end);
+  S2.KFinalizePoints(n, begin, end);
+  S3.KFinalizePoints(n, begin, end);
+}
+
+void Dust::KFinalizeComplete()
+{
+  D.swap_a_c();
+  S1.swap_a_c();
+  S2.swap_a_c();
+  S3.swap_a_c();
 }
 
 
@@ -202,66 +304,49 @@ DustData Dust::getDustData(BSSNData *bd)
 
 real_t Dust::dt_D(idx_t i, idx_t j, idx_t k)
 {
-  return derivative(i,j,k,1,aDv1)+derivative(i,j,k,2,aDv2)+derivative(i,j,k,3,aDv3);
+  return derivative(i,j,k,1,aDv1,ctx->inv_dx)+derivative(i,j,k,2,aDv2,ctx->inv_dx)+derivative(i,j,k,3,aDv3,ctx->inv_dx);
 }
 
 real_t Dust::dt_S1(idx_t i, idx_t j, idx_t k)
 {
-  return derivative(i,j,k,1,aS1v1)+derivative(i,j,k,2,aS1v2)+derivative(i,j,k,3,aS1v3)
+  return derivative(i,j,k,1,aS1v1,ctx->inv_dx)+derivative(i,j,k,2,aS1v2,ctx->inv_dx)+derivative(i,j,k,3,aS1v3,ctx->inv_dx)
   + S1src[NP_INDEX(i,j,k)];
 }
 
 real_t Dust::dt_S2(idx_t i, idx_t j, idx_t k)
 {
-  return derivative(i,j,k,1,aS2v1)+derivative(i,j,k,2,aS2v2)+derivative(i,j,k,3,aS2v3)
+  return derivative(i,j,k,1,aS2v1,ctx->inv_dx)+derivative(i,j,k,2,aS2v2,ctx->inv_dx)+derivative(i,j,k,3,aS2v3,ctx->inv_dx)
   + S2src[NP_INDEX(i,j,k)];
 }
 
 real_t Dust::dt_S3(idx_t i, idx_t j, idx_t k)
 {
-  return derivative(i,j,k,1,aS3v1)+derivative(i,j,k,2,aS3v2)+derivative(i,j,k,3,aS3v3)
+  return derivative(i,j,k,1,aS3v1,ctx->inv_dx)+derivative(i,j,k,2,aS3v2,ctx->inv_dx)+derivative(i,j,k,3,aS3v3,ctx->inv_dx)
   + S3src[NP_INDEX(i,j,k)];
 }
 
-void Dust::addBSSNSrc(BSSN * bssn)
+/**
+ * @brief Add dust contributions to BSSN sources at a point, using derived
+ * fields from the last call to Dust::populateDerivedFields(Pt)
+ */
+void Dust::addBSSNSrcPt(BSSN *bssn, BSSNData *bd)
 {
-  arr_t & DIFFr_a = *bssn->fields["DIFFr_a"];
-  arr_t & DIFFS_a = *bssn->fields["DIFFS_a"];
-  arr_t & S1_a = *bssn->fields["S1_a"];
-  arr_t & S2_a = *bssn->fields["S2_a"];
-  arr_t & S3_a = *bssn->fields["S3_a"];
-  arr_t & STF11_a = *bssn->fields["STF11_a"];
-  arr_t & STF12_a = *bssn->fields["STF12_a"];
-  arr_t & STF13_a = *bssn->fields["STF13_a"];
-  arr_t & STF22_a = *bssn->fields["STF22_a"];
-  arr_t & STF23_a = *bssn->fields["STF23_a"];
-  arr_t & STF33_a = *bssn->fields["STF33_a"];
-
-  idx_t i, j, k;
+  idx_t idx = bd->idx;
 
-# pragma omp parallel for default(shared) private(i, j, k)
-  LOOP3(i, j, k)
-  {
-    idx_t idx = INDEX(i,j,k);
+  bd->DIFFr += W[idx]*D[idx]/detg[idx];
 
-    DIFFr_a[idx] += W[idx]*D[idx]/detg[idx];
+  bd->DIFFS += D[idx]/detg[idx] * (W[idx]*W[idx]-1.0)/W[idx];
 
-    DIFFS_a[idx] += D[idx]/detg[idx] * (W[idx]*W[idx]-1.0)/W[idx];
+  bd->S1 += S1[idx]/detg[idx];
+  bd->S2 += S2[idx]/detg[idx];
+  bd->S3 += S3[idx]/detg[idx];
 
-    S1_a[idx] += S1[idx]/detg[idx];
-    S2_a[idx] += S2[idx]/detg[idx];
-    S3_a[idx] += S3[idx]/detg[idx];
-
-    STF11_a[idx] += S1[idx]*S1[idx]/W[idx]/D[idx]/detg[idx] - 1.0/3.0*g11[idx]*DIFFS_a[idx];
-    STF12_a[idx] += S1[idx]*S2[idx]/W[idx]/D[idx]/detg[idx] - 1.0/3.0*g12[idx]*DIFFS_a[idx];
-    STF13_a[idx] += S1[idx]*S3[idx]/W[idx]/D[idx]/detg[idx] - 1.0/3.0*g13[idx]*DIFFS_a[idx];
-    STF22_a[idx] += S2[idx]*S2[idx]/W[idx]/D[idx]/detg[idx] - 1.0/3.0*g22[idx]*DIFFS_a[idx];
-    STF23_a[idx] += S2[idx]*S3[idx]/W[idx]/D[idx]/detg[idx] - 1.0/3.0*g23[idx]*DIFFS_a[idx];
-    STF33_a[idx] += S3[idx]*S3[idx]/W[idx]/D[idx]/detg[idx] - 1.0/3.0*g33[idx]*DIFFS_a[idx];
-  }
-
-  return;
+  bd->STF11 += S1[idx]*S1[idx]/W[idx]/D[idx]/detg[idx] - 1.0/3.0*g11[idx]*bd->DIFFS;
+  bd->STF12 += S1[idx]*S2[idx]/W[idx]/D[idx]/detg[idx] - 1.0/3.0*g12[idx]*bd->DIFFS;
+  bd->STF13 += S1[idx]*S3[idx]/W[idx]/D[idx]/detg[idx] - 1.0/3.0*g13[idx]*bd->DIFFS;
+  bd->STF22 += S2[idx]*S2[idx]/W[idx]/D[idx]/detg[idx] - 1.0/3.0*g22[idx]*bd->DIFFS;
+  bd->STF23 += S2[idx]*S3[idx]/W[idx]/D[idx]/detg[idx] - 1.0/3.0*g23[idx]*bd->DIFFS;
+  bd->STF33 += S3[idx]*S3[idx]/W[idx]/D[idx]/detg[idx] - 1.0/3.0*g33[idx]*bd->DIFFS;
 }
 
-
 } // namespace cosmo
@@ -3,6 +3,7 @@
 
 #include "../../cosmo_types.h"
 #include "../bssn/bssn.h"
+#include "../matter/MatterComponent.h"
 
 
 namespace cosmo
@@ -25,10 +26,12 @@ typedef struct {
  * @brief Class implementing functionality for a dust fluid that relies on a
  * BSSN instance.
  */
-class Dust
+class Dust : public MatterComponent
 {
 
 public:
+  SimContext * ctx; ///< context of the simulation
+
   register_t D;
   register_t S1;
   register_t S2;
@@ -42,10 +45,12 @@ public:
 
   arr_t S1src, S2src, S3src;
 
+  std::vector<arr_t *> flux_fields; ///< flux arrays exchanged between MPI processes
+
   arr_t detg, g11, g12, g13, g22, g23, g33;
   arr_t W;
 
-  Dust();
+  Dust(SimContext * ctx_in);
   ~Dust();
 
   void setDt(real_t dt);
@@ -56,16 +61,28 @@ public:
   void K3Finalize();
   void K4Finalize();
   void populateDerivedFields(BSSN *bssn);
+  void populateDerivedFieldsPt(BSSNData *bd);
   void RKEvolve(BSSN *bssn);
 
+  // MatterComponent interface
+  void addBSSNSrcPt(BSSN *bssn, BSSNData *bd);
+  void RKEvolvePt(BSSNData *bd);
+  void RKEvolveNonlocal(BSSN *bssn);
+  bool hasPointwiseRHS() { return true; }
+  void subcycleInit(BSSN *bssn);
+
+  // tile-based (x-range) variants for use within tasks; see DustSim
+  void populateDerivedFields(BSSN *bssn, idx_t x_begin, idx_t x_end);
+  void RKEvolveTile(idx_t x_begin, idx_t x_end);
+  void KFinalizeTile(int n, idx_t x_begin, idx_t x_end);
+  void KFinalizeComplete();
+
   real_t dt_D(idx_t i, idx_t j, idx_t k);
   real_t dt_S1(idx_t i, idx_t j, idx_t k);
   real_t dt_S2(idx_t i, idx_t j, idx_t k);
   real_t dt_S3(idx_t i, idx_t j, idx_t k);
 
   DustData getDustData(BSSNData *bd);
-
-  void addBSSNSrc(BSSN *bssn);
 };
 
 } // namespace cosmo
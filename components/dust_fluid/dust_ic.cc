@@ -1,7 +1,6 @@
 #include "dust_ic.h"
 #include "../../cosmo_includes.h"
 #include "../../cosmo_types.h"
-#include "../../cosmo_globals.h"
 #include "../../utils/Fourier.h"
 #include "../../utils/math.h"
 #include "../../ICs/ICs.h"
@@ -24,13 +23,14 @@ void dust_ic_set_random( BSSN * bssn, Dust * dust, Lambda * lambda,
   Fourier * fourier, IOData * iodata )
 {
   idx_t i, j, k;
+  const real_t inv_dx = bssn->ctx->inv_dx;
 
   // Background cosmology, a_FRW = 1
   real_t rho_FRW = 3.0/PI/8.0;
-  real_t Omega_L = std::stod(_config("Omega_L", "1.0e-6"));
-  real_t p0 = std::stod(_config("p0", "7.0"));
-  real_t P = H_LEN_FRAC*H_LEN_FRAC*1.0e-15*std::stod(_config("P", "1.0"));
-  real_t p_cut = std::stod(_config("p_cut", "1.0"));
+  real_t Omega_L = std::stod(bssn->ctx->config("Omega_L", "1.0e-6"));
+  real_t p0 = std::stod(bssn->ctx->config("p0", "7.0"));
+  real_t P = H_LEN_FRAC*H_LEN_FRAC*1.0e-15*std::stod(bssn->ctx->config("P", "1.0"));
+  real_t p_cut = std::stod(bssn->ctx->config("p_cut", "1.0"));
   real_t rho_L = Omega_L * rho_FRW;
   lambda->setLambda(rho_L);
 
@@ -57,7 +57,7 @@ void dust_ic_set_random( BSSN * bssn, Dust * dust, Lambda * lambda,
   arr_t & W3 = *bssn->fields["A33_c"];
 
   // 1.a) Synchronous-gauge Newtonian potential:
-  set_gaussian_random_Phi_N(phi_N, fourier, P, p0, p_cut);
+  set_gaussian_random_Phi_N(bssn->ctx, phi_N, fourier, P, p0, p_cut);
 
   // 1.b) Preliminary metric variables: phi, K
 # pragma omp parallel for default(shared) private(i,j,k)
@@ -65,7 +65,7 @@ void dust_ic_set_random( BSSN * bssn, Dust * dust, Lambda * lambda,
   {
     idx_t idx = NP_INDEX(i,j,k);
     
-    lap_phi_N[idx] = laplacian(i, j, k, phi_N);
+    lap_phi_N[idx] = laplacian(i, j, k, phi_N, inv_dx);
 
     DIFFphi_p[idx] = log1p(-10.0/3.0*phi_N[idx])/4.0;
     DIFFK_p[idx] = -3.0*(1.0 + 2.0*phi_N[idx]) + 2.0/3.0*lap_phi_N[idx];
@@ -77,9 +77,9 @@ void dust_ic_set_random( BSSN * bssn, Dust * dust, Lambda * lambda,
   LOOP3(i,j,k) {
     idx_t idx = NP_INDEX(i,j,k);
     real_t e6p = exp(6.0*DIFFphi_p[idx]);
-    invlape6pd1K[idx] = e6p*derivative(i,j,k,1,DIFFK_p);
-    invlape6pd2K[idx] = e6p*derivative(i,j,k,2,DIFFK_p);
-    invlape6pd3K[idx] = e6p*derivative(i,j,k,3,DIFFK_p);
+    invlape6pd1K[idx] = e6p*derivative(i,j,k,1,DIFFK_p,inv_dx);
+    invlape6pd2K[idx] = e6p*derivative(i,j,k,2,DIFFK_p,inv_dx);
+    invlape6pd3K[idx] = e6p*derivative(i,j,k,3,DIFFK_p,inv_dx);
   }
   fourier->inverseLaplacian <idx_t, real_t> (invlape6pd1K._array);
   fourier->inverseLaplacian <idx_t, real_t> (invlape6pd2K._array);
@@ -89,9 +89,9 @@ void dust_ic_set_random( BSSN * bssn, Dust * dust, Lambda * lambda,
   LOOP3(i,j,k)
   {
     idx_t idx = NP_INDEX(i,j,k);
-    W1[idx] = -derivative(i,j,k,1,phi_N)/3.0 + invlape6pd1K[idx]/2.0;
-    W2[idx] = -derivative(i,j,k,2,phi_N)/3.0 + invlape6pd2K[idx]/2.0;
-    W3[idx] = -derivative(i,j,k,3,phi_N)/3.0 + invlape6pd3K[idx]/2.0;
+    W1[idx] = -derivative(i,j,k,1,phi_N,inv_dx)/3.0 + invlape6pd1K[idx]/2.0;
+    W2[idx] = -derivative(i,j,k,2,phi_N,inv_dx)/3.0 + invlape6pd2K[idx]/2.0;
+    W3[idx] = -derivative(i,j,k,3,phi_N,inv_dx)/3.0 + invlape6pd3K[idx]/2.0;
   }
 
   // 1.d) Aij components
@@ -101,15 +101,15 @@ void dust_ic_set_random( BSSN * bssn, Dust * dust, Lambda * lambda,
     idx_t idx = NP_INDEX(i,j,k);
     // these are the CTT conformal Aij
     real_t CTT2BSSNAij = exp(-6.0*DIFFphi_p[idx]);
-    real_t DkWk = derivative(i,j,k,1,W1) + derivative(i,j,k,2,W2) + derivative(i,j,k,3,W3);
-    A11_p[idx] = CTT2BSSNAij * ( derivative(i,j,k,1,W1) + derivative(i,j,k,1,W1) + 2.0/3.0*double_derivative(i,j,k,1,1,phi_N)
+    real_t DkWk = derivative(i,j,k,1,W1,inv_dx) + derivative(i,j,k,2,W2,inv_dx) + derivative(i,j,k,3,W3,inv_dx);
+    A11_p[idx] = CTT2BSSNAij * ( derivative(i,j,k,1,W1,inv_dx) + derivative(i,j,k,1,W1,inv_dx) + 2.0/3.0*double_derivative(i,j,k,1,1,phi_N,inv_dx)
       - 2.0/3.0*DkWk - 2.0/9.0*lap_phi_N[idx] );
-    A12_p[idx] = CTT2BSSNAij * ( derivative(i,j,k,1,W2) + derivative(i,j,k,2,W1) + 2.0/3.0*double_derivative(i,j,k,1,2,phi_N) );
-    A13_p[idx] = CTT2BSSNAij * ( derivative(i,j,k,1,W3) + derivative(i,j,k,3,W1) + 2.0/3.0*double_derivative(i,j,k,1,3,phi_N) );
-    A22_p[idx] = CTT2BSSNAij * ( derivative(i,j,k,2,W2) + derivative(i,j,k,2,W2) + 2.0/3.0*double_derivative(i,j,k,2,2,phi_N)
+    A12_p[idx] = CTT2BSSNAij * ( derivative(i,j,k,1,W2,inv_dx) + derivative(i,j,k,2,W1,inv_dx) + 2.0/3.0*double_derivative(i,j,k,1,2,phi_N,inv_dx) );
+    A13_p[idx] = CTT2BSSNAij * ( derivative(i,j,k,1,W3,inv_dx) + derivative(i,j,k,3,W1,inv_dx) + 2.0/3.0*double_derivative(i,j,k,1,3,phi_N,inv_dx) );
+    A22_p[idx] = CTT2BSSNAij * ( derivative(i,j,k,2,W2,inv_dx) + derivative(i,j,k,2,W2,inv_dx) + 2.0/3.0*double_derivative(i,j,k,2,2,phi_N,inv_dx)
       - 2.0/3.0*DkWk - 2.0/9.0*lap_phi_N[idx] );
-    A23_p[idx] = CTT2BSSNAij * ( derivative(i,j,k,2,W3) + derivative(i,j,k,3,W2) + 2.0/3.0*double_derivative(i,j,k,2,3,phi_N) );
-    A33_p[idx] = CTT2BSSNAij * ( derivative(i,j,k,3,W3) + derivative(i,j,k,3,W3) + 2.0/3.0*double_derivative(i,j,k,3,3,phi_N)
+    A23_p[idx] = CTT2BSSNAij * ( derivative(i,j,k,2,W3,inv_dx) + derivative(i,j,k,3,W2,inv_dx) + 2.0/3.0*double_derivative(i,j,k,2,3,phi_N,inv_dx) );
+    A33_p[idx] = CTT2BSSNAij * ( derivative(i,j,k,3,W3,inv_dx) + derivative(i,j,k,3,W3,inv_dx) + 2.0/3.0*double_derivative(i,j,k,3,3,phi_N,inv_dx)
       - 2.0/3.0*DkWk - 2.0/9.0*lap_phi_N[idx] );
   }
 
@@ -121,8 +121,8 @@ void dust_ic_set_random( BSSN * bssn, Dust * dust, Lambda * lambda,
 
     real_t AijAij = A11_p[idx]*A11_p[idx] + A22_p[idx]*A22_p[idx] + A33_p[idx]*A33_p[idx]
       + 2.0*(A12_p[idx]*A12_p[idx] + A13_p[idx]*A13_p[idx] + A23_p[idx]*A23_p[idx]);
-    real_t lap_e_p = exp(DIFFphi_p[idx]) * ( laplacian(i,j,k,DIFFphi_p)
-      + pw2(derivative(i,j,k,1,DIFFphi_p)) + pw2(derivative(i,j,k,2,DIFFphi_p)) + pw2(derivative(i,j,k,3,DIFFphi_p)) );
+    real_t lap_e_p = exp(DIFFphi_p[idx]) * ( laplacian(i,j,k,DIFFphi_p,inv_dx)
+      + pw2(derivative(i,j,k,1,DIFFphi_p,inv_dx)) + pw2(derivative(i,j,k,2,DIFFphi_p,inv_dx)) + pw2(derivative(i,j,k,3,DIFFphi_p,inv_dx)) );
     real_t rho_ADM = 1.0/2.0/PI * ( DIFFK_p[idx]*DIFFK_p[idx]/12.0 - AijAij/8.0 - exp(-5.0*DIFFphi_p[idx])*lap_e_p );
     real_t rho_0 = rho_ADM - rho_L;
 
@@ -0,0 +1,115 @@
+/**
+ * @file MatterComponent.h
+ * @brief Common interface for matter components evolved alongside BSSN
+ * fields, see MatterDriver.
+ */
+
+#ifndef COSMO_MATTER_COMPONENT_H
+#define COSMO_MATTER_COMPONENT_H
+
+#include "../bssn/bssn_data.h"
+#include "../../cosmo_types.h"
+#include <vector>
+
+namespace cosmo
+{
+
+class BSSN; // forward declaration of BSSN class
+
+/**
+ * @brief Interface for a matter component coupled to BSSN fields
+ * @details During each RK substep, BSSN::RKEvolve makes a single sweep over
+ * the grid in which BSSNData is computed once per point. Every component
+ * adds its source contributions to the source members of that BSSNData
+ * (DIFFr, DIFFS, S1-S3, STF11-STF33), which are then stored and used for
+ * the BSSN RHS, and evaluates its own pointwise RHS from the same data;
+ * see BSSN::assembleSrcPt.
+ * Anything that cannot be computed pointwise (eg. derivatives of fluxes
+ * computed in the sweep, or particle/sheet evolution) is done afterward, in
+ * RKEvolveNonlocal. All methods have no-op defaults.
+ */
+class MatterComponent
+{
+public:
+  virtual ~MatterComponent() {}
+
+  /**
+   * @brief Whether BSSN sources are deposited onto the grid before the
+   * sweep (using depositBSSNSrc) rather than computed pointwise
+   */
+  virtual bool depositsBSSNSrc() { return false; }
+
+  /**
+   * @brief Add contributions to BSSN source arrays before the sweep; arrays
+   * are cleared beforehand
+   */
+  virtual void depositBSSNSrc(BSSN *bssn) {}
+
+  /**
+   * @brief Whether STF contributions must be made trace-free once sources
+   * from all components are assembled
+   */
+  virtual bool tracefreeBSSNSrc() { return false; }
+
+  /**
+   * @brief Add contributions that are the same at every point (eg. a
+   * cosmological constant) to source members of offset, once per substep
+   */
+  virtual void addBSSNSrcOffset(BSSNData *offset) {}
+
+  /**
+   * @brief Add contributions to BSSN sources at a point
+   * @details Components are called in the order they were added to the
+   * MatterDriver, so source members of bd hold contributions of earlier
+   * components; offsets are added after all components. Only BD_LOCAL
+   * members of bd are guaranteed to be set, and source-dependent ones
+   * (r, S, H) are not updated until sources are stored.
+   */
+  virtual void addBSSNSrcPt(BSSN *bssn, BSSNData *bd) {}
+
+  /**
+   * @brief Evaluate the RHS (or quantities needed for it) at a point; BSSN
+   * sources in bd are set.
+   */
+  virtual void RKEvolvePt(BSSNData *bd) {}
+
+  /**
+   * @brief Complete RHS evaluation after the sweep
+   */
+  virtual void RKEvolveNonlocal(BSSN *bssn) {}
+
+  /**
+   * @brief Append fields whose halos must be current for the sweep, see
+   * BSSN::addStaleHaloFields
+   */
+  virtual void addStaleHaloFields(std::vector<arr_t *> & fields) {}
+
+  /**
+   * @brief Set the RK step size of evolved fields
+   */
+  virtual void setDt(real_t dt) {}
+
+  /**
+   * @brief Whether RKEvolvePt must be called (in a sweep over the grid) when
+   * the component is subcycled, see MatterDriver
+   */
+  virtual bool hasPointwiseRHS() { return false; }
+
+  /**
+   * @brief Begin a subcycled step after the first one within a BSSN step
+   * (eg. call RK4Register::stepInit); BSSN fields hold the interpolated
+   * metric at the start of the subcycled step.
+   * @details Subcycled components only receive BD_DERIVS members of
+   * BSSNData in RKEvolvePt.
+   */
+  virtual void subcycleInit(BSSN *bssn) {}
+
+  virtual void K1Finalize() {}
+  virtual void K2Finalize() {}
+  virtual void K3Finalize() {}
+  virtual void K4Finalize() {}
+};
+
+} // namespace cosmo
+
+#endif
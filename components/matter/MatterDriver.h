@@ -0,0 +1,217 @@
+/**
+ * @file MatterDriver.h
+ * @brief Evolve BSSN fields together with a set of matter components.
+ */
+
+#ifndef COSMO_MATTER_DRIVER_H
+#define COSMO_MATTER_DRIVER_H
+
+#include "MatterComponent.h"
+#include "../bssn/bssn.h"
+#include <vector>
+
+namespace cosmo
+{
+
+/**
+ * @brief Run RK substeps for BSSN fields and matter components
+ * @details Sources and RHS of all components are evaluated in the same
+ * sweep over the grid as the BSSN RHS (see BSSN::RKEvolve), followed by
+ * MatterComponent::RKEvolveNonlocal for each component; BSSN fields are
+ * finalized before components. Components are called in the order they
+ * were added.
+ *
+ * Components may instead be subcycled: after the BSSN step, they take
+ * several RK4 steps with BSSN fields linearly interpolated in time between
+ * the start and end of the BSSN step (see BSSN::setInterpolatedMetric).
+ * BSSN sources from subcycled components are taken from their values at the
+ * start of the BSSN step.
+ */
+class MatterDriver
+{
+  BSSN * bssn;
+  std::vector<MatterComponent *> components; ///< all components, in order added
+  std::vector<MatterComponent *> evolved; ///< components evolved with BSSN fields
+  std::vector<MatterComponent *> subcycled; ///< components evolved afterward
+  std::vector<int> substeps; ///< number of steps taken by each subcycled component
+
+public:
+  MatterDriver(BSSN * bssn_in) :
+    bssn(bssn_in)
+  {}
+
+  /**
+   * @brief Add a component
+   *
+   * @param n_substeps number of steps the component takes per BSSN step;
+   * the step size of the component is set to dt/n_substeps, with dt that
+   * of the simulation context.
+   */
+  void addComponent(MatterComponent * component, int n_substeps = 1)
+  {
+    components.push_back(component);
+    if(n_substeps > 1)
+    {
+      subcycled.push_back(component);
+      substeps.push_back(n_substeps);
+      component->setDt(bssn->ctx->dt/n_substeps);
+    }
+    else
+    {
+      evolved.push_back(component);
+    }
+  }
+
+  /**
+   * @brief Set the step size of BSSN fields and all components
+   */
+  void setDt(real_t dt_in)
+  {
+    bssn->setDt(dt_in);
+    for(MatterComponent * component : evolved)
+      component->setDt(dt_in);
+    for(size_t c=0; c<subcycled.size(); ++c)
+      subcycled[c]->setDt(dt_in/substeps[c]);
+  }
+
+  /**
+   * @brief Set BSSN sources from all components (eg. for output)
+   */
+  void setSources()
+  {
+    bssn->setSrc(components);
+  }
+
+  /**
+   * @brief Prepare setting BSSN sources in tiles, see BSSN::prepareSrc
+   */
+  void prepareSources(BSSNSrcAssembly *sa)
+  {
+    bssn->prepareSrc(components, sa);
+  }
+
+  /**
+   * @brief Set BSSN sources in x-planes [x_begin, x_end) for use within a
+   * task; sa must be prepared by prepareSources first.
+   */
+  void setSources(BSSNSrcAssembly *sa, idx_t x_begin, idx_t x_end)
+  {
+    bssn->setSrc(components, sa, x_begin, x_end);
+  }
+
+  /**
+   * @brief Evaluate the RHS of BSSN fields and all components
+   *
+   * @param set_sources recompute BSSN sources first; otherwise sources
+   * already in the BSSN arrays are used.
+   */
+  void RKEvolve(bool set_sources)
+  {
+    bssn->RKEvolve(evolved, components, set_sources);
+    for(MatterComponent * component : evolved)
+      component->RKEvolveNonlocal(bssn);
+  }
+
+  void KFinalize(int n)
+  {
+    switch(n)
+    {
+      case 1:
+        bssn->K1Finalize();
+        break;
+      case 2:
+        bssn->K2Finalize();
+        break;
+      case 3:
+        bssn->K3Finalize();
+        break;
+      case 4:
+        bssn->K4Finalize();
+        break;
+    }
+    for(MatterComponent * component : evolved)
+      KFinalize(component, n);
+  }
+
+  static void KFinalize(MatterComponent * component, int n)
+  {
+    switch(n)
+    {
+      case 1:
+        component->K1Finalize();
+        break;
+      case 2:
+        component->K2Finalize();
+        break;
+      case 3:
+        component->K3Finalize();
+        break;
+      case 4:
+        component->K4Finalize();
+        break;
+    }
+  }
+
+  /**
+   * @brief Evolve a subcycled component through a BSSN step that has
+   * already been taken; the first subcycled step must already be
+   * initialized.
+   */
+  void subcycle(MatterComponent * component, int n_substeps)
+  {
+    std::vector<MatterComponent *> single(1, component);
+    const real_t stage_times[4] = {0.0, 0.5, 0.5, 1.0};
+    real_t theta = -1.0;
+
+    for(int s=0; s<n_substeps; ++s)
+    {
+      if(s > 0)
+        component->subcycleInit(bssn);
+
+      for(int n=1; n<=4; ++n)
+      {
+        real_t stage_theta = (s + stage_times[n-1])/n_substeps;
+        if(stage_theta != theta)
+        {
+          theta = stage_theta;
+          bssn->setInterpolatedMetric(theta);
+        }
+        if(component->hasPointwiseRHS())
+          bssn->RKEvolveMatter(single);
+        component->RKEvolveNonlocal(bssn);
+        KFinalize(component, n);
+      }
+    }
+  }
+
+  /**
+   * @brief Perform a full RK4 step, minus initialization
+   * @details Sources for the first substep must already be set (they are
+   * typically needed for output anyway).
+   */
+  void step()
+  {
+    if(!subcycled.empty())
+      bssn->storeStepStart();
+
+    RKEvolve(false);
+    KFinalize(1);
+    RKEvolve(true);
+    KFinalize(2);
+    RKEvolve(true);
+    KFinalize(3);
+    RKEvolve(true);
+    KFinalize(4);
+
+    if(!subcycled.empty())
+    {
+      for(size_t c=0; c<subcycled.size(); ++c)
+        subcycle(subcycled[c], substeps[c]);
+      bssn->setInterpolatedMetric(1.0);
+    }
+  }
+};
+
+} // namespace cosmo
+
+#endif
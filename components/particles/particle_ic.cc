@@ -1,7 +1,6 @@
 #include "particle_ic.h"
 #include "../../cosmo_includes.h"
 #include "../../cosmo_types.h"
-#include "../../cosmo_globals.h"
 #include "../../ICs/ICs.h"
 #include "../../utils/math.h"
 
@@ -17,6 +16,8 @@ void particle_ic_set_random(BSSN * bssnSim, Particles * particles, Fourier * fou
   IOData * iodata)
 {
   idx_t i, j, k;
+  const real_t inv_dx = bssnSim->ctx->inv_dx;
+  const real_t dx = bssnSim->ctx->dx;
   arr_t & DIFFr = *bssnSim->fields["DIFFr_a"];
   arr_t & DIFFphi_p = *bssnSim->fields["DIFFphi_p"];
   arr_t & DIFFphi_a = *bssnSim->fields["DIFFphi_a"];
@@ -30,7 +31,7 @@ void particle_ic_set_random(BSSN * bssnSim, Particles * particles, Fourier * fou
   // d^2 exp(\phi) = -2*pi exp(5\phi) * \rho
   // generate gaussian random field 1 + xi = exp(phi) (use phi_p as a proxy):
   real_t p0 = 7.0, P = 1.0, p_cut = 17.0;
-  set_gaussian_random_Phi_N(DIFFphi_p, fourier, P, p0, p_cut);
+  set_gaussian_random_Phi_N(bssnSim->ctx, DIFFphi_p, fourier, P, p0, p_cut);
 
   // rho = -lap(phi)/xi^5/2pi
 # pragma omp parallel for default(shared) private(i,j,k)
@@ -39,9 +40,9 @@ void particle_ic_set_random(BSSN * bssnSim, Particles * particles, Fourier * fou
     DIFFr[NP_INDEX(i,j,k)] = rho_FRW - 0.5/PI/(
       pow(1.0 + DIFFphi_p[NP_INDEX(i,j,k)], 5.0)
     )*(
-      double_derivative(i, j, k, 1, 1, DIFFphi_p)
-      + double_derivative(i, j, k, 2, 2, DIFFphi_p)
-      + double_derivative(i, j, k, 3, 3, DIFFphi_p)
+      double_derivative(i, j, k, 1, 1, DIFFphi_p, inv_dx)
+      + double_derivative(i, j, k, 2, 2, DIFFphi_p, inv_dx)
+      + double_derivative(i, j, k, 3, 3, DIFFphi_p, inv_dx)
     );
   }
 
@@ -185,6 +186,7 @@ void particle_ic_set_random(BSSN * bssnSim, Particles * particles, Fourier * fou
  */
 void particle_ic_set_sinusoid(BSSN * bssnSim, Particles * particles, IOData * iodata)
 {
+  const real_t dx = bssnSim->ctx->dx;
   iodata->log("Setting sinusoidal ICs.");
   idx_t i, j, k;
 
@@ -195,7 +197,7 @@ void particle_ic_set_sinusoid(BSSN * bssnSim, Particles * particles, IOData * io
   // matter sources
   arr_t & DIFFr_a = *bssnSim->fields["DIFFr_a"];
 
-  real_t A = H_LEN_FRAC*H_LEN_FRAC*std::stod(_config("peak_amplitude_frac", "0.0001"));
+  real_t A = H_LEN_FRAC*H_LEN_FRAC*std::stod(bssnSim->ctx->config("peak_amplitude_frac", "0.0001"));
   iodata->log( "Generating ICs with peak amp. = " + stringify(A) );
 
   real_t rho_FRW = 3.0/PI/8.0;
@@ -205,7 +207,7 @@ void particle_ic_set_sinusoid(BSSN * bssnSim, Particles * particles, IOData * io
   // d^2 exp(\phi) = -2*pi exp(5\phi) * \delta_rho
   // generate random mode in \phi
   // delta_rho = -(lap e^\phi)/e^(4\phi)/2pi
-  real_t phix = std::stod(_config("sinusoid_phix", "2.77"));
+  real_t phix = std::stod(bssnSim->ctx->config("sinusoid_phix", "2.77"));
   real_t twopi_L = 2.0*PI/H_LEN_FRAC;
   real_t pw2_twopi_L = twopi_L*twopi_L;
   // grid values
@@ -230,7 +232,7 @@ void particle_ic_set_sinusoid(BSSN * bssnSim, Particles * particles, IOData * io
 
   // particle values
   // parallelizing may break this, be careful
-  idx_t particles_per_dx = std::stoi(_config("particles_per_dx", "1"));
+  idx_t particles_per_dx = std::stoi(bssnSim->ctx->config("particles_per_dx", "1"));
   iodata->log("Particles per dx: " + stringify(particles_per_dx));
   for(i=0; i<NX*particles_per_dx; ++i)
     for(j=0; j<NY; ++j)
@@ -259,7 +261,7 @@ void particle_ic_set_sinusoid(BSSN * bssnSim, Particles * particles, IOData * io
     // mass is distributed across nearby points;
     // try to counteract this
     // TODO: tune this?
-    real_t stren = std::stod(_config("deconvolution_strength", "1.0"));
+    real_t stren = std::stod(bssnSim->ctx->config("deconvolution_strength", "1.0"));
     rho = -stren*rhop + (1.0+2.0*stren)*rho - stren*rhom;
 
 
@@ -315,6 +317,7 @@ void particle_ic_set_sinusoid(BSSN * bssnSim, Particles * particles, IOData * io
 void particle_ic_set_vectorpert(BSSN * bssnSim, Particles * particles,
   IOData * iodata)
 {
+  const real_t dx = bssnSim->ctx->dx;
   iodata->log("Setting ICs based on a vector mode fluctuation.");
   // assumes functions vary in the y-direction
   idx_t i, j, k;
@@ -326,9 +329,9 @@ void particle_ic_set_vectorpert(BSSN * bssnSim, Particles * particles,
   // beta1 (x-shift) to counter fluid velocity
   arr_t & beta1_p = *bssnSim->fields["beta1_p"];
 
-  real_t b = std::stod(_config("peak_amplitude", "0.01"));
+  real_t b = std::stod(bssnSim->ctx->config("peak_amplitude", "0.01"));
   iodata->log( "Generating ICs with b = " + stringify(b) );
-  real_t use_initial_shift = std::stoi(_config("use_initial_shift", "1"));
+  real_t use_initial_shift = std::stoi(bssnSim->ctx->config("use_initial_shift", "1"));
   if(use_initial_shift)
   {
     iodata->log( "Using initial shift." );
@@ -365,7 +368,7 @@ void particle_ic_set_vectorpert(BSSN * bssnSim, Particles * particles,
   }
 
   // particle values
-  idx_t particles_per_dy = std::stoi(_config("particles_per_dy", "1"));
+  idx_t particles_per_dy = std::stoi(bssnSim->ctx->config("particles_per_dy", "1"));
   iodata->log("Particles per dx: " + stringify(particles_per_dy));
 
   for(i=0; i<NX; ++i)
@@ -399,7 +402,7 @@ void particle_ic_set_vectorpert(BSSN * bssnSim, Particles * particles,
     }
 
     // de-convolved variables
-    real_t stren = std::stod(_config("deconvolution_strength", "1.0"));
+    real_t stren = std::stod(bssnSim->ctx->config("deconvolution_strength", "1.0"));
     real_t MW = -stren*MWs[0] + (1.0+2.0*stren)*MWs[1] - stren*MWs[2];
     real_t MU = -stren*MUs[0] + (1.0+2.0*stren)*MUs[1] - stren*MUs[2];
 
@@ -3,14 +3,27 @@
 #include "../../utils/math.h"
 #include "../../utils/Timer.h"
 #include "../../IO/io.h"
-#include "../../cosmo_globals.h"
 
 namespace cosmo
 {
 
-Particles::Particles()
+Particles::Particles(SimContext * ctx_in)
 {
+  ctx = ctx_in;
   particles = new particle_vec();
+
+  sort_interval = std::stol(ctx->config("particle_sort_interval", "10"));
+  steps_since_sort = 0;
+
+  // sample metric primitives from a precomputed grid, rather than
+  // computing them at cell corners for each particle
+  use_primitives_grid = std::stoi(ctx->config("particle_primitives_grid", "1"));
+
+  // mass assignment scheme: 0 = spherical kernel of width set by
+  // smoothing_radius, or one of the separable NGP, CIC, TSC, PCS schemes,
+  // optionally with their window deconvolved from deposited sources
+  deposit = static_cast<depositScheme> (std::stoi(ctx->config("particle_deposit_scheme", "0")));
+  deconvolve_deposit = std::stoi(ctx->config("particle_deposit_deconvolve", "0"));
 }
 
 Particles::~Particles()
@@ -43,24 +56,19 @@ void Particles::init(idx_t n_particles)
     Particle<real_t> particle = {0};
 
     // Randomized position
-    particle.X[0] = 0.0*dist(gen)*COSMO_N*dx;
-    particle.X[1] = 0.0*dist(gen)*COSMO_N*dx;
-    particle.X[2] = 0.0*dist(gen)*COSMO_N*dx;
+    particle.X[0] = 0.0*dist(gen)*COSMO_N*ctx->dx;
+    particle.X[1] = 0.0*dist(gen)*COSMO_N*ctx->dx;
+    particle.X[2] = 0.0*dist(gen)*COSMO_N*ctx->dx;
     // Mass in units TBD
-    particle.M = 1.0*dx*dx*dx;
+    particle.M = 1.0*ctx->dx*ctx->dx*ctx->dx;
 
     particle.U[0] = dist(gen)/3.0;
     particle.U[1] = dist(gen)/13.0;
     particle.U[2] = dist(gen)/2.0;
 
-    ParticleRegister<real_t> particle_register;
-    particle_register.p_p = particle;
-    particle_register.p_a = particle;
-    particle_register.p_c = particle;
-    particle_register.p_f = particle;
-
-    particles->push_back( particle_register );
+    particles->push_back( particle );
   }
+  cell_start.clear();
 }
 
 /**
@@ -71,12 +79,8 @@ void Particles::init(idx_t n_particles)
  */
 void Particles::addParticle(Particle<real_t> particle)
 {
-  ParticleRegister<real_t> particle_register;
-  particle_register.p_p = particle;
-  particle_register.p_a = particle;
-  particle_register.p_c = particle;
-  particle_register.p_f = particle;
-  particles->push_back( particle_register );
+  particles->push_back( particle );
+  cell_start.clear();
   return;
 }
 
@@ -85,7 +89,7 @@ void Particles::addParticle(Particle<real_t> particle)
  */
 real_t Particles::getFractionalIndex(real_t x)
 {
-  return real_t_mod(x, COSMO_N*dx)/dx;
+  return real_t_mod(x, COSMO_N*ctx->dx)/ctx->dx;
 }
 
 /**
@@ -207,6 +211,84 @@ real_t Particles::linearInterpolation(
   return C0*(1.0 - x_d[2]) + C1*x_d[2];
 }
 
+/**
+ * @brief      Compute metric primitives at a grid point
+ * @details    Computes the lapse, rooted metric determinant, and (full)
+ *  inverse metric at a point; if complete, also the shift and derivatives
+ *  of the lapse, shift, and inverse metric.
+ *
+ * @param      f         BSSN fields to compute primitives from
+ * @param[in]  complete  Whether to compute all primitives
+ *
+ * @return     Metric primitives at the point (unset components are zero)
+ */
+ParticleMetricPrimitives<real_t> Particles::getPrimitivesAtPoint(
+  ParticlePrimitiveFields & f, idx_t x_idx, idx_t y_idx, idx_t z_idx,
+  bool complete)
+{
+  arr_t & DIFFalpha_a = *f.DIFFalpha_a;
+  arr_t & DIFFphi_a = *f.DIFFphi_a;
+  arr_t & DIFFgamma11_a = *f.DIFFgamma11_a;
+  arr_t & DIFFgamma12_a = *f.DIFFgamma12_a;
+  arr_t & DIFFgamma13_a = *f.DIFFgamma13_a;
+  arr_t & DIFFgamma22_a = *f.DIFFgamma22_a;
+  arr_t & DIFFgamma23_a = *f.DIFFgamma23_a;
+  arr_t & DIFFgamma33_a = *f.DIFFgamma33_a;
+
+  idx_t idx = INDEX(x_idx, y_idx, z_idx);
+
+  ParticleMetricPrimitives<real_t> pp = {0};
+
+  pp.rootdetg = std::exp(6.0*DIFFphi_a[idx]);
+  pp.alpha = DIFFalpha_a[idx];
+
+  pp.gi[aIDX(1,1)] = std::exp(-4.0*DIFFphi_a[idx])*(1.0 + DIFFgamma22_a[idx] + DIFFgamma33_a[idx] - pw2(DIFFgamma23_a[idx]) + DIFFgamma22_a[idx]*DIFFgamma33_a[idx]);
+  pp.gi[aIDX(2,2)] = std::exp(-4.0*DIFFphi_a[idx])*(1.0 + DIFFgamma11_a[idx] + DIFFgamma33_a[idx] - pw2(DIFFgamma13_a[idx]) + DIFFgamma11_a[idx]*DIFFgamma33_a[idx]);
+  pp.gi[aIDX(3,3)] = std::exp(-4.0*DIFFphi_a[idx])*(1.0 + DIFFgamma11_a[idx] + DIFFgamma22_a[idx] - pw2(DIFFgamma12_a[idx]) + DIFFgamma11_a[idx]*DIFFgamma22_a[idx]);
+  pp.gi[aIDX(1,2)] = std::exp(-4.0*DIFFphi_a[idx])*(DIFFgamma13_a[idx]*DIFFgamma23_a[idx] - DIFFgamma12_a[idx]*(1.0 + DIFFgamma33_a[idx]));
+  pp.gi[aIDX(1,3)] = std::exp(-4.0*DIFFphi_a[idx])*(DIFFgamma12_a[idx]*DIFFgamma23_a[idx] - DIFFgamma13_a[idx]*(1.0 + DIFFgamma22_a[idx]));
+  pp.gi[aIDX(2,3)] = std::exp(-4.0*DIFFphi_a[idx])*(DIFFgamma12_a[idx]*DIFFgamma13_a[idx] - DIFFgamma23_a[idx]*(1.0 + DIFFgamma11_a[idx]));
+
+  if(!complete)
+    return pp;
+
+# if USE_BSSN_SHIFT
+    arr_t & beta1_a = *f.beta1_a;
+    arr_t & beta2_a = *f.beta2_a;
+    arr_t & beta3_a = *f.beta3_a;
+
+    pp.beta[0] = beta1_a[idx];
+    pp.beta[1] = beta2_a[idx];
+    pp.beta[2] = beta3_a[idx];
+# endif
+
+  for(idx_t a=0; a<3; a++)
+  {
+    pp.dalpha[a] = DER(DIFFalpha_a);
+
+#   if USE_BSSN_SHIFT
+      pp.dbeta[a][0] = DER(beta1_a);
+      pp.dbeta[a][1] = DER(beta2_a);
+      pp.dbeta[a][2] = DER(beta3_a);
+#   endif
+
+    pp.dgi[a][aIDX(1,1)] = -4.0*DER(DIFFphi_a)*pp.gi[aIDX(1,1)]
+      + std::exp(-4.0*DIFFphi_a[idx])*(DER(DIFFgamma22_a) + DER(DIFFgamma33_a) - 2.0*DIFFgamma23_a[idx]*DER(DIFFgamma23_a) + DER(DIFFgamma22_a)*DIFFgamma33_a[idx] + DIFFgamma22_a[idx]*DER(DIFFgamma33_a));
+    pp.dgi[a][aIDX(2,2)] = -4.0*DER(DIFFphi_a)*pp.gi[aIDX(2,2)]
+      + std::exp(-4.0*DIFFphi_a[idx])*(DER(DIFFgamma11_a) + DER(DIFFgamma33_a) - 2.0*DIFFgamma13_a[idx]*DER(DIFFgamma13_a) + DER(DIFFgamma11_a)*DIFFgamma33_a[idx] + DIFFgamma11_a[idx]*DER(DIFFgamma33_a));
+    pp.dgi[a][aIDX(3,3)] = -4.0*DER(DIFFphi_a)*pp.gi[aIDX(3,3)]
+      + std::exp(-4.0*DIFFphi_a[idx])*(DER(DIFFgamma11_a) + DER(DIFFgamma22_a) - 2.0*DIFFgamma12_a[idx]*DER(DIFFgamma12_a) + DER(DIFFgamma11_a)*DIFFgamma22_a[idx] + DIFFgamma11_a[idx]*DER(DIFFgamma22_a));
+    pp.dgi[a][aIDX(1,2)] = -4.0*DER(DIFFphi_a)*pp.gi[aIDX(1,2)]
+      + std::exp(-4.0*DIFFphi_a[idx])*(DER(DIFFgamma13_a)*DIFFgamma23_a[idx] + DIFFgamma13_a[idx]*DER(DIFFgamma23_a) - DER(DIFFgamma12_a)*(1.0 + DIFFgamma33_a[idx]) - DIFFgamma12_a[idx]*DER(DIFFgamma33_a));
+    pp.dgi[a][aIDX(1,3)] = -4.0*DER(DIFFphi_a)*pp.gi[aIDX(1,3)]
+      + std::exp(-4.0*DIFFphi_a[idx])*(DER(DIFFgamma12_a)*DIFFgamma23_a[idx] + DIFFgamma12_a[idx]*DER(DIFFgamma23_a) - DER(DIFFgamma13_a)*(1.0 + DIFFgamma22_a[idx]) - DIFFgamma13_a[idx]*DER(DIFFgamma22_a));
+    pp.dgi[a][aIDX(2,3)] = -4.0*DER(DIFFphi_a)*pp.gi[aIDX(2,3)]
+      + std::exp(-4.0*DIFFphi_a[idx])*(DER(DIFFgamma12_a)*DIFFgamma13_a[idx] + DIFFgamma12_a[idx]*DER(DIFFgamma13_a) - DER(DIFFgamma23_a)*(1.0 + DIFFgamma11_a[idx]) - DIFFgamma23_a[idx]*DER(DIFFgamma11_a));
+  }
+
+  return pp;
+}
+
 /**
  * @brief      Interpolate some metric primitives required for geodesic integration
  * @details    Interpolate some metric primitives (eg, only some variables in a
@@ -222,41 +304,16 @@ real_t Particles::linearInterpolation(
 ParticleMetricPrimitives<real_t> Particles::getInterpolatedPrimitivesIncomplete(Particle<real_t> * p,
   map_t & bssn_fields)
 {
-  arr_t & DIFFalpha_a = *bssn_fields["DIFFalpha_a"];
-  arr_t & DIFFphi_a = *bssn_fields["DIFFphi_a"];
-  arr_t & DIFFgamma11_a = *bssn_fields["DIFFgamma11_a"];
-  arr_t & DIFFgamma12_a = *bssn_fields["DIFFgamma12_a"];
-  arr_t & DIFFgamma13_a = *bssn_fields["DIFFgamma13_a"];
-  arr_t & DIFFgamma22_a = *bssn_fields["DIFFgamma22_a"];
-  arr_t & DIFFgamma23_a = *bssn_fields["DIFFgamma23_a"];
-  arr_t & DIFFgamma33_a = *bssn_fields["DIFFgamma33_a"];
+  ParticlePrimitiveFields f (bssn_fields);
 
   // Linear interpolant
   ParticleMetricPrimitives<real_t> corner_pp[2][2][2];
   for(idx_t i=0; i<2; i++)
     for(idx_t j=0; j<2; j++)
       for(idx_t k=0; k<2; k++)
-      {
-        idx_t x_idx = getIndexBelow(p->X[0]) + i;
-        idx_t y_idx = getIndexBelow(p->X[1]) + j;
-        idx_t z_idx = getIndexBelow(p->X[2]) + k;
-        idx_t idx = INDEX(x_idx, y_idx, z_idx);
-
-        ParticleMetricPrimitives<real_t> pp = {0};
-
-        pp.rootdetg = std::exp(6.0*DIFFphi_a[idx]);
-        pp.alpha = DIFFalpha_a[idx];
-
-        pp.gi[aIDX(1,1)] = std::exp(-4.0*DIFFphi_a[idx])*(1.0 + DIFFgamma22_a[idx] + DIFFgamma33_a[idx] - pw2(DIFFgamma23_a[idx]) + DIFFgamma22_a[idx]*DIFFgamma33_a[idx]);
-        pp.gi[aIDX(2,2)] = std::exp(-4.0*DIFFphi_a[idx])*(1.0 + DIFFgamma11_a[idx] + DIFFgamma33_a[idx] - pw2(DIFFgamma13_a[idx]) + DIFFgamma11_a[idx]*DIFFgamma33_a[idx]);
-        pp.gi[aIDX(3,3)] = std::exp(-4.0*DIFFphi_a[idx])*(1.0 + DIFFgamma11_a[idx] + DIFFgamma22_a[idx] - pw2(DIFFgamma12_a[idx]) + DIFFgamma11_a[idx]*DIFFgamma22_a[idx]);
-        pp.gi[aIDX(1,2)] = std::exp(-4.0*DIFFphi_a[idx])*(DIFFgamma13_a[idx]*DIFFgamma23_a[idx] - DIFFgamma12_a[idx]*(1.0 + DIFFgamma33_a[idx]));
-        pp.gi[aIDX(1,3)] = std::exp(-4.0*DIFFphi_a[idx])*(DIFFgamma12_a[idx]*DIFFgamma23_a[idx] - DIFFgamma13_a[idx]*(1.0 + DIFFgamma22_a[idx]));
-        pp.gi[aIDX(2,3)] = std::exp(-4.0*DIFFphi_a[idx])*(DIFFgamma12_a[idx]*DIFFgamma13_a[idx] - DIFFgamma23_a[idx]*(1.0 + DIFFgamma11_a[idx]));
-
-        corner_pp[i][j][k] = pp;
-      }
-  /* end i, j, k loops */
+        corner_pp[i][j][k] = getPrimitivesAtPoint(f,
+          getIndexBelow(p->X[0]) + i, getIndexBelow(p->X[1]) + j,
+          getIndexBelow(p->X[2]) + k, false);
 
   real_t x_d[3];
   setX_d(p->X, x_d);
@@ -278,91 +335,130 @@ ParticleMetricPrimitives<real_t> Particles::getInterpolatedPrimitivesIncomplete(
 ParticleMetricPrimitives<real_t> Particles::getInterpolatedPrimitives(Particle<real_t> * p,
   map_t & bssn_fields)
 {
-  arr_t & DIFFalpha_a = *bssn_fields["DIFFalpha_a"];
-  
-# if USE_BSSN_SHIFT
-    arr_t & beta1_a = *bssn_fields["beta1_a"];
-    arr_t & beta2_a = *bssn_fields["beta2_a"];
-    arr_t & beta3_a = *bssn_fields["beta3_a"];
-# endif
-
-  arr_t & DIFFphi_a = *bssn_fields["DIFFphi_a"];
-
-  arr_t & DIFFgamma11_a = *bssn_fields["DIFFgamma11_a"];
-  arr_t & DIFFgamma12_a = *bssn_fields["DIFFgamma12_a"];
-  arr_t & DIFFgamma13_a = *bssn_fields["DIFFgamma13_a"];
-  arr_t & DIFFgamma22_a = *bssn_fields["DIFFgamma22_a"];
-  arr_t & DIFFgamma23_a = *bssn_fields["DIFFgamma23_a"];
-  arr_t & DIFFgamma33_a = *bssn_fields["DIFFgamma33_a"];
+  ParticlePrimitiveFields f (bssn_fields);
 
   // Linear interpolant
   ParticleMetricPrimitives<real_t> corner_pp[2][2][2];
   for(idx_t i=0; i<2; i++)
     for(idx_t j=0; j<2; j++)
       for(idx_t k=0; k<2; k++)
-      {
-        idx_t x_idx = getIndexBelow(p->X[0]) + i;
-        idx_t y_idx = getIndexBelow(p->X[1]) + j;
-        idx_t z_idx = getIndexBelow(p->X[2]) + k;
-        idx_t idx = INDEX(x_idx, y_idx, z_idx);
-
-        ParticleMetricPrimitives<real_t> pp;
-
-        pp.rootdetg = std::exp(6.0*DIFFphi_a[idx]);
-        pp.alpha = DIFFalpha_a[idx];
-
-#       if USE_BSSN_SHIFT
-          pp.beta[0] = beta1_a[idx];
-          pp.beta[1] = beta2_a[idx];
-          pp.beta[2] = beta3_a[idx];
-#       else
-          pp.beta[0] = 0;
-          pp.beta[1] = 0;
-          pp.beta[2] = 0;
-#       endif
-
-        pp.gi[aIDX(1,1)] = std::exp(-4.0*DIFFphi_a[idx])*(1.0 + DIFFgamma22_a[idx] + DIFFgamma33_a[idx] - pw2(DIFFgamma23_a[idx]) + DIFFgamma22_a[idx]*DIFFgamma33_a[idx]);
-        pp.gi[aIDX(2,2)] = std::exp(-4.0*DIFFphi_a[idx])*(1.0 + DIFFgamma11_a[idx] + DIFFgamma33_a[idx] - pw2(DIFFgamma13_a[idx]) + DIFFgamma11_a[idx]*DIFFgamma33_a[idx]);
-        pp.gi[aIDX(3,3)] = std::exp(-4.0*DIFFphi_a[idx])*(1.0 + DIFFgamma11_a[idx] + DIFFgamma22_a[idx] - pw2(DIFFgamma12_a[idx]) + DIFFgamma11_a[idx]*DIFFgamma22_a[idx]);
-        pp.gi[aIDX(1,2)] = std::exp(-4.0*DIFFphi_a[idx])*(DIFFgamma13_a[idx]*DIFFgamma23_a[idx] - DIFFgamma12_a[idx]*(1.0 + DIFFgamma33_a[idx]));
-        pp.gi[aIDX(1,3)] = std::exp(-4.0*DIFFphi_a[idx])*(DIFFgamma12_a[idx]*DIFFgamma23_a[idx] - DIFFgamma13_a[idx]*(1.0 + DIFFgamma22_a[idx]));
-        pp.gi[aIDX(2,3)] = std::exp(-4.0*DIFFphi_a[idx])*(DIFFgamma12_a[idx]*DIFFgamma13_a[idx] - DIFFgamma23_a[idx]*(1.0 + DIFFgamma11_a[idx]));
-
-        for(idx_t a=0; a<3; a++)
-        {
-          pp.dalpha[a] = DER(DIFFalpha_a);
-
-#         if USE_BSSN_SHIFT
-            pp.dbeta[a][0] = DER(beta1_a);
-            pp.dbeta[a][1] = DER(beta2_a);
-            pp.dbeta[a][2] = DER(beta3_a);
-#         else
-            pp.dbeta[a][0] = 0;
-            pp.dbeta[a][1] = 0;
-            pp.dbeta[a][2] = 0;
-#         endif
-
-          pp.dgi[a][aIDX(1,1)] = -4.0*DER(DIFFphi_a)*pp.gi[aIDX(1,1)]
-            + std::exp(-4.0*DIFFphi_a[idx])*(DER(DIFFgamma22_a) + DER(DIFFgamma33_a) - 2.0*DIFFgamma23_a[idx]*DER(DIFFgamma23_a) + DER(DIFFgamma22_a)*DIFFgamma33_a[idx] + DIFFgamma22_a[idx]*DER(DIFFgamma33_a));
-          pp.dgi[a][aIDX(2,2)] = -4.0*DER(DIFFphi_a)*pp.gi[aIDX(2,2)]
-            + std::exp(-4.0*DIFFphi_a[idx])*(DER(DIFFgamma11_a) + DER(DIFFgamma33_a) - 2.0*DIFFgamma13_a[idx]*DER(DIFFgamma13_a) + DER(DIFFgamma11_a)*DIFFgamma33_a[idx] + DIFFgamma11_a[idx]*DER(DIFFgamma33_a));
-          pp.dgi[a][aIDX(3,3)] = -4.0*DER(DIFFphi_a)*pp.gi[aIDX(3,3)]
-            + std::exp(-4.0*DIFFphi_a[idx])*(DER(DIFFgamma11_a) + DER(DIFFgamma22_a) - 2.0*DIFFgamma12_a[idx]*DER(DIFFgamma12_a) + DER(DIFFgamma11_a)*DIFFgamma22_a[idx] + DIFFgamma11_a[idx]*DER(DIFFgamma22_a));
-          pp.dgi[a][aIDX(1,2)] = -4.0*DER(DIFFphi_a)*pp.gi[aIDX(1,2)]
-            + std::exp(-4.0*DIFFphi_a[idx])*(DER(DIFFgamma13_a)*DIFFgamma23_a[idx] + DIFFgamma13_a[idx]*DER(DIFFgamma23_a) - DER(DIFFgamma12_a)*(1.0 + DIFFgamma33_a[idx]) - DIFFgamma12_a[idx]*DER(DIFFgamma33_a));
-          pp.dgi[a][aIDX(1,3)] = -4.0*DER(DIFFphi_a)*pp.gi[aIDX(1,3)]
-            + std::exp(-4.0*DIFFphi_a[idx])*(DER(DIFFgamma12_a)*DIFFgamma23_a[idx] + DIFFgamma12_a[idx]*DER(DIFFgamma23_a) - DER(DIFFgamma13_a)*(1.0 + DIFFgamma22_a[idx]) - DIFFgamma13_a[idx]*DER(DIFFgamma22_a));
-          pp.dgi[a][aIDX(2,3)] = -4.0*DER(DIFFphi_a)*pp.gi[aIDX(2,3)]
-            + std::exp(-4.0*DIFFphi_a[idx])*(DER(DIFFgamma12_a)*DIFFgamma13_a[idx] + DIFFgamma12_a[idx]*DER(DIFFgamma13_a) - DER(DIFFgamma23_a)*(1.0 + DIFFgamma11_a[idx]) - DIFFgamma23_a[idx]*DER(DIFFgamma11_a));
-        }
+        corner_pp[i][j][k] = getPrimitivesAtPoint(f,
+          getIndexBelow(p->X[0]) + i, getIndexBelow(p->X[1]) + j,
+          getIndexBelow(p->X[2]) + k, true);
+
+  real_t x_d[3];
+  setX_d(p->X, x_d);
+  return interpolatePrimitivesFromCorners(corner_pp, x_d);
+}
+
+/**
+ * @brief      Compute metric primitives at every grid point
+ * @details    Fills primitives_grid in a single parallel sweep, so that
+ *  particles can then be advanced by only sampling it (samplePrimitivesGrid)
+ *  rather than recomputing primitives at the corners of their cell. The
+ *  grid must be recomputed whenever the BSSN _a fields change, ie. at each
+ *  RK substep.
+ *
+ * @param[in]  complete  Compute all primitives, or only the "incomplete" set
+ *  (rootdetg, alpha, gi) needed for deposition.
+ */
+void Particles::computePrimitivesGrid(map_t & bssn_fields, bool complete)
+{
+  ctx->timer["Particles::primitivesGrid"].start();
+
+  ParticlePrimitiveFields f (bssn_fields);
+  idx_t n_components = complete ? PARTICLES_N_PRIMITIVES
+    : PARTICLES_N_PRIMITIVES_INCOMPLETE;
+  primitives_grid.resize(POINTS, n_components);
+  real_t * grid = primitives_grid.data.data();
 
-        corner_pp[i][j][k] = pp;
+  idx_t i, j, k;
+# pragma omp parallel for default(shared) private(i, j, k)
+  LOOP3(i, j, k)
+  {
+    idx_t idx = NP_INDEX(i,j,k);
+    ParticleMetricPrimitives<real_t> pp = getPrimitivesAtPoint(f, i, j, k, complete);
+
+    grid[PARTICLES_PP_ROOTDETG*POINTS + idx] = pp.rootdetg;
+    grid[PARTICLES_PP_ALPHA*POINTS + idx] = pp.alpha;
+    for(idx_t n=0; n<6; n++)
+      grid[PARTICLES_PP_GI(n)*POINTS + idx] = pp.gi[n];
+
+    if(complete)
+      for(idx_t a=0; a<3; a++)
+      {
+        grid[PARTICLES_PP_BETA(a)*POINTS + idx] = pp.beta[a];
+        grid[PARTICLES_PP_DALPHA(a)*POINTS + idx] = pp.dalpha[a];
+        for(idx_t n=0; n<3; n++)
+          grid[PARTICLES_PP_DBETA(a,n)*POINTS + idx] = pp.dbeta[a][n];
+        for(idx_t n=0; n<6; n++)
+          grid[PARTICLES_PP_DGI(a,n)*POINTS + idx] = pp.dgi[a][n];
       }
-  /* end i, j, k loops */
+  }
+
+  primitives_grid.n_components = n_components;
+
+  ctx->timer["Particles::primitivesGrid"].stop();
+}
+
+/**
+ * @brief      Trilinearly interpolate metric primitives from primitives_grid
+ * @details    Gives the same result as getInterpolatedPrimitives (or
+ *  getInterpolatedPrimitivesIncomplete), up to round-off, provided the grid
+ *  was computed from the same fields with at least the requested set.
+ */
+ParticleMetricPrimitives<real_t> Particles::samplePrimitivesGrid(
+  Particle<real_t> * p, bool complete)
+{
+  idx_t n_components = complete ? PARTICLES_N_PRIMITIVES
+    : PARTICLES_N_PRIMITIVES_INCOMPLETE;
 
+  idx_t x_idx = getIndexBelow(p->X[0]);
+  idx_t y_idx = getIndexBelow(p->X[1]);
+  idx_t z_idx = getIndexBelow(p->X[2]);
   real_t x_d[3];
   setX_d(p->X, x_d);
-  return interpolatePrimitivesFromCorners(corner_pp, x_d);
+
+  // corner indexes and weights, in "binary" order
+  idx_t corners[8];
+  real_t weights[8];
+  for(idx_t i=0; i<2; i++)
+    for(idx_t j=0; j<2; j++)
+      for(idx_t k=0; k<2; k++)
+      {
+        corners[4*i + 2*j + k] = INDEX(x_idx + i, y_idx + j, z_idx + k);
+        weights[4*i + 2*j + k] = (i ? x_d[0] : 1.0 - x_d[0])
+          *(j ? x_d[1] : 1.0 - x_d[1])*(k ? x_d[2] : 1.0 - x_d[2]);
+      }
+
+  real_t vals[PARTICLES_N_PRIMITIVES];
+  for(idx_t c=0; c<n_components; c++)
+  {
+    const real_t * comp = primitives_grid.component(c);
+    real_t val = 0.0;
+    for(idx_t m=0; m<8; m++)
+      val += weights[m]*comp[corners[m]];
+    vals[c] = val;
+  }
+
+  ParticleMetricPrimitives<real_t> pp = {0};
+  pp.rootdetg = vals[PARTICLES_PP_ROOTDETG];
+  pp.alpha = vals[PARTICLES_PP_ALPHA];
+  for(idx_t n=0; n<6; n++)
+    pp.gi[n] = vals[PARTICLES_PP_GI(n)];
+
+  if(complete)
+    for(idx_t a=0; a<3; a++)
+    {
+      pp.beta[a] = vals[PARTICLES_PP_BETA(a)];
+      pp.dalpha[a] = vals[PARTICLES_PP_DALPHA(a)];
+      for(idx_t n=0; n<3; n++)
+        pp.dbeta[a][n] = vals[PARTICLES_PP_DBETA(a,n)];
+      for(idx_t n=0; n<6; n++)
+        pp.dgi[a][n] = vals[PARTICLES_PP_DGI(a,n)];
+    }
+
+  return pp;
 }
 
 /**
@@ -396,20 +492,21 @@ ParticleMetricPrimitives<real_t> Particles::getInterpolatedPrimitives(Particle<r
  *  For a single RK step, we can just do: y_c = y_p + h * f(y_a)
  *  and y_f += RK_sum_coeff * y_c
  *
- * @param      pr            Register of particles to integrate
+ * @param      n             Index of particle to integrate
  * @param[in]  h             step size for particular RK step
  * @param[in]  RK_sum_coeff  coefficient when adding RK step
  * @param      bssn_fields   Map from bssn class to fields.
  */
-void Particles::RKStep(ParticleRegister<real_t> * pr, real_t h, real_t RK_sum_coeff,
+void Particles::RKStep(idx_t n, real_t h, real_t RK_sum_coeff,
   map_t & bssn_fields)
 {
-  Particle<real_t> & p_p = pr->p_p;
-  Particle<real_t> & p_a = pr->p_a;
-  Particle<real_t> & p_c = pr->p_c;
-  Particle<real_t> & p_f = pr->p_f;
+  ParticleArrays<real_t> & p_p = particles->p_p;
+  ParticleArrays<real_t> & p_c = particles->p_c;
+  ParticleArrays<real_t> & p_f = particles->p_f;
+  Particle<real_t> p_a = particles->p_a.get(n);
 
-  ParticleMetricPrimitives<real_t> pp_a = getInterpolatedPrimitives(& p_a, bssn_fields);
+  ParticleMetricPrimitives<real_t> pp_a = use_primitives_grid ?
+    samplePrimitivesGrid(& p_a, true) : getInterpolatedPrimitives(& p_a, bssn_fields);
 
 // TODO: check!
   real_t W = std::sqrt( 1.0 + 
@@ -420,8 +517,8 @@ void Particles::RKStep(ParticleRegister<real_t> * pr, real_t h, real_t RK_sum_co
 
   for(int i=1; i<=3; i++)
   {
-    p_c.X[iIDX(i)] = p_p.X[iIDX(i)] + h*( (pp_a.gi[aIDX(i,1)]*p_a.U[iIDX(1)] + pp_a.gi[aIDX(i,2)]*p_a.U[iIDX(2)] + pp_a.gi[aIDX(i,3)]*p_a.U[iIDX(3)]) / U0 - pp_a.beta[iIDX(i)]);
-    p_c.U[iIDX(i)] = p_p.U[iIDX(i)] + h*(
+    p_c.X[iIDX(i)][n] = p_p.X[iIDX(i)][n] + h*( (pp_a.gi[aIDX(i,1)]*p_a.U[iIDX(1)] + pp_a.gi[aIDX(i,2)]*p_a.U[iIDX(2)] + pp_a.gi[aIDX(i,3)]*p_a.U[iIDX(3)]) / U0 - pp_a.beta[iIDX(i)]);
+    p_c.U[iIDX(i)][n] = p_p.U[iIDX(i)][n] + h*(
       -1.0*W*pp_a.dalpha[iIDX(i)] + p_a.U[iIDX(1)]*pp_a.dbeta[iIDX(i)][iIDX(1)] + p_a.U[iIDX(2)]*pp_a.dbeta[iIDX(i)][iIDX(2)] + p_a.U[iIDX(3)]*pp_a.dbeta[iIDX(i)][iIDX(3)]
       -1.0/2.0/U0*(
         pp_a.dgi[iIDX(i)][aIDX(1,1)]*p_a.U[0]*p_a.U[0] + pp_a.dgi[iIDX(i)][aIDX(2,2)]*p_a.U[1]*p_a.U[1] + pp_a.dgi[iIDX(i)][aIDX(3,3)]*p_a.U[2]*p_a.U[2]
@@ -429,88 +526,203 @@ void Particles::RKStep(ParticleRegister<real_t> * pr, real_t h, real_t RK_sum_co
       )
     );
 
-    p_f.X[iIDX(i)] += RK_sum_coeff*p_c.X[iIDX(i)];
-    p_f.U[iIDX(i)] += RK_sum_coeff*p_c.U[iIDX(i)];
+    p_f.X[iIDX(i)][n] += RK_sum_coeff*p_c.X[iIDX(i)][n];
+    p_f.U[iIDX(i)][n] += RK_sum_coeff*p_c.U[iIDX(i)][n];
   }
 }
 
 void Particles::RK1Step(map_t & bssn_fields)
 {
-  _timer["Particles::RKCalcs"].start();
-  PARTICLES_PARALLEL_LOOP(pr)
+  if(use_primitives_grid)
+    computePrimitivesGrid(bssn_fields, true);
+
+  ctx->timer["Particles::RKCalcs"].start();
+  PARTICLES_PARALLEL_LOOP(n)
   {
-    RKStep(& (*pr), dt/2.0, 1.0, bssn_fields);
+    RKStep(n, ctx->dt/2.0, 1.0, bssn_fields);
   }
-  _timer["Particles::RKCalcs"].stop();
+  ctx->timer["Particles::RKCalcs"].stop();
 }
 
 void Particles::RK2Step(map_t & bssn_fields)
 {
-  _timer["Particles::RKCalcs"].start();
-  PARTICLES_PARALLEL_LOOP(pr)
+  if(use_primitives_grid)
+    computePrimitivesGrid(bssn_fields, true);
+
+  ctx->timer["Particles::RKCalcs"].start();
+  PARTICLES_PARALLEL_LOOP(n)
   {
-    RKStep(& (*pr), dt/2.0, 2.0, bssn_fields);
+    RKStep(n, ctx->dt/2.0, 2.0, bssn_fields);
   }
-  _timer["Particles::RKCalcs"].stop();
+  ctx->timer["Particles::RKCalcs"].stop();
 }
 
 void Particles::RK3Step(map_t & bssn_fields)
 {
-  _timer["Particles::RKCalcs"].start();
-  PARTICLES_PARALLEL_LOOP(pr)
+  if(use_primitives_grid)
+    computePrimitivesGrid(bssn_fields, true);
+
+  ctx->timer["Particles::RKCalcs"].start();
+  PARTICLES_PARALLEL_LOOP(n)
   {
-    RKStep(& (*pr), dt, 1.0, bssn_fields);
+    RKStep(n, ctx->dt, 1.0, bssn_fields);
   }
-  _timer["Particles::RKCalcs"].stop();
+  ctx->timer["Particles::RKCalcs"].stop();
 }
 
 void Particles::RK4Step(map_t & bssn_fields)
 {
-  _timer["Particles::RKCalcs"].start();
-  PARTICLES_PARALLEL_LOOP(pr)
+  if(use_primitives_grid)
+    computePrimitivesGrid(bssn_fields, true);
+
+  ctx->timer["Particles::RKCalcs"].start();
+  PARTICLES_PARALLEL_LOOP(n)
   {
-    RKStep(& (*pr), dt/2.0, 1.0, bssn_fields);
+    RKStep(n, ctx->dt/2.0, 1.0, bssn_fields);
   }
-  _timer["Particles::RKCalcs"].stop();
+  ctx->timer["Particles::RKCalcs"].stop();
 }
 
-void Particles::stepInit(map_t & bssn_fields)
+/**
+ * @brief      Interleave the bits of a cell index into a Morton (Z-order) key
+ */
+idx_t Particles::getMortonKey(idx_t i, idx_t j, idx_t k)
 {
-  _timer["Particles::RKCalcs"].start();
-  PARTICLES_PARALLEL_LOOP(pr)
+  return morton_key(i, j, k, PARTICLES_MORTON_BITS);
+}
+
+/**
+ * @brief      Order grid cells along the Morton curve, storing the rank of
+ *  each cell (by NP_INDEX) in cell_morton_rank.
+ */
+void Particles::initCellOrdering()
+{
+  std::vector< std::pair<idx_t, idx_t> > keys(POINTS);
+  idx_t i, j, k;
+# pragma omp parallel for default(shared) private(i, j, k)
+  LOOP3(i, j, k)
   {
-    pr->p_c = pr->p_p;
-    pr->p_a = pr->p_p;
-    pr->p_f = {0};
+    idx_t idx = NP_INDEX(i,j,k);
+    keys[idx] = std::make_pair(getMortonKey(i, j, k), idx);
   }
-  _timer["Particles::RKCalcs"].stop();
+  std::sort(keys.begin(), keys.end());
+
+  cell_morton_rank.resize(POINTS);
+  for(idx_t r=0; r<POINTS; ++r)
+    cell_morton_rank[keys[r].second] = r;
 }
 
-void Particles::regSwap_c_a()
+/**
+ * @brief      Spatially sort particles along a Morton curve
+ * @details    Particles are ordered by the cell containing their _p
+ *  position, with cells visited in Morton order, so that particles close
+ *  in memory are close on the grid. A counting sort over cells is used
+ *  (linear in the number of particles and cells), which also records where
+ *  each cell's particles begin; see getCellRange. All registers are
+ *  permuted together.
+ */
+void Particles::sortParticles()
 {
-  _timer["Particles::RKCalcs"].start();
-  PARTICLES_PARALLEL_LOOP(pr)
+  ctx->timer["Particles::sort"].start();
+
+  if(cell_morton_rank.empty())
+    initCellOrdering();
+
+  idx_t n_particles = particles->size();
+  ParticleArrays<real_t> & p_p = particles->p_p;
+
+  sort_key.resize(n_particles);
+  idx_t n;
+# pragma omp parallel for
+  for(n=0; n<n_particles; ++n)
   {
-    std::swap(pr->p_c, pr->p_a);
+    idx_t i = idx_t_mod(getIndexBelow(p_p.X[0][n]), NX);
+    idx_t j = idx_t_mod(getIndexBelow(p_p.X[1][n]), NY);
+    idx_t k = idx_t_mod(getIndexBelow(p_p.X[2][n]), NZ);
+    sort_key[n] = cell_morton_rank[NP_INDEX(i,j,k)];
   }
-  _timer["Particles::RKCalcs"].stop();
+
+  cell_start.assign(POINTS+1, 0);
+  for(n=0; n<n_particles; ++n)
+    cell_start[sort_key[n]+1]++;
+  for(idx_t r=0; r<POINTS; ++r)
+    cell_start[r+1] += cell_start[r];
+
+  std::vector<idx_t> fill(cell_start.begin(), cell_start.end()-1);
+  sort_order.resize(n_particles);
+  for(n=0; n<n_particles; ++n)
+    sort_order[fill[sort_key[n]]++] = n;
+
+  particles->permute(sort_order);
+  steps_since_sort = 0;
+
+  ctx->timer["Particles::sort"].stop();
 }
 
-void Particles::stepTerm()
+/**
+ * @brief      Get the range [begin, end) of particles in cell (i, j, k)
+ * @details    Ranges refer to _p positions at the most recent sort; the
+ *  particles are sorted first if they have not been since being added.
+ */
+void Particles::getCellRange(idx_t i, idx_t j, idx_t k, idx_t & begin, idx_t & end)
 {
-  _timer["Particles::RKCalcs"].start();
-  PARTICLES_PARALLEL_LOOP(pr)
-  {
-    Particle<real_t> & p_p = pr->p_p;
-    Particle<real_t> & p_f = pr->p_f;
+  if((idx_t) cell_start.size() != POINTS+1)
+    sortParticles();
 
+  idx_t r = cell_morton_rank[INDEX(i,j,k)];
+  begin = cell_start[r];
+  end = cell_start[r+1];
+}
+
+void Particles::stepInit(map_t & bssn_fields)
+{
+  if(sort_interval > 0 &&
+      ((idx_t) cell_start.size() != POINTS+1 || steps_since_sort >= sort_interval))
+    sortParticles();
+  steps_since_sort++;
+
+  ctx->timer["Particles::RKCalcs"].start();
+  ParticleArrays<real_t> & p_p = particles->p_p;
+  ParticleArrays<real_t> & p_a = particles->p_a;
+  ParticleArrays<real_t> & p_c = particles->p_c;
+  ParticleArrays<real_t> & p_f = particles->p_f;
+  PARTICLES_PARALLEL_LOOP(n)
+  {
     for(int i=0; i<3; i++)
     {
-      p_p.X[i] = p_f.X[i]/3.0 - 2.0/3.0*p_p.X[i];
-      p_p.U[i] = p_f.U[i]/3.0 - 2.0/3.0*p_p.U[i];
+      p_a.X[i][n] = p_c.X[i][n] = p_p.X[i][n];
+      p_a.U[i][n] = p_c.U[i][n] = p_p.U[i][n];
+      p_f.X[i][n] = 0;
+      p_f.U[i][n] = 0;
+    }
+    p_a.M[n] = p_c.M[n] = p_p.M[n];
+    p_f.M[n] = 0;
+  }
+  ctx->timer["Particles::RKCalcs"].stop();
+}
+
+void Particles::regSwap_c_a()
+{
+  // registers are swapped wholesale
+  std::swap(particles->p_c, particles->p_a);
+}
+
+void Particles::stepTerm()
+{
+  ctx->timer["Particles::RKCalcs"].start();
+  ParticleArrays<real_t> & p_p = particles->p_p;
+  ParticleArrays<real_t> & p_f = particles->p_f;
+  for(int i=0; i<3; i++)
+  {
+    real_t * X_p = p_p.X[i].data(), * U_p = p_p.U[i].data();
+    const real_t * X_f = p_f.X[i].data(), * U_f = p_f.U[i].data();
+    PARTICLES_PARALLEL_LOOP(n)
+    {
+      X_p[n] = X_f[n]/3.0 - 2.0/3.0*X_p[n];
+      U_p[n] = U_f[n]/3.0 - 2.0/3.0*U_p[n];
     }
   }
-  _timer["Particles::RKCalcs"].stop();
+  ctx->timer["Particles::RKCalcs"].stop();
 }
 
 real_t Particles::getKernelWeight(real_t r, real_t r_s)
@@ -533,13 +745,380 @@ real_t Particles::getKernelWeight(real_t r, real_t r_s)
   return weight;
 }
 
+/**
+ * @brief      Number of gridpoints the deposition kernel extends below a
+ *  particle's cell; it extends one further above.
+ */
+idx_t Particles::getKernelWidth(real_t r_s)
+{
+  // cubic interpolant with kernel of characteristic "softening" radius r_s and maximum width w_k
+  // eg, Eq. 12.2: http://www.ita.uni-heidelberg.de/~dullemond/lectures/num_fluid_2011/Chapter_12.pdf
+  real_t w_k = r_s*2.0;
+  return (idx_t) (w_k + 1.0);
+}
+
+/**
+ * @brief      Compute normalized kernel weights for a particle
+ * @details    Weights for the (2*w_idx+2)^3 gridpoints starting at
+ *  (x_idx-w_idx, y_idx-w_idx, z_idx-w_idx) are stored with z varying
+ *  fastest, and sum to one to ensure conservation of mass.
+ */
+void Particles::computeKernelWeights(Particle<real_t> & p, real_t r_s,
+  idx_t w_idx, real_t * weights)
+{
+  idx_t x_idx = (idx_t) std::floor(p.X[0]/ctx->dx);
+  idx_t y_idx = (idx_t) std::floor(p.X[1]/ctx->dx);
+  idx_t z_idx = (idx_t) std::floor(p.X[2]/ctx->dx);
+
+  idx_t n = 0;
+  real_t total_weight = 0.0;
+  for(idx_t x=x_idx-w_idx; x<=x_idx+w_idx+1; ++x)
+    for(idx_t y=y_idx-w_idx; y<=y_idx+w_idx+1; ++y)
+      for(idx_t z=z_idx-w_idx; z<=z_idx+w_idx+1; ++z)
+      {
+        real_t r = std::sqrt( pw2(x - p.X[0]/ctx->dx) + pw2(y - p.X[1]/ctx->dx) + pw2(z - p.X[2]/ctx->dx) );
+        weights[n] = getKernelWeight(r, r_s);
+        total_weight += weights[n];
+        ++n;
+      }
+
+  for(idx_t m=0; m<n; ++m)
+    weights[m] /= total_weight;
+}
+
+/**
+ * @brief      Extent of the deposition footprint of a particle, relative to
+ *  the cell containing it: deposits lie in [cell - lo, cell - lo + span)
+ *  along each direction.
+ */
+void Particles::getDepositFootprint(real_t r_s, idx_t & lo, idx_t & span)
+{
+  switch (deposit)
+  {
+    case NGP:
+    case CIC:
+      lo = 0;
+      span = 2;
+      break;
+    case TSC:
+    case PCS:
+      lo = 1;
+      span = 4;
+      break;
+    case KERNEL:
+    default:
+      lo = getKernelWidth(r_s);
+      span = 2*lo + 2;
+      break;
+  }
+}
+
+/**
+ * @brief      Compute deposition weights for a particle
+ * @details    For the separable schemes (NGP, CIC, TSC, PCS), 1D weights
+ *  are evaluated once along each axis and combined; these sum to one
+ *  without further normalization. Otherwise the spherical kernel of
+ *  computeKernelWeights is used.
+ *
+ * @param[out] cell     Cell containing the particle (unwrapped)
+ * @param[out] start    First gridpoint deposited to (unwrapped)
+ * @param[out] weights  Weights for the n^3 points starting at start, with z
+ *  varying fastest
+ *
+ * @return     Number of points n deposited to along each direction
+ */
+idx_t Particles::computeDepositWeights(Particle<real_t> & p, real_t r_s,
+  idx_t cell[3], idx_t start[3], real_t * weights)
+{
+  if(deposit == KERNEL)
+  {
+    idx_t w_idx = getKernelWidth(r_s);
+    for(int d=0; d<3; ++d)
+    {
+      cell[d] = (idx_t) std::floor(p.X[d]/ctx->dx);
+      start[d] = cell[d] - w_idx;
+    }
+    computeKernelWeights(p, r_s, w_idx, weights);
+    return 2*w_idx + 2;
+  }
+
+  idx_t n = 1;
+  real_t w[3][4];
+  for(int d=0; d<3; ++d)
+  {
+    real_t u = p.X[d]/ctx->dx;
+    cell[d] = (idx_t) std::floor(u);
+    real_t f = u - cell[d];
+
+    switch (deposit)
+    {
+      case NGP:
+        n = 1;
+        start[d] = cell[d] + (f < 0.5 ? 0 : 1);
+        w[d][0] = 1.0;
+        break;
+      case CIC:
+        n = 2;
+        start[d] = cell[d];
+        w[d][0] = 1.0 - f;
+        w[d][1] = f;
+        break;
+      case TSC:
+      {
+        n = 3;
+        // offset from the nearest gridpoint, in [-1/2, 1/2)
+        real_t g = f < 0.5 ? f : f - 1.0;
+        start[d] = cell[d] - 1 + (f < 0.5 ? 0 : 1);
+        w[d][0] = 0.5*pw2(0.5 - g);
+        w[d][1] = 0.75 - g*g;
+        w[d][2] = 0.5*pw2(0.5 + g);
+        break;
+      }
+      case PCS:
+      default:
+        n = 4;
+        start[d] = cell[d] - 1;
+        w[d][0] = pw2(1.0 - f)*(1.0 - f)/6.0;
+        w[d][1] = (4.0 - 6.0*f*f + 3.0*f*f*f)/6.0;
+        w[d][2] = (4.0 - 6.0*pw2(1.0 - f) + 3.0*pw2(1.0 - f)*(1.0 - f))/6.0;
+        w[d][3] = f*f*f/6.0;
+        break;
+    }
+  }
+
+  idx_t m = 0;
+  for(idx_t a=0; a<n; ++a)
+    for(idx_t b=0; b<n; ++b)
+    {
+      real_t wab = w[0][a]*w[1][b];
+      for(idx_t c=0; c<n; ++c)
+        weights[m++] = wab*w[2][c];
+    }
+
+  return n;
+}
+
+/**
+ * @brief      Compute the PARTICLES_N_SOURCES source values of a particle
+ *  (STF components are not yet trace-free)
+ */
+void Particles::computeParticleSources(Particle<real_t> & p_a,
+  map_t & bssn_fields, real_t * src)
+{
+  ParticleMetricPrimitives<real_t> pp_a = use_primitives_grid ?
+    samplePrimitivesGrid(& p_a, false) : getInterpolatedPrimitivesIncomplete(& p_a, bssn_fields);
+
+  real_t W = std::sqrt( 1.0 + 
+      pp_a.gi[aIDX(1,1)]*p_a.U[0]*p_a.U[0] + pp_a.gi[aIDX(2,2)]*p_a.U[1]*p_a.U[1] + pp_a.gi[aIDX(3,3)]*p_a.U[2]*p_a.U[2]
+      + 2.0*( pp_a.gi[aIDX(1,2)]*p_a.U[0]*p_a.U[1] + pp_a.gi[aIDX(1,3)]*p_a.U[0]*p_a.U[2] + pp_a.gi[aIDX(2,3)]*p_a.U[1]*p_a.U[2] )
+    );
+  real_t MnA = p_a.M / W / ctx->dx/ctx->dx/ctx->dx / pp_a.rootdetg;
+
+  real_t rho = MnA*W*W;
+  src[0] = rho;
+  src[1] = rho - MnA;
+  src[2] = MnA*W*p_a.U[0];
+  src[3] = MnA*W*p_a.U[1];
+  src[4] = MnA*W*p_a.U[2];
+  src[5] = MnA*p_a.U[0]*p_a.U[0];
+  src[6] = MnA*p_a.U[0]*p_a.U[1];
+  src[7] = MnA*p_a.U[0]*p_a.U[2];
+  src[8] = MnA*p_a.U[1]*p_a.U[1];
+  src[9] = MnA*p_a.U[1]*p_a.U[2];
+  src[10] = MnA*p_a.U[2]*p_a.U[2];
+}
+
+/**
+ * @brief      Counting sort of particles by deposit_key into n_buckets
+ *  buckets; fills deposit_order and deposit_bucket_start.
+ */
+void Particles::sortDepositBuckets(idx_t n_buckets)
+{
+  idx_t n_particles = particles->size();
+  deposit_bucket_start.assign(n_buckets+1, 0);
+  for(idx_t n=0; n<n_particles; ++n)
+    deposit_bucket_start[deposit_key[n]+1]++;
+  for(idx_t b=0; b<n_buckets; ++b)
+    deposit_bucket_start[b+1] += deposit_bucket_start[b];
+
+  std::vector<idx_t> fill(deposit_bucket_start.begin(), deposit_bucket_start.end()-1);
+  deposit_order.resize(n_particles);
+  for(idx_t n=0; n<n_particles; ++n)
+    deposit_order[fill[deposit_key[n]]++] = n;
+}
+
+/**
+ * @brief      Deposit particle sources using per-thread private slabs
+ * @details    Particles are sorted by x-plane and split into contiguous
+ *  chunks, one per thread, so each thread accumulates into a private slab
+ *  of planes covering only its chunk's footprint. Slabs are then summed
+ *  into the grid in parallel over planes.
+ */
+void Particles::depositPrivateTiles(real_t ** fields, real_t r_s)
+{
+  idx_t n_particles = particles->size();
+  idx_t w_lo, w_span;
+  getDepositFootprint(r_s, w_lo, w_span);
+
+  deposit_key.resize(n_particles);
+  idx_t n;
+# pragma omp parallel for
+  for(n=0; n<n_particles; ++n)
+    deposit_key[n] = idx_t_mod((idx_t) std::floor(particles->p_a.X[0][n]/ctx->dx), NX);
+  sortDepositBuckets(NX);
+
+  int max_threads = omp_get_max_threads();
+  deposit_slabs.resize(max_threads);
+  deposit_slab_lo.assign(max_threads, 0);
+  deposit_slab_span.assign(max_threads, 0);
+
+# pragma omp parallel
+  {
+    int t = omp_get_thread_num(), n_threads = omp_get_num_threads();
+    idx_t begin = n_particles*t/n_threads, end = n_particles*(t+1)/n_threads;
+
+    // slab of planes [lo, lo+span) (unwrapped) covers all particles' footprints
+    idx_t lo = 0, span = 0;
+    if(end > begin)
+    {
+      lo = deposit_key[deposit_order[begin]] - w_lo;
+      span = deposit_key[deposit_order[end-1]] - deposit_key[deposit_order[begin]] + w_span;
+    }
+    deposit_slab_lo[t] = lo;
+    deposit_slab_span[t] = span;
+
+    idx_t slab_pts = span*NY*NZ;
+    std::vector<real_t> & slab = deposit_slabs[t];
+    slab.assign(PARTICLES_N_SOURCES*slab_pts, 0.0);
+    std::vector<real_t> weights(w_span*w_span*w_span);
+
+    for(idx_t m=begin; m<end; ++m)
+    {
+      idx_t id = deposit_order[m];
+      Particle<real_t> p_a = particles->p_a.get(id);
+      const real_t * src = &deposit_src[PARTICLES_N_SOURCES*id];
+      idx_t cell[3], start[3];
+      idx_t w_pts = computeDepositWeights(p_a, r_s, cell, start, &weights[0]);
+
+      idx_t xs0 = deposit_key[id] + start[0] - cell[0] - lo;
+
+      idx_t w = 0;
+      for(idx_t a=0; a<w_pts; ++a)
+        for(idx_t b=0; b<w_pts; ++b)
+        {
+          idx_t yz0 = ((xs0 + a)*NY + idx_t_mod(start[1] + b, NY))*NZ;
+          for(idx_t c=0; c<w_pts; ++c)
+          {
+            idx_t idx = yz0 + idx_t_mod(start[2] + c, NZ);
+            real_t weight = weights[w++];
+            for(idx_t f=0; f<PARTICLES_N_SOURCES; ++f)
+              slab[f*slab_pts + idx] += weight*src[f];
+          }
+        }
+    }
+
+#   pragma omp barrier
+
+    // sum slabs into the grid, plane by plane
+#   pragma omp for
+    for(idx_t X=0; X<NX; ++X)
+      for(int t2=0; t2<n_threads; ++t2)
+      {
+        idx_t span2 = deposit_slab_span[t2];
+        idx_t slab2_pts = span2*NY*NZ;
+        const real_t * slab2 = deposit_slabs[t2].data();
+        for(idx_t xs = idx_t_mod(X - deposit_slab_lo[t2], NX); xs < span2; xs += NX)
+          for(idx_t f=0; f<PARTICLES_N_SOURCES; ++f)
+            for(idx_t yz=0; yz<NY*NZ; ++yz)
+              fields[f][X*NY*NZ + yz] += slab2[f*slab2_pts + xs*NY*NZ + yz];
+      }
+  }
+}
+
+/**
+ * @brief      Deposit particle sources directly into the grid, processing
+ *  spatial tiles in 8 colors so that no two tiles deposited concurrently
+ *  have overlapping footprints.
+ * @details    Tiles are at least as wide as the deposition footprint and
+ *  there is an even number of them along each colored direction, so tiles
+ *  of the same color are separated by at least one tile (periodically as
+ *  well).
+ *
+ * @return     false if the grid is too small for tiling; nothing is
+ *  deposited in that case.
+ */
+bool Particles::depositColoredTiles(real_t ** fields, real_t r_s)
+{
+  idx_t n_particles = particles->size();
+  idx_t w_lo, w_span;
+  getDepositFootprint(r_s, w_lo, w_span);
+
+  idx_t ntx = NX >= 2*w_span ? 2*(NX/(2*w_span)) : 1;
+  idx_t nty = NY >= 2*w_span ? 2*(NY/(2*w_span)) : 1;
+  idx_t ntz = NZ >= 2*w_span ? 2*(NZ/(2*w_span)) : 1;
+  if(ntx == 1 && nty == 1 && ntz == 1)
+    return false;
+  idx_t n_tiles = ntx*nty*ntz;
+
+  deposit_key.resize(n_particles);
+  idx_t n;
+# pragma omp parallel for
+  for(n=0; n<n_particles; ++n)
+  {
+    const ParticleArrays<real_t> & p_a = particles->p_a;
+    idx_t tx = idx_t_mod((idx_t) std::floor(p_a.X[0][n]/ctx->dx), NX)*ntx/NX;
+    idx_t ty = idx_t_mod((idx_t) std::floor(p_a.X[1][n]/ctx->dx), NY)*nty/NY;
+    idx_t tz = idx_t_mod((idx_t) std::floor(p_a.X[2][n]/ctx->dx), NZ)*ntz/NZ;
+    deposit_key[n] = (tx*nty + ty)*ntz + tz;
+  }
+  sortDepositBuckets(n_tiles);
+
+  for(idx_t color=0; color<8; ++color)
+  {
+#   pragma omp parallel
+    {
+      std::vector<real_t> weights(w_span*w_span*w_span);
+
+#     pragma omp for schedule(dynamic)
+      for(idx_t tile=0; tile<n_tiles; ++tile)
+      {
+        idx_t tz = tile % ntz, ty = (tile/ntz) % nty, tx = tile/ntz/nty;
+        if( (tx%2)*4 + (ty%2)*2 + tz%2 != color )
+          continue;
+
+        for(idx_t m=deposit_bucket_start[tile]; m<deposit_bucket_start[tile+1]; ++m)
+        {
+          idx_t id = deposit_order[m];
+          Particle<real_t> p_a = particles->p_a.get(id);
+          const real_t * src = &deposit_src[PARTICLES_N_SOURCES*id];
+          idx_t cell[3], start[3];
+          idx_t w_pts = computeDepositWeights(p_a, r_s, cell, start, &weights[0]);
+
+          idx_t w = 0;
+          for(idx_t x=start[0]; x<start[0]+w_pts; ++x)
+            for(idx_t y=start[1]; y<start[1]+w_pts; ++y)
+              for(idx_t z=start[2]; z<start[2]+w_pts; ++z)
+              {
+                idx_t idx = NP_INDEX( idx_t_mod(x,NX), idx_t_mod(y,NY), idx_t_mod(z,NZ) );
+                real_t weight = weights[w++];
+                for(idx_t f=0; f<PARTICLES_N_SOURCES; ++f)
+                  fields[f][idx] += weight*src[f];
+              }
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
 /**
  * Set bssn _a source registers
  * using data from particle _c register
  */
-void Particles::addParticlesToBSSNSrc(BSSN * bssnSim)
+void Particles::addParticlesToBSSNSrc(BSSN * bssnSim, Fourier * fourier)
 {
-  _timer["Particles::addToBSSNSrc"].start();
+  ctx->timer["Particles::addToBSSNSrc"].start();
 
   // matter / source fields
   // will always be setting _a register from _a register
@@ -556,73 +1135,42 @@ void Particles::addParticlesToBSSNSrc(BSSN * bssnSim)
   arr_t & STF33_a = *bssnSim->fields["STF33_a"];
 
   // smoothing radius
-  real_t r_s = std::stod(_config("smoothing_radius", "1.5")); // units of dx
-
-  PARTICLES_PARALLEL_LOOP(pr)
+  real_t r_s = std::stod(ctx->config("smoothing_radius", "1.5")); // units of dx
+  std::string strategy = ctx->config("particle_deposit_strategy", "private");
+
+  // source values are computed once per particle, then deposited using
+  // either strategy without locks or atomics
+  if(use_primitives_grid)
+    computePrimitivesGrid(bssnSim->fields, false);
+
+  idx_t n_particles = particles->size();
+  deposit_src.resize(PARTICLES_N_SOURCES*n_particles);
+  idx_t n;
+# pragma omp parallel for
+  for(n=0; n<n_particles; ++n)
   {
-    Particle<real_t> & p_a = pr->p_a;
-    ParticleMetricPrimitives<real_t> pp_a = getInterpolatedPrimitivesIncomplete(& p_a, bssnSim->fields);
-
-    real_t W = std::sqrt( 1.0 + 
-        pp_a.gi[aIDX(1,1)]*p_a.U[0]*p_a.U[0] + pp_a.gi[aIDX(2,2)]*p_a.U[1]*p_a.U[1] + pp_a.gi[aIDX(3,3)]*p_a.U[2]*p_a.U[2]
-        + 2.0*( pp_a.gi[aIDX(1,2)]*p_a.U[0]*p_a.U[1] + pp_a.gi[aIDX(1,3)]*p_a.U[0]*p_a.U[2] + pp_a.gi[aIDX(2,3)]*p_a.U[1]*p_a.U[2] )
-      );
-    real_t MnA = p_a.M / W / dx/dx/dx / pp_a.rootdetg;
-
-    real_t rho = MnA*W*W;
-    real_t S = rho - MnA;
-    real_t S_1 = MnA*W*p_a.U[0];
-    real_t S_2 = MnA*W*p_a.U[1];
-    real_t S_3 = MnA*W*p_a.U[2];
-
-    // cubic interpolant with kernel of characteristic "softening" radius r_s and maximum width w_k
-    // eg, Eq. 12.2: http://www.ita.uni-heidelberg.de/~dullemond/lectures/num_fluid_2011/Chapter_12.pdf
-    real_t w_k = r_s*2.0;
-    idx_t w_idx = (idx_t) (w_k + 1.0);
-    
-    // distribute mass to nearby gridpoints
-    idx_t x_idx = (idx_t) (p_a.X[0]/dx);
-    idx_t y_idx = (idx_t) (p_a.X[1]/dx);
-    idx_t z_idx = (idx_t) (p_a.X[2]/dx);
-
-    // ensure conservation of mass
-    real_t total_weight = 0.0;
-    for(idx_t x=x_idx-w_idx; x<=x_idx+w_idx+1; ++x)
-      for(idx_t y=y_idx-w_idx; y<=y_idx+w_idx+1; ++y)
-        for(idx_t z=z_idx-w_idx; z<=z_idx+w_idx+1; ++z)
-        {
-          real_t r = std::sqrt( pw2(x - p_a.X[0]/dx) + pw2(y - p_a.X[1]/dx) + pw2(z - p_a.X[2]/dx) );
-          total_weight += getKernelWeight(r, r_s);
-        }
-
-#   pragma omp critical
-    {
-      for(idx_t x=x_idx-w_idx; x<=x_idx+w_idx+1; ++x)
-        for(idx_t y=y_idx-w_idx; y<=y_idx+w_idx+1; ++y)
-          for(idx_t z=z_idx-w_idx; z<=z_idx+w_idx+1; ++z)
-      {
-        idx_t idx = NP_INDEX( idx_t_mod(x,NX), idx_t_mod(y,NY), idx_t_mod(z,NZ) );
-
-        real_t r = std::sqrt( pw2(x - p_a.X[0]/dx) + pw2(y - p_a.X[1]/dx) + pw2(z - p_a.X[2]/dx) );
-        real_t weight = getKernelWeight(r, r_s) / total_weight;
+    Particle<real_t> p_a = particles->p_a.get(n);
+    computeParticleSources(p_a, bssnSim->fields,
+      &deposit_src[PARTICLES_N_SOURCES*n]);
+  }
 
-        DIFFr_a[idx] += weight*rho;
-        DIFFS_a[idx] += weight*S;
+  real_t * fields[PARTICLES_N_SOURCES] = {
+    DIFFr_a._array, DIFFS_a._array, S1_a._array, S2_a._array, S3_a._array,
+    STF11_a._array, STF12_a._array, STF13_a._array,
+    STF22_a._array, STF23_a._array, STF33_a._array
+  };
 
-        S1_a[idx] += weight*S_1;
-        S2_a[idx] += weight*S_2;
-        S3_a[idx] += weight*S_3;
+  if(strategy != "colored" || !depositColoredTiles(fields, r_s))
+    depositPrivateTiles(fields, r_s);
 
-        // Not yet trace-free
-        STF11_a[idx] += weight*(MnA*p_a.U[0]*p_a.U[0]);
-        STF12_a[idx] += weight*(MnA*p_a.U[0]*p_a.U[1]);
-        STF13_a[idx] += weight*(MnA*p_a.U[0]*p_a.U[2]);
-        STF22_a[idx] += weight*(MnA*p_a.U[1]*p_a.U[1]);
-        STF23_a[idx] += weight*(MnA*p_a.U[1]*p_a.U[2]);
-        STF33_a[idx] += weight*(MnA*p_a.U[2]*p_a.U[2]);
-      }
-    } // end loop over nearby indexes 
-  } // end particles loop
+  // remove the assignment window (separable schemes only)
+  if(deconvolve_deposit && deposit != KERNEL && fourier != nullptr)
+  {
+    ctx->timer["Particles::deconvolve"].start();
+    for(idx_t f=0; f<PARTICLES_N_SOURCES; ++f)
+      fourier->deconvolveWindow<idx_t, real_t>(fields[f], (int) deposit);
+    ctx->timer["Particles::deconvolve"].stop();
+  }
 
   // ensure STF is trace-free
   idx_t i, j, k;
@@ -632,7 +1180,7 @@ void Particles::addParticlesToBSSNSrc(BSSN * bssnSim)
     idx_t idx = NP_INDEX(i,j,k);
 
     BSSNData bd = {0};
-    bssnSim->set_bd_values(i, j, k, &bd);
+    bssnSim->set_bd_values<BD_LOCAL>(i, j, k, &bd);
     real_t trS = exp(-4.0*bd.phi)*(
         STF11_a[idx]*bd.gammai11 + STF22_a[idx]*bd.gammai22 + STF33_a[idx]*bd.gammai33
         + 2.0*(STF12_a[idx]*bd.gammai12 + STF13_a[idx]*bd.gammai13 + STF23_a[idx]*bd.gammai23)
@@ -647,7 +1195,7 @@ void Particles::addParticlesToBSSNSrc(BSSN * bssnSim)
   }
 
 
-  _timer["Particles::addToBSSNSrc"].stop();
+  ctx->timer["Particles::addToBSSNSrc"].stop();
 }
 
 } /* namespace cosmo */
@@ -5,6 +5,7 @@
 #include "../../cosmo_includes.h"
 #include "particles_data.h"
 #include "../bssn/bssn.h"
+#include "../../utils/Fourier.h"
 
 namespace cosmo
 {
@@ -17,12 +18,45 @@ namespace cosmo
  */
 class Particles
 {
+  SimContext * ctx; ///< context of the simulation
+
   // list of particle registers
   particle_vec * particles;
 
+  // metric primitives on the grid, recomputed each RK substep
+  bool use_primitives_grid;
+  ParticlePrimitivesGrid<real_t> primitives_grid;
+
+  // mass assignment
+  enum depositScheme { KERNEL = 0, NGP = 1, CIC = 2, TSC = 3, PCS = 4 }; ///< separable schemes by order
+  depositScheme deposit;
+  bool deconvolve_deposit;
+
+  // scratch space for depositing particles to the grid
+  std::vector<real_t> deposit_src; ///< PARTICLES_N_SOURCES values per particle
+  std::vector<idx_t> deposit_key; ///< bucket (x-plane or tile) of each particle
+  std::vector<idx_t> deposit_order; ///< particle ids, sorted by bucket
+  std::vector<idx_t> deposit_bucket_start;
+  std::vector< std::vector<real_t> > deposit_slabs; ///< per-thread accumulators
+  std::vector<idx_t> deposit_slab_lo, deposit_slab_span;
+
+  // spatial ordering of particles
+  idx_t sort_interval; ///< sort particles every sort_interval steps (0: never)
+  idx_t steps_since_sort;
+  std::vector<idx_t> cell_morton_rank; ///< position of each cell along the curve
+  std::vector<idx_t> cell_start; ///< first particle in each cell, by rank
+  std::vector<idx_t> sort_key, sort_order;
+
+  static idx_t getMortonKey(idx_t i, idx_t j, idx_t k);
+  void initCellOrdering();
+
+  void sortDepositBuckets(idx_t n_buckets);
+  void depositPrivateTiles(real_t ** fields, real_t r_s);
+  bool depositColoredTiles(real_t ** fields, real_t r_s);
+
 public:
   
-  Particles();
+  Particles(SimContext * ctx_in);
   ~Particles();
 
   void init(idx_t n_particles);
@@ -47,26 +81,44 @@ public:
     real_t x_d[3] /* normalized position within cube */
     );
 
+  ParticleMetricPrimitives<real_t> getPrimitivesAtPoint(
+    ParticlePrimitiveFields & f, idx_t x_idx, idx_t y_idx, idx_t z_idx,
+    bool complete);
+
   ParticleMetricPrimitives<real_t> getInterpolatedPrimitivesIncomplete(
     Particle<real_t> * p, map_t & bssn_fields);
 
   ParticleMetricPrimitives<real_t> getInterpolatedPrimitives(
     Particle<real_t> * p, map_t & bssn_fields);
 
-  void RKStep(ParticleRegister<real_t> * pr, real_t h, real_t RK_sum_coeff,
-    map_t & bssn_fields);
+  void computePrimitivesGrid(map_t & bssn_fields, bool complete);
+  ParticleMetricPrimitives<real_t> samplePrimitivesGrid(Particle<real_t> * p,
+    bool complete);
+
+  void RKStep(idx_t n, real_t h, real_t RK_sum_coeff, map_t & bssn_fields);
 
   void RK1Step(map_t & bssn_fields);
   void RK2Step(map_t & bssn_fields);
   void RK3Step(map_t & bssn_fields);
   void RK4Step(map_t & bssn_fields);
 
+  void sortParticles();
+  void getCellRange(idx_t i, idx_t j, idx_t k, idx_t & begin, idx_t & end);
+
   void stepInit(map_t & bssn_fields);
   void regSwap_c_a();
   void stepTerm();
 
   real_t getKernelWeight(real_t r, real_t r_s);
-  void addParticlesToBSSNSrc(BSSN * bssnSim);
+  idx_t getKernelWidth(real_t r_s);
+  void computeKernelWeights(Particle<real_t> & p, real_t r_s, idx_t w_idx,
+    real_t * weights);
+  void getDepositFootprint(real_t r_s, idx_t & lo, idx_t & span);
+  idx_t computeDepositWeights(Particle<real_t> & p, real_t r_s,
+    idx_t cell[3], idx_t start[3], real_t * weights);
+  void computeParticleSources(Particle<real_t> & p, map_t & bssn_fields,
+    real_t * src);
+  void addParticlesToBSSNSrc(BSSN * bssnSim, Fourier * fourier = nullptr);
   void addParticleToBSSNSrc(Particle<real_t> * p_c, map_t & bssn_fields);
 };
 
@@ -1,6 +1,10 @@
 #ifndef COSMO_PARTICLES_DATA
 #define COSMO_PARTICLES_DATA
 
+#include <vector>
+#include <new>
+#include <cstdlib>
+
 namespace cosmo
 {
 
@@ -17,23 +21,167 @@ struct Particle {
   RT M;        // Particle Mass
 };
 
+/**
+ * @brief Allocator returning memory aligned to Alignment bytes, so that
+ *  particle arrays can be loaded with aligned SIMD instructions.
+ */
+template<typename T, std::size_t Alignment>
+struct AlignedAllocator {
+  typedef T value_type;
+  template<typename U> struct rebind { typedef AlignedAllocator<U, Alignment> other; };
+
+  AlignedAllocator() {}
+  template<typename U> AlignedAllocator(const AlignedAllocator<U, Alignment> &) {}
+
+  T * allocate(std::size_t n)
+  {
+    void * ptr = nullptr;
+    if(posix_memalign(&ptr, Alignment, n*sizeof(T) > 0 ? n*sizeof(T) : Alignment) != 0)
+      throw std::bad_alloc();
+    return static_cast<T *>(ptr);
+  }
+  void deallocate(T * ptr, std::size_t) { free(ptr); }
+
+  template<typename U>
+  bool operator==(const AlignedAllocator<U, Alignment> &) const { return true; }
+  template<typename U>
+  bool operator!=(const AlignedAllocator<U, Alignment> &) const { return false; }
+};
+
+#define PARTICLES_ALIGNMENT 64
+
+/**
+ * @brief Structure-of-arrays storage for one register of particles
+ * @details Each component (X[0..2], U[0..2], M) is a separate contiguous,
+ *  64-byte aligned array, so loops over particles stream only the
+ *  components they use.
+ *
+ * @tparam RT simulation real type
+ */
+template<typename RT>
+struct ParticleArrays {
+  typedef std::vector<RT, AlignedAllocator<RT, PARTICLES_ALIGNMENT> > array_t;
+
+  array_t X[3];
+  array_t U[3];
+  array_t M;
+
+  idx_t size() const { return M.size(); }
+
+  void resize(idx_t n)
+  {
+    for(int i=0; i<3; i++)
+    {
+      X[i].resize(n);
+      U[i].resize(n);
+    }
+    M.resize(n);
+  }
+
+  Particle<RT> get(idx_t n) const
+  {
+    Particle<RT> p;
+    for(int i=0; i<3; i++)
+    {
+      p.X[i] = X[i][n];
+      p.U[i] = U[i][n];
+    }
+    p.M = M[n];
+    return p;
+  }
+
+  void set(idx_t n, const Particle<RT> & p)
+  {
+    for(int i=0; i<3; i++)
+    {
+      X[i][n] = p.X[i];
+      U[i][n] = p.U[i];
+    }
+    M[n] = p.M;
+  }
+
+  void push_back(const Particle<RT> & p)
+  {
+    for(int i=0; i<3; i++)
+    {
+      X[i].push_back(p.X[i]);
+      U[i].push_back(p.U[i]);
+    }
+    M.push_back(p.M);
+  }
+
+  /**
+   * @brief Reorder particles so that new particle n is old particle order[n]
+   */
+  void permute(const std::vector<idx_t> & order)
+  {
+    array_t tmp(order.size());
+    array_t * arrays[7] = { &X[0], &X[1], &X[2], &U[0], &U[1], &U[2], &M };
+    for(array_t * arr : arrays)
+    {
+      idx_t n;
+#     pragma omp parallel for
+      for(n=0; n<(idx_t) order.size(); ++n)
+        tmp[n] = (*arr)[order[n]];
+      arr->swap(tmp);
+    }
+  }
+};
+
 /**
  * @brief Data structure containing 4 needed RK4 registers
  * @details Data structure used for an RK4 integration; contains
- * registers p_x for a Particle<RT> : _p, _a, _c, _f
- * 
+ * registers p_x for all particles : _p, _a, _c, _f. Particle n is the
+ * same particle in every register.
+ *
  * @tparam RT simulation real type
  */
 template<typename RT>
-struct ParticleRegister {
-  // 4 standard "registers" for each particle
-  Particle<RT> p_p;
-  Particle<RT> p_a;
-  Particle<RT> p_c;
-  Particle<RT> p_f;
+struct ParticleRegisters {
+  ParticleArrays<RT> p_p;
+  ParticleArrays<RT> p_a;
+  ParticleArrays<RT> p_c;
+  ParticleArrays<RT> p_f;
+  std::vector<idx_t> id; ///< persistent particle IDs, in order of creation
+
+  idx_t size() const { return p_p.size(); }
+
+  void push_back(const Particle<RT> & p)
+  {
+    id.push_back(size());
+    p_p.push_back(p);
+    p_a.push_back(p);
+    p_c.push_back(p);
+    p_f.push_back(p);
+  }
+
+  void permute(const std::vector<idx_t> & order)
+  {
+    p_p.permute(order);
+    p_a.permute(order);
+    p_c.permute(order);
+    p_f.permute(order);
+
+    std::vector<idx_t> tmp(order.size());
+    for(idx_t n=0; n<(idx_t) order.size(); ++n)
+      tmp[n] = id[order[n]];
+    id.swap(tmp);
+  }
+
+  /**
+   * @brief Storage index of each particle, in order of ID; used to write
+   * output whose columns do not move when particles are sorted
+   */
+  std::vector<idx_t> idOrder() const
+  {
+    std::vector<idx_t> order(id.size());
+    for(idx_t n=0; n<(idx_t) id.size(); ++n)
+      order[id[n]] = n;
+    return order;
+  }
 };
 
-typedef std::vector<ParticleRegister<real_t>> particle_vec;
+typedef ParticleRegisters<real_t> particle_vec;
 
 /**
  * @brief Data structure for storing metric quantities ("primitives") at an
@@ -56,6 +204,67 @@ struct ParticleMetricPrimitives {
   RT dgi[3][6];     // Inverse metric derivative
 };
 
+/**
+ * @brief Structure-of-arrays grid of metric primitives
+ * @details Stores the contents of a ParticleMetricPrimitives struct at
+ * every grid point, component c of point idx at data[c*pts + idx] (see
+ * the PARTICLES_PP_* component indices). The first
+ * PARTICLES_N_PRIMITIVES_INCOMPLETE components (rootdetg, alpha, gi) are
+ * those needed for deposition; n_components is the number currently valid.
+ *
+ * @tparam RT simulation real type
+ */
+template<typename RT>
+struct ParticlePrimitivesGrid {
+  typedef std::vector<RT, AlignedAllocator<RT, PARTICLES_ALIGNMENT> > array_t;
+
+  array_t data;
+  idx_t pts;
+  idx_t n_components;
+
+  ParticlePrimitivesGrid() : pts(0), n_components(0) {}
+
+  void resize(idx_t points, idx_t components)
+  {
+    pts = points;
+    if((idx_t) data.size() < components*points)
+      data.resize(components*points);
+  }
+
+  RT * component(idx_t c) { return &data[c*pts]; }
+  const RT * component(idx_t c) const { return &data[c*pts]; }
+};
+
+/**
+ * @brief References to the BSSN fields primitives are computed from
+ */
+struct ParticlePrimitiveFields {
+  arr_t * DIFFalpha_a;
+  arr_t * DIFFphi_a;
+  arr_t * DIFFgamma11_a, * DIFFgamma12_a, * DIFFgamma13_a,
+        * DIFFgamma22_a, * DIFFgamma23_a, * DIFFgamma33_a;
+  arr_t * beta1_a, * beta2_a, * beta3_a;
+
+  ParticlePrimitiveFields(map_t & bssn_fields)
+  {
+    DIFFalpha_a = bssn_fields["DIFFalpha_a"];
+    DIFFphi_a = bssn_fields["DIFFphi_a"];
+    DIFFgamma11_a = bssn_fields["DIFFgamma11_a"];
+    DIFFgamma12_a = bssn_fields["DIFFgamma12_a"];
+    DIFFgamma13_a = bssn_fields["DIFFgamma13_a"];
+    DIFFgamma22_a = bssn_fields["DIFFgamma22_a"];
+    DIFFgamma23_a = bssn_fields["DIFFgamma23_a"];
+    DIFFgamma33_a = bssn_fields["DIFFgamma33_a"];
+#   if USE_BSSN_SHIFT
+      beta1_a = bssn_fields["beta1_a"];
+      beta2_a = bssn_fields["beta2_a"];
+      beta3_a = bssn_fields["beta3_a"];
+#   else
+      beta1_a = beta2_a = beta3_a = nullptr;
+#   endif
+  }
+};
+
 }
 
 #endif
@@ -8,13 +8,31 @@
     x_d \
   )
 
+// rho, S, S1, S2, S3, STF11, STF12, STF13, STF22, STF23, STF33
+#define PARTICLES_N_SOURCES 11
+
+// components of a ParticlePrimitivesGrid; rootdetg, alpha, and gi
+// (the "incomplete" set) come first
+#define PARTICLES_N_PRIMITIVES 41
+#define PARTICLES_N_PRIMITIVES_INCOMPLETE 8
+#define PARTICLES_PP_ROOTDETG 0
+#define PARTICLES_PP_ALPHA 1
+#define PARTICLES_PP_GI(n) (2 + (n))
+#define PARTICLES_PP_BETA(n) (8 + (n))
+#define PARTICLES_PP_DALPHA(a) (11 + (a))
+#define PARTICLES_PP_DBETA(a, n) (14 + 3*(a) + (n))
+#define PARTICLES_PP_DGI(a, n) (23 + 6*(a) + (n))
+
 #define PARTICLES_ROUND(val) ((idx_t)( (val) + 0.5))
 
-#define DER(field) (derivative(x_idx, y_idx, z_idx, a+1, field))
+#define DER(field) (derivative(x_idx, y_idx, z_idx, a+1, field, ctx->inv_dx))
+
+#define PARTICLES_PARALLEL_LOOP(n) \
+  idx_t n; \
+  _Pragma("omp parallel for default(shared) private(n)") \
+  for(n = 0; n < particles->size(); ++n)
 
-#define PARTICLES_PARALLEL_LOOP(pr) \
-  typename particle_vec::iterator pr; \
-  _Pragma("omp parallel for default(shared) private(pr)") \
-  for(pr = particles->begin(); pr < particles->end(); ++pr) \
+// bits per dimension in Morton (Z-order) keys
+#define PARTICLES_MORTON_BITS 21
 
 #endif
@@ -1,52 +1,22 @@
 #include "sheets.h"
 #include "../../utils/math.h"
 #include "../../cosmo_includes.h"
-#include "../../cosmo_globals.h"
 #include "sheets_macros.h"
 
 namespace cosmo
 {
 
-Sheet::Sheet():
-  ns1(std::stoi(_config["ns1"])),
-  ns2(std::stoi(_config["ns2"])),
-  ns3(std::stoi(_config["ns3"])),
-  Dx(ns1, ns2, ns3, dt),
-  Dy(ns1, ns2, ns3, dt),
-  Dz(ns1, ns2, ns3, dt),
-  vx(ns1, ns2, ns3, dt),
-  vy(ns1, ns2, ns3, dt),
-  vz(ns1, ns2, ns3, dt),
-  d1alpha_a(NX, NY, NZ),
-  d2alpha_a(NX, NY, NZ),
-  d3alpha_a(NX, NY, NZ),
-  d1gammai11_a(NX, NY, NZ),
-  d1gammai22_a(NX, NY, NZ),
-  d1gammai33_a(NX, NY, NZ),
-  d1gammai12_a(NX, NY, NZ),
-  d1gammai13_a(NX, NY, NZ),
-  d1gammai23_a(NX, NY, NZ),
-  d2gammai11_a(NX, NY, NZ),
-  d2gammai22_a(NX, NY, NZ),
-  d2gammai33_a(NX, NY, NZ),
-  d2gammai12_a(NX, NY, NZ),
-  d2gammai13_a(NX, NY, NZ),
-  d2gammai23_a(NX, NY, NZ),
-  d3gammai11_a(NX, NY, NZ),
-  d3gammai22_a(NX, NY, NZ),
-  d3gammai33_a(NX, NY, NZ),
-  d3gammai12_a(NX, NY, NZ),
-  d3gammai13_a(NX, NY, NZ),
-  d3gammai23_a(NX, NY, NZ),
-  d1beta1_a(NX, NY, NZ),
-  d1beta2_a(NX, NY, NZ),
-  d1beta3_a(NX, NY, NZ),
-  d2beta1_a(NX, NY, NZ),
-  d2beta2_a(NX, NY, NZ),
-  d2beta3_a(NX, NY, NZ),
-  d3beta1_a(NX, NY, NZ),
-  d3beta2_a(NX, NY, NZ),
-  d3beta3_a(NX, NY, NZ)
+Sheet::Sheet(SimContext * ctx_in, IOData * iodata_in):
+  ctx(ctx_in),
+  ns1(std::stoi(ctx->config["ns1"])),
+  ns2(std::stoi(ctx->config["ns2"])),
+  ns3(std::stoi(ctx->config["ns3"])),
+  Dx(ns1, ns2, ns3, ctx->dt),
+  Dy(ns1, ns2, ns3, ctx->dt),
+  Dz(ns1, ns2, ns3, ctx->dt),
+  vx(ns1, ns2, ns3, ctx->dt),
+  vy(ns1, ns2, ns3, ctx->dt),
+  vz(ns1, ns2, ns3, ctx->dt)
 {
   dx = H_LEN_FRAC / (real_t) COSMO_N;
   dy = dx;
@@ -59,18 +29,48 @@ Sheet::Sheet():
   std::cout << "Initiaizing sheet class with lx,ly,lz = " << lx << "," << ly << "," << lz
     << ", dx,dy,dz = " << dx << "," << dy << "," << dz << std::endl;
 
-  carrier_count_scheme = static_cast<carrierCountScheme> (std::stoi(_config("carrier_count_scheme","1")));
-  deposit = static_cast<depositScheme> (std::stoi(_config("deposit_scheme","1")));
+  carrier_count_scheme = static_cast<carrierCountScheme> (std::stoi(ctx->config("carrier_count_scheme","1")));
+  deposit = static_cast<depositScheme> (std::stoi(ctx->config("deposit_scheme","1")));
+  deposit_strategy = static_cast<depositStrategy> (std::stoi(ctx->config("deposit_strategy","0")));
+  deposit_tile_size = std::stoi(ctx->config("deposit_tile_size","8"));
 
-  follow_null_geodesics = !!std::stoi(_config("follow_null_geodesics", "0"));
-  rescale_sheet = std::stod(_config("rescale_sheet", "1.0"));
+  source_mass = 0.0;
+  follow_null_geodesics = !!std::stoi(ctx->config("follow_null_geodesics", "0"));
+  rescale_sheet = std::stod(ctx->config("rescale_sheet", "1.0"));
   if(rescale_sheet == 1.0) rescale_sheet = 0.0;
-  ray_bundle_epsilon = std::stod(_config("ray_bundle_epsilon","1.0")) / (real_t POINTS);
+  ray_bundle_epsilon = std::stod(ctx->config("ray_bundle_epsilon","1.0")) / (real_t POINTS);
   det_g_obs = 0.0;
 
-  carriers_per_dx = std::stoi(_config("carriers_per_dx","1"));
-  carriers_per_dy = std::stoi(_config("carriers_per_dy","1"));
-  carriers_per_dz = std::stoi(_config("carriers_per_dz","1"));
+  carriers_per_dx = std::stoi(ctx->config("carriers_per_dx","1"));
+  carriers_per_dy = std::stoi(ctx->config("carriers_per_dy","1"));
+  carriers_per_dz = std::stoi(ctx->config("carriers_per_dz","1"));
+
+  sort_interval = std::stol(ctx->config("sheet_sort_interval", "10"));
+  steps_since_sort = sort_interval; // sort at the first step
+  log_sort = !!std::stoi(ctx->config("sheet_sort_log", "0"));
+  iodata = iodata_in;
+  element_order.resize(ns1*ns2*ns3);
+  for(idx_t e=0; e<ns1*ns2*ns3; ++e)
+    element_order[e] = e;
+
+  metric_derivatives = static_cast<metricDerivatives> (std::stoi(ctx->config("sheet_metric_derivatives","0")));
+  if(metric_derivatives == DERIVATIVE_GRIDS)
+  {
+    arr_t * derivative_grids[] = {
+      &d1alpha_a, &d2alpha_a, &d3alpha_a,
+      &d1gammai11_a, &d1gammai22_a, &d1gammai33_a,
+      &d1gammai12_a, &d1gammai13_a, &d1gammai23_a,
+      &d2gammai11_a, &d2gammai22_a, &d2gammai33_a,
+      &d2gammai12_a, &d2gammai13_a, &d2gammai23_a,
+      &d3gammai11_a, &d3gammai22_a, &d3gammai33_a,
+      &d3gammai12_a, &d3gammai13_a, &d3gammai23_a,
+      &d1beta1_a, &d1beta2_a, &d1beta3_a,
+      &d2beta1_a, &d2beta2_a, &d2beta3_a,
+      &d3beta1_a, &d3beta2_a, &d3beta3_a
+    };
+    for(arr_t * grid : derivative_grids)
+      grid->init(NX, NY, NZ);
+  }
 }
 
 
@@ -90,198 +90,273 @@ void Sheet::setDt(real_t dt)
   vz.setDt(dt);
 }
 
-void Sheet::_MassDeposit(real_t weight, real_t x_idx, real_t y_idx,
-  real_t z_idx, arr_t &rho)
+/**
+ * @brief      Compute the mass deposition stencil for a point
+ * @details    A unit deposit at (x_idx, y_idx, z_idx) adds
+ *  weights[(a*n[1] + b)*n[2] + c] to gridpoint
+ *  (start[0] + a, start[1] + b, start[2] + c) (unwrapped), for a < n[0],
+ *  b < n[1], c < n[2], according to the deposit scheme. The stencil is
+ *  computed once for all source components deposited at a point.
+ */
+void Sheet::_getDepositStencil(real_t x_idx, real_t y_idx, real_t z_idx,
+  idx_t start[3], idx_t n[3], real_t * weights)
 {
+  // gridpoint index "left" of x_idx
+  idx_t ix = (x_idx < 0 ? (idx_t) x_idx - 1 : (idx_t) x_idx );
+  idx_t iy = (y_idx < 0 ? (idx_t) y_idx - 1 : (idx_t) y_idx );
+  idx_t iz = (z_idx < 0 ? (idx_t) z_idx - 1 : (idx_t) z_idx );
+
+  real_t x_f = x_idx - (real_t) ix;
+  real_t y_f = y_idx - (real_t) iy;
+  real_t z_f = z_idx - (real_t) iz;
+
   switch (deposit)
   {
     case PCS:
-      _PCSDeposit(weight, x_idx, y_idx, z_idx, rho);
+    {
+      bool is_1d = (ns2 == 1 && NY == 1 && ns3 == 1 && NZ == 1);
+      start[0] = ix - 1;
+      start[1] = is_1d ? iy : iy - 1;
+      start[2] = is_1d ? iz : iz - 1;
+      n[0] = 4;
+      n[1] = is_1d ? 1 : 4;
+      n[2] = is_1d ? 1 : 4;
+
+      // (spherical) piecewise cubic spline, normalized over the stencil
+      real_t norm = 0.0;
+      idx_t w = 0;
+      for(idx_t i=0; i<n[0]; ++i)
+        for(idx_t j=0; j<n[1]; ++j)
+          for(idx_t k=0; k<n[2]; ++k)
+          {
+            real_t s = is_1d ? std::abs( start[0]+i-x_idx )
+              : std::sqrt( pw2(start[0]+i-x_idx) + pw2(start[1]+j-y_idx)
+                           + pw2(start[2]+k-z_idx) );
+
+            real_t pcs = 0.0;
+            if(s<1.0)
+              pcs = (4.0 - 6.0*s*s + 3.0*s*s*s)/6.0;
+            else if(s<2.0)
+              pcs = std::pow(2.0 - s, 3)/6.0;
+
+            weights[w++] = pcs;
+            norm += pcs;
+          }
+      for(idx_t m=0; m<w; ++m)
+        weights[m] /= norm;
       break;
+    }
     case CINT:
-      _CINTDeposit(weight, x_idx, y_idx, z_idx, rho);
+    {
+      start[0] = ix - 1;
+      start[1] = iy - 1;
+      start[2] = iz - 1;
+      n[0] = n[1] = n[2] = 4;
+
+      real_t x_wts[4] = { x_f*x_f*(2.0-x_f)-x_f, x_f*x_f*(3.0*x_f-5.0)+2.0,
+             x_f*x_f*(4.0-3.0*x_f)+x_f, x_f*x_f*(x_f-1.0) };
+      real_t y_wts[4] = { y_f*y_f*(2.0-y_f)-y_f, y_f*y_f*(3.0*y_f-5.0)+2.0,
+             y_f*y_f*(4.0-3.0*y_f)+y_f, y_f*y_f*(y_f-1.0) };
+      real_t z_wts[4] = { z_f*z_f*(2.0-z_f)-z_f, z_f*z_f*(3.0*z_f-5.0)+2.0,
+             z_f*z_f*(4.0-3.0*z_f)+z_f, z_f*z_f*(z_f-1.0) };
+
+      idx_t w = 0;
+      for(idx_t i=0; i<4; ++i)
+        for(idx_t j=0; j<4; ++j)
+          for(idx_t k=0; k<4; ++k)
+            weights[w++] = x_wts[i]*y_wts[j]*z_wts[k]/2.0/2.0/2.0;
       break;
+    }
     case CIC:
     default:
-      _CICDeposit(weight, x_idx, y_idx, z_idx, rho);
+    {
+      start[0] = ix;
+      start[1] = iy;
+      start[2] = iz;
+      n[0] = n[1] = n[2] = 2;
+
+      real_t x_wts[2] = { 1.0 - x_f, x_f };
+      real_t y_wts[2] = { 1.0 - y_f, y_f };
+      real_t z_wts[2] = { 1.0 - z_f, z_f };
+
+      idx_t w = 0;
+      for(idx_t i=0; i<2; ++i)
+        for(idx_t j=0; j<2; ++j)
+          for(idx_t k=0; k<2; ++k)
+            weights[w++] = x_wts[i]*y_wts[j]*z_wts[k];
       break;
+    }
   }
 }
 
-void Sheet::_CICDeposit(real_t weight, real_t x_idx, real_t y_idx,
-  real_t z_idx, arr_t &rho)
-{
-  idx_t ix, iy, iz,
-        ixp, iyp, izp;
-
-  real_t x_f, y_f, z_f,
-         x_h, y_h, z_h;
-
-  // gridpoint index "left" of x_idx
-  ix = (x_idx < 0 ? (idx_t) x_idx - 1 : (idx_t) x_idx );
-  ixp = ix + 1;
-  x_f = x_idx - (real_t) ix;
-  x_h = 1.0 - x_f;
-
-  iy = (y_idx < 0 ? (idx_t) y_idx - 1 : (idx_t) y_idx );
-  iyp = iy + 1;
-  y_f = y_idx - (real_t) iy;
-  y_h = 1.0 - y_f;
-
-  iz = (z_idx < 0 ? (idx_t) z_idx - 1 : (idx_t) z_idx );
-  izp = iz + 1;
-  z_f = z_idx - (real_t) iz;
-  z_h = 1.0 - z_f;
-
-#pragma omp atomic    
-  rho(ix, iy, iz) += x_h*y_h*z_h*weight;
-#pragma omp atomic
-  rho(ix, iy, izp) += x_h*y_h*z_f*weight;
-#pragma omp atomic
-  rho(ix, iyp, iz) += x_h*y_f*z_h*weight;
-#pragma omp atomic
-  rho(ix, iyp, izp) += x_h*y_f*z_f*weight;
-
-#pragma omp atomic
-  rho(ixp, iy, iz) += x_f*y_h*z_h*weight;
-#pragma omp atomic
-  rho(ixp, iy, izp) += x_f*y_h*z_f*weight;
-#pragma omp atomic
-  rho(ixp, iyp, iz) += x_f*y_f*z_h*weight;
-#pragma omp atomic
-  rho(ixp, iyp, izp) += x_f*y_f*z_f*weight;
-
-}
-
 /**
- * @brief      Piecewise cubic spline deposition
+ * @brief      Deposit stored carriers (deposit_carriers) tile by tile
+ * @details    Carriers are binned by the spatial tile containing them.
+ *  Each tile is deposited by a single thread into its own buffer, which
+ *  extends past the tile by the stencil reach (one point below, two
+ *  above). In a second parallel pass over tiles, each tile gathers
+ *  contributions from the buffers of its (periodic) neighbors into the
+ *  grid. Neither pass needs atomics, and the result does not depend on the
+ *  number of threads.
  */
-void Sheet::_PCSDeposit(real_t weight, real_t x_idx, real_t y_idx,
-  real_t z_idx, arr_t &rho)
+void Sheet::_depositCarriersTiled(real_t ** source_fields)
 {
-
-  if(ns2 == 1 && NY == 1 && ns3 == 1 && NZ == 1)
+  const idx_t ghost_lo = 1, ghost_hi = 2;
+  const idx_t N[3] = { NX, NY, NZ };
+  const idx_t tile_size = std::max(deposit_tile_size, (idx_t) 4);
+
+  // tile t along direction d spans [tile_lo[d][t], tile_lo[d][t+1])
+  idx_t nt[3];
+  std::vector<idx_t> tile_lo[3];
+  for(int d=0; d<3; ++d)
   {
-    idx_t ix = (x_idx < 0 ? (idx_t) x_idx - 1 : (idx_t) x_idx );
+    nt[d] = std::max(N[d]/tile_size, (idx_t) 1);
+    tile_lo[d].resize(nt[d]+1);
+    for(idx_t t=0; t<=nt[d]; ++t)
+      tile_lo[d][t] = (t*N[d] + nt[d] - 1)/nt[d];
+  }
+  const idx_t n_tiles = nt[0]*nt[1]*nt[2];
+
+  // tile containing the gridpoint "left" of a carrier
+  auto left_idx = [](real_t x) { return x < 0 ? (idx_t) x - 1 : (idx_t) x; };
+  auto tile_of = [&](const SheetCarrier & c) {
+    idx_t tx = idx_t_mod(left_idx(c.x_idx), N[0])*nt[0]/N[0];
+    idx_t ty = idx_t_mod(left_idx(c.y_idx), N[1])*nt[1]/N[1];
+    idx_t tz = idx_t_mod(left_idx(c.z_idx), N[2])*nt[2]/N[2];
+    return (tx*nt[1] + ty)*nt[2] + tz;
+  };
 
-    real_t norm = 0.0;
-    for(idx_t i=-1; i<=2; ++i)
+  // counting sort of carriers by tile
+  tile_carrier_start.assign(n_tiles+1, 0);
+  idx_t n_carriers = 0;
+  for(auto & carriers : deposit_carriers)
+    for(auto & c : carriers)
     {
-      real_t s = std::abs( ix+i-x_idx );
-      
-      if(s<1.0)
-      {
-        norm += (4.0 - 6.0*s*s + 3.0*std::pow(std::abs(s), 3))/6.0;
-      }
-      else if(s<2.0 && s>=1.0)
-      {
-        norm += std::pow(2.0 - std::abs(s), 3)/6.0;
-      }
+      tile_carrier_start[tile_of(c)+1]++;
+      n_carriers++;
     }
+  for(idx_t t=0; t<n_tiles; ++t)
+    tile_carrier_start[t+1] += tile_carrier_start[t];
+  std::vector<idx_t> fill(tile_carrier_start.begin(), tile_carrier_start.end()-1);
+  tile_carriers.resize(n_carriers);
+  for(auto & carriers : deposit_carriers)
+    for(auto & c : carriers)
+      tile_carriers[fill[tile_of(c)]++] = &c;
 
-    real_t pcs;
-    for(idx_t i=-1; i<=2; ++i)
+  tile_buffers.resize(n_tiles);
+
+# pragma omp parallel
+  {
+    real_t weights[64];
+
+    // deposit each tile into its buffer
+#   pragma omp for schedule(dynamic)
+    for(idx_t tile=0; tile<n_tiles; ++tile)
     {
-      real_t s = std::abs( ix+i-x_idx );
-          
-      if(s<1.0)
+      std::vector<real_t> & buffer = tile_buffers[tile];
+      if(tile_carrier_start[tile] == tile_carrier_start[tile+1])
       {
-        pcs = (4.0 - 6.0*s*s + 3.0*std::pow(std::abs(s), 3))/6.0;
-#pragma omp atomic
-        rho(ix+i, 0, 0) += pcs*weight/norm;
+        buffer.clear();
+        continue;
       }
-      else if(s<2.0 && s>=1.0)
-      {
-        pcs = std::pow(2.0 - std::abs(s), 3)/6.0;
-#pragma omp atomic
-        rho(ix+i, 0, 0) += pcs*weight/norm;
-      }
-    }
 
-  }
-  else
-  {
-    idx_t ix = (x_idx < 0 ? (idx_t) x_idx - 1 : (idx_t) x_idx );
-    idx_t iy = (y_idx < 0 ? (idx_t) y_idx - 1 : (idx_t) y_idx );
-    idx_t iz = (z_idx < 0 ? (idx_t) z_idx - 1 : (idx_t) z_idx );
-
-    real_t norm = 0.0;
-    for(idx_t i=-1; i<=2; ++i)
-      for(idx_t j=-1; j<=2; ++j)
-        for(idx_t k=-1; k<=2; ++k)
+      idx_t t[3] = { tile/nt[2]/nt[1], (tile/nt[2]) % nt[1], tile % nt[2] };
+      idx_t bdim[3];
+      for(int d=0; d<3; ++d)
+        bdim[d] = tile_lo[d][t[d]+1] - tile_lo[d][t[d]] + ghost_lo + ghost_hi;
+      buffer.assign(bdim[0]*bdim[1]*bdim[2]*SHEET_N_SOURCES, 0.0);
+
+      for(idx_t m=tile_carrier_start[tile]; m<tile_carrier_start[tile+1]; ++m)
+      {
+        const SheetCarrier & c = *tile_carriers[m];
+        idx_t start[3], n[3];
+        _getDepositStencil(c.x_idx, c.y_idx, c.z_idx, start, n, weights);
+
+        // stencil start in buffer coordinates
+        real_t X[3] = { c.x_idx, c.y_idx, c.z_idx };
+        idx_t l0[3];
+        for(int d=0; d<3; ++d)
         {
-          real_t s = std::sqrt( std::pow(ix+i-x_idx, 2)
-            + std::pow(iy+j-y_idx, 2)
-            + std::pow(iz+k-z_idx, 2) );
-          
-          if(s<1.0)
-          {
-            norm += (4.0 - 6.0*s*s + 3.0*std::pow(std::abs(s), 3))/6.0;
-          }
-          else if(s<2.0 && s>=1.0)
-          {
-            norm += std::pow(2.0 - std::abs(s), 3)/6.0;
-          }
+          idx_t left = left_idx(X[d]);
+          l0[d] = idx_t_mod(left, N[d]) - tile_lo[d][t[d]] + ghost_lo + start[d] - left;
         }
 
-    real_t pcs;
-    for(idx_t i=-1; i<=2; ++i)
-      for(idx_t j=-1; j<=2; ++j)
-        for(idx_t k=-1; k<=2; ++k)
-        {
-          real_t s = std::sqrt( std::pow(ix+i-x_idx, 2)
-            + std::pow(iy+j-y_idx, 2)
-            + std::pow(iz+k-z_idx, 2) );
-          
-          if(s<1.0)
-          {
-            pcs = (4.0 - 6.0*s*s + 3.0*std::pow(std::abs(s), 3))/6.0;
-#pragma omp atomic
-            rho(ix+i, iy+j, iz+k) += pcs*weight/norm;
-          }
-          else if(s<2.0 && s>=1.0)
+        idx_t w = 0;
+        for(idx_t a=0; a<n[0]; ++a)
+          for(idx_t b=0; b<n[1]; ++b)
           {
-            pcs = std::pow(2.0 - std::abs(s), 3)/6.0;
-#pragma omp atomic
-            rho(ix+i, iy+j, iz+k) += pcs*weight/norm;
+            real_t * row = &buffer[((l0[0]+a)*bdim[1] + l0[1]+b)*bdim[2]*SHEET_N_SOURCES];
+            for(idx_t k=0; k<n[2]; ++k)
+            {
+              real_t * pt = row + (l0[2]+k)*SHEET_N_SOURCES;
+              real_t weight = weights[w++];
+              for(idx_t f=0; f<SHEET_N_SOURCES; ++f)
+                pt[f] += weight*c.src[f];
+            }
           }
-        }
-  }
-
-}
-
-
-/**
- * @brief      Deposition based on cubic interoplation (CINT)
- */
-void Sheet::_CINTDeposit(real_t weight, real_t x_idx, real_t y_idx,
-  real_t z_idx, arr_t &rho)
-{
-  // gridpoint index "left" of x_idx
-  idx_t ix = (x_idx < 0 ? (idx_t) x_idx - 1 : (idx_t) x_idx );
-  real_t x_f = x_idx - (real_t) ix;
-
-  idx_t iy = (y_idx < 0 ? (idx_t) y_idx - 1 : (idx_t) y_idx );
-  real_t y_f = y_idx - (real_t) iy;
+      }
+    }
 
-  idx_t iz = (z_idx < 0 ? (idx_t) z_idx - 1 : (idx_t) z_idx );
-  real_t z_f = z_idx - (real_t) iz;
+    // each tile gathers from its neighbors' buffers
+    std::vector<idx_t> l_list[3], g_list[3];
+#   pragma omp for schedule(dynamic)
+    for(idx_t tile=0; tile<n_tiles; ++tile)
+    {
+      idx_t t[3] = { tile/nt[2]/nt[1], (tile/nt[2]) % nt[1], tile % nt[2] };
 
-  real_t x_wts[4] = { x_f*x_f*(2.0-x_f)-x_f, x_f*x_f*(3.0*x_f-5.0)+2.0,
-         x_f*x_f*(4.0-3.0*x_f)+x_f, x_f*x_f*(x_f-1.0) };
-  real_t y_wts[4] = { y_f*y_f*(2.0-y_f)-y_f, y_f*y_f*(3.0*y_f-5.0)+2.0,
-         y_f*y_f*(4.0-3.0*y_f)+y_f, y_f*y_f*(y_f-1.0) };
-  real_t z_wts[4] = { z_f*z_f*(2.0-z_f)-z_f, z_f*z_f*(3.0*z_f-5.0)+2.0,
-         z_f*z_f*(4.0-3.0*z_f)+z_f, z_f*z_f*(z_f-1.0) };
-
-  for(idx_t i=-1; i<=2; ++i)
-    for(idx_t j=-1; j<=2; ++j)
-      for(idx_t k=-1; k<=2; ++k)
-      {        
-#pragma omp atomic
-          rho(ix+i, iy+j, iz+k) += weight*x_wts[i+1]*y_wts[j+1]*z_wts[k+1]/2.0/2.0/2.0;
+      // distinct neighboring tiles along each direction
+      idx_t nbrs[3][3], n_nbrs[3];
+      for(int d=0; d<3; ++d)
+      {
+        n_nbrs[d] = 0;
+        for(idx_t o=-1; o<=1; ++o)
+        {
+          idx_t s = idx_t_mod(t[d] + o, nt[d]);
+          if(std::find(nbrs[d], nbrs[d] + n_nbrs[d], s) == nbrs[d] + n_nbrs[d])
+            nbrs[d][n_nbrs[d]++] = s;
+        }
       }
 
+      for(idx_t a=0; a<n_nbrs[0]; ++a)
+        for(idx_t b=0; b<n_nbrs[1]; ++b)
+          for(idx_t c=0; c<n_nbrs[2]; ++c)
+          {
+            idx_t s[3] = { nbrs[0][a], nbrs[1][b], nbrs[2][c] };
+            const std::vector<real_t> & buffer = tile_buffers[(s[0]*nt[1] + s[1])*nt[2] + s[2]];
+            if(buffer.empty())
+              continue;
+
+            // buffer points (l) falling in this tile (at g), along each direction
+            idx_t bdim[3];
+            for(int d=0; d<3; ++d)
+            {
+              bdim[d] = tile_lo[d][s[d]+1] - tile_lo[d][s[d]] + ghost_lo + ghost_hi;
+              l_list[d].clear();
+              g_list[d].clear();
+              for(idx_t l=0; l<bdim[d]; ++l)
+              {
+                idx_t g = idx_t_mod(tile_lo[d][s[d]] - ghost_lo + l, N[d]);
+                if(g >= tile_lo[d][t[d]] && g < tile_lo[d][t[d]+1])
+                {
+                  l_list[d].push_back(l);
+                  g_list[d].push_back(g);
+                }
+              }
+            }
+
+            for(idx_t i=0; i<(idx_t) l_list[0].size(); ++i)
+              for(idx_t j=0; j<(idx_t) l_list[1].size(); ++j)
+                for(idx_t k=0; k<(idx_t) l_list[2].size(); ++k)
+                {
+                  const real_t * pt = &buffer[
+                    ((l_list[0][i]*bdim[1] + l_list[1][j])*bdim[2] + l_list[2][k])*SHEET_N_SOURCES];
+                  idx_t idx = NP_INDEX(g_list[0][i], g_list[1][j], g_list[2][k]);
+                  for(idx_t f=0; f<SHEET_N_SOURCES; ++f)
+                    source_fields[f][idx] += pt[f];
+                }
+          }
+    }
+  }
 }
 
 
@@ -322,8 +397,45 @@ real_t Sheet::_getXRangeInSVoxel(register_t & DX, idx_t s1_idx, idx_t s2_idx,
  */
 void Sheet::addBSSNSource(BSSN *bssn, real_t tot_mass)
 {
-  _timer["_pushsheetToStressTensor"].start();
+  ctx->timer["_pushsheetToStressTensor"].start();
+
+  depositBSSNSrc(bssn, tot_mass);
+
+  idx_t i, j, k;
+# pragma omp parallel for default(shared) private(i, j, k)
+  LOOP3(i, j, k)
+  {
+    BSSNData bd = {0};
+    bssn->set_bd_values<BD_LOCAL>(i, j, k, &bd);
+    bssn->enforceTFSIJ(&bd);
+    bssn->store_bd_sources(&bd);
+  }
+
+  ctx->timer["_pushsheetToStressTensor"].stop();
+}
+
+/**
+ * @brief Deposit sources (without removing the trace of STF) when driven
+ * by a MatterDriver; see Sheet::tracefreeBSSNSrc.
+ */
+void Sheet::depositBSSNSrc(BSSN *bssn)
+{
+  ctx->timer["_pushsheetToStressTensor"].start();
+  depositBSSNSrc(bssn, source_mass);
+  ctx->timer["_pushsheetToStressTensor"].stop();
+}
+
+void Sheet::RKEvolveNonlocal(BSSN *bssn)
+{
+  RKStep(bssn);
+}
 
+/**
+ * @brief Deposit sheet stress-energy onto BSSN source arrays; STF is not
+ * yet trace-free.
+ */
+void Sheet::depositBSSNSrc(BSSN *bssn, real_t tot_mass)
+{
   arr_t & DIFFr_a = *bssn->fields["DIFFr_a"];
   arr_t & DIFFS_a = *bssn->fields["DIFFS_a"];
   arr_t & S1_a = *bssn->fields["S1_a"];
@@ -344,186 +456,247 @@ void Sheet::addBSSNSource(BSSN *bssn, real_t tot_mass)
   arr_t & DIFFgamma12_a = *bssn->fields["DIFFgamma12_a"];
   arr_t & DIFFgamma13_a = *bssn->fields["DIFFgamma13_a"];
   arr_t & DIFFgamma23_a = *bssn->fields["DIFFgamma23_a"];
+
+  const real_t * metric_fields[7] = {
+    DIFFphi_a._array, DIFFgamma11_a._array, DIFFgamma22_a._array,
+    DIFFgamma33_a._array, DIFFgamma12_a._array, DIFFgamma23_a._array,
+    DIFFgamma13_a._array };
   
-  idx_t num_x_carriers, num_y_carriers, num_z_carriers;
+  real_t * source_fields[SHEET_N_SOURCES] = {
+    DIFFr_a._array, DIFFS_a._array, S1_a._array, S2_a._array, S3_a._array,
+    STF11_a._array, STF12_a._array, STF13_a._array,
+    STF22_a._array, STF23_a._array, STF33_a._array };
+
+  // Either deposit into per-thread plane buffers, then sum these into the
+  // source fields plane by plane, or store carriers for tiled deposition;
+  // no atomic updates are needed in either case.
+  const bool tiled = (deposit_strategy == TILES);
+  deposit_buffers.resize(omp_get_max_threads());
+  deposit_carriers.resize(omp_get_max_threads());
+  const idx_t plane_size = NY*NZ*SHEET_N_SOURCES;
+  const idx_t n_elements = ns1*ns2*ns3;
+
+# pragma omp parallel
+  {
+    SheetDepositPlanes & buffer = deposit_buffers[omp_get_thread_num()];
+    std::vector<SheetCarrier> & carriers = deposit_carriers[omp_get_thread_num()];
+    std::vector<real_t> carrier_values;
+    if(tiled)
+      carriers.clear();
+    else
+      buffer.reset(NX);
+
+    // static schedule keeps each thread's part of the sheet contiguous
+    // (in element_order)
+#   pragma omp for schedule(static)
+    for(idx_t e=0; e<n_elements; ++e)
+    {
+      idx_t s1, s2, s3;
+      _getElementIndices(element_order[e], s1, s2, s3);
 
-  //    int i, j, k;
-# pragma omp parallel for collapse(2)
-  for(idx_t s1=0; s1<ns1; ++s1)
-    for(idx_t s2=0; s2<ns2; ++s2)
-      for(idx_t s3=0; s3<ns3; ++s3)
+      idx_t num_x_carriers, num_y_carriers, num_z_carriers;
+      switch(carrier_count_scheme)
       {
-        switch(carrier_count_scheme)
-        {
-        case per_dx:
-          num_x_carriers = carriers_per_dx == 0 ? 1 : carriers_per_dx*(
-            (idx_t) (0.5 + _getXRangeInSVoxel(Dx, s1, s2, s3, _S1IDXtoX0(s1), _S1IDXtoX0(s1+1)) / dx ) );
-          num_y_carriers = carriers_per_dy == 0 ? 1 : carriers_per_dy*(
-            (idx_t) (0.5 + _getXRangeInSVoxel(Dy, s1, s2, s3, _S2IDXtoY0(s2), _S2IDXtoY0(s2+1)) / dy ) );
-          num_z_carriers = carriers_per_dz == 0 ? 1 : carriers_per_dz*(
-            (idx_t) (0.5 + _getXRangeInSVoxel(Dz, s1, s2, s3, _S3IDXtoZ0(s3), _S3IDXtoZ0(s3+1)) / dz ) );
-          break;
-        case per_ds:
-        default:
-          num_x_carriers = carriers_per_dx;
-          num_y_carriers = carriers_per_dy;
-          num_z_carriers = carriers_per_dz;
-          break;
-        }
+      case per_dx:
+        num_x_carriers = carriers_per_dx == 0 ? 1 : carriers_per_dx*(
+          (idx_t) (0.5 + _getXRangeInSVoxel(Dx, s1, s2, s3, _S1IDXtoX0(s1), _S1IDXtoX0(s1+1)) / dx ) );
+        num_y_carriers = carriers_per_dy == 0 ? 1 : carriers_per_dy*(
+          (idx_t) (0.5 + _getXRangeInSVoxel(Dy, s1, s2, s3, _S2IDXtoY0(s2), _S2IDXtoY0(s2+1)) / dy ) );
+        num_z_carriers = carriers_per_dz == 0 ? 1 : carriers_per_dz*(
+          (idx_t) (0.5 + _getXRangeInSVoxel(Dz, s1, s2, s3, _S3IDXtoZ0(s3), _S3IDXtoZ0(s3+1)) / dz ) );
+        break;
+      case per_ds:
+      default:
+        num_x_carriers = carriers_per_dx;
+        num_y_carriers = carriers_per_dy;
+        num_z_carriers = carriers_per_dz;
+        break;
+      }
 
 
-        if(num_x_carriers <= 0) num_x_carriers = 1;
-        if(num_y_carriers <= 0) num_y_carriers = 1;
-        if(num_z_carriers <= 0) num_z_carriers = 1;
-        
-        idx_t num_carriers = num_x_carriers*num_y_carriers*num_z_carriers;
+      if(num_x_carriers <= 0) num_x_carriers = 1;
+      if(num_y_carriers <= 0) num_y_carriers = 1;
+      if(num_z_carriers <= 0) num_z_carriers = 1;
+    
+      idx_t num_carriers = num_x_carriers*num_y_carriers*num_z_carriers;
 
-        idx_t i, j, k;
+      idx_t i, j, k;
 
-        real_t f_Dx[64], f_Dy[64], f_Dz[64];
-        real_t a_Dx[64], a_Dy[64], a_Dz[64];
+      // tricubic coefficient blocks of Dx, Dy, Dz (Lagrange) and
+      // vx, vy, vz (Catmull-Rom) in this element, evaluated once on the
+      // whole carrier lattice and reused by each carrier
+      if(num_carriers > 1)
+      {
+        real_t f[6*64], a[6*64];
+        for(i=0; i<4; ++i)
+          for(j=0; j<4; ++j)
+            for(k=0; k<4; ++k)
+            {
+              idx_t n = i*16 + j*4 + k;
+              f[n] = Dx(s1-1+i, s2-1+j, s3-1+k);
+              f[64+n] = Dy(s1-1+i, s2-1+j, s3-1+k);
+              f[128+n] = Dz(s1-1+i, s2-1+j, s3-1+k);
+              f[192+n] = vx._array_a(s1-1+i, s2-1+j, s3-1+k);
+              f[256+n] = vy._array_a(s1-1+i, s2-1+j, s3-1+k);
+              f[320+n] = vz._array_a(s1-1+i, s2-1+j, s3-1+k);
+            }
+        for(idx_t c=0; c<6; ++c)
+          compute_tricubic_coeffs_separable(a + 64*c, f + 64*c,
+            c < 3 ? TriCubicBasis<real_t>::lagrange : TriCubicBasis<real_t>::catmull_rom);
 
-        if(num_x_carriers != 1 || num_y_carriers != 1 || num_z_carriers != 1)
-        {
-        
-          for(i=0; i<4; ++i)
-            for(j=0; j<4; ++j)
-              for(k=0; k<4; ++k)
-              {
-                f_Dx[i*16 + j*4 + k] = Dx(s1-1+i, s2-1+j, s3-1+k);
-                f_Dy[i*16 + j*4 + k] = Dy(s1-1+i, s2-1+j, s3-1+k);
-                f_Dz[i*16 + j*4 + k] = Dz(s1-1+i, s2-1+j, s3-1+k);
-              }
-          compute_tricubic_coeffs(a_Dx, f_Dx);
-          compute_tricubic_coeffs(a_Dy, f_Dy);
-          compute_tricubic_coeffs(a_Dz, f_Dz);
-        }
-        // distribute mass from all carriers
-        for(i=0; i<num_x_carriers; ++i)
-          for(j=0; j<num_y_carriers; ++j)
-            for(k=0; k<num_z_carriers; ++k)
+        carrier_values.resize(6*num_carriers);
+        evaluate_interpolation_lattice<idx_t, real_t>(6, a,
+          num_x_carriers, num_y_carriers, num_z_carriers, carrier_values.data());
+      }
+
+      // distribute mass from all carriers
+      for(i=0; i<num_x_carriers; ++i)
+        for(j=0; j<num_y_carriers; ++j)
+          for(k=0; k<num_z_carriers; ++k)
+          {
+            real_t carrier_x_idx, carrier_y_idx, carrier_z_idx;
+            real_t u[3];
+
+            if(num_carriers == 1)
+            {
+              // special case if only one carrier
+              carrier_x_idx = ( _S1IDXtoX0(s1) + Dx(s1, s2, s3) ) / dx;
+              carrier_y_idx = ( _S2IDXtoY0(s2) + Dy(s1, s2, s3) ) / dy;
+              carrier_z_idx = ( _S3IDXtoZ0(s3) + Dz(s1, s2, s3) ) / dz;
+              u[0] = vx._array_a(s1, s2, s3);
+              u[1] = vy._array_a(s1, s2, s3);
+              u[2] = vz._array_a(s1, s2, s3);
+            }
+            else
             {
+              const real_t * values = &carrier_values[
+                (i*num_y_carriers + j)*num_z_carriers + k];
+              carrier_x_idx = ( _S1IDXtoX0(s1 + (real_t) i / (real_t) num_x_carriers)
+                                + values[0] ) / dx;
+              carrier_y_idx = ( _S2IDXtoY0(s2 + (real_t) j / (real_t) num_y_carriers)
+                                + values[num_carriers] ) / dy;
+              carrier_z_idx = ( _S3IDXtoZ0(s3 + (real_t) k / (real_t) num_z_carriers)
+                                + values[2*num_carriers] ) / dz;
+              u[0] = values[3*num_carriers];
+              u[1] = values[4*num_carriers];
+              u[2] = values[5*num_carriers];
+            }
 
-              real_t carrier_s1d = (real_t) i / (real_t) num_x_carriers;
-              real_t carrier_s2d = (real_t) j / (real_t) num_y_carriers;
-              real_t carrier_s3d = (real_t) k / (real_t) num_z_carriers;
+            // metric on the grid
+            real_t metric[7];
+            TriCubicStencil<idx_t, real_t> x_stencil(carrier_x_idx, carrier_y_idx, carrier_z_idx,
+              NX, NY, NZ);
+            x_stencil.interpolate(7, metric_fields, metric);
 
-              real_t carrier_s1 = s1 + carrier_s1d;
-              real_t carrier_s2 = s2 + carrier_s2d;
-              real_t carrier_s3 = s3 + carrier_s3d;
+            real_t u1 = u[0], u2 = u[1], u3 = u[2];
 
-              real_t carrier_x_idx, carrier_y_idx, carrier_z_idx;
-              
-              if(num_x_carriers == 1 && num_y_carriers == 1 && num_z_carriers == 1)
-              {
-                // special case if only one carrier
-                carrier_x_idx = ( _S1IDXtoX0(s1) + Dx(s1, s2, s3) ) / dx;
-                carrier_y_idx = ( _S2IDXtoY0(s2) + Dy(s1, s2, s3) ) / dy;
-                carrier_z_idx = ( _S3IDXtoZ0(s3) + Dz(s1, s2, s3) ) / dz;
-              }
-              else
-              {
-                carrier_x_idx = ( _S1IDXtoX0(carrier_s1)
-                                         + evaluate_interpolation(a_Dx, carrier_s1d, carrier_s2d, carrier_s3d) ) / dx;
-                carrier_y_idx = ( _S2IDXtoY0(carrier_s2)
-                                         + evaluate_interpolation(a_Dy, carrier_s1d, carrier_s2d, carrier_s3d) ) / dy;
-                carrier_z_idx = ( _S3IDXtoZ0(carrier_s3)
-                                         + evaluate_interpolation(a_Dz, carrier_s1d, carrier_s2d, carrier_s3d) ) / dz;
-              }
+            real_t phi = metric[0];
 
-              real_t u1 = vx._array_a.getTriCubicInterpolatedValue(carrier_s1, carrier_s2, carrier_s3);
-              real_t u2 = vy._array_a.getTriCubicInterpolatedValue(carrier_s1, carrier_s2, carrier_s3);
-              real_t u3 = vz._array_a.getTriCubicInterpolatedValue(carrier_s1, carrier_s2, carrier_s3);
-
-              real_t phi = DIFFphi_a.getTriCubicInterpolatedValue(
-                carrier_x_idx, carrier_y_idx, carrier_z_idx);
-
-              real_t DIFFgamma11 = DIFFgamma11_a.getTriCubicInterpolatedValue(
-                carrier_x_idx, carrier_y_idx, carrier_z_idx); 
-              real_t DIFFgamma22 = DIFFgamma22_a.getTriCubicInterpolatedValue(
-                carrier_x_idx, carrier_y_idx, carrier_z_idx) ; 
-              real_t DIFFgamma33 = DIFFgamma33_a.getTriCubicInterpolatedValue(
-                carrier_x_idx, carrier_y_idx, carrier_z_idx) ; 
-
-              real_t DIFFgamma12 = DIFFgamma12_a.getTriCubicInterpolatedValue(
-                carrier_x_idx, carrier_y_idx, carrier_z_idx); 
-              real_t DIFFgamma23 = DIFFgamma23_a.getTriCubicInterpolatedValue(
-                carrier_x_idx, carrier_y_idx, carrier_z_idx); 
-              real_t DIFFgamma13 = DIFFgamma13_a.getTriCubicInterpolatedValue(
-                carrier_x_idx, carrier_y_idx, carrier_z_idx); 
-
-              real_t gammai11 = std::exp(-4.0*phi)*(1.0 + DIFFgamma22 + DIFFgamma33 - pw2(DIFFgamma23) + DIFFgamma22*DIFFgamma33);
-              real_t gammai22 = std::exp(-4.0*phi)*(1.0 + DIFFgamma11 + DIFFgamma33 - pw2(DIFFgamma13) + DIFFgamma11*DIFFgamma33);
-              real_t gammai33 = std::exp(-4.0*phi)*(1.0 + DIFFgamma11 + DIFFgamma22 - pw2(DIFFgamma12) + DIFFgamma11*DIFFgamma22);
-              real_t gammai12 = std::exp(-4.0*phi)*(DIFFgamma13*DIFFgamma23 - DIFFgamma12*(1.0 + DIFFgamma33));
-              real_t gammai13 = std::exp(-4.0*phi)*(DIFFgamma12*DIFFgamma23 - DIFFgamma13*(1.0 + DIFFgamma22));
-              real_t gammai23 = std::exp(-4.0*phi)*(DIFFgamma12*DIFFgamma13 - DIFFgamma23*(1.0 + DIFFgamma11));
-
-              real_t rootdetg = std::exp(6.0*phi);
-        
-              real_t W = 0.0;
-              if(follow_null_geodesics)
-              {
-                W = std::sqrt(
-                  gammai11*u1*u1 + gammai22*u2*u2 + gammai33*u3*u3
-                  + 2.0*( gammai12*u1*u2 + gammai13*u1*u3 + gammai23*u2*u3 )
-                );
-              }
-              else
+            real_t DIFFgamma11 = metric[1];
+            real_t DIFFgamma22 = metric[2];
+            real_t DIFFgamma33 = metric[3];
+
+            real_t DIFFgamma12 = metric[4];
+            real_t DIFFgamma23 = metric[5];
+            real_t DIFFgamma13 = metric[6];
+
+            real_t gammai11 = std::exp(-4.0*phi)*(1.0 + DIFFgamma22 + DIFFgamma33 - pw2(DIFFgamma23) + DIFFgamma22*DIFFgamma33);
+            real_t gammai22 = std::exp(-4.0*phi)*(1.0 + DIFFgamma11 + DIFFgamma33 - pw2(DIFFgamma13) + DIFFgamma11*DIFFgamma33);
+            real_t gammai33 = std::exp(-4.0*phi)*(1.0 + DIFFgamma11 + DIFFgamma22 - pw2(DIFFgamma12) + DIFFgamma11*DIFFgamma22);
+            real_t gammai12 = std::exp(-4.0*phi)*(DIFFgamma13*DIFFgamma23 - DIFFgamma12*(1.0 + DIFFgamma33));
+            real_t gammai13 = std::exp(-4.0*phi)*(DIFFgamma12*DIFFgamma23 - DIFFgamma13*(1.0 + DIFFgamma22));
+            real_t gammai23 = std::exp(-4.0*phi)*(DIFFgamma12*DIFFgamma13 - DIFFgamma23*(1.0 + DIFFgamma11));
+
+            real_t rootdetg = std::exp(6.0*phi);
+    
+            real_t W = 0.0;
+            if(follow_null_geodesics)
+            {
+              W = std::sqrt(
+                gammai11*u1*u1 + gammai22*u2*u2 + gammai33*u3*u3
+                + 2.0*( gammai12*u1*u2 + gammai13*u1*u3 + gammai23*u2*u3 )
+              );
+            }
+            else
+            {
+              W = std::sqrt( 1.0 +
+                gammai11*u1*u1 + gammai22*u2*u2 + gammai33*u3*u3
+                + 2.0*( gammai12*u1*u2 + gammai13*u1*u3 + gammai23*u2*u3 )
+              );
+            }
+          
+            real_t mass = tot_mass / (real_t) num_carriers / ns1/ns2/ns3;
+          
+            real_t MnA = mass / W / dx / dy / dz / rootdetg;
+
+            real_t rho = MnA*W*W;
+            real_t S = rho - MnA;
+            real_t S1 = MnA*W*u1;
+            real_t S2 = MnA*W*u2;
+            real_t S3 = MnA*W*u3;
+
+            // STF is not trace free yet
+            real_t STF11 = (MnA*u1*u1);
+            real_t STF12 = (MnA*u1*u2);
+            real_t STF13 = (MnA*u1*u3);
+            real_t STF22 = (MnA*u2*u2);
+            real_t STF23 = (MnA*u2*u3);
+            real_t STF33 = (MnA*u3*u3);
+
+            if(tiled)
+            {
+              SheetCarrier carrier = { carrier_x_idx, carrier_y_idx, carrier_z_idx,
+                { rho, S, S1, S2, S3, STF11, STF12, STF13, STF22, STF23, STF33 } };
+              carriers.push_back(carrier);
+              continue;
+            }
+
+            // deposit all components with a single stencil
+            real_t src[SHEET_N_SOURCES] = { rho, S, S1, S2, S3,
+              STF11, STF12, STF13, STF22, STF23, STF33 };
+            idx_t start[3], n[3];
+            real_t weights[64];
+            _getDepositStencil(carrier_x_idx, carrier_y_idx, carrier_z_idx,
+              start, n, weights);
+
+            idx_t w = 0;
+            for(idx_t a=0; a<n[0]; ++a)
+            {
+              real_t * plane = buffer.plane(idx_t_mod(start[0]+a, NX), plane_size);
+              for(idx_t b=0; b<n[1]; ++b)
               {
-                W = std::sqrt( 1.0 +
-                  gammai11*u1*u1 + gammai22*u2*u2 + gammai33*u3*u3
-                  + 2.0*( gammai12*u1*u2 + gammai13*u1*u3 + gammai23*u2*u3 )
-                );
+                idx_t y_off = idx_t_mod(start[1]+b, NY)*NZ;
+                for(idx_t c=0; c<n[2]; ++c)
+                {
+                  real_t * pt = plane + (y_off + idx_t_mod(start[2]+c, NZ))*SHEET_N_SOURCES;
+                  real_t weight = weights[w++];
+                  for(idx_t f=0; f<SHEET_N_SOURCES; ++f)
+                    pt[f] += weight*src[f];
+                }
               }
-              
-              real_t mass = tot_mass / (real_t) num_carriers / ns1/ns2/ns3;
-              
-              real_t MnA = mass / W / dx / dy / dz / rootdetg;
-
-              real_t rho = MnA*W*W;
-              real_t S = rho - MnA;
-              real_t S1 = MnA*W*u1;
-              real_t S2 = MnA*W*u2;
-              real_t S3 = MnA*W*u3;
-
-              // STF is not trace free yet
-              real_t STF11 = (MnA*u1*u1);
-              real_t STF12 = (MnA*u1*u2);
-              real_t STF13 = (MnA*u1*u3);
-              real_t STF22 = (MnA*u2*u2);
-              real_t STF23 = (MnA*u2*u3);
-              real_t STF33 = (MnA*u3*u3);
-
-              _MassDeposit(rho, carrier_x_idx, carrier_y_idx, carrier_z_idx, DIFFr_a);
-
-              _MassDeposit(S, carrier_x_idx, carrier_y_idx, carrier_z_idx, DIFFS_a);
-              
-              _MassDeposit(S1, carrier_x_idx, carrier_y_idx, carrier_z_idx, S1_a);
-              _MassDeposit(S2, carrier_x_idx, carrier_y_idx, carrier_z_idx, S2_a);
-              _MassDeposit(S3, carrier_x_idx, carrier_y_idx, carrier_z_idx, S3_a);
-
-              _MassDeposit(STF11, carrier_x_idx, carrier_y_idx, carrier_z_idx, STF11_a);
-              _MassDeposit(STF22, carrier_x_idx, carrier_y_idx, carrier_z_idx, STF22_a);
-              _MassDeposit(STF33, carrier_x_idx, carrier_y_idx, carrier_z_idx, STF33_a);
-              _MassDeposit(STF12, carrier_x_idx, carrier_y_idx, carrier_z_idx, STF12_a);
-              _MassDeposit(STF13, carrier_x_idx, carrier_y_idx, carrier_z_idx, STF13_a);
-              _MassDeposit(STF23, carrier_x_idx, carrier_y_idx, carrier_z_idx, STF23_a);
             }
-        
-      }
+          }
+    }
 
-  idx_t i, j, k;
-# pragma omp parallel for default(shared) private(i, j, k)
-  LOOP3(i, j, k)
-  {
-    BSSNData bd = {0};
-    bssn->set_bd_values(i, j, k, &bd);
-    bssn->enforceTFSIJ(&bd);
+    if(!tiled)
+    {
+#     pragma omp for
+      for(idx_t X=0; X<NX; ++X)
+        for(int t=0; t<omp_get_num_threads(); ++t)
+        {
+          SheetDepositPlanes & thread_buffer = deposit_buffers[t];
+          if(!thread_buffer.used[X])
+            continue;
+          const real_t * plane = thread_buffer.planes[X].data();
+          for(idx_t yz=0; yz<NY*NZ; ++yz)
+            for(idx_t f=0; f<SHEET_N_SOURCES; ++f)
+              source_fields[f][X*NY*NZ + yz] += plane[yz*SHEET_N_SOURCES + f];
+        }
+    }
   }
 
-
-  _timer["_pushsheetToStressTensor"].stop();
+  if(tiled)
+    _depositCarriersTiled(source_fields);
 }
 
 void Sheet::rescaleFieldPerturbations(arr_t & field, real_t multiplier)
@@ -550,7 +723,7 @@ void Sheet::rescaleVelocityPerturbations(arr_t & ux, arr_t & uy, arr_t & uz, rea
   }
   avg_u /= ns1;
 
-  std::ifstream vecFile(_config["healpix_vecs_file"]);
+  std::ifstream vecFile(ctx->config["healpix_vecs_file"]);
   idx_t r = 0;
   while (!vecFile.eof() && r < ns1)
   {
@@ -595,7 +768,7 @@ void Sheet::rescalePositionPerturbations(arr_t & dx, arr_t & dy, arr_t & dz, rea
   }
   avg_r /= ns1;
 
-  std::ifstream vecFile(_config["healpix_vecs_file"]);
+  std::ifstream vecFile(ctx->config["healpix_vecs_file"]);
   idx_t r = 0;
   while (!vecFile.eof() && r < ns1)
   {
@@ -649,6 +822,29 @@ void Sheet::rescaleAllFieldPerturbations(BSSN *bssn, real_t multiplier)
 }
 
 
+namespace
+{
+
+/**
+ * @brief      Derivatives of the inverse metric along one direction, given
+ *  the conformal factor phi, DIFFgamma (11, 22, 33, 12, 13, 23), their
+ *  derivatives, and the inverse metric itself (same ordering); the same
+ *  expressions as SET_GAMMAI_DER.
+ */
+inline void sheet_gammai_derivatives(real_t phi, const real_t * g,
+  real_t dphi, const real_t * dg, const real_t * gammai, real_t * dgammai)
+{
+  const real_t e = std::exp(-4.0*phi);
+  dgammai[0] = -4.0*dphi*gammai[0] + e*(dg[1] + dg[2] - 2.0*g[5]*dg[5] + dg[1]*g[2] + g[1]*dg[2]);
+  dgammai[1] = -4.0*dphi*gammai[1] + e*(dg[0] + dg[2] - 2.0*g[4]*dg[4] + dg[0]*g[2] + g[0]*dg[2]);
+  dgammai[2] = -4.0*dphi*gammai[2] + e*(dg[0] + dg[1] - 2.0*g[3]*dg[3] + dg[0]*g[1] + g[0]*dg[1]);
+  dgammai[3] = -4.0*dphi*gammai[3] + e*(dg[4]*g[5] + g[4]*dg[5] - dg[3]*(1.0 + g[2]) - g[3]*dg[2]);
+  dgammai[4] = -4.0*dphi*gammai[4] + e*(dg[3]*g[5] + g[3]*dg[5] - dg[4]*(1.0 + g[1]) - g[4]*dg[1]);
+  dgammai[5] = -4.0*dphi*gammai[5] + e*(dg[3]*g[4] + g[3]*dg[4] - dg[5]*(1.0 + g[0]) - g[5]*dg[0]);
+}
+
+} // anonymous namespace
+
 void Sheet::RKStep(BSSN *bssn)
 {
   if(rescale_sheet) rescaleAllFieldPerturbations(bssn, rescale_sheet);
@@ -673,203 +869,326 @@ void Sheet::RKStep(BSSN *bssn)
 #endif
 
 
-# pragma omp parallel for default(shared) private(i, j, k)
-  LOOP3(i, j, k)
+  const bool derivative_grids = (metric_derivatives == DERIVATIVE_GRIDS);
+
+  if(derivative_grids)
   {
+  # pragma omp parallel for default(shared) private(i, j, k)
+    LOOP3(i, j, k)
+    {
 #if USE_BSSN_SHIFT
-    d1beta1_a(i, j, k) = derivative(i, j, k, 1, beta1_a);
-    d1beta2_a(i, j, k) = derivative(i, j, k, 1, beta2_a);
-    d1beta3_a(i, j, k) = derivative(i, j, k, 1, beta3_a);
-    d2beta1_a(i, j, k) = derivative(i, j, k, 2, beta1_a);
-    d2beta2_a(i, j, k) = derivative(i, j, k, 2, beta2_a);
-    d2beta3_a(i, j, k) = derivative(i, j, k, 2, beta3_a);
-    d3beta1_a(i, j, k) = derivative(i, j, k, 3, beta1_a);
-    d3beta2_a(i, j, k) = derivative(i, j, k, 3, beta2_a);
-    d3beta3_a(i, j, k) = derivative(i, j, k, 3, beta3_a);
+      d1beta1_a(i, j, k) = derivative(i, j, k, 1, beta1_a, ctx->inv_dx);
+      d1beta2_a(i, j, k) = derivative(i, j, k, 1, beta2_a, ctx->inv_dx);
+      d1beta3_a(i, j, k) = derivative(i, j, k, 1, beta3_a, ctx->inv_dx);
+      d2beta1_a(i, j, k) = derivative(i, j, k, 2, beta1_a, ctx->inv_dx);
+      d2beta2_a(i, j, k) = derivative(i, j, k, 2, beta2_a, ctx->inv_dx);
+      d2beta3_a(i, j, k) = derivative(i, j, k, 2, beta3_a, ctx->inv_dx);
+      d3beta1_a(i, j, k) = derivative(i, j, k, 3, beta1_a, ctx->inv_dx);
+      d3beta2_a(i, j, k) = derivative(i, j, k, 3, beta2_a, ctx->inv_dx);
+      d3beta3_a(i, j, k) = derivative(i, j, k, 3, beta3_a, ctx->inv_dx);
 #endif
 
-    d1alpha_a(i, j, k) = derivative(i, j, k, 1, DIFFalpha_a);
-    d2alpha_a(i, j, k) = derivative(i, j, k, 2, DIFFalpha_a);
-    d3alpha_a(i, j, k) = derivative(i, j, k, 3, DIFFalpha_a);
+      d1alpha_a(i, j, k) = derivative(i, j, k, 1, DIFFalpha_a, ctx->inv_dx);
+      d2alpha_a(i, j, k) = derivative(i, j, k, 2, DIFFalpha_a, ctx->inv_dx);
+      d3alpha_a(i, j, k) = derivative(i, j, k, 3, DIFFalpha_a, ctx->inv_dx);
 
 
-    real_t phi = DIFFphi_a(i, j, k);
+      real_t phi = DIFFphi_a(i, j, k);
 
-    real_t DIFFgamma11 = DIFFgamma11_a(i, j, k);
-    real_t DIFFgamma22 = DIFFgamma22_a(i, j, k);
-    real_t DIFFgamma33 = DIFFgamma33_a(i, j, k);
+      real_t DIFFgamma11 = DIFFgamma11_a(i, j, k);
+      real_t DIFFgamma22 = DIFFgamma22_a(i, j, k);
+      real_t DIFFgamma33 = DIFFgamma33_a(i, j, k);
 
-    real_t DIFFgamma12 = DIFFgamma12_a(i, j, k);
-    real_t DIFFgamma23 = DIFFgamma23_a(i, j, k);
-    real_t DIFFgamma13 = DIFFgamma13_a(i, j, k);
+      real_t DIFFgamma12 = DIFFgamma12_a(i, j, k);
+      real_t DIFFgamma23 = DIFFgamma23_a(i, j, k);
+      real_t DIFFgamma13 = DIFFgamma13_a(i, j, k);
     
-    real_t gammai11 = std::exp(-4.0*phi)*(1.0 + DIFFgamma22 + DIFFgamma33 - pw2(DIFFgamma23) + DIFFgamma22*DIFFgamma33);
-    real_t gammai22 = std::exp(-4.0*phi)*(1.0 + DIFFgamma11 + DIFFgamma33 - pw2(DIFFgamma13) + DIFFgamma11*DIFFgamma33);
-    real_t gammai33 = std::exp(-4.0*phi)*(1.0 + DIFFgamma11 + DIFFgamma22 - pw2(DIFFgamma12) + DIFFgamma11*DIFFgamma22);
-    real_t gammai12 = std::exp(-4.0*phi)*(DIFFgamma13*DIFFgamma23 - DIFFgamma12*(1.0 + DIFFgamma33));
-    real_t gammai13 = std::exp(-4.0*phi)*(DIFFgamma12*DIFFgamma23 - DIFFgamma13*(1.0 + DIFFgamma22));
-    real_t gammai23 = std::exp(-4.0*phi)*(DIFFgamma12*DIFFgamma13 - DIFFgamma23*(1.0 + DIFFgamma11));
+      real_t gammai11 = std::exp(-4.0*phi)*(1.0 + DIFFgamma22 + DIFFgamma33 - pw2(DIFFgamma23) + DIFFgamma22*DIFFgamma33);
+      real_t gammai22 = std::exp(-4.0*phi)*(1.0 + DIFFgamma11 + DIFFgamma33 - pw2(DIFFgamma13) + DIFFgamma11*DIFFgamma33);
+      real_t gammai33 = std::exp(-4.0*phi)*(1.0 + DIFFgamma11 + DIFFgamma22 - pw2(DIFFgamma12) + DIFFgamma11*DIFFgamma22);
+      real_t gammai12 = std::exp(-4.0*phi)*(DIFFgamma13*DIFFgamma23 - DIFFgamma12*(1.0 + DIFFgamma33));
+      real_t gammai13 = std::exp(-4.0*phi)*(DIFFgamma12*DIFFgamma23 - DIFFgamma13*(1.0 + DIFFgamma22));
+      real_t gammai23 = std::exp(-4.0*phi)*(DIFFgamma12*DIFFgamma13 - DIFFgamma23*(1.0 + DIFFgamma11));
+
+      SET_GAMMAI_DER(1);
+      SET_GAMMAI_DER(2);
+      SET_GAMMAI_DER(3);
+    }
+  }
 
-    SET_GAMMAI_DER(1);
-    SET_GAMMAI_DER(2);
-    SET_GAMMAI_DER(3);
+  // fields interpolated to sheet positions; order must match the
+  // unpacking of interp_vals below
+  const real_t * interp_fields[SHEET_MAX_INTERP_FIELDS];
+  idx_t n_interp = 0;
+  interp_fields[n_interp++] = DIFFphi_a._array;
+  interp_fields[n_interp++] = DIFFalpha_a._array;
+#if USE_BSSN_SHIFT
+  interp_fields[n_interp++] = beta1_a._array;
+  interp_fields[n_interp++] = beta2_a._array;
+  interp_fields[n_interp++] = beta3_a._array;
+#endif
+  interp_fields[n_interp++] = DIFFgamma11_a._array;
+  interp_fields[n_interp++] = DIFFgamma22_a._array;
+  interp_fields[n_interp++] = DIFFgamma33_a._array;
+  interp_fields[n_interp++] = DIFFgamma12_a._array;
+  interp_fields[n_interp++] = DIFFgamma23_a._array;
+  interp_fields[n_interp++] = DIFFgamma13_a._array;
+  const idx_t n_interp_metric = n_interp;
+  if(derivative_grids)
+  {
+    interp_fields[n_interp++] = d1alpha_a._array;
+    interp_fields[n_interp++] = d2alpha_a._array;
+    interp_fields[n_interp++] = d3alpha_a._array;
+#if USE_BSSN_SHIFT
+    interp_fields[n_interp++] = d1beta1_a._array;
+    interp_fields[n_interp++] = d1beta2_a._array;
+    interp_fields[n_interp++] = d1beta3_a._array;
+    interp_fields[n_interp++] = d2beta1_a._array;
+    interp_fields[n_interp++] = d2beta2_a._array;
+    interp_fields[n_interp++] = d2beta3_a._array;
+    interp_fields[n_interp++] = d3beta1_a._array;
+    interp_fields[n_interp++] = d3beta2_a._array;
+    interp_fields[n_interp++] = d3beta3_a._array;
+#endif
+    interp_fields[n_interp++] = d1gammai11_a._array;
+    interp_fields[n_interp++] = d1gammai22_a._array;
+    interp_fields[n_interp++] = d1gammai33_a._array;
+    interp_fields[n_interp++] = d1gammai12_a._array;
+    interp_fields[n_interp++] = d1gammai13_a._array;
+    interp_fields[n_interp++] = d1gammai23_a._array;
+#if !(NY == 1 && NZ == 1)
+    interp_fields[n_interp++] = d2gammai11_a._array;
+    interp_fields[n_interp++] = d2gammai22_a._array;
+    interp_fields[n_interp++] = d2gammai33_a._array;
+    interp_fields[n_interp++] = d2gammai12_a._array;
+    interp_fields[n_interp++] = d2gammai13_a._array;
+    interp_fields[n_interp++] = d2gammai23_a._array;
+    interp_fields[n_interp++] = d3gammai11_a._array;
+    interp_fields[n_interp++] = d3gammai22_a._array;
+    interp_fields[n_interp++] = d3gammai33_a._array;
+    interp_fields[n_interp++] = d3gammai12_a._array;
+    interp_fields[n_interp++] = d3gammai13_a._array;
+    interp_fields[n_interp++] = d3gammai23_a._array;
+#endif
   }
 
+  const idx_t n_elements = ns1*ns2*ns3;
 #pragma omp parallel for default(shared) private(i, j, k)
-  for(i=0; i<ns1; ++i)
-    for(j=0; j<ns2; ++j)
-      for(k=0; k<ns3; ++k)
-      {
-        real_t x_pt = Dx._a(i,j,k) + _S1IDXtoX0(i);
-        real_t y_pt = Dy._a(i,j,k) + _S2IDXtoY0(j);
-        real_t z_pt = Dz._a(i,j,k) + _S3IDXtoZ0(k);
+  for(idx_t e=0; e<n_elements; ++e)
+  {
+    _getElementIndices(element_order[e], i, j, k);
+
+    real_t x_pt = Dx._a(i,j,k) + _S1IDXtoX0(i);
+    real_t y_pt = Dy._a(i,j,k) + _S2IDXtoY0(j);
+    real_t z_pt = Dz._a(i,j,k) + _S3IDXtoZ0(k);
 
-        real_t x_idx = x_pt/dx;
-        real_t y_idx = y_pt/dy;
-        real_t z_idx = z_pt/dz;
- 
-        real_t u1 = vx._a(i, j, k);
-        real_t u2 = vy._a(i, j, k);
-        real_t u3 = vz._a(i, j, k);
+    real_t x_idx = x_pt/dx;
+    real_t y_idx = y_pt/dy;
+    real_t z_idx = z_pt/dz;
 
-        
-        real_t phi = DIFFphi_a.getTriCubicInterpolatedValue(
-          x_idx, y_idx, z_idx);
+    real_t u1 = vx._a(i, j, k);
+    real_t u2 = vy._a(i, j, k);
+    real_t u3 = vz._a(i, j, k);
 
-        real_t DIFFalpha = DIFFalpha_a.getTriCubicInterpolatedValue(x_idx, y_idx, z_idx);
+    
+    // gather all metric fields at (x_idx, y_idx, z_idx) in one pass
+    TriCubicStencil<idx_t, real_t> stencil(x_idx, y_idx, z_idx, NX, NY, NZ,
+      !derivative_grids);
+    real_t interp_vals[SHEET_MAX_INTERP_FIELDS];
+    real_t interp_grads[3*SHEET_MAX_INTERP_FIELDS];
+    if(derivative_grids)
+      stencil.interpolate(n_interp, interp_fields, interp_vals);
+    else
+      stencil.interpolateWithGradient(n_interp_metric, interp_fields,
+        interp_vals, interp_grads);
+    idx_t n = 0;
+
+    real_t phi = interp_vals[n++];
+    real_t DIFFalpha = interp_vals[n++];
 
 #if USE_BSSN_SHIFT
-        real_t beta1 = beta1_a.getTriCubicInterpolatedValue(x_idx, y_idx, z_idx);
-        real_t beta2 = beta2_a.getTriCubicInterpolatedValue(x_idx, y_idx, z_idx);
-        real_t beta3 = beta3_a.getTriCubicInterpolatedValue(x_idx, y_idx, z_idx);
+    real_t beta1 = interp_vals[n++];
+    real_t beta2 = interp_vals[n++];
+    real_t beta3 = interp_vals[n++];
 #else
-        real_t beta1 = 0, beta2 = 0, beta3 = 0;
+    real_t beta1 = 0, beta2 = 0, beta3 = 0;
 #endif
-        real_t DIFFgamma11 = DIFFgamma11_a.getTriCubicInterpolatedValue(
-          x_idx, y_idx, z_idx);
-        real_t DIFFgamma22 = DIFFgamma22_a.getTriCubicInterpolatedValue(
-          x_idx, y_idx, z_idx);
-        real_t DIFFgamma33 = DIFFgamma33_a.getTriCubicInterpolatedValue(
-          x_idx, y_idx, z_idx);
-
-        real_t DIFFgamma12 = DIFFgamma12_a.getTriCubicInterpolatedValue(
-          x_idx, y_idx, z_idx); 
-        real_t DIFFgamma23 = DIFFgamma23_a.getTriCubicInterpolatedValue(
-          x_idx, y_idx, z_idx); 
-        real_t DIFFgamma13 = DIFFgamma13_a.getTriCubicInterpolatedValue(
-          x_idx, y_idx, z_idx); 
-
-        real_t gammai11 = std::exp(-4.0*phi)*(1.0 + DIFFgamma22 + DIFFgamma33 - pw2(DIFFgamma23) + DIFFgamma22*DIFFgamma33);
-        real_t gammai22 = std::exp(-4.0*phi)*(1.0 + DIFFgamma11 + DIFFgamma33 - pw2(DIFFgamma13) + DIFFgamma11*DIFFgamma33);
-        real_t gammai33 = std::exp(-4.0*phi)*(1.0 + DIFFgamma11 + DIFFgamma22 - pw2(DIFFgamma12) + DIFFgamma11*DIFFgamma22);
-        real_t gammai12 = std::exp(-4.0*phi)*(DIFFgamma13*DIFFgamma23 - DIFFgamma12*(1.0 + DIFFgamma33));
-        real_t gammai13 = std::exp(-4.0*phi)*(DIFFgamma12*DIFFgamma23 - DIFFgamma13*(1.0 + DIFFgamma22));
-        real_t gammai23 = std::exp(-4.0*phi)*(DIFFgamma12*DIFFgamma13 - DIFFgamma23*(1.0 + DIFFgamma11));
-
-        real_t d1alpha = d1alpha_a.getTriCubicInterpolatedValue(x_idx, y_idx, z_idx);
-        real_t d2alpha = d2alpha_a.getTriCubicInterpolatedValue(x_idx, y_idx, z_idx);
-        real_t d3alpha = d3alpha_a.getTriCubicInterpolatedValue(x_idx, y_idx, z_idx);
+    real_t DIFFgamma11 = interp_vals[n++];
+    real_t DIFFgamma22 = interp_vals[n++];
+    real_t DIFFgamma33 = interp_vals[n++];
 
-#if USE_BSSN_SHIFT
-        real_t d1beta1 = d1beta1_a.getTriCubicInterpolatedValue(x_idx, y_idx, z_idx);
-        real_t d1beta2 = d1beta2_a.getTriCubicInterpolatedValue(x_idx, y_idx, z_idx);
-        real_t d1beta3 = d1beta3_a.getTriCubicInterpolatedValue(x_idx, y_idx, z_idx);
+    real_t DIFFgamma12 = interp_vals[n++];
+    real_t DIFFgamma23 = interp_vals[n++];
+    real_t DIFFgamma13 = interp_vals[n++];
 
-        real_t d2beta1 = d2beta1_a.getTriCubicInterpolatedValue(x_idx, y_idx, z_idx);
-        real_t d2beta2 = d2beta2_a.getTriCubicInterpolatedValue(x_idx, y_idx, z_idx);
-        real_t d2beta3 = d2beta3_a.getTriCubicInterpolatedValue(x_idx, y_idx, z_idx);
+    real_t gammai11 = std::exp(-4.0*phi)*(1.0 + DIFFgamma22 + DIFFgamma33 - pw2(DIFFgamma23) + DIFFgamma22*DIFFgamma33);
+    real_t gammai22 = std::exp(-4.0*phi)*(1.0 + DIFFgamma11 + DIFFgamma33 - pw2(DIFFgamma13) + DIFFgamma11*DIFFgamma33);
+    real_t gammai33 = std::exp(-4.0*phi)*(1.0 + DIFFgamma11 + DIFFgamma22 - pw2(DIFFgamma12) + DIFFgamma11*DIFFgamma22);
+    real_t gammai12 = std::exp(-4.0*phi)*(DIFFgamma13*DIFFgamma23 - DIFFgamma12*(1.0 + DIFFgamma33));
+    real_t gammai13 = std::exp(-4.0*phi)*(DIFFgamma12*DIFFgamma23 - DIFFgamma13*(1.0 + DIFFgamma22));
+    real_t gammai23 = std::exp(-4.0*phi)*(DIFFgamma12*DIFFgamma13 - DIFFgamma23*(1.0 + DIFFgamma11));
 
-        real_t d3beta1 = d3beta1_a.getTriCubicInterpolatedValue(x_idx, y_idx, z_idx);
-        real_t d3beta2 = d3beta2_a.getTriCubicInterpolatedValue(x_idx, y_idx, z_idx);
-        real_t d3beta3 = d3beta3_a.getTriCubicInterpolatedValue(x_idx, y_idx, z_idx);
-#else
-        real_t d1beta1 = 0, d1beta2 = 0, d1beta3 = 0;
-        real_t d2beta1 = 0, d2beta2 = 0, d2beta3 = 0;
-        real_t d3beta1 = 0, d3beta2 = 0, d3beta3 = 0;
+    // metric derivatives, from the derivative grids or the gradient of
+    // the interpolant; d_beta[a][b] = d_a beta_b, and d_gammai[a]
+    // ordered as 11, 22, 33, 12, 13, 23
+    real_t d_alpha[3] = {0}, d_beta[3][3] = {{0}}, d_gammai[3][6] = {{0}};
+    if(derivative_grids)
+    {
+      for(idx_t a=0; a<3; ++a)
+        d_alpha[a] = interp_vals[n++];
+#if USE_BSSN_SHIFT
+      for(idx_t a=0; a<3; ++a)
+        for(idx_t b=0; b<3; ++b)
+          d_beta[a][b] = interp_vals[n++];
 #endif
-
-        real_t d1gammai11 = d1gammai11_a.getTriCubicInterpolatedValue(x_idx, y_idx, z_idx);
-        real_t d1gammai22 = d1gammai22_a.getTriCubicInterpolatedValue(x_idx, y_idx, z_idx);
-        real_t d1gammai33 = d1gammai33_a.getTriCubicInterpolatedValue(x_idx, y_idx, z_idx);
-        real_t d1gammai12 = d1gammai12_a.getTriCubicInterpolatedValue(x_idx, y_idx, z_idx);
-        real_t d1gammai13 = d1gammai13_a.getTriCubicInterpolatedValue(x_idx, y_idx, z_idx);
-        real_t d1gammai23 = d1gammai23_a.getTriCubicInterpolatedValue(x_idx, y_idx, z_idx);
-
 // optimize this for 1d
 #if NY == 1 && NZ == 1
-        real_t d2gammai11 = 0.0;
-        real_t d2gammai22 = 0.0;
-        real_t d2gammai33 = 0.0;
-        real_t d2gammai12 = 0.0;
-        real_t d2gammai13 = 0.0;
-        real_t d2gammai23 = 0.0;
-
-        real_t d3gammai11 = 0.0;
-        real_t d3gammai22 = 0.0;
-        real_t d3gammai33 = 0.0;
-        real_t d3gammai12 = 0.0;
-        real_t d3gammai13 = 0.0;
-        real_t d3gammai23 = 0.0;
+      for(idx_t c=0; c<6; ++c)
+        d_gammai[0][c] = interp_vals[n++];
 #else
-        real_t d2gammai11 = d2gammai11_a.getTriCubicInterpolatedValue(x_idx, y_idx, z_idx);
-        real_t d2gammai22 = d2gammai22_a.getTriCubicInterpolatedValue(x_idx, y_idx, z_idx);
-        real_t d2gammai33 = d2gammai33_a.getTriCubicInterpolatedValue(x_idx, y_idx, z_idx);
-        real_t d2gammai12 = d2gammai12_a.getTriCubicInterpolatedValue(x_idx, y_idx, z_idx);
-        real_t d2gammai13 = d2gammai13_a.getTriCubicInterpolatedValue(x_idx, y_idx, z_idx);
-        real_t d2gammai23 = d2gammai23_a.getTriCubicInterpolatedValue(x_idx, y_idx, z_idx);
-
-        real_t d3gammai11 = d3gammai11_a.getTriCubicInterpolatedValue(x_idx, y_idx, z_idx);
-        real_t d3gammai22 = d3gammai22_a.getTriCubicInterpolatedValue(x_idx, y_idx, z_idx);
-        real_t d3gammai33 = d3gammai33_a.getTriCubicInterpolatedValue(x_idx, y_idx, z_idx);
-        real_t d3gammai12 = d3gammai12_a.getTriCubicInterpolatedValue(x_idx, y_idx, z_idx);
-        real_t d3gammai13 = d3gammai13_a.getTriCubicInterpolatedValue(x_idx, y_idx, z_idx);
-        real_t d3gammai23 = d3gammai23_a.getTriCubicInterpolatedValue(x_idx, y_idx, z_idx);
+      for(idx_t a=0; a<3; ++a)
+        for(idx_t c=0; c<6; ++c)
+          d_gammai[a][c] = interp_vals[n++];
+#endif
+    }
+    else
+    {
+      // gradients are in index units; field ordering as in interp_fields
+      const real_t h[3] = { dx, dy, dz };
+      const idx_t g_off = n_interp_metric - 6;
+      const real_t g[6] = { DIFFgamma11, DIFFgamma22, DIFFgamma33,
+        DIFFgamma12, DIFFgamma13, DIFFgamma23 };
+      const real_t gammai[6] = { gammai11, gammai22, gammai33,
+        gammai12, gammai13, gammai23 };
+      for(idx_t a=0; a<3; ++a)
+      {
+        d_alpha[a] = interp_grads[3*1 + a]/h[a];
+#if USE_BSSN_SHIFT
+        for(idx_t b=0; b<3; ++b)
+          d_beta[a][b] = interp_grads[3*(2+b) + a]/h[a];
 #endif
+        const real_t dg[6] = {
+          interp_grads[3*(g_off+0) + a]/h[a], interp_grads[3*(g_off+1) + a]/h[a],
+          interp_grads[3*(g_off+2) + a]/h[a], interp_grads[3*(g_off+3) + a]/h[a],
+          interp_grads[3*(g_off+5) + a]/h[a], interp_grads[3*(g_off+4) + a]/h[a] };
+        sheet_gammai_derivatives(phi, g, interp_grads[a]/h[a], dg, gammai,
+          d_gammai[a]);
+      }
+    }
 
-        real_t W = 0.0;
-        if(follow_null_geodesics)
-        {
-          W = std::sqrt(
-            gammai11 * u1 * u1 + gammai22 * u2 * u2 + gammai33 * u3 * u3
-            + 2.0 * (gammai12 * u1 * u2 + gammai13 * u1 * u3 + gammai23 * u2 * u3 )
-          );
-        }
-        else
-        {
-          W = std::sqrt( 1.0 +
-            gammai11 * u1 * u1 + gammai22 * u2 * u2 + gammai33 * u3 * u3
-            + 2.0 * (gammai12 * u1 * u2 + gammai13 * u1 * u3 + gammai23 * u2 * u3 )
-          );
-        }
+    real_t W = 0.0;
+    if(follow_null_geodesics)
+    {
+      W = std::sqrt(
+        gammai11 * u1 * u1 + gammai22 * u2 * u2 + gammai33 * u3 * u3
+        + 2.0 * (gammai12 * u1 * u2 + gammai13 * u1 * u3 + gammai23 * u2 * u3 )
+      );
+    }
+    else
+    {
+      W = std::sqrt( 1.0 +
+        gammai11 * u1 * u1 + gammai22 * u2 * u2 + gammai33 * u3 * u3
+        + 2.0 * (gammai12 * u1 * u2 + gammai13 * u1 * u3 + gammai23 * u2 * u3 )
+      );
+    }
 
-        real_t U0 = W/(DIFFalpha + 1.0);
-        
-        Dx._c(i,j,k) = (gammai11 * u1 + gammai12 * u2 + gammai13 * u3) / U0 - beta1;
-        Dy._c(i,j,k) = (gammai12 * u1 + gammai22 * u2 + gammai23 * u3) / U0 - beta2;
-        Dz._c(i,j,k) = (gammai13 * u1 + gammai23 * u2 + gammai33 * u3) / U0 - beta3;
-
-        vx._c(i,j,k) = -1.0*W*d1alpha + u1*d1beta1 + u2*d1beta2 + u3*d1beta3
-          -0.5 / U0 * (
-            d1gammai11 * u1 * u1 + d1gammai22 * u2 * u2 + d1gammai33 * u3 * u3
-            + 2.0 * (d1gammai12 * u1 * u2 + d1gammai13 * u1 * u3 + d1gammai23 * u2 * u3)
-          );
-
-        vy._c(i,j,k) = -1.0*W*d2alpha + u1*d2beta1 + u2*d2beta2 + u3*d2beta3
-          -0.5 / U0 * (
-            d2gammai11 * u1 * u1 + d2gammai22 * u2 * u2 + d2gammai33 * u3 * u3
-            + 2.0 * (d2gammai12 * u1 * u2 + d2gammai13 * u1 * u3 + d2gammai23 * u2 * u3)
-          );
-
-        vz._c(i,j,k) = -1.0*W*d3alpha + u1*d3beta1 + u2*d3beta2 + u3*d3beta3
-          -0.5 / U0 * (
-            d3gammai11 * u1 * u1 + d3gammai22 * u2 * u2 + d3gammai33 * u3 * u3
-            + 2.0 * (d3gammai12 * u1 * u2 + d3gammai13 * u1 * u3 + d3gammai23 * u2 * u3)
-          );
-      }
+    real_t U0 = W/(DIFFalpha + 1.0);
+    
+    Dx._c(i,j,k) = (gammai11 * u1 + gammai12 * u2 + gammai13 * u3) / U0 - beta1;
+    Dy._c(i,j,k) = (gammai12 * u1 + gammai22 * u2 + gammai23 * u3) / U0 - beta2;
+    Dz._c(i,j,k) = (gammai13 * u1 + gammai23 * u2 + gammai33 * u3) / U0 - beta3;
+
+    register_t * v[3] = { &vx, &vy, &vz };
+    for(idx_t a=0; a<3; ++a)
+      v[a]->_c(i,j,k) = -1.0*W*d_alpha[a]
+        + u1*d_beta[a][0] + u2*d_beta[a][1] + u3*d_beta[a][2]
+        -0.5 / U0 * (
+          d_gammai[a][0] * u1 * u1 + d_gammai[a][1] * u2 * u2 + d_gammai[a][2] * u3 * u3
+          + 2.0 * (d_gammai[a][3] * u1 * u2 + d_gammai[a][4] * u1 * u3 + d_gammai[a][5] * u2 * u3)
+        );
+  }
 
   if(rescale_sheet) rescaleAllFieldPerturbations(bssn, 1.0/rescale_sheet);
 }
 
+/**
+ * @brief      Fraction of consecutive elements (in element_order) whose _p
+ *  positions lie in grid cells that are not neighbors, i.e. whose tricubic
+ *  stencils do not overlap; a proxy for the cache-miss rate of the
+ *  interpolation and deposition loops.
+ */
+real_t Sheet::_getElementOrderJumpFraction()
+{
+  const idx_t n_elements = ns1*ns2*ns3;
+  const idx_t N[3] = { NX, NY, NZ };
+  idx_t jumps = 0;
+
+# pragma omp parallel for reduction(+:jumps)
+  for(idx_t e=1; e<n_elements; ++e)
+  {
+    idx_t cells[2][3];
+    for(idx_t m=0; m<2; ++m)
+    {
+      idx_t s1, s2, s3;
+      _getElementIndices(element_order[e-m], s1, s2, s3);
+      cells[m][0] = idx_t_mod(std::floor((_S1IDXtoX0(s1) + Dx._p(s1,s2,s3))/dx), NX);
+      cells[m][1] = idx_t_mod(std::floor((_S2IDXtoY0(s2) + Dy._p(s1,s2,s3))/dy), NY);
+      cells[m][2] = idx_t_mod(std::floor((_S3IDXtoZ0(s3) + Dz._p(s1,s2,s3))/dz), NZ);
+    }
+    for(idx_t d=0; d<3; ++d)
+    {
+      idx_t sep = std::abs(cells[0][d] - cells[1][d]);
+      if(std::min(sep, N[d] - sep) > 1)
+      {
+        jumps++;
+        break;
+      }
+    }
+  }
+
+  return n_elements > 1 ? (real_t) jumps / (real_t) (n_elements - 1) : 0.0;
+}
+
+/**
+ * @brief      Order sheet elements along a Morton curve in Eulerian space
+ * @details    Elements are ordered by the grid cell containing their _p
+ *  position, so that consecutive elements in the RKStep and addBSSNSource
+ *  loops gather from (and deposit to) nearby gridpoints even after shell
+ *  crossing. Only element_order is changed; the Lagrangian storage is not.
+ *  With "sheet_sort_log" set, the fraction of non-neighboring consecutive
+ *  elements before and after sorting is logged.
+ */
+void Sheet::sortElements()
+{
+  ctx->timer["Sheet::sortElements"].start();
+
+  const idx_t n_elements = ns1*ns2*ns3;
+  const bool report = log_sort && iodata != NULL;
+  real_t jumps_before = report ? _getElementOrderJumpFraction() : 0.0;
+
+  std::vector< std::pair<idx_t, idx_t> > keys(n_elements);
+# pragma omp parallel for
+  for(idx_t e=0; e<n_elements; ++e)
+  {
+    idx_t s1, s2, s3;
+    _getElementIndices(e, s1, s2, s3);
+    idx_t i = idx_t_mod(std::floor((_S1IDXtoX0(s1) + Dx._p(s1,s2,s3))/dx), NX);
+    idx_t j = idx_t_mod(std::floor((_S2IDXtoY0(s2) + Dy._p(s1,s2,s3))/dy), NY);
+    idx_t k = idx_t_mod(std::floor((_S3IDXtoZ0(s3) + Dz._p(s1,s2,s3))/dz), NZ);
+    keys[e] = std::make_pair(morton_key(i, j, k, SHEET_MORTON_BITS), e);
+  }
+  std::sort(keys.begin(), keys.end());
+  for(idx_t e=0; e<n_elements; ++e)
+    element_order[e] = keys[e].second;
+
+  if(report)
+    iodata->log("Reordered sheet elements; non-neighboring consecutive elements: "
+      + stringify(jumps_before) + " -> " + stringify(_getElementOrderJumpFraction()));
+
+  steps_since_sort = 0;
+  ctx->timer["Sheet::sortElements"].stop();
+}
+
 void Sheet::stepInit()
 {
   Dx.stepInit();
@@ -878,6 +1197,10 @@ void Sheet::stepInit()
   vx.stepInit();
   vy.stepInit();
   vz.stepInit();
+
+  if(sort_interval > 0 && steps_since_sort >= sort_interval)
+    sortElements();
+  steps_since_sort++;
 }
 
 void Sheet::K1Finalize()
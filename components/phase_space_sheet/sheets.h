@@ -24,8 +24,11 @@
 #include "../../utils/Timer.h"
 #include "../../cosmo_types.h"
 #include "../bssn/bssn.h"
+#include "../matter/MatterComponent.h"
 #include "../../utils/TriCubicInterpolator.h"
+#include "../../utils/TriCubicStencil.h"
 #include "../Lambda/lambda.h"
+#include "../../IO/IOData.h"
 #include <cmath>
 #include <algorithm>
 #include <iostream>
@@ -41,12 +44,62 @@ namespace cosmo
 {
 
 
+/**
+ * @brief Per-thread accumulator for depositing sheet sources
+ * @details Planes of constant x are allocated (and zeroed) only once
+ *  touched, and planes not touched in the previous deposit are released
+ *  on reset. With Morton-ordered elements a thread's part of the sheet
+ *  still spans a large fraction (roughly NX/4 to NX/2) of the planes, so
+ *  this can approach a copy of the sources per thread; the TILES
+ *  strategy avoids this. Source components are interleaved at each
+ *  point.
+ */
+struct SheetDepositPlanes
+{
+  std::vector< std::vector<real_t> > planes;
+  std::vector<char> used;
+
+  void reset(idx_t n_planes)
+  {
+    planes.resize(n_planes);
+    used.resize(n_planes, 0);
+    for(idx_t x=0; x<n_planes; ++x)
+    {
+      if(!used[x])
+        std::vector<real_t>().swap(planes[x]);
+      used[x] = 0;
+    }
+  }
+
+  real_t * plane(idx_t x, idx_t plane_size)
+  {
+    if(!used[x])
+    {
+      planes[x].assign(plane_size, 0.0);
+      used[x] = 1;
+    }
+    return planes[x].data();
+  }
+};
+
+/**
+ * @brief Position (in grid index units) and source values of a mass
+ *  carrier, stored for tiled deposition.
+ */
+struct SheetCarrier
+{
+  real_t x_idx, y_idx, z_idx;
+  real_t src[11]; ///< rho, S, S1, S2, S3, STF11, STF12, STF13, STF22, STF23, STF33
+};
+
 /**
  * Class used to run a sheet sim.
  */
-class Sheet
+class Sheet : public MatterComponent
 {
 public:
+  SimContext * ctx; ///< context of the simulation
+
   // Simulation information
   idx_t nx, ny, nz;
   idx_t ns1, ns2, ns3; ///< Phase-space sheet resolution
@@ -57,6 +110,13 @@ public:
   register_t vx, vy, vz; ///< Phase-space velocity fields
   
   arr_t tmp; ///< Array for misc. tmp storage (such as deconvolving)
+  std::vector<SheetDepositPlanes> deposit_buffers; ///< one per thread
+  std::vector< std::vector<SheetCarrier> > deposit_carriers; ///< one per thread
+  std::vector<idx_t> tile_carrier_start; ///< carriers binned by tile
+  std::vector<SheetCarrier *> tile_carriers;
+  std::vector< std::vector<real_t> > tile_buffers; ///< tiles + ghost margins
+
+  real_t source_mass; ///< mass deposited as a BSSN source by a MatterDriver (0: not a source, eg. rays)
 
   bool follow_null_geodesics;
   real_t rescale_sheet;
@@ -64,6 +124,12 @@ public:
 
   idx_t step;
 
+  std::vector<idx_t> element_order; ///< flat s-indices, in processing order
+  idx_t sort_interval; ///< reorder elements every sort_interval steps (0: never)
+  idx_t steps_since_sort;
+  bool log_sort; ///< log how well ordered elements are when sorting (costly)
+  IOData * iodata; ///< log for sorting reports; may be NULL
+
   // internal types
   enum carrierCountScheme { per_dx = 0, per_ds = 1};
   carrierCountScheme carrier_count_scheme;
@@ -71,11 +137,22 @@ public:
   enum depositScheme { CIC = 0, PCS = 1, CINT = 2 };
   depositScheme deposit;
 
+  enum depositStrategy { PLANES = 0, TILES = 1 };
+  depositStrategy deposit_strategy;
+  idx_t deposit_tile_size;
+
   idx_t carriers_per_dx,
         carriers_per_dy,
         carriers_per_dz;
 
-  Sheet();
+  // metric derivatives used in the sheet evolution: from full-grid
+  // derivative arrays (below), or from the gradient of the tricubic
+  // interpolant at each sheet element (second-order accurate; no extra
+  // grids are allocated)
+  enum metricDerivatives { DERIVATIVE_GRIDS = 0, INTERPOLANT_GRADIENT = 1 };
+  metricDerivatives metric_derivatives;
+
+  Sheet(SimContext * ctx_in, IOData * iodata_in = NULL);
   ~Sheet();
 
   void setDt(real_t dt);
@@ -90,17 +167,23 @@ public:
   real_t _S2IDXtoY0(real_t s2) {  return (real_t)s2*ly/(real_t)ns2; }
   real_t _S3IDXtoZ0(real_t s3) {  return (real_t)s3*lz/(real_t)ns3; }
 
-  void _MassDeposit(real_t weight, real_t x_idx, real_t y_idx, real_t z_idx,
-                    arr_t &rho);
+  /**
+   * Split a flat element index (as in element_order) into s-indices
+   */
+  void _getElementIndices(idx_t e, idx_t & s1, idx_t & s2, idx_t & s3)
+  {
+    s3 = e % ns3;
+    s2 = (e / ns3) % ns2;
+    s1 = e / ns3 / ns2;
+  }
 
-  void _CICDeposit(real_t weight, real_t x_idx, real_t y_idx, real_t z_idx,
-                   arr_t &rho);
+  real_t _getElementOrderJumpFraction();
+  void sortElements();
 
-  void _PCSDeposit(real_t weight, real_t x_idx, real_t y_idx, real_t z_idx,
-                   arr_t &rho);
+  void _getDepositStencil(real_t x_idx, real_t y_idx, real_t z_idx,
+                          idx_t start[3], idx_t n[3], real_t * weights);
 
-  void _CINTDeposit(real_t weight, real_t x_idx, real_t y_idx, real_t z_idx,
-                   arr_t &rho);
+  void _depositCarriersTiled(real_t ** source_fields);
 
   void _deconvolve(arr_t &field);
 
@@ -136,6 +219,14 @@ public:
                             idx_t s3_idx, real_t X0_lower, real_t X0_upper);
 
   void addBSSNSource(BSSN *bssn, real_t tot_mass);
+  void depositBSSNSrc(BSSN *bssn, real_t tot_mass);
+
+  // MatterComponent interface
+  bool depositsBSSNSrc() { return source_mass != 0.0; }
+  void depositBSSNSrc(BSSN *bssn);
+  bool tracefreeBSSNSrc() { return source_mass != 0.0; }
+  void RKEvolveNonlocal(BSSN *bssn);
+  void subcycleInit(BSSN *bssn) { stepInit(); }
 
   void rescaleFieldPerturbations(arr_t & field, real_t multiplier);
   void rescaleVelocityPerturbations(arr_t & ux, arr_t & uy, arr_t & uz, real_t multiplier);
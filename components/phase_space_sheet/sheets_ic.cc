@@ -1,7 +1,7 @@
 #include "sheets_ic.h"
+#include "sheets_ic_inversion.h"
 #include "../../cosmo_includes.h"
 #include "../../cosmo_types.h"
-#include "../../cosmo_globals.h"
 #include "../../utils/Fourier.h"
 #include "../../utils/math.h"
 #include <iomanip>
@@ -18,6 +18,7 @@ void sheets_ic_sinusoid_3d(
 {
   iodata->log("Setting sinusoidal ICs.");
   idx_t i, j, k;
+  const real_t inv_dx = sheetSim->ctx->inv_dx;
 
   // conformal factor
   arr_t & DIFFphi_p = *bssnSim->fields["DIFFphi_p"];
@@ -30,7 +31,7 @@ void sheets_ic_sinusoid_3d(
   arr_t & Dy = sheetSim->Dy._array_p;
   arr_t & Dz = sheetSim->Dz._array_p;
   
-  real_t A = sheetSim->lx*sheetSim->lx*std::stod(_config("peak_amplitude", "0.0001"));
+  real_t A = sheetSim->lx*sheetSim->lx*std::stod(sheetSim->ctx->config("peak_amplitude", "0.0001"));
   iodata->log( "Generating ICs with peak amp. = " + stringify(A) );
 
   real_t rho_FRW = 3.0/PI/8.0;
@@ -71,7 +72,7 @@ void sheets_ic_sinusoid_3d(
     DIFFr_a[idx] = rho;
   }
   
-  idx_t integration_points_per_dx = std::stod(_config("integration_points_per_dx", "1000"));
+  idx_t integration_points_per_dx = std::stod(sheetSim->ctx->config("integration_points_per_dx", "1000"));
   idx_t integration_points_per_dy = integration_points_per_dx;
   idx_t integration_points_per_dz = integration_points_per_dx;
   idx_t integration_points_x = NX * integration_points_per_dx;
@@ -315,148 +316,18 @@ void sheets_ic_sinusoid_3d(
       for(int k = 0; k < NZ; k++)
       {
         real_t err = fabs(DIFFr_a[NP_INDEX(i, j, k)] / rho_s
-                          - ((derivative(i, j, k, 1, s1) + 1.0)
-                             * (derivative(0, j, k, 2, s2) + 1.0)
-                             * (derivative(0, 0, k, 3, s3) + 1.0)));
+                          - ((derivative(i, j, k, 1, s1, inv_dx) + 1.0)
+                             * (derivative(0, j, k, 2, s2, inv_dx) + 1.0)
+                             * (derivative(0, 0, k, 3, s3, inv_dx) + 1.0)));
         if(err > max_err) max_err_i = i;
         max_err = std::max(max_err, err);
       }
   
   std::cout<<"Max error to Eq. 10 is "<<max_err<<" at "<<max_err_i<<"\n";
 
-  const int b_search_interation_limit = 20;
-  real_t max_inverse_deviation = 0;
-
-  // reverse to get s3
-#pragma omp parallel for
-  for(int k =0; k < sheetSim->ns3; k++)
-  {
-    real_t cur_s3 = ((real_t)k / sheetSim->ns3) * sheetSim->lz;
-
-    real_t z = cur_s3;
-
-    real_t dz_cur = 0;
-
-    real_t dz_lower = -z, dz_upper = (real_t)sheetSim->lz - z;
-        
-    int iter_cnt = 0;
-    idx_t z_idx;
-    while(iter_cnt <= b_search_interation_limit)
-    {
-      dz_cur = (dz_lower + dz_upper) / 2.0;
-
-      z_idx = (z + dz_cur) / dx;
-
-      if(z+dz_cur + s3.getTriCubicInterpolatedValue(0,0,z_idx) < cur_s3)
-      {
-        dz_lower = dz_cur;
-      }
-      else
-      {
-        dz_upper = dz_cur;
-      }
-      iter_cnt++;
-    }
-
-    for(int i = 0; i < sheetSim->ns1; i++)
-      for(int j = 0; j < sheetSim->ns2; j++)
-        Dz(i, j, k) = dz_cur;
-
-  }
-
-  // reverse to get s2
-#pragma omp parallel for collapse(2)
-  for(int j =0; j < sheetSim->ns2; j++)
-  {
-    for(int k =0; k < sheetSim->ns3; k++)
-    {
-      real_t cur_s2 = ((real_t)j / sheetSim->ns2) * sheetSim->ly;
-      real_t cur_s3 = ((real_t)k / sheetSim->ns3) * sheetSim->lz;
-
-      real_t z = cur_s3 + Dz(0, 0, k);
-      real_t y = cur_s2;
-
-      real_t dy_cur = 0;
-
-      real_t dy_lower = -y, dy_upper = (real_t)sheetSim->ly - y;
-        
-      int iter_cnt = 0;
-      real_t y_idx, z_idx;
-      while(iter_cnt <= b_search_interation_limit)
-      {
-        dy_cur = (dy_lower + dy_upper) / 2.0;
-
-        y_idx = (y + dy_cur) / dx;
-        z_idx = z / dx;
-
-        if(y+dy_cur + s2.getTriCubicInterpolatedValue(0,y_idx,z_idx) < cur_s2)
-        {
-          dy_lower = dy_cur;
-        }
-        else
-        {
-          dy_upper = dy_cur;
-        }
-        iter_cnt++;
-      }
-
-      for(int i = 0; i < sheetSim->ns1; i++)
-          Dy(i, j, k) = dy_cur;
-
-    }
-  }
-
-  // reverset to get s1
-#pragma omp parallel for collapse(2) reduction(max:max_inverse_deviation)
-  for(int i =0; i < sheetSim->ns1; i++)
-  {
-    for(int j = 0; j < sheetSim->ns2; j++)
-    {
-      for(int k =0; k < sheetSim->ns3; k ++)
-      {
-        real_t cur_s1 = ((real_t)i / sheetSim->ns1) * sheetSim->lx;
-        real_t cur_s2 = ((real_t)j / sheetSim->ns2) * sheetSim->ly;
-        real_t cur_s3 = ((real_t)k / sheetSim->ns3) * sheetSim->lz;
-
-        real_t x = cur_s1;
-        real_t y = cur_s2 + Dy(0, j, k);
-        real_t z = cur_s3 + Dz(0 , 0, k);
-
-        real_t dx_cur = 0;
-
-        real_t dx_lower = -x, dx_upper = (real_t)sheetSim->lx - x;
-        
-        int iter_cnt = 0;
-        real_t x_idx, y_idx, z_idx;
-        while(iter_cnt <= b_search_interation_limit)
-        {
-          dx_cur = (dx_lower + dx_upper) / 2.0;
-          x_idx = (x + dx_cur) / dx;
-          y_idx = y / dx;
-          z_idx = z / dx;
-
-          if(x+dx_cur + s1.getTriCubicInterpolatedValue(x_idx,y_idx,z_idx) < cur_s1)
-          {
-            dx_lower = dx_cur;
-          }
-          else
-          {
-            dx_upper = dx_cur;
-          }
-          iter_cnt++;
-        }
-        Dx(i, j, k) = dx_cur;
-        max_inverse_deviation = std::max(max_inverse_deviation,
-                                 (real_t) fabs(x+dx_cur+s1.getTriCubicInterpolatedValue(x_idx,y_idx,z_idx) - cur_s1));
-        max_inverse_deviation = std::max(max_inverse_deviation,
-                                 (real_t) fabs(y+s2.getTriCubicInterpolatedValue(x_idx,y_idx,z_idx) - cur_s2));
-        max_inverse_deviation = std::max(max_inverse_deviation,
-                                 (real_t) fabs(z+s3.getTriCubicInterpolatedValue(x_idx,y_idx,z_idx) - cur_s3));
-
-      }
-    }
-  }
-  
+  // invert s = x + f(x) for the displacements
+  real_t max_inverse_deviation = sheets_ic_invert_displacement_map(sheetSim,
+    s1, s2, s3, Dx, Dy, Dz);
 
   std::cout<<"The inversion of function brings an deviation of "<<max_inverse_deviation<<"\n";
     
@@ -506,7 +377,8 @@ real_t semianalytic_int_rhodg(real_t x, real_t L, real_t A, real_t rho_m)
            (L*L)*rho_m*(200*A*(8 + 3*(A*A))*std::cos((6*PI*x)/L) - 72*(A*A*A)*std::cos((10*PI*x)/L) - 225*(16 + 16*(A*A) + (A*A*A*A))*std::sin((4*PI*x)/L) + 45*(A*A)*(10 + (A*A))*std::sin((8*PI*x)/L) - 5*(A*A*A*A)*std::sin((12*PI*x)/L)))))/
    (1920.*(L*L)*PI); // returns something with units of m
 }
-real_t semianalytic_x_at_target_xmass( real_t xm_target, real_t L, real_t A, real_t rho_m )
+real_t semianalytic_x_at_target_xmass( real_t xm_target, real_t L, real_t A, real_t rho_m,
+  real_t dx )
 {
   real_t int_rhodg_0 = semianalytic_int_rhodg(0.0, L, A, rho_m);
 
@@ -548,10 +420,10 @@ void sheets_ic_semianalytic(BSSN *bssnSim, Sheet *sheetSim,
   real_t K_FRW = -3.0;
   real_t rho_FRW = 3.0/PI/8.0;
   real_t L = sheetSim->lx;
-  real_t A = std::stod(_config("peak_amplitude", "0.0001"))*0.026699*L*L; // A -> sigma rho / rho
+  real_t A = std::stod(sheetSim->ctx->config("peak_amplitude", "0.0001"))*0.026699*L*L; // A -> sigma rho / rho
   iodata->log( "Generating ICs with peak amp. = " + stringify(A) );
 
-  real_t Omega_L = std::stod(_config("Omega_L", "0.0"));
+  real_t Omega_L = std::stod(sheetSim->ctx->config("Omega_L", "0.0"));
   real_t rho_m = (1.0 - Omega_L) * rho_FRW;
   real_t rho_L = Omega_L * rho_FRW;
   lambda->setLambda(rho_L);
@@ -568,7 +440,7 @@ void sheets_ic_semianalytic(BSSN *bssnSim, Sheet *sheetSim,
   LOOP3(i,j,k)
   {
     idx_t idx = NP_INDEX(i,j,k);
-    real_t x = ((real_t) i) * dx;
+    real_t x = ((real_t) i) * bssnSim->ctx->dx;
     DIFFphi_p[NP_INDEX(i,j,k)] = semianalytic_phi(x, L, A);
     DIFFphi_a[NP_INDEX(i,j,k)] = DIFFphi_p[NP_INDEX(i,j,k)];
     DIFFK_p[idx] = K_FRW;
@@ -583,7 +455,7 @@ void sheets_ic_semianalytic(BSSN *bssnSim, Sheet *sheetSim,
   for(tracer_num=0; tracer_num<sheetSim->ns1; tracer_num++)
   {
     real_t xmass_target = xmass_per_tracer*tracer_num;
-    real_t x_m = semianalytic_x_at_target_xmass(xmass_target, L, A, rho_m);
+    real_t x_m = semianalytic_x_at_target_xmass(xmass_target, L, A, rho_m, bssnSim->ctx->dx);
     real_t x_ref = tracer_num/(real_t) sheetSim->ns1*L;
 
     for(j=0; j<sheetSim->ns2; j++)
@@ -611,13 +483,13 @@ void sheets_ic_sinusoid(
   arr_t & DIFFr_a = *bssnSim->fields["DIFFr_a"];
   arr_t & Dx = sheetSim->Dx._array_p;
   
-  real_t A = sheetSim->lx*sheetSim->lx*std::stod(_config("peak_amplitude", "0.0001"));
+  real_t A = sheetSim->lx*sheetSim->lx*std::stod(sheetSim->ctx->config("peak_amplitude", "0.0001"));
   iodata->log( "Generating ICs with peak amp. = " + stringify(A) );
 
   real_t K_FRW = -3.0;
   real_t rho_FRW = 3.0/PI/8.0;
   
-  real_t Omega_L = std::stod(_config("Omega_L", "0.0"));
+  real_t Omega_L = std::stod(sheetSim->ctx->config("Omega_L", "0.0"));
   real_t rho_m = (1.0 - Omega_L) * rho_FRW;
   real_t rho_L = Omega_L * rho_FRW;
   lambda->setLambda(rho_L);
@@ -653,7 +525,7 @@ void sheets_ic_sinusoid(
     DIFFr_a[idx] = rho;
   }
 
-  idx_t integration_points = sheetSim->ns1 * std::stoi(_config("integration_points_per_dx", "1000"));
+  idx_t integration_points = sheetSim->ns1 * std::stoi(sheetSim->ctx->config("integration_points_per_dx", "1000"));
   std::cout << "Setting initial conditions using " << integration_points << " integration_points" << std::endl;
   real_t integration_interval = sheetSim->lx / integration_points;
   tot_mass = 0;
@@ -731,6 +603,7 @@ void sheets_ic_sinusoid_3d_diffusion(
   iodata->log("Setting sinusoidal 3D ICs with diffusion method");
 
   idx_t i, j, k;
+  const real_t inv_dx = sheetSim->ctx->inv_dx;
 
 
   // conformal factor
@@ -750,17 +623,17 @@ void sheets_ic_sinusoid_3d_diffusion(
   arr_t & Dy_a = sheetSim->Dy._array_a;
   arr_t & Dz_a = sheetSim->Dz._array_a;
   
-  real_t A = sheetSim->lx*sheetSim->lx*std::stod(_config("peak_amplitude", "0.0001"));
+  real_t A = sheetSim->lx*sheetSim->lx*std::stod(sheetSim->ctx->config("peak_amplitude", "0.0001"));
 
   // setting iteration stuff
-  real_t damping_coef = sheetSim->lx * sheetSim->lx * std::stod(_config("damping_coef", "0.1"));
+  real_t damping_coef = sheetSim->lx * sheetSim->lx * std::stod(sheetSim->ctx->config("damping_coef", "0.1"));
   
   iodata->log( "Generating ICs with peak amp. = " + stringify(A) );
 
   real_t rho_FRW = 3.0/PI/8.0;
   real_t K_FRW = -sqrt(24.0*PI*rho_FRW);
 
-  real_t Omega_L = std::stod(_config("Omega_L", "0.0"));
+  real_t Omega_L = std::stod(sheetSim->ctx->config("Omega_L", "0.0"));
   real_t rho_m = (1.0 - Omega_L) * rho_FRW;
   real_t rho_L = Omega_L * rho_FRW;
   lambda->setLambda(rho_L);
@@ -819,7 +692,7 @@ void sheets_ic_sinusoid_3d_diffusion(
   }
   
 
-  idx_t integration_points_per_dx = std::stod(_config("integration_points_per_dx", "1000"));
+  idx_t integration_points_per_dx = std::stod(sheetSim->ctx->config("integration_points_per_dx", "1000"));
   idx_t integration_points_per_dy = integration_points_per_dx;
   idx_t integration_points_per_dz = integration_points_per_dx;
   idx_t integration_points_x = NX * integration_points_per_dx;
@@ -874,7 +747,7 @@ void sheets_ic_sinusoid_3d_diffusion(
   tot_mass = tot_mass_tmp;
   std::cout<<"Total mass is "<<tot_mass<<"\n";
 
-  int read_from_file = std::stoi(_config("set_initial_from_file", "0"));
+  int read_from_file = std::stoi(sheetSim->ctx->config("set_initial_from_file", "0"));
 
   if(read_from_file)
   {
@@ -920,7 +793,8 @@ void sheets_ic_sinusoid_3d_diffusion(
 
   Fourier * fourier;
   fourier = new Fourier();
-  fourier->Initialize(NX, NY, NZ);
+  fourier->Initialize(NX, NY, NZ,
+    std::stoi(sheetSim->ctx->config("fft_pencil_columns", "1")));
 
   fourier->inverseLaplacian <idx_t, real_t> (fourier_temp._array);
 
@@ -932,145 +806,15 @@ void sheets_ic_sinusoid_3d_diffusion(
       for(idx_t k = 0; k < NZ; k++)
       {
         idx_t idx = NP_INDEX(i,j,k);
-        d1phi[idx] = derivative(i, j, k, 1, fourier_temp);
-        d2phi[idx] = derivative(i, j, k, 2, fourier_temp);
-        d3phi[idx] = derivative(i, j, k, 3, fourier_temp);
+        d1phi[idx] = derivative(i, j, k, 1, fourier_temp, inv_dx);
+        d2phi[idx] = derivative(i, j, k, 2, fourier_temp, inv_dx);
+        d3phi[idx] = derivative(i, j, k, 3, fourier_temp, inv_dx);
       }
 
   // staring inverse process
-  const int b_search_interation_limit = 20;
-  real_t max_inverse_deviation = 0;
-
-  // reverse to get s3
-#pragma omp parallel for
-  for(int k =0; k < sheetSim->ns3; k++)
-  {
-    real_t cur_s3 = ((real_t)k / sheetSim->ns3) * sheetSim->lz;
-
-    real_t z = cur_s3;
-
-    real_t dz_cur = 0;
-
-    real_t dz_lower = -z, dz_upper = (real_t)sheetSim->lz - z;
-        
-    int iter_cnt = 0;
-    real_t z_idx;
-    while(iter_cnt <= b_search_interation_limit)
-    {
-      dz_cur = (dz_lower + dz_upper) / 2.0;
-
-      z_idx = (z + dz_cur) / dx;
-
-      if(z+dz_cur + d3phi.getTriCubicInterpolatedValue(0,0,z_idx) < cur_s3)
-      {
-        dz_lower = dz_cur;
-      }
-      else
-      {
-        dz_upper = dz_cur;
-      }
-      iter_cnt++;
-    }
-
-    for(int i = 0; i < sheetSim->ns1; i++)
-      for(int j = 0; j < sheetSim->ns2; j++)
-        Dz_p(i, j, k) = dz_cur;
-
-  }
-
-  // reverse to get s2
-#pragma omp parallel for collapse(2)
-  for(int j =0; j < sheetSim->ns2; j++)
-  {
-    for(int k =0; k < sheetSim->ns3; k++)
-    {
-      real_t cur_s2 = ((real_t)j / sheetSim->ns2) * sheetSim->ly;
-      real_t cur_s3 = ((real_t)k / sheetSim->ns3) * sheetSim->lz;
-
-      real_t z = cur_s3 + Dz_p(0, 0, k);
-      real_t y = cur_s2;
-
-      real_t dy_cur = 0;
-
-      real_t dy_lower = -y, dy_upper = (real_t)sheetSim->ly - y;
-        
-      int iter_cnt = 0;
-      real_t y_idx, z_idx;
-      while(iter_cnt <= b_search_interation_limit)
-      {
-        dy_cur = (dy_lower + dy_upper) / 2.0;
-
-        y_idx = (y + dy_cur) / dx;
-        z_idx = z / dx;
-
-        if(y+dy_cur + d2phi.getTriCubicInterpolatedValue(0,y_idx,z_idx) < cur_s2)
-        {
-          dy_lower = dy_cur;
-        }
-        else
-        {
-          dy_upper = dy_cur;
-        }
-        iter_cnt++;
-      }
-
-      for(int i = 0; i < sheetSim->ns1; i++)
-          Dy_p(i, j, k) = dy_cur;
-
-    }
-  }
-
-  // reverset to get s1
-#pragma omp parallel for collapse(2) reduction(max:max_inverse_deviation)
-  for(int i =0; i < sheetSim->ns1; i++)
-  {
-    for(int j = 0; j < sheetSim->ns2; j++)
-    {
-      for(int k =0; k < sheetSim->ns3; k ++)
-      {
-        real_t cur_s1 = ((real_t)i / sheetSim->ns1) * sheetSim->lx;
-        real_t cur_s2 = ((real_t)j / sheetSim->ns2) * sheetSim->ly;
-        real_t cur_s3 = ((real_t)k / sheetSim->ns3) * sheetSim->lz;
-
-        real_t x = cur_s1;
-        real_t y = cur_s2 + Dy_p(0, j, k);
-        real_t z = cur_s3 + Dz_p(0 , 0, k);
-
-        real_t dx_cur = 0;
-
-        real_t dx_lower = -x, dx_upper = (real_t)sheetSim->lx - x;
-        
-        int iter_cnt = 0;
-        real_t x_idx, y_idx, z_idx;
-        while(iter_cnt <= b_search_interation_limit)
-        {
-          dx_cur = (dx_lower + dx_upper) / 2.0;
-          x_idx = (x + dx_cur) / dx;
-          y_idx = y / dx;
-          z_idx = z / dx;
-
-          if(x+dx_cur + d1phi.getTriCubicInterpolatedValue(x_idx,y_idx,z_idx) < cur_s1)
-          {
-            dx_lower = dx_cur;
-          }
-          else
-          {
-            dx_upper = dx_cur;
-          }
-          iter_cnt++;
-        }
-        Dx_p(i, j, k) = dx_cur;
-        max_inverse_deviation = std::max(max_inverse_deviation,
-                                  (real_t) fabs(x+dx_cur+d1phi.getTriCubicInterpolatedValue(x_idx,y_idx,z_idx) - cur_s1));
-        max_inverse_deviation = std::max(max_inverse_deviation,
-                                  (real_t) fabs(y+d2phi.getTriCubicInterpolatedValue(x_idx,y_idx,z_idx) - cur_s2));
-        max_inverse_deviation = std::max(max_inverse_deviation,
-                                  (real_t) fabs(z+d3phi.getTriCubicInterpolatedValue(x_idx,y_idx,z_idx) - cur_s3));
-
-      }
-    }
-  }
-  
+  // invert s = x + f(x) for the displacements
+  real_t max_inverse_deviation = sheets_ic_invert_displacement_map(sheetSim,
+    d1phi, d2phi, d3phi, Dx_p, Dy_p, Dz_p);
 
   std::cout<<"The inversion of function brings an deviation of "<<max_inverse_deviation<<"\n";
 
@@ -1086,7 +830,7 @@ void sheets_ic_sinusoid_3d_diffusion(
   idx_t ns3 = Dx_a.nz;
 
   idx_t iter_cnt = 0;
-  idx_t iter_cnt_limit = std::stoi(_config("iter_cnt_limit", "0"));
+  idx_t iter_cnt_limit = std::stoi(sheetSim->ctx->config("iter_cnt_limit", "0"));
 
   // doing iteration
   // stop when max_err increase 
@@ -1129,9 +873,9 @@ void sheets_ic_sinusoid_3d_diffusion(
         for(idx_t k = 0; k < NZ; k++)
         {
           idx_t idx = NP_INDEX(i,j,k);
-          drhodx[idx] = derivative(i, j, k, 1, rho_err);
-          drhody[idx] = derivative(i, j, k, 2, rho_err);
-          drhodz[idx] = derivative(i, j, k, 3, rho_err);
+          drhodx[idx] = derivative(i, j, k, 1, rho_err, inv_dx);
+          drhody[idx] = derivative(i, j, k, 2, rho_err, inv_dx);
+          drhodz[idx] = derivative(i, j, k, 3, rho_err, inv_dx);
         }
       
     
@@ -1172,6 +916,7 @@ void sheets_ic_sinusoid_1d_diffusion(
 {
   iodata->log("Setting sinusoidal 1D ICs with diffusion method");
   idx_t i, j, k;
+  const real_t inv_dx = sheetSim->ctx->inv_dx;
 
   // conformal factor
   arr_t & DIFFphi_p = *bssnSim->fields["DIFFphi_p"];
@@ -1184,18 +929,18 @@ void sheets_ic_sinusoid_1d_diffusion(
   arr_t & Dx_p = sheetSim->Dx._array_p;
   arr_t & Dx_a = sheetSim->Dx._array_a;
   
-  real_t A = sheetSim->lx*sheetSim->lx*std::stod(_config("peak_amplitude", "0.0001"));
+  real_t A = sheetSim->lx*sheetSim->lx*std::stod(sheetSim->ctx->config("peak_amplitude", "0.0001"));
 
   // setting iteration stuff
-  real_t precision_goal = pw2(sheetSim->lx/sheetSim->ns1) * std::stod(_config("precision_goal", "1e-6"));
-  real_t damping_coef = sheetSim->lx * sheetSim->lx * std::stod(_config("damping_coef", "0.1"));
+  real_t precision_goal = pw2(sheetSim->lx/sheetSim->ns1) * std::stod(sheetSim->ctx->config("precision_goal", "1e-6"));
+  real_t damping_coef = sheetSim->lx * sheetSim->lx * std::stod(sheetSim->ctx->config("damping_coef", "0.1"));
   
   iodata->log( "Generating ICs with peak amp. = " + stringify(A) );
 
   real_t rho_FRW = 3.0/PI/8.0;
   real_t K_FRW = -sqrt(24.0*PI*rho_FRW);
 
-  real_t Omega_L = std::stod(_config("Omega_L", "0.0"));
+  real_t Omega_L = std::stod(sheetSim->ctx->config("Omega_L", "0.0"));
   real_t rho_m = (1.0 - Omega_L) * rho_FRW;
   real_t rho_L = Omega_L * rho_FRW;
   lambda->setLambda(rho_L);
@@ -1240,7 +985,7 @@ void sheets_ic_sinusoid_1d_diffusion(
   }
   
 
-  idx_t integration_points = std::stod(_config("integration_points_per_dx", "1000"));
+  idx_t integration_points = std::stod(sheetSim->ctx->config("integration_points_per_dx", "1000"));
   std::cout << "Setting initial conditions using " << integration_points<< " integration_points" << std::endl;
   real_t integration_interval = sheetSim->lx / integration_points;
 
@@ -1317,7 +1062,7 @@ void sheets_ic_sinusoid_1d_diffusion(
         for(idx_t k = 0; k < NZ; k++)
         {
           idx_t idx = NP_INDEX(i,j,k);
-          drhodx[idx] = derivative(i, j, k, 1, rho_err);
+          drhodx[idx] = derivative(i, j, k, 1, rho_err, inv_dx);
         }
       
     
@@ -1344,8 +1089,8 @@ void sheets_ic_sinusoid_1d_diffusion(
 void sheets_ic_rays(BSSN *bssnSim, Sheet *raySheet, IOData *iodata)
 {
   // make sure ns1, ns2, ns3 are set "correctly" for now
-  idx_t n_obs = std::pow(std::stoi(_config("observers_per_dim", "1")), 3);
-  idx_t nside = std::stoi(_config("nside", "16"));
+  idx_t n_obs = std::pow(std::stoi(raySheet->ctx->config("observers_per_dim", "1")), 3);
+  idx_t nside = std::stoi(raySheet->ctx->config("nside", "16"));
   idx_t npix = 12*nside*nside;
   if( raySheet->ns1 != n_obs*npix || raySheet->ns2 != 3 || raySheet->ns3 != 1 )
   {
@@ -1377,7 +1122,7 @@ void sheets_ic_rays(BSSN *bssnSim, Sheet *raySheet, IOData *iodata)
   arr_t & vx_p = raySheet->vx._array_p;
   arr_t & vy_p = raySheet->vy._array_p;
   arr_t & vz_p = raySheet->vz._array_p;
-  std::ifstream vecFile(_config["healpix_vecs_file"]);
+  std::ifstream vecFile(raySheet->ctx->config["healpix_vecs_file"]);
   idx_t r = 0;
 
   // fermi transformation components
@@ -1486,7 +1231,7 @@ void sheets_ic_rays(BSSN *bssnSim, Sheet *raySheet, IOData *iodata)
 
   if(r < npix)
   {
-    iodata->log("Warning/error: not all rays initialized correctly (npix > lines in "+_config["healpix_vecs_file"]+").");
+    iodata->log("Warning/error: not all rays initialized correctly (npix > lines in "+raySheet->ctx->config["healpix_vecs_file"]+").");
   }
 
 }
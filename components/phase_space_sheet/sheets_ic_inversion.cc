@@ -0,0 +1,248 @@
+#include "sheets_ic_inversion.h"
+#include "../../cosmo_includes.h"
+
+#define SHEET_IC_INVERSION_MAX_ITERS 50
+
+namespace cosmo
+{
+
+namespace
+{
+
+// Catmull-Rom spline, identical to CosmoArray::CINT
+inline real_t sheet_ic_cint(real_t u, real_t p0, real_t p1, real_t p2, real_t p3)
+{
+  return 0.5*(
+        (u*u*(2.0 - u) - u)*p0
+      + (u*u*(3.0*u - 5.0) + 2)*p1
+      + (u*u*(4.0 - 3.0*u) + u)*p2
+      + u*u*(u - 1.0)*p3
+    );
+}
+
+// Split a grid coordinate into the index "left" of it and a fraction
+inline idx_t sheet_ic_split(real_t u, real_t & frac)
+{
+  idx_t l = u < 0 ? (idx_t) u - 1 : (idx_t) u;
+  frac = u - l;
+  return l;
+}
+
+// Interpolate f along z at (i, j), with z = kl + kd
+inline real_t sheet_ic_interp_z(arr_t & f, idx_t i, idx_t j, idx_t kl, real_t kd)
+{
+  return sheet_ic_cint(kd, f(i, j, kl-1), f(i, j, kl), f(i, j, kl+1), f(i, j, kl+2));
+}
+
+// Interpolate f in the y-z plane at x-index i
+inline real_t sheet_ic_interp_yz(arr_t & f, idx_t i, idx_t jl, real_t jd,
+  idx_t kl, real_t kd)
+{
+  return sheet_ic_cint(jd,
+    sheet_ic_interp_z(f, i, jl-1, kl, kd), sheet_ic_interp_z(f, i, jl, kl, kd),
+    sheet_ic_interp_z(f, i, jl+1, kl, kd), sheet_ic_interp_z(f, i, jl+2, kl, kd));
+}
+
+} // anonymous namespace
+
+/**
+ * @brief      Build the map X -> X + g(X/h) from n periodic samples g
+ */
+void SheetICLine::build(const real_t * g, idx_t n_in, real_t h_in)
+{
+  n = n_in;
+  h = h_in;
+  L = n*h;
+  coefs.resize(4*n);
+  edges.resize(n+1);
+
+  for(idx_t c=0; c<n; ++c)
+  {
+    real_t p0 = g[(c-1+n)%n], p1 = g[c], p2 = g[(c+1)%n], p3 = g[(c+2)%n];
+    coefs[4*c+0] = p1;
+    coefs[4*c+1] = 0.5*(p2 - p0);
+    coefs[4*c+2] = 0.5*(2.0*p0 - 5.0*p1 + 4.0*p2 - p3);
+    coefs[4*c+3] = 0.5*(-p0 + 3.0*p1 - 3.0*p2 + p3);
+    edges[c] = c*h + p1;
+  }
+  edges[n] = L + g[0];
+}
+
+/**
+ * @brief      Find X such that X + g(X/h) = s
+ *
+ * @param[in]  s         Target (Lagrangian) coordinate
+ * @param[out] residual  X + g(X/h) - s at the returned X
+ *
+ * @return     Eulerian coordinate X
+ */
+real_t SheetICLine::invert(real_t s, real_t & residual)
+{
+  // map satisfies F(X + L) = F(X) + L; shift s into [edges[0], edges[n])
+  real_t shift = 0;
+  while(s < edges[0]) { s += L; shift -= L; }
+  while(s >= edges[n]) { s -= L; shift += L; }
+
+  // cell with edges[c] <= s < edges[c+1]
+  idx_t lo = 0, hi = n;
+  while(hi - lo > 1)
+  {
+    idx_t mid = (lo + hi)/2;
+    if(edges[mid] <= s)
+      lo = mid;
+    else
+      hi = mid;
+  }
+  const idx_t c = lo;
+  const real_t * a = &coefs[4*c];
+
+  // F(t) = (c+t)h + a0 + a1 t + a2 t^2 + a3 t^3 - s on t in [0, 1]
+  real_t F_lo = edges[c] - s, F_hi = edges[c+1] - s;
+  real_t t_lo = 0.0, t_hi = 1.0;
+  real_t t = F_hi > F_lo ? -F_lo/(F_hi - F_lo) : 0.5;
+  const real_t tol = 4.0*std::numeric_limits<real_t>::epsilon()*(L + std::fabs(s));
+
+  real_t F = 0;
+  for(int it=0; it<SHEET_IC_INVERSION_MAX_ITERS; ++it)
+  {
+    F = (c+t)*h + a[0] + t*(a[1] + t*(a[2] + t*a[3])) - s;
+    if(std::fabs(F) <= tol)
+      break;
+
+    if(F < 0)
+      t_lo = t;
+    else
+      t_hi = t;
+
+    // Newton step, falling back to bisection if it leaves the bracket
+    real_t dF = h + a[1] + t*(2.0*a[2] + 3.0*t*a[3]);
+    real_t t_new = t - F/dF;
+    if(!(dF > 0) || t_new <= t_lo || t_new >= t_hi)
+      t_new = 0.5*(t_lo + t_hi);
+
+    if(t_new == t)
+      break;
+    t = t_new;
+  }
+  F = (c+t)*h + a[0] + t*(a[1] + t*(a[2] + t*a[3])) - s;
+
+  residual = F;
+  return (c+t)*h + shift;
+}
+
+/**
+ * @brief      Invert X = s + D(s), where s = X + f(X), for displacements D
+ * @details    As in the sheet IC routines, f3 is inverted along the line
+ *  x = y = 0, f2 along y at x = 0, and f1 along x; s3 is inverted first so
+ *  that s2 and s1 lines can be placed at the Eulerian z (and y) positions.
+ *  Each grid line is built once and then inverted for all sheet
+ *  coordinates on it, in parallel over lines.
+ *
+ * @return     Maximum deviation |X + f(X) - s| over all components
+ */
+real_t sheets_ic_invert_displacement_map(Sheet * sheetSim,
+  arr_t & f1, arr_t & f2, arr_t & f3, arr_t & Dx, arr_t & Dy, arr_t & Dz)
+{
+  const idx_t ns1 = sheetSim->ns1, ns2 = sheetSim->ns2, ns3 = sheetSim->ns3;
+  const real_t dx = sheetSim->ctx->dx;
+  real_t max_inverse_deviation = 0;
+
+  // reverse to get s3, along z at x = y = 0
+  {
+    std::vector<real_t> g(f3.nz);
+    for(idx_t k=0; k<f3.nz; ++k)
+      g[k] = f3(0, 0, k);
+    SheetICLine line;
+    line.build(&g[0], f3.nz, dx);
+
+#pragma omp parallel for
+    for(idx_t k=0; k<ns3; k++)
+    {
+      real_t cur_s3 = ((real_t)k / ns3) * sheetSim->lz;
+      real_t residual;
+      real_t dz_cur = line.invert(cur_s3, residual) - cur_s3;
+
+      for(idx_t i=0; i<ns1; i++)
+        for(idx_t j=0; j<ns2; j++)
+          Dz(i, j, k) = dz_cur;
+    }
+  }
+
+  // reverse to get s2, along y at x = 0 and the Eulerian z
+#pragma omp parallel
+  {
+    std::vector<real_t> g(f2.ny);
+    SheetICLine line;
+
+#pragma omp for
+    for(idx_t k=0; k<ns3; k++)
+    {
+      real_t cur_s3 = ((real_t)k / ns3) * sheetSim->lz;
+      real_t kd;
+      idx_t kl = sheet_ic_split((cur_s3 + Dz(0, 0, k)) / dx, kd);
+      for(idx_t j=0; j<f2.ny; ++j)
+        g[j] = sheet_ic_interp_z(f2, 0, j, kl, kd);
+      line.build(&g[0], f2.ny, dx);
+
+      for(idx_t j=0; j<ns2; j++)
+      {
+        real_t cur_s2 = ((real_t)j / ns2) * sheetSim->ly;
+        real_t residual;
+        real_t dy_cur = line.invert(cur_s2, residual) - cur_s2;
+
+        for(idx_t i=0; i<ns1; i++)
+          Dy(i, j, k) = dy_cur;
+      }
+    }
+  }
+
+  // reverse to get s1, along x at the Eulerian y and z
+  const real_t * f23_fields[2] = { f2._array, f3._array };
+#pragma omp parallel reduction(max:max_inverse_deviation)
+  {
+    std::vector<real_t> g(f1.nx);
+    SheetICLine line;
+
+#pragma omp for collapse(2)
+    for(idx_t j=0; j<ns2; j++)
+    {
+      for(idx_t k=0; k<ns3; k++)
+      {
+        real_t cur_s2 = ((real_t)j / ns2) * sheetSim->ly;
+        real_t cur_s3 = ((real_t)k / ns3) * sheetSim->lz;
+
+        real_t y = cur_s2 + Dy(0, j, k);
+        real_t z = cur_s3 + Dz(0, 0, k);
+
+        real_t jd, kd;
+        idx_t jl = sheet_ic_split(y / dx, jd);
+        idx_t kl = sheet_ic_split(z / dx, kd);
+        for(idx_t i=0; i<f1.nx; ++i)
+          g[i] = sheet_ic_interp_yz(f1, i, jl, jd, kl, kd);
+        line.build(&g[0], f1.nx, dx);
+
+        for(idx_t i=0; i<ns1; i++)
+        {
+          real_t cur_s1 = ((real_t)i / ns1) * sheetSim->lx;
+          real_t residual;
+          real_t x = line.invert(cur_s1, residual);
+          Dx(i, j, k) = x - cur_s1;
+
+          max_inverse_deviation = std::max(max_inverse_deviation,
+            (real_t) std::fabs(residual));
+          real_t f23[2];
+          TriCubicStencil<idx_t, real_t> stencil(x/dx, y/dx, z/dx, f2.nx, f2.ny, f2.nz);
+          stencil.interpolate(2, f23_fields, f23);
+          max_inverse_deviation = std::max(max_inverse_deviation,
+            (real_t) std::fabs(y + f23[0] - cur_s2));
+          max_inverse_deviation = std::max(max_inverse_deviation,
+            (real_t) std::fabs(z + f23[1] - cur_s3));
+        }
+      }
+    }
+  }
+
+  return max_inverse_deviation;
+}
+
+} // namespace cosmo
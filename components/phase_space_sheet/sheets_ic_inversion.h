@@ -0,0 +1,41 @@
+/** @file sheets_ic_inversion.h
+ * @brief Inversion of the Lagrangian-to-Eulerian map used to set sheet ICs.
+ */
+
+#ifndef COSMO_SHEETS_IC_INVERSION
+#define COSMO_SHEETS_IC_INVERSION
+
+#include "sheets.h"
+
+namespace cosmo
+{
+
+/**
+ * @brief Piecewise-cubic map X -> X + g(X/h) along one periodic grid line,
+ *  where g is the Catmull-Rom spline through n values (as used by
+ *  CosmoArray::getTriCubicInterpolatedValue).
+ * @details Per-cell polynomial coefficients and the values of the map at
+ *  cell edges are precomputed when the line is built, so inversion is a
+ *  binary search over cells followed by a safeguarded Newton iteration
+ *  using the analytic derivative of the interpolant.
+ */
+class SheetICLine
+{
+  idx_t n;
+  real_t h, L;
+  std::vector<real_t> coefs; ///< 4 coefficients (in powers of t) per cell
+  std::vector<real_t> edges; ///< map evaluated at the n+1 cell edges
+
+public:
+  SheetICLine() : n(0), h(0), L(0) {}
+
+  void build(const real_t * g, idx_t n_in, real_t h_in);
+  real_t invert(real_t s, real_t & residual);
+};
+
+real_t sheets_ic_invert_displacement_map(Sheet * sheetSim,
+  arr_t & f1, arr_t & f2, arr_t & f3, arr_t & Dx, arr_t & Dy, arr_t & Dz);
+
+}
+
+#endif
@@ -1,6 +1,15 @@
 #ifndef SHEET_MACROS
 #define SHEET_MACROS
 
+// upper bound on metric fields interpolated to each sheet element
+#define SHEET_MAX_INTERP_FIELDS 48
+
+// rho, S, S1, S2, S3, STF11, STF12, STF13, STF22, STF23, STF33
+#define SHEET_N_SOURCES 11
+
+// bits per dimension in Morton (Z-order) keys of element positions
+#define SHEET_MORTON_BITS 21
+
 #define SET_GAMMAI_DER_ZERO(I) \
   d##I##gammai11_a(i, j, k) = 0.0; \
   d##I##gammai22_a(i, j, k) = 0.0; \
@@ -11,23 +20,23 @@
 
 
 #define SET_GAMMAI_DER(I) \
-  d##I##gammai11_a(i, j, k) = -4.0*derivative(i, j, k, I, DIFFphi_a)*gammai11 \
-    + std::exp(-4.0*DIFFphi_a(i, j, k))*(derivative(i, j, k, I, DIFFgamma22_a) + derivative(i, j, k, I, DIFFgamma33_a) - 2.0*DIFFgamma23_a(i, j, k)*derivative(i, j, k, I, DIFFgamma23_a) + derivative(i, j, k, I, DIFFgamma22_a)*DIFFgamma33_a(i, j, k) + DIFFgamma22_a(i, j, k)*derivative(i, j, k, I, DIFFgamma33_a)); \
+  d##I##gammai11_a(i, j, k) = -4.0*derivative(i, j, k, I, DIFFphi_a, ctx->inv_dx)*gammai11 \
+    + std::exp(-4.0*DIFFphi_a(i, j, k))*(derivative(i, j, k, I, DIFFgamma22_a, ctx->inv_dx) + derivative(i, j, k, I, DIFFgamma33_a, ctx->inv_dx) - 2.0*DIFFgamma23_a(i, j, k)*derivative(i, j, k, I, DIFFgamma23_a, ctx->inv_dx) + derivative(i, j, k, I, DIFFgamma22_a, ctx->inv_dx)*DIFFgamma33_a(i, j, k) + DIFFgamma22_a(i, j, k)*derivative(i, j, k, I, DIFFgamma33_a, ctx->inv_dx)); \
     \
-  d##I##gammai22_a(i, j, k) = -4.0*derivative(i, j, k, I, DIFFphi_a)*gammai22 \
-    + std::exp(-4.0*DIFFphi_a(i, j, k))*(derivative(i, j, k, I, DIFFgamma11_a) + derivative(i, j, k, I, DIFFgamma33_a) - 2.0*DIFFgamma13_a(i, j, k)*derivative(i, j, k, I, DIFFgamma13_a) + derivative(i, j, k, I, DIFFgamma11_a)*DIFFgamma33_a(i, j, k) + DIFFgamma11_a(i, j, k)*derivative(i, j, k, I, DIFFgamma33_a)); \
+  d##I##gammai22_a(i, j, k) = -4.0*derivative(i, j, k, I, DIFFphi_a, ctx->inv_dx)*gammai22 \
+    + std::exp(-4.0*DIFFphi_a(i, j, k))*(derivative(i, j, k, I, DIFFgamma11_a, ctx->inv_dx) + derivative(i, j, k, I, DIFFgamma33_a, ctx->inv_dx) - 2.0*DIFFgamma13_a(i, j, k)*derivative(i, j, k, I, DIFFgamma13_a, ctx->inv_dx) + derivative(i, j, k, I, DIFFgamma11_a, ctx->inv_dx)*DIFFgamma33_a(i, j, k) + DIFFgamma11_a(i, j, k)*derivative(i, j, k, I, DIFFgamma33_a, ctx->inv_dx)); \
     \
-   d##I##gammai33_a(i, j, k) = -4.0*derivative(i, j, k, I, DIFFphi_a)*gammai33 \
-     + std::exp(-4.0*DIFFphi_a(i, j, k))*(derivative(i, j, k, I, DIFFgamma11_a) + derivative(i, j, k, I, DIFFgamma22_a) - 2.0*DIFFgamma12_a(i,j,k)*derivative(i, j, k, I, DIFFgamma12_a) + derivative(i, j, k, I, DIFFgamma11_a)*DIFFgamma22_a(i, j, k) + DIFFgamma11_a(i, j, k)*derivative(i, j, k, I, DIFFgamma22_a)); \
+   d##I##gammai33_a(i, j, k) = -4.0*derivative(i, j, k, I, DIFFphi_a, ctx->inv_dx)*gammai33 \
+     + std::exp(-4.0*DIFFphi_a(i, j, k))*(derivative(i, j, k, I, DIFFgamma11_a, ctx->inv_dx) + derivative(i, j, k, I, DIFFgamma22_a, ctx->inv_dx) - 2.0*DIFFgamma12_a(i,j,k)*derivative(i, j, k, I, DIFFgamma12_a, ctx->inv_dx) + derivative(i, j, k, I, DIFFgamma11_a, ctx->inv_dx)*DIFFgamma22_a(i, j, k) + DIFFgamma11_a(i, j, k)*derivative(i, j, k, I, DIFFgamma22_a, ctx->inv_dx)); \
     \
-    d##I##gammai12_a(i, j, k) = -4.0*derivative(i, j, k, I, DIFFphi_a)*gammai12 \
-  + std::exp(-4.0*DIFFphi_a(i, j, k))*(derivative(i, j, k, I, DIFFgamma13_a)*DIFFgamma23_a(i, j, k) + DIFFgamma13_a(i, j, k)*derivative(i, j, k, I, DIFFgamma23_a) - derivative(i, j, k, I, DIFFgamma12_a)*(1.0 + DIFFgamma33_a(i, j, k)) - DIFFgamma12_a(i, j, k)*derivative(i, j, k, I, DIFFgamma33_a)); \
+    d##I##gammai12_a(i, j, k) = -4.0*derivative(i, j, k, I, DIFFphi_a, ctx->inv_dx)*gammai12 \
+  + std::exp(-4.0*DIFFphi_a(i, j, k))*(derivative(i, j, k, I, DIFFgamma13_a, ctx->inv_dx)*DIFFgamma23_a(i, j, k) + DIFFgamma13_a(i, j, k)*derivative(i, j, k, I, DIFFgamma23_a, ctx->inv_dx) - derivative(i, j, k, I, DIFFgamma12_a, ctx->inv_dx)*(1.0 + DIFFgamma33_a(i, j, k)) - DIFFgamma12_a(i, j, k)*derivative(i, j, k, I, DIFFgamma33_a, ctx->inv_dx)); \
     \
-    d##I##gammai13_a(i, j, k) = -4.0*derivative(i, j, k, I, DIFFphi_a)*gammai13 \
-  + std::exp(-4.0*DIFFphi_a(i, j, k))*(derivative(i, j, k, I, DIFFgamma12_a)*DIFFgamma23_a(i, j, k) + DIFFgamma12_a(i, j, k)*derivative(i, j, k, I, DIFFgamma23_a) - derivative(i, j, k, I, DIFFgamma13_a)*(1.0 + DIFFgamma22_a(i, j, k)) - DIFFgamma13_a(i, j, k)*derivative(i, j, k, I, DIFFgamma22_a)); \
+    d##I##gammai13_a(i, j, k) = -4.0*derivative(i, j, k, I, DIFFphi_a, ctx->inv_dx)*gammai13 \
+  + std::exp(-4.0*DIFFphi_a(i, j, k))*(derivative(i, j, k, I, DIFFgamma12_a, ctx->inv_dx)*DIFFgamma23_a(i, j, k) + DIFFgamma12_a(i, j, k)*derivative(i, j, k, I, DIFFgamma23_a, ctx->inv_dx) - derivative(i, j, k, I, DIFFgamma13_a, ctx->inv_dx)*(1.0 + DIFFgamma22_a(i, j, k)) - DIFFgamma13_a(i, j, k)*derivative(i, j, k, I, DIFFgamma22_a, ctx->inv_dx)); \
 \
-    d##I##gammai23_a(i, j, k) = -4.0*derivative(i, j, k, I, DIFFphi_a)*gammai23 \
-  + std::exp(-4.0*DIFFphi_a(i, j, k))*(derivative(i, j, k, I, DIFFgamma12_a)*DIFFgamma13_a(i, j, k) + DIFFgamma12_a(i, j, k)*derivative(i, j, k, I, DIFFgamma13_a) - derivative(i, j, k, I, DIFFgamma23_a)*(1.0 + DIFFgamma11_a(i, j, k)) - DIFFgamma23_a(i, j, k)*derivative(i, j, k, I, DIFFgamma11_a)) 
+    d##I##gammai23_a(i, j, k) = -4.0*derivative(i, j, k, I, DIFFphi_a, ctx->inv_dx)*gammai23 \
+  + std::exp(-4.0*DIFFphi_a(i, j, k))*(derivative(i, j, k, I, DIFFgamma12_a, ctx->inv_dx)*DIFFgamma13_a(i, j, k) + DIFFgamma12_a(i, j, k)*derivative(i, j, k, I, DIFFgamma13_a, ctx->inv_dx) - derivative(i, j, k, I, DIFFgamma23_a, ctx->inv_dx)*(1.0 + DIFFgamma11_a(i, j, k)) - DIFFgamma23_a(i, j, k)*derivative(i, j, k, I, DIFFgamma11_a, ctx->inv_dx)) 
 
 
 #endif
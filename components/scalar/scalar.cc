@@ -1,25 +1,29 @@
 #include "scalar.h"
 #include "../../utils/math.h"
 #include "../../cosmo_includes.h"
-#include "../../cosmo_globals.h"
 
 namespace cosmo
 {
 
 /**
  * @brief Constructor: initialize fields needed for scalar evolution,
- * set timestep according to global `dt`.
+ * set timestep according to the `dt` of the simulation context.
  */
-Scalar::Scalar():
+Scalar::Scalar(SimContext * ctx_in):
+  ctx(ctx_in),
   phi(), Pi(), psi1(), psi2(), psi3()
 {
-  std::cout << "Creating scalar class with dt=" << dt << "\n";
+  std::cout << "Creating scalar class with dt=" << ctx->dt << "\n";
 
-  phi.init(NX, NY, NZ, dt);
-  Pi.init(NX, NY, NZ, dt);
-  psi1.init(NX, NY, NZ, dt);
-  psi2.init(NX, NY, NZ, dt);
-  psi3.init(NX, NY, NZ, dt);
+  phi.init(NX, NY, NZ, ctx->dt);
+  Pi.init(NX, NY, NZ, ctx->dt);
+  psi1.init(NX, NY, NZ, ctx->dt);
+  psi2.init(NX, NY, NZ, ctx->dt);
+  psi3.init(NX, NY, NZ, ctx->dt);
+
+  halo_fields = { &phi._array_a, &Pi._array_a,
+    &psi1._array_a, &psi2._array_a, &psi3._array_a };
+  halos_current = false;
 }
 
 Scalar::~Scalar()
@@ -31,6 +35,18 @@ Scalar::~Scalar()
   psi3.~RK4Register();
 }
 
+/**
+ * @brief Set RK step size for fields.
+ */
+void Scalar::setDt(real_t dt)
+{
+  phi.setDt(dt);
+  Pi.setDt(dt);
+  psi1.setDt(dt);
+  psi2.setDt(dt);
+  psi3.setDt(dt);
+}
+
 /**
  * @brief Call RK4Register::stepInit for fields.
  */
@@ -41,6 +57,7 @@ void Scalar::stepInit()
   psi1.stepInit();
   psi2.stepInit();
   psi3.stepInit();
+  halos_current = false;
 }
 
 /**
@@ -53,6 +70,7 @@ void Scalar::K1Finalize()
   psi1.K1Finalize();
   psi2.K1Finalize();
   psi3.K1Finalize();
+  halos_current = false;
 }
 
 void Scalar::K2Finalize()
@@ -62,6 +80,7 @@ void Scalar::K2Finalize()
   psi1.K2Finalize();
   psi2.K2Finalize();
   psi3.K2Finalize();
+  halos_current = false;
 }
 
 void Scalar::K3Finalize()
@@ -71,6 +90,7 @@ void Scalar::K3Finalize()
   psi1.K3Finalize();
   psi2.K3Finalize();
   psi3.K3Finalize();
+  halos_current = false;
 }
 
 void Scalar::K4Finalize()
@@ -80,6 +100,34 @@ void Scalar::K4Finalize()
   psi1.K4Finalize();
   psi2.K4Finalize();
   psi3.K4Finalize();
+  halos_current = false;
+}
+
+/**
+ * @brief Fill halos of the _a register from neighboring MPI processes,
+ * blocking until done; see BSSN::exchangeHalos.
+ */
+void Scalar::exchangeHalos()
+{
+#if USE_MPI
+  if(halos_current) return;
+
+  ctx->timer["halo_exchange"].start();
+  decomposition_exchange_halos(halo_fields);
+  ctx->timer["halo_exchange"].stop();
+#endif
+  halos_current = true;
+}
+
+/**
+ * @brief Append fields with stale halos to a list of fields to be exchanged;
+ * see BSSN::addStaleHaloFields.
+ */
+void Scalar::addStaleHaloFields(std::vector<arr_t *> & fields)
+{
+  if(!halos_current)
+    fields.insert(fields.end(), halo_fields.begin(), halo_fields.end());
+  halos_current = true;
 }
 
 void Scalar::RKEvolvePt(BSSNData *bd)
@@ -106,25 +154,25 @@ ScalarData Scalar::getScalarData(BSSNData *bd)
   sd.psi2 = psi2._array_a[idx];
   sd.psi3 = psi3._array_a[idx];
 
-  sd.d1phi = derivative(i, j, k, 1, phi._array_a);
-  sd.d2phi = derivative(i, j, k, 2, phi._array_a);
-  sd.d3phi = derivative(i, j, k, 3, phi._array_a);
+  sd.d1phi = derivative(i, j, k, 1, phi._array_a, ctx->inv_dx);
+  sd.d2phi = derivative(i, j, k, 2, phi._array_a, ctx->inv_dx);
+  sd.d3phi = derivative(i, j, k, 3, phi._array_a, ctx->inv_dx);
 
-  sd.d1Pi = derivative(i, j, k, 1, Pi._array_a);
-  sd.d2Pi = derivative(i, j, k, 2, Pi._array_a);
-  sd.d3Pi = derivative(i, j, k, 3, Pi._array_a);
+  sd.d1Pi = derivative(i, j, k, 1, Pi._array_a, ctx->inv_dx);
+  sd.d2Pi = derivative(i, j, k, 2, Pi._array_a, ctx->inv_dx);
+  sd.d3Pi = derivative(i, j, k, 3, Pi._array_a, ctx->inv_dx);
 
-  sd.d1psi1 = derivative(i, j, k, 1, psi1._array_a);
-  sd.d2psi1 = derivative(i, j, k, 2, psi1._array_a);
-  sd.d3psi1 = derivative(i, j, k, 3, psi1._array_a);
+  sd.d1psi1 = derivative(i, j, k, 1, psi1._array_a, ctx->inv_dx);
+  sd.d2psi1 = derivative(i, j, k, 2, psi1._array_a, ctx->inv_dx);
+  sd.d3psi1 = derivative(i, j, k, 3, psi1._array_a, ctx->inv_dx);
 
-  sd.d1psi2 = derivative(i, j, k, 1, psi2._array_a);
-  sd.d2psi2 = derivative(i, j, k, 2, psi2._array_a);
-  sd.d3psi2 = derivative(i, j, k, 3, psi2._array_a);
+  sd.d1psi2 = derivative(i, j, k, 1, psi2._array_a, ctx->inv_dx);
+  sd.d2psi2 = derivative(i, j, k, 2, psi2._array_a, ctx->inv_dx);
+  sd.d3psi2 = derivative(i, j, k, 3, psi2._array_a, ctx->inv_dx);
 
-  sd.d1psi3 = derivative(i, j, k, 1, psi3._array_a);
-  sd.d2psi3 = derivative(i, j, k, 2, psi3._array_a);
-  sd.d3psi3 = derivative(i, j, k, 3, psi3._array_a);
+  sd.d1psi3 = derivative(i, j, k, 1, psi3._array_a, ctx->inv_dx);
+  sd.d2psi3 = derivative(i, j, k, 2, psi3._array_a, ctx->inv_dx);
+  sd.d3psi3 = derivative(i, j, k, 3, psi3._array_a, ctx->inv_dx);
 
   return sd;
 }
@@ -198,65 +246,43 @@ real_t Scalar::dt_psi3(BSSNData *bd, ScalarData *sd)
   );
 }
 
-void Scalar::addBSSNSource(BSSN * bssn)
+/**
+ * @brief Add scalar field contributions to BSSN sources at a point
+ */
+void Scalar::addBSSNSrcPt(BSSN * bssn, BSSNData *bd)
 {
-  arr_t & DIFFr_a = *bssn->fields["DIFFr_a"];
-  arr_t & DIFFS_a = *bssn->fields["DIFFS_a"];
-  arr_t & S1_a = *bssn->fields["S1_a"];
-  arr_t & S2_a = *bssn->fields["S2_a"];
-  arr_t & S3_a = *bssn->fields["S3_a"];
-  arr_t & STF11_a = *bssn->fields["STF11_a"];
-  arr_t & STF12_a = *bssn->fields["STF12_a"];
-  arr_t & STF13_a = *bssn->fields["STF13_a"];
-  arr_t & STF22_a = *bssn->fields["STF22_a"];
-  arr_t & STF23_a = *bssn->fields["STF23_a"];
-  arr_t & STF33_a = *bssn->fields["STF33_a"];
-
-  idx_t i, j, k;
-
-  #pragma omp parallel for default(shared) private(i, j, k)
-  LOOP3(i, j, k)
-  {
-    idx_t idx = INDEX(i,j,k);
-
-    BSSNData bd = {0};
-    // TODO: remove redundant computations here?
-    bssn->set_bd_values(i, j, k, &bd);
-    ScalarData sd = getScalarData(&bd);
-
-    // n^mu d_mu phi
-    real_t nmudmuphi = (
-      dt_phi(&bd, &sd)
-      #if(USE_BSSN_SHIFT)
-        - bd.beta1*sd.d1phi - bd.beta2*sd.d2phi - bd.beta3*sd.d3phi
-      #endif
-    )/bd.alpha;
-    
-    // gammai^ij d_j phi d_i phi
-    real_t diphidiphi = (
-      bd.gammai11*sd.d1phi*sd.d1phi + bd.gammai22*sd.d2phi*sd.d2phi + bd.gammai33*sd.d3phi*sd.d3phi
-      + 2.0*(bd.gammai12*sd.d1phi*sd.d2phi + bd.gammai13*sd.d1phi*sd.d3phi + bd.gammai23*sd.d2phi*sd.d3phi)
-    );
-
-    DIFFr_a[idx] += 0.5*nmudmuphi*nmudmuphi
-      + 0.5*exp(-4.0*bd.phi)*diphidiphi + V(sd.phi);
-
-    DIFFS_a[idx] += 3.0/2.0*nmudmuphi*nmudmuphi
-      - 0.5*exp(-4.0*bd.phi)*diphidiphi - 3.0*V(sd.phi);
-
-    S1_a[idx] += -nmudmuphi*sd.d1phi;
-    S2_a[idx] += -nmudmuphi*sd.d2phi;
-    S3_a[idx] += -nmudmuphi*sd.d3phi;
-
-    STF11_a[idx] += sd.d1phi*sd.d1phi - bd.gamma11/3.0*diphidiphi;
-    STF12_a[idx] += sd.d1phi*sd.d2phi - bd.gamma12/3.0*diphidiphi;
-    STF13_a[idx] += sd.d1phi*sd.d3phi - bd.gamma13/3.0*diphidiphi;
-    STF22_a[idx] += sd.d2phi*sd.d2phi - bd.gamma22/3.0*diphidiphi;
-    STF23_a[idx] += sd.d2phi*sd.d3phi - bd.gamma23/3.0*diphidiphi;
-    STF33_a[idx] += sd.d3phi*sd.d3phi - bd.gamma33/3.0*diphidiphi;
-  }
+  ScalarData sd = getScalarData(bd);
+
+  // n^mu d_mu phi
+  real_t nmudmuphi = (
+    dt_phi(bd, &sd)
+    #if(USE_BSSN_SHIFT)
+      - bd->beta1*sd.d1phi - bd->beta2*sd.d2phi - bd->beta3*sd.d3phi
+    #endif
+  )/bd->alpha;
+
+  // gammai^ij d_j phi d_i phi
+  real_t diphidiphi = (
+    bd->gammai11*sd.d1phi*sd.d1phi + bd->gammai22*sd.d2phi*sd.d2phi + bd->gammai33*sd.d3phi*sd.d3phi
+    + 2.0*(bd->gammai12*sd.d1phi*sd.d2phi + bd->gammai13*sd.d1phi*sd.d3phi + bd->gammai23*sd.d2phi*sd.d3phi)
+  );
+
+  bd->DIFFr += 0.5*nmudmuphi*nmudmuphi
+    + 0.5*exp(-4.0*bd->phi)*diphidiphi + V(sd.phi);
+
+  bd->DIFFS += 3.0/2.0*nmudmuphi*nmudmuphi
+    - 0.5*exp(-4.0*bd->phi)*diphidiphi - 3.0*V(sd.phi);
+
+  bd->S1 += -nmudmuphi*sd.d1phi;
+  bd->S2 += -nmudmuphi*sd.d2phi;
+  bd->S3 += -nmudmuphi*sd.d3phi;
 
-  return;
+  bd->STF11 += sd.d1phi*sd.d1phi - bd->gamma11/3.0*diphidiphi;
+  bd->STF12 += sd.d1phi*sd.d2phi - bd->gamma12/3.0*diphidiphi;
+  bd->STF13 += sd.d1phi*sd.d3phi - bd->gamma13/3.0*diphidiphi;
+  bd->STF22 += sd.d2phi*sd.d2phi - bd->gamma22/3.0*diphidiphi;
+  bd->STF23 += sd.d2phi*sd.d3phi - bd->gamma23/3.0*diphidiphi;
+  bd->STF33 += sd.d3phi*sd.d3phi - bd->gamma33/3.0*diphidiphi;
 }
 
 real_t Scalar::dV(real_t phi_in)
@@ -278,11 +304,11 @@ real_t Scalar::scalarConstraint(idx_t i, idx_t j, idx_t k, idx_t dir)
   switch(dir)
   {
     case 1:
-      return derivative(i, j, k, dir, phi._array_a) - psi1._array_a[INDEX(i,j,k)];
+      return derivative(i, j, k, dir, phi._array_a, ctx->inv_dx) - psi1._array_a[INDEX(i,j,k)];
     case 2:
-      return derivative(i, j, k, dir, phi._array_a) - psi2._array_a[INDEX(i,j,k)];
+      return derivative(i, j, k, dir, phi._array_a, ctx->inv_dx) - psi2._array_a[INDEX(i,j,k)];
     case 3:
-      return derivative(i, j, k, dir, phi._array_a) - psi3._array_a[INDEX(i,j,k)];
+      return derivative(i, j, k, dir, phi._array_a, ctx->inv_dx) - psi3._array_a[INDEX(i,j,k)];
   }
 
   throw -1;
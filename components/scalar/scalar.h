@@ -3,6 +3,7 @@
 
 #include "../../cosmo_types.h"
 #include "../bssn/bssn.h"
+#include "../matter/MatterComponent.h"
 
 
 namespace cosmo
@@ -26,27 +27,37 @@ typedef struct {
  * @brief Class implementing functionality for a scalar field that relies on a
  * BSSN instance.
  */
-class Scalar
+class Scalar : public MatterComponent
 {
   // real_t (*_dV)(real_t);
   // real_t (*_V)(real_t);
 
+  std::vector<arr_t *> halo_fields; ///< _a registers exchanged between MPI processes
+  bool halos_current; ///< whether halos of halo_fields hold neighbor data
+
 public:
+  SimContext * ctx; ///< context of the simulation
+
   register_t phi;
   register_t Pi;
   register_t psi1;
   register_t psi2;
   register_t psi3;
 
-  Scalar();
+  Scalar(SimContext * ctx_in);
   ~Scalar();
 
+  void setDt(real_t dt);
   void stepInit();
   void K1Finalize();
   void K2Finalize();
   void K3Finalize();
   void K4Finalize();
+  void exchangeHalos();
+  void addStaleHaloFields(std::vector<arr_t *> & fields);
   void RKEvolvePt(BSSNData *bd);
+  bool hasPointwiseRHS() { return true; }
+  void subcycleInit(BSSN *bssn) { stepInit(); }
 
   ScalarData getScalarData(BSSNData *bd);
 
@@ -64,7 +75,7 @@ public:
 
   real_t dV(real_t phi_in);
   real_t V(real_t phi_in);
-  void addBSSNSource(BSSN * bssn);
+  void addBSSNSrcPt(BSSN * bssn, BSSNData *bd);
 
   real_t scalarConstraint(idx_t i, idx_t j, idx_t k, idx_t dir);
 
@@ -1,12 +1,9 @@
 #include "scalar_ic.h"
 #include "../../cosmo_includes.h"
 #include "../../cosmo_types.h"
-#include "../../cosmo_globals.h"
 #include "../../utils/Fourier.h"
 #include "../../utils/math.h"
-#if USE_MULTIGRID
-#include "../elliptic_solver/full_multigrid.h"
-#endif
+#include "../../utils/FASMultigrid.h"
 
 namespace cosmo
 {
@@ -18,6 +15,8 @@ namespace cosmo
  */
 void scalar_ic_set_wave(BSSN * bssn, Scalar * scalar)
 {
+  const real_t inv_dx = bssn->ctx->inv_dx;
+
   // BSSN is already initialized to flat, just initialize scalar fields
   arr_t & phi = scalar->phi._array_p; // Gaussian 
   arr_t & psi1 = scalar->psi1._array_p; // derivative of phi in x-dir
@@ -44,9 +43,9 @@ void scalar_ic_set_wave(BSSN * bssn, Scalar * scalar)
   #pragma omp parallel for default(shared) private(i,j,k)
   LOOP3(i,j,k)
   {
-    psi1[INDEX(i,j,k)] = derivative(i, j, k, 1, phi);
-    psi2[INDEX(i,j,k)] = derivative(i, j, k, 2, phi);
-    psi3[INDEX(i,j,k)] = derivative(i, j, k, 3, phi);
+    psi1[INDEX(i,j,k)] = derivative(i, j, k, 1, phi, inv_dx);
+    psi2[INDEX(i,j,k)] = derivative(i, j, k, 2, phi, inv_dx);
+    psi3[INDEX(i,j,k)] = derivative(i, j, k, 3, phi, inv_dx);
   }
 
   #pragma omp parallel for default(shared) private(i,j,k)
@@ -86,6 +85,7 @@ void scalar_ic_set_semianalytic_test(BSSN * bssn, Scalar * scalar,
   IOData * iodata)
 {
   idx_t i, j, k;
+  const real_t inv_dx = bssn->ctx->inv_dx;
 
   arr_t & phi_p = *bssn->fields["DIFFphi_p"];
   arr_t & phi_a = *bssn->fields["DIFFphi_a"];
@@ -134,7 +134,7 @@ void scalar_ic_set_semianalytic_test(BSSN * bssn, Scalar * scalar,
     for(j = 0; j < NY; j++)
       for(k = 0; k < NZ; k++)
   phi[INDEX(i,j,k)] = temp[i];
-    lap_dif = std::max( lap_dif, (real_t) fabs(double_derivative(i,0,0,1,1,phi_p)
+    lap_dif = std::max( lap_dif, (real_t) fabs(double_derivative(i,0,0,1,1,phi_p,inv_dx)
             +pw2(4.0 * PI) * 0.01  *  std::sin(4.0 * PI *( (real_t)i / NX - 0.125) ) ) );
   }
 
@@ -150,9 +150,9 @@ void scalar_ic_set_semianalytic_test(BSSN * bssn, Scalar * scalar,
     if(i > 0)
     {
       std::swap(fourier->f_field[i][0], fourier->f_field[i][1]);
-      fourier->f_field[i][0] = dx * fourier->f_field[i][0] /
+      fourier->f_field[i][0] = bssn->ctx->dx * fourier->f_field[i][0] /
           ( 2.0 * PI * (real_t) i / NX);
-      fourier->f_field[i][1] = - dx * fourier->f_field[i][1] /
+      fourier->f_field[i][1] = - bssn->ctx->dx * fourier->f_field[i][1] /
           ( 2.0 * PI * (real_t) i / NX);
     }
     else
@@ -173,7 +173,7 @@ void scalar_ic_set_semianalytic_test(BSSN * bssn, Scalar * scalar,
 
   for(i = 0; i < NX; i++)
   {
-    max_deviation = std::max(max_deviation, (real_t) fabs( derivative(i,0,0,1,phi) - der_bak[i]));
+    max_deviation = std::max(max_deviation, (real_t) fabs( derivative(i,0,0,1,phi,inv_dx) - der_bak[i]));
   }
   iodata->log("The maximum deviation of the numerical and analytic solution of phi using odx"
     + stringify(STENCIL_ORDER) + " stencils is: " + stringify(max_deviation));
@@ -182,16 +182,16 @@ void scalar_ic_set_semianalytic_test(BSSN * bssn, Scalar * scalar,
   #pragma omp parallel for default(shared) private(i,j,k)
   LOOP3(i,j,k)
   {
-    psi1[INDEX(i,j,k)] = derivative(i, j, k, 1, phi);
-    psi2[INDEX(i,j,k)] = derivative(i, j, k, 2, phi);
-    psi3[INDEX(i,j,k)] = derivative(i, j, k, 3, phi);
+    psi1[INDEX(i,j,k)] = derivative(i, j, k, 1, phi, inv_dx);
+    psi2[INDEX(i,j,k)] = derivative(i, j, k, 2, phi, inv_dx);
+    psi3[INDEX(i,j,k)] = derivative(i, j, k, 3, phi, inv_dx);
   }
 }
 
-#if USE_MULTIGRID
 void scalar_ic_set_full_equations(BSSN * bssn, Scalar * scalar, IOData * iodata)
 {
   idx_t i, j, k;
+  const real_t inv_dx = bssn->ctx->inv_dx;
 
   // Choose a configuration for the scalar fields first:
   arr_t & phi = scalar->phi._array_p; // field
@@ -209,9 +209,9 @@ void scalar_ic_set_full_equations(BSSN * bssn, Scalar * scalar, IOData * iodata)
 
   // cutoff @ "ic_spec_cut"; maybe initialize this field
   // according to some power spectrum?
-  real_t n_max = std::stoi(_config["n_max"]);
-  real_t phi_0 = std::stod(_config["phi_0"]);
-  real_t delta = std::stod(_config["delta_phi"]);
+  real_t n_max = std::stoi(bssn->ctx->config["n_max"]);
+  real_t phi_0 = std::stod(bssn->ctx->config["phi_0"]);
+  real_t delta = std::stod(bssn->ctx->config["delta_phi"]);
   
   // background value
   LOOP3(i,j,k)
@@ -244,9 +244,9 @@ void scalar_ic_set_full_equations(BSSN * bssn, Scalar * scalar, IOData * iodata)
   #pragma omp parallel for default(shared) private(i,j,k)
   LOOP3(i,j,k)
   {
-    psi1[INDEX(i,j,k)] = derivative(i, j, k, 1, phi);
-    psi2[INDEX(i,j,k)] = derivative(i, j, k, 2, phi);
-    psi3[INDEX(i,j,k)] = derivative(i, j, k, 3, phi);
+    psi1[INDEX(i,j,k)] = derivative(i, j, k, 1, phi, inv_dx);
+    psi2[INDEX(i,j,k)] = derivative(i, j, k, 2, phi, inv_dx);
+    psi3[INDEX(i,j,k)] = derivative(i, j, k, 3, phi, inv_dx);
     Pi[INDEX(i,j,k)] = -dt_phi;
   }
 
@@ -310,11 +310,11 @@ void scalar_ic_set_full_equations(BSSN * bssn, Scalar * scalar, IOData * iodata)
   
   idx_t molecule_n[4] = {18, 5, 5, 5};
 
-  real_t relaxation_tolerance = std::stod(_config["relaxation_tolerance"]);
+  real_t relaxation_tolerance = std::stod(bssn->ctx->config["relaxation_tolerance"]);
 
   atom atom_tmp = {0};
 
-  FASMultigrid multigrid(X, 4, molecule_n, 4, 5, relaxation_tolerance);
+  FASMultigrid multigrid(iodata, X, 4, molecule_n, 4, 5, relaxation_tolerance);
 
   /*Starting adding all the terms in equations*******************************/
 
@@ -532,7 +532,7 @@ void scalar_ic_set_full_equations(BSSN * bssn, Scalar * scalar, IOData * iodata)
   iodata->log("The average value of coefficient of the fifth order term is: " + stringify(avg5));
   iodata->log("The suggested initial value of multigrid solver is: " + stringify(std::pow(-avg1/avg5,1.0/4.0)));
   iodata->log("The estimated value of gradient energy/potential is:" + stringify(-avg5/PI/2.0/scalar->V(1)));
-  iodata->log("The ratio of H_LEN_FRAC/H_0^-1 is: " + stringify(dx*NX/(3.0/K_src)));
+  iodata->log("The ratio of H_LEN_FRAC/H_0^-1 is: " + stringify(bssn->ctx->dx*NX/(3.0/K_src)));
 
   
   LOOP3(i, j, k)
@@ -542,7 +542,11 @@ void scalar_ic_set_full_equations(BSSN * bssn, Scalar * scalar, IOData * iodata)
     X[1][idx] = X[2][idx] = X[3][idx] = 0.0;
   }
   //  std::cout<<std::max(psi2.max(),psi3.max())<<"\n";
-  multigrid.VCycles(std::stoi(_config["num_v_cycles"]));
+  // vector potentials are only defined up to a constant
+  for(i = 1; i < 4; i++)
+    multigrid.enforceZeroMean(i);
+  multigrid.solve(bssn->ctx->config("multigrid_cycle_type", "V"),
+    std::stoi(bssn->ctx->config["num_v_cycles"]));
 
   LOOP3(i,j,k)
   {
@@ -551,19 +555,19 @@ void scalar_ic_set_full_equations(BSSN * bssn, Scalar * scalar, IOData * iodata)
     real_t temp = 0.0;
 
     for(idx_t kk = 1; kk <=3; kk++)
-      temp += derivative(i, j, k, kk, X[kk]);
+      temp += derivative(i, j, k, kk, X[kk], inv_dx);
     
-    A11_p[idx] = A11_a[idx] = std::pow(phi_p[idx], -6.0) * (derivative(i, j, k, 1, X[1]) + derivative(i, j, k, 1, X[1]) - 2.0 * temp / 3.0);
+    A11_p[idx] = A11_a[idx] = std::pow(phi_p[idx], -6.0) * (derivative(i, j, k, 1, X[1], inv_dx) + derivative(i, j, k, 1, X[1], inv_dx) - 2.0 * temp / 3.0);
 
-    A12_p[idx] = A12_a[idx] = std::pow(phi_p[idx], -6.0) * (derivative(i, j, k, 1, X[2]) + derivative(i, j, k, 2, X[1]));
+    A12_p[idx] = A12_a[idx] = std::pow(phi_p[idx], -6.0) * (derivative(i, j, k, 1, X[2], inv_dx) + derivative(i, j, k, 2, X[1], inv_dx));
 
-    A13_p[idx] = A13_a[idx] = std::pow(phi_p[idx], -6.0) * (derivative(i, j, k, 1, X[3]) + derivative(i, j, k, 3, X[1]));
+    A13_p[idx] = A13_a[idx] = std::pow(phi_p[idx], -6.0) * (derivative(i, j, k, 1, X[3], inv_dx) + derivative(i, j, k, 3, X[1], inv_dx));
 
-    A22_p[idx] = A22_a[idx] = std::pow(phi_p[idx], -6.0) * (derivative(i, j, k, 2, X[2]) + derivative(i, j, k, 2, X[2]) - 2.0 * temp / 3.0);
+    A22_p[idx] = A22_a[idx] = std::pow(phi_p[idx], -6.0) * (derivative(i, j, k, 2, X[2], inv_dx) + derivative(i, j, k, 2, X[2], inv_dx) - 2.0 * temp / 3.0);
     
-    A23_p[idx] = A23_a[idx] = std::pow(phi_p[idx], -6.0) * (derivative(i, j, k, 2, X[3]) + derivative(i, j, k, 3, X[2]));
+    A23_p[idx] = A23_a[idx] = std::pow(phi_p[idx], -6.0) * (derivative(i, j, k, 2, X[3], inv_dx) + derivative(i, j, k, 3, X[2], inv_dx));
 
-    A33_p[idx] = A33_a[idx] = std::pow(phi_p[idx], -6.0) * (derivative(i, j, k, 3, X[3]) + derivative(i, j, k, 3, X[3]) - 2.0 * temp / 3.0);
+    A33_p[idx] = A33_a[idx] = std::pow(phi_p[idx], -6.0) * (derivative(i, j, k, 3, X[3], inv_dx) + derivative(i, j, k, 3, X[3], inv_dx) - 2.0 * temp / 3.0);
 
     
     phi_p[idx] = std::log(fabs(phi_p[idx]));
@@ -583,9 +587,9 @@ void scalar_ic_set_Bowen_York(BSSN * bssn, Scalar * scalar, IOData * iodata)
 
   idx_t molecule_n[3] = {4, 4, 4}; //three terms for each equation
 
-  real_t relaxation_tolerance = std::stod(_config["relaxation_tolerance"]);
+  real_t relaxation_tolerance = std::stod(bssn->ctx->config["relaxation_tolerance"]);
   
-  FASMultigrid multigrid(X, 3, molecule_n, 4, 5, relaxation_tolerance);
+  FASMultigrid multigrid(iodata, X, 3, molecule_n, 4, 5, relaxation_tolerance);
   
   atom atom_tmp = {0};
 
@@ -694,7 +698,8 @@ void scalar_ic_set_Bowen_York(BSSN * bssn, Scalar * scalar, IOData * iodata)
                 + cos(2.0*PI*((real_t) n/NZ)*k + z_phase ));
   }
 
-    multigrid.VCycles(std::stoi(_config["num_v_cycles"]));
+    multigrid.solve(bssn->ctx->config("multigrid_cycle_type", "V"),
+      std::stoi(bssn->ctx->config["num_v_cycles"]));
 }
   
 /**
@@ -704,6 +709,7 @@ void scalar_ic_set_Bowen_York(BSSN * bssn, Scalar * scalar, IOData * iodata)
 void scalar_ic_set_multigrid(BSSN * bssn, Scalar * scalar, IOData * iodata)
 {
   idx_t i, j, k;
+  const real_t inv_dx = bssn->ctx->inv_dx;
 
   // Choose a configuration for the scalar fields first:
   arr_t & phi = scalar->phi._array_p; // field
@@ -717,9 +723,9 @@ void scalar_ic_set_multigrid(BSSN * bssn, Scalar * scalar, IOData * iodata)
 
   // cutoff @ "ic_spec_cut"; maybe initialize this field
   // according to some power spectrum?
-  real_t n_max = std::stoi(_config["n_max"]);
-  real_t phi_0 = std::stod(_config["phi_0"]);
-  real_t delta = std::stod(_config["delta_phi"]);
+  real_t n_max = std::stoi(bssn->ctx->config["n_max"]);
+  real_t phi_0 = std::stod(bssn->ctx->config["phi_0"]);
+  real_t delta = std::stod(bssn->ctx->config["delta_phi"]);
   
   // background value
   LOOP3(i,j,k)
@@ -752,9 +758,9 @@ void scalar_ic_set_multigrid(BSSN * bssn, Scalar * scalar, IOData * iodata)
   #pragma omp parallel for default(shared) private(i,j,k)
   LOOP3(i,j,k)
   {
-    psi1[INDEX(i,j,k)] = derivative(i, j, k, 1, phi);
-    psi2[INDEX(i,j,k)] = derivative(i, j, k, 2, phi);
-    psi3[INDEX(i,j,k)] = derivative(i, j, k, 3, phi);
+    psi1[INDEX(i,j,k)] = derivative(i, j, k, 1, phi, inv_dx);
+    psi2[INDEX(i,j,k)] = derivative(i, j, k, 2, phi, inv_dx);
+    psi3[INDEX(i,j,k)] = derivative(i, j, k, 3, phi, inv_dx);
   }
 
   // PI is zero for now
@@ -782,11 +788,11 @@ void scalar_ic_set_multigrid(BSSN * bssn, Scalar * scalar, IOData * iodata)
   }
 
   // solve for BSSN fields using multigrid class:
-  real_t relaxation_tolerance = std::stod(_config["relaxation_tolerance"]);
+  real_t relaxation_tolerance = std::stod(bssn->ctx->config["relaxation_tolerance"]);
 
   iodata->log("K_0 = " + stringify(K_src) + ", H_0 = "
       + stringify(-K_src/3.0) + ", and k/H_0 = "
-      + stringify(2.0*PI/(NX*dx)/(-K_src/3.0))
+      + stringify(2.0*PI/(NX*bssn->ctx->dx)/(-K_src/3.0))
     );
 
    // solve for BSSN fields using multigrid class:
@@ -800,7 +806,7 @@ void scalar_ic_set_multigrid(BSSN * bssn, Scalar * scalar, IOData * iodata)
 
 
   
-  FASMultigrid multigrid(phi_ini, 1, molecule_n, 4, 5, relaxation_tolerance);
+  FASMultigrid multigrid(iodata, phi_ini, 1, molecule_n, 4, 5, relaxation_tolerance);
 
   
   
@@ -858,7 +864,7 @@ void scalar_ic_set_multigrid(BSSN * bssn, Scalar * scalar, IOData * iodata)
   iodata->log("The average value of coefficient of the fifth order term is: " + stringify(avg5));
   iodata->log("The suggested initial value of multigrid solver is: " + stringify(std::pow(-avg1/avg5,1.0/4.0)));
   iodata->log("The estimated value of gradient energy/potential is:" + stringify(-avg5/PI/2.0/scalar->V(1)));
-  iodata->log("The ratio of H_LEN_FRAC/H_0^-1 is: " + stringify(dx*NX/(3.0/K_src)));
+  iodata->log("The ratio of H_LEN_FRAC/H_0^-1 is: " + stringify(bssn->ctx->dx*NX/(3.0/K_src)));
 
   LOOP3(i, j, k)
   {
@@ -866,7 +872,8 @@ void scalar_ic_set_multigrid(BSSN * bssn, Scalar * scalar, IOData * iodata)
     phi_ini[0][idx] = std::pow(-avg1/avg5,1.0/4.0);
   }
 
-  multigrid.VCycles(std::stoi(_config["num_v_cycles"]));
+  multigrid.solve(bssn->ctx->config("multigrid_cycle_type", "V"),
+    std::stoi(bssn->ctx->config["num_v_cycles"]));
 
   LOOP3(i,j,k)
   {
@@ -879,6 +886,5 @@ void scalar_ic_set_multigrid(BSSN * bssn, Scalar * scalar, IOData * iodata)
   
   return;
 }
-#endif // if USE_MULTIGRID
 
 } // namespace cosmo
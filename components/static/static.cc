@@ -1,6 +1,5 @@
 #include "static.h"
 #include "../../cosmo_includes.h"
-#include "../../cosmo_globals.h"
 
 namespace cosmo
 {
@@ -16,23 +15,12 @@ Static::~Static()
   GEN1_ARRAY_DELETE(DIFFD);
 }
 
-void Static::addBSSNSrc(map_t & bssn_fields, FRW<real_t> *frw)
+void Static::addBSSNSrcPt(BSSN *bssn, BSSNData *bd)
 {
-  idx_t i=0, j=0, k=0;
-  arr_t & DIFFr_a = *bssn_fields["DIFFr_a"];
-  arr_t & DIFFphi_a = *bssn_fields["DIFFphi_a"];
-
-  real_t phi_FRW = frw->get_phi();
-  real_t rho_FRW = frw->get_rho();
-
-  LOOP3(i,j,k)
-  {
-    idx_t idx = NP_INDEX(i,j,k);
-    // \Delta \rho = \rho - \rho_FRW = ...
-    DIFFr_a[idx] += exp(-6.0*(DIFFphi_a[idx] + phi_FRW))*DIFFD_a[idx]
-      + rho_FRW*expm1(-6.0*DIFFphi_a[idx]);
-  }
-
+  idx_t idx = bd->idx;
+  // \Delta \rho = \rho - \rho_FRW = ...
+  bd->DIFFr += exp(-6.0*(bd->DIFFphi + bd->phi_FRW))*DIFFD_a[idx]
+    + bd->rho_FRW*expm1(-6.0*bd->DIFFphi);
 }
 
 void Static::init()
@@ -5,12 +5,13 @@
 #include "../../cosmo_macros.h"
 #include "../../utils/Array.h"
 #include "../../utils/FRW.h"
+#include "../matter/MatterComponent.h"
 
 namespace cosmo
 {
 
 /** Static matter class **/
-class Static
+class Static : public MatterComponent
 {
   /* Fluid field */
   // just a density variable
@@ -22,7 +23,7 @@ public:
   Static();
   ~Static();
 
-  void addBSSNSrc(map_t & bssn_fields, FRW<real_t> *frw);
+  void addBSSNSrcPt(BSSN *bssn, BSSNData *bd);
 
   void init();
 };
@@ -1,14 +1,13 @@
 #include "static_ic.h"
 #include "../../cosmo_includes.h"
 #include "../../cosmo_types.h"
-#include "../../cosmo_globals.h"
 #include "../../ICs/ICs.h"
 #include "../../utils/math.h"
-
-#include <boost/math/special_functions/spherical_harmonic.hpp>
+#include "../bssn/bssn_ic.h"
 
 #include <utility>
 #include <random>
+#include <limits>
 
 namespace cosmo
 {
@@ -32,13 +31,14 @@ void static_ic_set_random(BSSN * bssn, Static * stat, Lambda * lambda,
   Fourier * fourier, IOData * iodata)
 {
   idx_t i, j, k;
+  const real_t inv_dx = bssn->ctx->inv_dx;
 
   // Background cosmology, a_FRW = 1
   real_t rho_FRW = 3.0/PI/8.0;
-  real_t Omega_L = std::stod(_config("Omega_L", "1.0e-6"));
-  real_t p0 = std::stod(_config("p0", "7.0"));
-  real_t P = H_LEN_FRAC*H_LEN_FRAC*1.0e-15*std::stod(_config("P", "1.0"));
-  real_t p_cut = std::stod(_config("p_cut", "1.0"));
+  real_t Omega_L = std::stod(bssn->ctx->config("Omega_L", "1.0e-6"));
+  real_t p0 = std::stod(bssn->ctx->config("p0", "7.0"));
+  real_t P = H_LEN_FRAC*H_LEN_FRAC*1.0e-15*std::stod(bssn->ctx->config("P", "1.0"));
+  real_t p_cut = std::stod(bssn->ctx->config("p_cut", "1.0"));
   real_t rho_L = Omega_L * rho_FRW;
   lambda->setLambda(rho_L);
 
@@ -65,7 +65,7 @@ void static_ic_set_random(BSSN * bssn, Static * stat, Lambda * lambda,
   arr_t & W3 = *bssn->fields["A33_c"];
 
   // 1.a) Synchronous-gauge Newtonian potential:
-  set_gaussian_random_Phi_N(phi_N, fourier, P, p0, p_cut);
+  set_gaussian_random_Phi_N(bssn->ctx, phi_N, fourier, P, p0, p_cut);
 
   // 1.b) Preliminary metric variables: phi, K
 # pragma omp parallel for default(shared) private(i,j,k)
@@ -73,7 +73,7 @@ void static_ic_set_random(BSSN * bssn, Static * stat, Lambda * lambda,
   {
     idx_t idx = NP_INDEX(i,j,k);
     
-    lap_phi_N[idx] = laplacian(i, j, k, phi_N);
+    lap_phi_N[idx] = laplacian(i, j, k, phi_N, inv_dx);
 
     DIFFphi_p[idx] = log1p(-10.0/3.0*phi_N[idx])/4.0;
     DIFFK_p[idx] = -3.0*(1.0 + 2.0*phi_N[idx]) + 2.0/3.0*lap_phi_N[idx];
@@ -85,9 +85,9 @@ void static_ic_set_random(BSSN * bssn, Static * stat, Lambda * lambda,
   LOOP3(i,j,k) {
     idx_t idx = NP_INDEX(i,j,k);
     real_t e6p = exp(6.0*DIFFphi_p[idx]);
-    invlape6pd1K[idx] = e6p*derivative(i,j,k,1,DIFFK_p);
-    invlape6pd2K[idx] = e6p*derivative(i,j,k,2,DIFFK_p);
-    invlape6pd3K[idx] = e6p*derivative(i,j,k,3,DIFFK_p);
+    invlape6pd1K[idx] = e6p*derivative(i,j,k,1,DIFFK_p,inv_dx);
+    invlape6pd2K[idx] = e6p*derivative(i,j,k,2,DIFFK_p,inv_dx);
+    invlape6pd3K[idx] = e6p*derivative(i,j,k,3,DIFFK_p,inv_dx);
   }
   fourier->inverseLaplacian <idx_t, real_t> (invlape6pd1K._array);
   fourier->inverseLaplacian <idx_t, real_t> (invlape6pd2K._array);
@@ -97,9 +97,9 @@ void static_ic_set_random(BSSN * bssn, Static * stat, Lambda * lambda,
   LOOP3(i,j,k)
   {
     idx_t idx = NP_INDEX(i,j,k);
-    W1[idx] = -derivative(i,j,k,1,phi_N)/3.0 + invlape6pd1K[idx]/2.0;
-    W2[idx] = -derivative(i,j,k,2,phi_N)/3.0 + invlape6pd2K[idx]/2.0;
-    W3[idx] = -derivative(i,j,k,3,phi_N)/3.0 + invlape6pd3K[idx]/2.0;
+    W1[idx] = -derivative(i,j,k,1,phi_N,inv_dx)/3.0 + invlape6pd1K[idx]/2.0;
+    W2[idx] = -derivative(i,j,k,2,phi_N,inv_dx)/3.0 + invlape6pd2K[idx]/2.0;
+    W3[idx] = -derivative(i,j,k,3,phi_N,inv_dx)/3.0 + invlape6pd3K[idx]/2.0;
   }
 
   // 1.d) Aij components
@@ -109,15 +109,15 @@ void static_ic_set_random(BSSN * bssn, Static * stat, Lambda * lambda,
     idx_t idx = NP_INDEX(i,j,k);
     // these are the CTT conformal Aij
     real_t CTT2BSSNAij = exp(-6.0*DIFFphi_p[idx]);
-    real_t DkWk = derivative(i,j,k,1,W1) + derivative(i,j,k,2,W2) + derivative(i,j,k,3,W3);
-    A11_p[idx] = CTT2BSSNAij * ( derivative(i,j,k,1,W1) + derivative(i,j,k,1,W1) + 2.0/3.0*double_derivative(i,j,k,1,1,phi_N)
+    real_t DkWk = derivative(i,j,k,1,W1,inv_dx) + derivative(i,j,k,2,W2,inv_dx) + derivative(i,j,k,3,W3,inv_dx);
+    A11_p[idx] = CTT2BSSNAij * ( derivative(i,j,k,1,W1,inv_dx) + derivative(i,j,k,1,W1,inv_dx) + 2.0/3.0*double_derivative(i,j,k,1,1,phi_N,inv_dx)
       - 2.0/3.0*DkWk - 2.0/9.0*lap_phi_N[idx] );
-    A12_p[idx] = CTT2BSSNAij * ( derivative(i,j,k,1,W2) + derivative(i,j,k,2,W1) + 2.0/3.0*double_derivative(i,j,k,1,2,phi_N) );
-    A13_p[idx] = CTT2BSSNAij * ( derivative(i,j,k,1,W3) + derivative(i,j,k,3,W1) + 2.0/3.0*double_derivative(i,j,k,1,3,phi_N) );
-    A22_p[idx] = CTT2BSSNAij * ( derivative(i,j,k,2,W2) + derivative(i,j,k,2,W2) + 2.0/3.0*double_derivative(i,j,k,2,2,phi_N)
+    A12_p[idx] = CTT2BSSNAij * ( derivative(i,j,k,1,W2,inv_dx) + derivative(i,j,k,2,W1,inv_dx) + 2.0/3.0*double_derivative(i,j,k,1,2,phi_N,inv_dx) );
+    A13_p[idx] = CTT2BSSNAij * ( derivative(i,j,k,1,W3,inv_dx) + derivative(i,j,k,3,W1,inv_dx) + 2.0/3.0*double_derivative(i,j,k,1,3,phi_N,inv_dx) );
+    A22_p[idx] = CTT2BSSNAij * ( derivative(i,j,k,2,W2,inv_dx) + derivative(i,j,k,2,W2,inv_dx) + 2.0/3.0*double_derivative(i,j,k,2,2,phi_N,inv_dx)
       - 2.0/3.0*DkWk - 2.0/9.0*lap_phi_N[idx] );
-    A23_p[idx] = CTT2BSSNAij * ( derivative(i,j,k,2,W3) + derivative(i,j,k,3,W2) + 2.0/3.0*double_derivative(i,j,k,2,3,phi_N) );
-    A33_p[idx] = CTT2BSSNAij * ( derivative(i,j,k,3,W3) + derivative(i,j,k,3,W3) + 2.0/3.0*double_derivative(i,j,k,3,3,phi_N)
+    A23_p[idx] = CTT2BSSNAij * ( derivative(i,j,k,2,W3,inv_dx) + derivative(i,j,k,3,W2,inv_dx) + 2.0/3.0*double_derivative(i,j,k,2,3,phi_N,inv_dx) );
+    A33_p[idx] = CTT2BSSNAij * ( derivative(i,j,k,3,W3,inv_dx) + derivative(i,j,k,3,W3,inv_dx) + 2.0/3.0*double_derivative(i,j,k,3,3,phi_N,inv_dx)
       - 2.0/3.0*DkWk - 2.0/9.0*lap_phi_N[idx] );
   }
 
@@ -129,8 +129,8 @@ void static_ic_set_random(BSSN * bssn, Static * stat, Lambda * lambda,
 
     real_t AijAij = A11_p[idx]*A11_p[idx] + A22_p[idx]*A22_p[idx] + A33_p[idx]*A33_p[idx]
       + 2.0*(A12_p[idx]*A12_p[idx] + A13_p[idx]*A13_p[idx] + A23_p[idx]*A23_p[idx]);
-    real_t lap_e_p = exp(DIFFphi_p[idx]) * ( laplacian(i,j,k,DIFFphi_p)
-      + pw2(derivative(i,j,k,1,DIFFphi_p)) + pw2(derivative(i,j,k,2,DIFFphi_p)) + pw2(derivative(i,j,k,3,DIFFphi_p)) );
+    real_t lap_e_p = exp(DIFFphi_p[idx]) * ( laplacian(i,j,k,DIFFphi_p,inv_dx)
+      + pw2(derivative(i,j,k,1,DIFFphi_p,inv_dx)) + pw2(derivative(i,j,k,2,DIFFphi_p,inv_dx)) + pw2(derivative(i,j,k,3,DIFFphi_p,inv_dx)) );
     real_t rho_ADM = 1.0/2.0/PI * ( DIFFK_p[idx]*DIFFK_p[idx]/12.0 - AijAij/8.0 - exp(-5.0*DIFFphi_p[idx])*lap_e_p );
     real_t rho_0 = rho_ADM - rho_L;
 
@@ -160,18 +160,18 @@ void static_ic_set_sinusoid_3d(BSSN * bssn, Static * stat, Lambda * lambda, Four
 
   real_t rho_FRW = 3.0/PI/8.0;
 
-  real_t Omega_L = std::stod(_config("Omega_L", "0.0"));
+  real_t Omega_L = std::stod(bssn->ctx->config("Omega_L", "0.0"));
   real_t rho_m = (1.0 - Omega_L) * rho_FRW;
   real_t rho_L = Omega_L * rho_FRW;
   lambda->setLambda(rho_L);
 
-  real_t A = H_LEN_FRAC*H_LEN_FRAC*std::stod(_config("peak_amplitude_frac", "0.001"));
+  real_t A = H_LEN_FRAC*H_LEN_FRAC*std::stod(bssn->ctx->config("peak_amplitude_frac", "0.001"));
 
   // the conformal factor in front of metric is the solution to
   // d^2 exp(\phi) = -2*pi exp(5\phi) * \delta_rho
   // generate random mode in \phi
   // delta_rho = -(lap e^\phi)/e^(4\phi)/2pi
-  real_t phix = std::stod(_config("phix", "0.0"));
+  real_t phix = std::stod(bssn->ctx->config("phix", "0.0"));
   real_t phiy = phix, phiz = phix;
 
   // grid values
@@ -295,18 +295,18 @@ void static_ic_set_sinusoid(BSSN * bssn, Static * stat, Lambda * lambda, Fourier
 
   real_t rho_FRW = 3.0/PI/8.0;
 
-  real_t Omega_L = std::stod(_config("Omega_L", "0.0"));
+  real_t Omega_L = std::stod(bssn->ctx->config("Omega_L", "0.0"));
   real_t rho_m = (1.0 - Omega_L) * rho_FRW;
   real_t rho_L = Omega_L * rho_FRW;
   lambda->setLambda(rho_L);
 
-  real_t A = H_LEN_FRAC*H_LEN_FRAC*std::stod(_config("peak_amplitude_frac", "0.001"));
+  real_t A = H_LEN_FRAC*H_LEN_FRAC*std::stod(bssn->ctx->config("peak_amplitude_frac", "0.001"));
 
   // the conformal factor in front of metric is the solution to
   // d^2 exp(\phi) = -2*pi exp(5\phi) * \delta_rho
   // generate random mode in \phi
   // delta_rho = -(lap e^\phi)/e^(4\phi)/2pi
-  real_t phix = std::stod(_config("phix", "0.0"));
+  real_t phix = std::stod(bssn->ctx->config("phix", "0.0"));
   real_t twopi_L = 2.0*PI/H_LEN_FRAC;
   real_t pw2_twopi_L = twopi_L*twopi_L;
   // grid values
@@ -406,6 +406,7 @@ void static_ic_set_semianalytic(
   IOData * iodata)
 {
   idx_t i, j, k;
+  const real_t dx = bssn->ctx->dx;
 
   arr_t & DIFFr_a = *bssn->fields["DIFFr_a"];
   arr_t & DIFFphi_p = *bssn->fields["DIFFphi_p"];
@@ -415,12 +416,12 @@ void static_ic_set_semianalytic(
   real_t rho_FRW = 3.0/PI/8.0;
   real_t K_FRW = -3.0;
 
-  real_t Omega_L = std::stod(_config("Omega_L", "0.0"));
+  real_t Omega_L = std::stod(bssn->ctx->config("Omega_L", "0.0"));
   real_t rho_m = (1.0 - Omega_L) * rho_FRW;
   real_t rho_L = Omega_L * rho_FRW;
   lambda->setLambda(rho_L);
   real_t L = H_LEN_FRAC;
-  real_t A = std::stod(_config("peak_amplitude", "0.001"))*0.026699*L*L;
+  real_t A = std::stod(bssn->ctx->config("peak_amplitude", "0.001"))*0.026699*L*L;
   // grid values
   LOOP3(i,j,k)
   {
@@ -468,12 +469,86 @@ void static_ic_set_semianalytic(
 
 
 
+/**
+ * @brief Fill recurrence coefficients for normalized associated Legendre
+ *  functions up to degree l.
+ * @details coefs[m*(l+1) + m] holds the sectoral factor
+ *  -sqrt((2m+1)/(2m)) (m > 0), and coefs[m*(l+1) + n] for n > m holds
+ *  a_nm = sqrt((4n^2-1)/(n^2-m^2)).
+ */
+void static_ic_ylm_init_coefs(idx_t l, real_t * coefs)
+{
+  for(idx_t m=0; m<=l; ++m)
+  {
+    coefs[m*(l+1) + m] = m > 0 ? -std::sqrt((2.0*m+1.0)/(2.0*m)) : 1.0;
+    for(idx_t n=m+1; n<=l; ++n)
+      coefs[m*(l+1) + n] = std::sqrt( (4.0*n*n - 1.0)/((real_t) n*n - (real_t) m*m) );
+    for(idx_t n=0; n<m; ++n)
+      coefs[m*(l+1) + n] = 0.0;
+  }
+}
+
+/**
+ * @brief Evaluate \sum_{m=-l}^{l} a_lm Y_lm(theta, phi) for a real field
+ *  (a_{l,-m} = (-1)^m a_lm^*).
+ * @details Matches boost::math::spherical_harmonic (Condon-Shortley phase
+ *  included) using one normalized associated-Legendre recurrence and one
+ *  cos/sin(m phi) recurrence, rather than trig and Legendre calls per m.
+ *
+ * @param l degree
+ * @param alms coefficients, indexed by m_idx(l,m)
+ * @param coefs recurrence coefficients from static_ic_ylm_init_coefs
+ * @param cos_theta, sin_theta, cos_phi, sin_phi direction of the point
+ */
+real_t static_ic_ylm_sum(idx_t l, const complex_t * alms,
+  const real_t * coefs, real_t cos_theta, real_t sin_theta,
+  real_t cos_phi, real_t sin_phi)
+{
+  real_t sum = 0.0;
+  real_t P_mm = 0.5/std::sqrt(PI); // normalized P_0^0
+  real_t cos_mphi = 1.0, sin_mphi = 0.0;
+
+  for(idx_t m=0; m<=l; ++m)
+  {
+    const real_t * a = coefs + m*(l+1);
+    if(m > 0)
+    {
+      P_mm *= a[m]*sin_theta;
+      real_t cos_prev = cos_mphi;
+      cos_mphi = cos_prev*cos_phi - sin_mphi*sin_phi;
+      sin_mphi = sin_mphi*cos_phi + cos_prev*sin_phi;
+    }
+
+    // raise degree from m to l at fixed m
+    real_t P_lm = P_mm;
+    if(l > m)
+    {
+      real_t P_prev = P_mm;
+      P_lm = a[m+1]*cos_theta*P_mm;
+      for(idx_t n=m+2; n<=l; ++n)
+      {
+        real_t P_next = a[n]*(cos_theta*P_lm - P_prev/a[n-1]);
+        P_prev = P_lm;
+        P_lm = P_next;
+      }
+    }
+
+    real_t term = P_lm*( alms[m_idx(l,m)].first*cos_mphi
+                         - alms[m_idx(l,m)].second*sin_mphi );
+    sum += m > 0 ? 2.0*term : term;
+  }
+
+  return sum;
+}
+
 /**
  * @brief Spherical "shell" of perturbations around an observer
  */
 void static_ic_set_sphere(BSSN * bssn, Static * stat, IOData * iodata)
 {
   idx_t i, j, k;
+  const real_t inv_dx = bssn->ctx->inv_dx;
+  const real_t dx = bssn->ctx->dx;
 
   arr_t & DIFFr_a = *bssn->fields["DIFFr_a"];
   arr_t & DIFFphi_p = *bssn->fields["DIFFphi_p"];
@@ -483,11 +558,13 @@ void static_ic_set_sphere(BSSN * bssn, Static * stat, IOData * iodata)
   arr_t & DIFFD_a = *stat->fields["DIFFD_a"];
 
   // shell amplitude
-  const real_t A = stod(_config("shell_amplitude", "1e-5"));
+  const real_t A = stod(bssn->ctx->config("shell_amplitude", "1e-5"));
   // Shell described by only one fixed l:
-  const idx_t l = stoi(_config("shell_angular_scale_l", "1"));
+  const idx_t l = stoi(bssn->ctx->config("shell_angular_scale_l", "1"));
   iodata->log( "Generating ICs with shell angular scale of l = " + stringify(l) );
   iodata->log( "Generating ICs with peak amp. = " + stringify(A) );
+  // Perturb density and solve for phi, rather than specifying phi?
+  const bool solve_constraint = !!stoi(bssn->ctx->config("shell_solve_constraint", "0"));
 
   // spherical shell of perturbations in phi0field
 
@@ -503,7 +580,7 @@ void static_ic_set_sphere(BSSN * bssn, Static * stat, IOData * iodata)
 
   // Angular fluctuations in shell described by spherical harmonic coeffs, a_lm's,
   complex_t * alms = new complex_t[m_idx(l,l)+1];
-  const real_t seed = stod(_config("mt19937_seed", "7"));
+  const real_t seed = stod(bssn->ctx->config("mt19937_seed", "7"));
   std::mt19937 gen(seed);
   std::normal_distribution<> normal_dist(0.0, 1.0);
   std::uniform_real_distribution<> uniform_dist(0.0, 2.0*PI);
@@ -535,41 +612,44 @@ void static_ic_set_sphere(BSSN * bssn, Static * stat, IOData * iodata)
       << " + " << alms[m_idx(l,m)].second << "i\n";
   }
 
+  // Recurrence coefficients for the normalized associated Legendre functions
+  real_t * legendre_coefs = new real_t[(l+1)*(l+1)];
+  static_ic_ylm_init_coefs(l, legendre_coefs);
+
+  // Angular factors differ at every grid point (no two points lie on the
+  // same ray from the off-grid center), so evaluate them directly, skipping
+  // points where the shell profile is below round-off.
+  const real_t profile_cutoff = std::numeric_limits<real_t>::epsilon();
+
+# pragma omp parallel for default(shared) private(i,j,k)
   LOOP3(i,j,k) {
     idx_t idx = NP_INDEX(i,j,k);
 
-    real_t x = i*dx;
-    real_t y = j*dx;
-    real_t z = k*dx;
+    real_t x = i*dx - x0;
+    real_t y = j*dx - y0;
+    real_t z = k*dx - z0;
 
-    real_t r = sqrt( pw2(x - x0) + pw2(y - y0) + pw2(z - z0) );
-    real_t theta = acos((z - z0) / r); // "theta" (polar angle)
-    real_t phi = atan2(y - y0, x - x0); // "phi" (azimuthal angle)
+    real_t r = sqrt( pw2(x) + pw2(y) + pw2(z) );
 
-    real_t DIFFphi_r = 0.0;
-    real_t DIFFphi_i = 0.0;
-    for(int m=-l; m<=l; m++)
-    {
-      real_t Y_r = boost::math::spherical_harmonic_r(l, m, theta, phi);
-      real_t Y_i = boost::math::spherical_harmonic_i(l, m, theta, phi);
+    // gaussian profile shell of fluctuations
+    real_t profile = std::exp( -pw2((r - r_shell)/2.0/shell_width) );
+    // cosine profile
+    // real_t profile = (r < r_shell-shell_width || r > r_shell+shell_width ) ? 0 : (1+std::cos(PI*(r-r_shell)/shell_width));
+    real_t U_r = A*profile;
 
-      DIFFphi_r += alms[m_idx(l,m)].first*Y_r - alms[m_idx(l,m)].second*Y_i;
-      DIFFphi_i += alms[m_idx(l,m)].first*Y_i + alms[m_idx(l,m)].second*Y_r;
-    }
-    if(std::abs(DIFFphi_i) > 1e-6)
+    if(profile < profile_cutoff)
     {
-      iodata->log("Significant non-zero imaginary component of solution exists!");
-      throw -1;
+      DIFFphi_p[idx] = 0.0;
+      continue;
     }
 
-    // gaussian profile shell of fluctuations
-    real_t U_r = A*std::exp( -pw2((r - r_shell)/2.0/shell_width) );
-    // cosine profile
-    // real_t U_r = (r < r_shell-shell_width || r > r_shell+shell_width ) ? 0 : A*(1+std::cos(PI*(r-r_shell)/shell_width));
+    // \sum_m a_lm Y_lm, with a_{l,-m} = (-1)^m a_lm^* this is real
+    real_t r_xy = sqrt( pw2(x) + pw2(y) );
+    real_t DIFFphi_r = static_ic_ylm_sum(l, alms, legendre_coefs,
+      z/r, r_xy/r, r_xy > 0 ? x/r_xy : 1.0, r_xy > 0 ? y/r_xy : 0.0);
 
     DIFFphi_p[idx] = U_r*DIFFphi_r;
 
-
     if(i==NX/2 && j==NY/2 && k==NZ/2)
       std::cout << "At a grid point close to the middle, r = " << r
                 << ", r_shell = " << r_shell
@@ -579,26 +659,52 @@ void static_ic_set_sphere(BSSN * bssn, Static * stat, IOData * iodata)
   }
   // cleanup
   delete [] alms;
+  delete [] legendre_coefs;
 
-  // delta_rho = -lap(phi)/(1+xi)^5/2pi
-# pragma omp parallel for default(shared) private(i,j,k)
-  LOOP3(i,j,k) {
-    DIFFr_a[NP_INDEX(i,j,k)] = -0.5/PI/(
-      pow(1.0 + DIFFphi_p[NP_INDEX(i,j,k)], 5.0)
-    )*(
-      double_derivative(i, j, k, 1, 1, DIFFphi_p)
-      + double_derivative(i, j, k, 2, 2, DIFFphi_p)
-      + double_derivative(i, j, k, 3, 3, DIFFphi_p)
-    );
+  if(solve_constraint)
+  {
+    // Shell profile is a fractional perturbation to the conformal density;
+    // solve the Hamiltonian constraint for phi (K = K_FRW, A_ij = 0).
+    real_t rho_FRW = 3.0/PI/8.0;
+    real_t K_FRW = -sqrt(24.0*PI*rho_FRW);
+#   pragma omp parallel for default(shared) private(i,j,k)
+    LOOP3(i,j,k) {
+      idx_t idx = NP_INDEX(i,j,k);
+      DIFFr_a[idx] = rho_FRW*(1.0 + DIFFphi_p[idx]);
+      DIFFphi_p[idx] = 0.0;
+    }
+
+    bssn_ic_solve_hamiltonian_constraint(bssn, DIFFr_a, K_FRW, iodata);
+
+#   pragma omp parallel for default(shared) private(i,j,k)
+    LOOP3(i,j,k) {
+      idx_t idx = NP_INDEX(i,j,k);
+      DIFFr_a[idx] -= rho_FRW;
+      DIFFphi_f[idx] = DIFFphi_p[idx];
+    }
   }
+  else
+  {
+    // delta_rho = -lap(phi)/(1+xi)^5/2pi
+#   pragma omp parallel for default(shared) private(i,j,k)
+    LOOP3(i,j,k) {
+      DIFFr_a[NP_INDEX(i,j,k)] = -0.5/PI/(
+        pow(1.0 + DIFFphi_p[NP_INDEX(i,j,k)], 5.0)
+      )*(
+        double_derivative(i, j, k, 1, 1, DIFFphi_p, inv_dx)
+        + double_derivative(i, j, k, 2, 2, DIFFphi_p, inv_dx)
+        + double_derivative(i, j, k, 3, 3, DIFFphi_p, inv_dx)
+      );
+    }
 
-  // phi = ln(xi)
-# pragma omp parallel for default(shared) private(i,j,k)
-  LOOP3(i,j,k) {
-    idx_t idx = NP_INDEX(i,j,k);
-    DIFFphi_a[idx] = log1p(DIFFphi_p[idx]);
-    DIFFphi_f[idx] = log1p(DIFFphi_p[idx]);
-    DIFFphi_p[idx] = log1p(DIFFphi_p[idx]);
+    // phi = ln(xi)
+#   pragma omp parallel for default(shared) private(i,j,k)
+    LOOP3(i,j,k) {
+      idx_t idx = NP_INDEX(i,j,k);
+      DIFFphi_a[idx] = log1p(DIFFphi_p[idx]);
+      DIFFphi_f[idx] = log1p(DIFFphi_p[idx]);
+      DIFFphi_p[idx] = log1p(DIFFphi_p[idx]);
+    }
   }
 
   // Make sure min density value > 0
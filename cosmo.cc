@@ -1,6 +1,7 @@
 #include "cosmo_includes.h"
 #include "cosmo_types.h"
-#include "cosmo_globals.h"
+#include "utils/SimContext.h"
+#include "utils/Decomposition.h"
 
 #include "sims/sim.h"
 #include "sims/dust.h"
@@ -9,70 +10,62 @@
 #include "sims/scalar.h"
 #include "sims/vacuum.h"
 #include "sims/sheets.h"
+#include "sims/ensemble.h"
 
 using namespace std;
 using namespace cosmo;
 
-/* global definitions */
-TimerManager _timer;
-ConfigParser _config;
-#ifndef dt
-  real_t dt;
-#endif
-#ifndef dx
-  real_t dx;
-#endif
-
-int main(int argc, char **argv)
+/**
+ * @brief Set process-wide state (number of threads) from the config of a
+ *  simulation
+ */
+void configure(SimContext * ctx)
 {
-  // read in config file
-  if(argc != 2)
-  {
-    std::cout << "Error: please supply exactly one config filename as an argument.\n";
-    return EXIT_FAILURE;
-  }
-  // TODO: eliminate global _config; feed directly into constructor.
-  _config.parse(argv[1]);
-
-  // If not compiled in, set dt, dx
-  // TODO: set other things (and check for performance hits)
-  //       set these in config file?
-  //       big performance hit setting N dynamically, should deal with BCs separately.
-  dx = stold(_config( "dx", stringify(H_LEN_FRAC/(1.0*COSMO_N)) ));
-  dt = stold(_config( "dt_frac", "0.1" ))*dx;
-
   // Set number of threads - only if specified
   // Otherwise, OMP_NUM_THREADS or openmp default should be used.
-  int num_threads = stoi(_config("omp_num_threads", "0"));
+  int num_threads = stoi(ctx->config("omp_num_threads", "0"));
   if(num_threads > 0)
     omp_set_num_threads(num_threads);
+}
 
+/**
+ * @brief Run a simulation according to the config of ctx
+ */
+int simulate(SimContext * ctx)
+{
   // Create simulation according to simulation_type
   CosmoSim * cosmoSim;
-  std::string simulation_type = _config["simulation_type"];
+  std::string simulation_type = ctx->config["simulation_type"];
+#if USE_MPI
+  if( simulation_type != "vacuum" )
+  {
+    std::cerr << "Only 'vacuum' simulations are supported with MPI. ";
+    throw 2;
+  }
+#endif
   if( simulation_type == "dust" )
   {
-    cosmoSim = new DustSim();
+    cosmoSim = new DustSim(ctx);
   }
   else if( simulation_type == "static" )
   {
-    cosmoSim = new StaticSim();
+    cosmoSim = new StaticSim(ctx);
   }
   else if( simulation_type == "particles" )
   {
-    cosmoSim = new ParticleSim();
+    cosmoSim = new ParticleSim(ctx);
   }
   else if( simulation_type == "scalar" )
   {
-    cosmoSim = new ScalarSim();
+    cosmoSim = new ScalarSim(ctx);
   }
   else if( simulation_type == "vacuum" )
   {
-    cosmoSim = new VacuumSim();
+    cosmoSim = new VacuumSim(ctx);
   }
   else if( simulation_type == "sheets")
   {
-    cosmoSim = new SheetSim();
+    cosmoSim = new SheetSim(ctx);
   }
   else
   {
@@ -84,9 +77,9 @@ int main(int argc, char **argv)
   cosmoSim->init();
 
   // Generate initial conditions
-  _timer["ICs"].start();
-  cosmoSim->setICs();
-  _timer["ICs"].stop();
+  ctx->timer["ICs"].start();
+  cosmoSim->generateICs();
+  ctx->timer["ICs"].stop();
 
   // Run simulation
   cosmoSim->run();
@@ -94,3 +87,35 @@ int main(int argc, char **argv)
   delete cosmoSim;
   return EXIT_SUCCESS;
 }
+
+int main(int argc, char **argv)
+{
+  // no-op unless compiled with USE_MPI
+  decomposition_init(&argc, &argv);
+
+  // read in config file
+  if(argc != 2)
+  {
+    std::cout << "Error: please supply exactly one config filename as an argument.\n";
+    return EXIT_FAILURE;
+  }
+  // configuration, timers, dx, and dt of the simulation
+  SimContext ctx;
+  ctx.parse(argv[1]);
+
+  int status;
+  if( ctx.config["simulation_type"] == "ensemble" )
+  {
+    // run member simulations concurrently, see sims/ensemble.h
+    Ensemble ensemble(&ctx.config);
+    status = ensemble.run(configure, simulate);
+  }
+  else
+  {
+    configure(&ctx);
+    status = simulate(&ctx);
+  }
+
+  decomposition_finalize();
+  return status;
+}
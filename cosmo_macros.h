@@ -12,6 +12,25 @@
 #ifndef COSMO_N
   #define COSMO_N 16
 #endif
+
+// MPI domain decomposition? Splits the x-direction into COSMO_MPI_RANKS
+// slabs; NX is then the local slab size, including halos
+#ifndef USE_MPI
+  #define USE_MPI false
+#endif
+#if USE_MPI
+  #ifndef COSMO_MPI_RANKS
+    #define COSMO_MPI_RANKS 1
+  #endif
+  #ifdef NX
+    #error "NX cannot be set when USE_MPI is enabled; set COSMO_N instead."
+  #endif
+  // halo planes on each side of a slab (derivative + KO stencil half-width)
+  #define COSMO_HALO_WIDTH (STENCIL_ORDER/2 + 1)
+  #define GLOBAL_NX COSMO_N
+  #define NX (GLOBAL_NX/COSMO_MPI_RANKS + 2*COSMO_HALO_WIDTH)
+#endif
+
 #ifndef NX
   #define NX COSMO_N
 #endif
@@ -23,6 +42,19 @@
 #endif
 #define POINTS ((NX)*(NY)*(NZ))
 
+// global grid, and the range of local x-indices owned by this process
+#if USE_MPI
+  #define OWNED_X_BEGIN (COSMO_HALO_WIDTH)
+  #define OWNED_X_END (NX - COSMO_HALO_WIDTH)
+  #define GLOBAL_X_INDEX(i) ((i) - COSMO_HALO_WIDTH + decomposition_x_offset())
+#else
+  #define GLOBAL_NX NX
+  #define OWNED_X_BEGIN 0
+  #define OWNED_X_END (NX)
+  #define GLOBAL_X_INDEX(i) (i)
+#endif
+#define GLOBAL_POINTS ((GLOBAL_NX)*(NY)*(NZ))
+
 // physical box size (in units of the initial Hubble^-1 scale)
 // eg; L = H_LEN_FRAC = N*dx
 #ifndef H_LEN_FRAC
@@ -67,10 +99,7 @@
   #define EXCLUDE_SECOND_ORDER_FRW false
 #endif
 
-// Optionally compile without raytracing, multigrid classes
-#ifndef USE_MULTIGRID
-  #define USE_MULTIGRID true
-#endif
+// Optionally compile without raytracing classes
 #ifndef USE_COSMOTRACE
   #define USE_COSMOTRACE true
 #endif
@@ -91,6 +120,18 @@
 #ifndef USE_Z4c_DAMPING
 #  define USE_Z4c_DAMPING false
 #endif
+#if USE_MPI
+#  if GLOBAL_NX % COSMO_MPI_RANKS != 0
+#    error "COSMO_N must be divisible by COSMO_MPI_RANKS."
+#  endif
+#  if GLOBAL_NX/COSMO_MPI_RANKS < COSMO_HALO_WIDTH
+#    error "Too many MPI ranks: slabs must be at least COSMO_HALO_WIDTH planes wide."
+#  endif
+#  if USE_GENERALIZED_NEWTON
+#    error "USE_GENERALIZED_NEWTON is not supported with USE_MPI."
+#  endif
+#endif
+
 #if USE_Z4c_DAMPING
 #  define Z4c_K1_DAMPING_AMPLITUDE 0.5
 #  define Z4c_K2_DAMPING_AMPLITUDE 0.1
@@ -135,6 +176,12 @@
     for(j=0; j<NY; ++j) \
       for(k=0; k<NZ; ++k)
 
+// loop over points owned by this process (all points without MPI)
+#define OWNED_LOOP3(i,j,k) \
+  for(i=OWNED_X_BEGIN; i<OWNED_X_END; ++i) \
+    for(j=0; j<NY; ++j) \
+      for(k=0; k<NZ; ++k)
+
 #define AREA_LOOP(j,k) \
   for(j=0; j<NY; ++j) \
     for(k=0; k<NZ; ++k)
@@ -160,7 +207,7 @@
 #define RK4_ARRAY_CREATE(name) \
         register_t * name
 
-#define RK4_ARRAY_ALLOC(name) \
+#define RK4_ARRAY_ALLOC(name, dt) \
         name = new register_t(); \
         name->init(NX, NY, NZ, dt)
 
@@ -0,0 +1,119 @@
+#!/bin/bash
+
+echo Running "$0 $@" on $(hostname)
+
+
+# Switch to the directory containing this script,
+cd "$(dirname "$0")"
+# And up a directory should be the main codebase.
+cd ..
+REPO_DIR=$(pwd)
+mkdir -p build_deposit
+cd build_deposit
+
+MIN_THREADS=1
+MAX_THREADS=8
+
+RES=64
+BASELINE=""
+COMPONENT=particles
+
+# read in options
+for i in "$@"
+do
+  case $i in
+      -h|--help)
+      printf "Usage: ./deposit_benchmark.sh\n"
+      printf "         [(-t|--min-threads)=1]\n"
+      printf "         [(-T|--max-threads)=8]\n"
+      printf "         [(-r|--resolution)=64]\n"
+      printf "         [(-b|--baseline)=<git revision>]\n"
+      printf "         [(-c|--component)=particles|sheets]\n"
+      printf "  Strong scaling of particle (sinusoid ICs, 2 particles per\n"
+      printf "  gridpoint) or sheet (64^3 elements) source deposition for\n"
+      printf "  each deposit strategy. With a baseline revision, the same\n"
+      printf "  runs are repeated with a build of that revision (eg. the\n"
+      printf "  commit before a deposit change).\n"
+      exit 0
+      ;;
+      -t=*|--min-threads=*)
+      MIN_THREADS="${i#*=}"
+      shift # past argument=value
+      ;;
+      -T=*|--max-threads=*)
+      MAX_THREADS="${i#*=}"
+      shift # past argument=value
+      ;;
+      -r=*|--resolution=*)
+      RES="${i#*=}"
+      shift # past argument=value
+      ;;
+      -b=*|--baseline=*)
+      BASELINE="${i#*=}"
+      shift # past argument=value
+      ;;
+      -c=*|--component=*)
+      COMPONENT="${i#*=}"
+      shift # past argument=value
+      ;;
+      *)
+        printf "Unrecognized option will not be used: ${i#*=}\n"
+        # unknown option
+      ;;
+  esac
+done
+
+if [ "$COMPONENT" == "sheets" ]; then
+  CONFIG=../config/sheet_deposit_benchmark.txt
+  TIMER="_pushsheetToStressTensor"
+  STRATEGY_KEY=deposit_strategy
+  STRATEGIES="0 1" # planes, tiles
+else
+  CONFIG=../config/particle_deposit_benchmark.txt
+  TIMER="Particles::addToBSSNSrc"
+  STRATEGY_KEY=particle_deposit_strategy
+  STRATEGIES="private colored"
+fi
+
+cp $CONFIG $CONFIG.test
+
+printf "Running deposit benchmark for\n"
+printf "  MIN_THREADS = $MIN_THREADS, MAX_THREADS = $MAX_THREADS\n"
+printf "  COMPONENT = $COMPONENT, RES = $RES, BASELINE = ${BASELINE:-none}\n"
+read -r -t 10 -p "Continue? Will automatically proceed in 10 seconds... [Y/n]: " response
+response=${response,,}    # tolower
+if ! [[ $response =~ ^(|y|yes)$ ]] ; then
+  printf "Aborting.\n"
+  exit 1
+fi
+printf "Running...\n"
+printf "\n"
+
+# run_scaling <label> <cosmo binary> <strategy>
+run_scaling() {
+  sed -i -E "s/${STRATEGY_KEY} = [a-z0-9]+/${STRATEGY_KEY} = $3/g" $CONFIG.test
+  THREADS=$MIN_THREADS
+  while [ "${THREADS}" -le "${MAX_THREADS}" ]; do
+    sed -i -E "s/omp_num_threads = [0-9]+/omp_num_threads = ${THREADS}/g" $CONFIG.test
+    DEPOSIT_TIME=$($2 $CONFIG.test | grep "$TIMER" | xargs)
+    echo "$1 for $THREADS threads, N = $RES:  $DEPOSIT_TIME"
+    ((THREADS=$THREADS*2))
+  done
+}
+
+COMPILE_RESULT=$(cmake -DCOSMO_N=$RES .. && make -j$MAX_THREADS)
+for STRATEGY in $STRATEGIES; do
+  run_scaling "$STRATEGY" ./cosmo $STRATEGY
+done
+
+if [ "$BASELINE" != "" ]; then
+  BASELINE_DIR=$REPO_DIR/build_deposit/baseline_src
+  rm -rf $BASELINE_DIR
+  git -C $REPO_DIR worktree add --detach $BASELINE_DIR $BASELINE > /dev/null
+  mkdir -p $BASELINE_DIR/build
+  COMPILE_RESULT=$(cd $BASELINE_DIR/build && cmake -DCOSMO_N=$RES .. && make -j$MAX_THREADS)
+  run_scaling "baseline $BASELINE" $BASELINE_DIR/build/cosmo ${STRATEGIES%% *}
+  git -C $REPO_DIR worktree remove --force $BASELINE_DIR
+fi
+
+rm $CONFIG.test
@@ -0,0 +1,125 @@
+#!/bin/bash
+
+echo Running "$0 $@" on $(hostname)
+
+
+# Switch to the directory containing this script,
+cd "$(dirname "$0")"
+# And up a directory should be the main codebase.
+cd ..
+mkdir -p build_mpi
+cd build_mpi
+
+MIN_RANKS=1
+MAX_RANKS=4
+
+RES=64
+THREADS=1
+
+MPIRUN=mpirun
+
+cp ../config/benchmark.txt ../config/mpi_benchmark.txt.test
+# write 3D output at the last step, to check it against the first run
+STEPS=$(grep -E "^steps = " ../config/mpi_benchmark.txt.test | sed -E "s/steps = //")
+printf "\nIO_3D_grid_interval = ${STEPS}\nIO_3D_DIFFgamma22_a = 1\n" >> ../config/mpi_benchmark.txt.test
+
+# read in options
+for i in "$@"
+do
+  case $i in
+      -h|--help)
+      printf "Usage: ./mpi_benchmark.sh\n"
+      printf "         [(-p|--min-ranks)=1]\n"
+      printf "         [(-P|--max-ranks)=4]\n"
+      printf "         [(-r|--resolution)=64]\n"
+      printf "         [(-t|--threads)=1]\n"
+      printf "         [(-m|--mpirun)=mpirun]\n"
+      printf "  Strong scaling runs an N^3 box on 1..P ranks; weak scaling\n"
+      printf "  runs an (N*ranks) x N x N box. N must be divisible by P.\n"
+      printf "  3D output of strong scaling runs (written with parallel HDF5\n"
+      printf "  when available) is compared with that of the first run.\n"
+      exit 0
+      ;;
+      -p=*|--min-ranks=*)
+      MIN_RANKS="${i#*=}"
+      shift # past argument=value
+      ;;
+      -P=*|--max-ranks=*)
+      MAX_RANKS="${i#*=}"
+      shift # past argument=value
+      ;;
+      -r=*|--resolution=*)
+      RES="${i#*=}"
+      shift # past argument=value
+      ;;
+      -t=*|--threads=*)
+      THREADS="${i#*=}"
+      shift # past argument=value
+      ;;
+      -m=*|--mpirun=*)
+      MPIRUN="${i#*=}"
+      shift # past argument=value
+      ;;
+      *)
+        printf "Unrecognized option will not be used: ${i#*=}\n"
+        # unknown option
+      ;;
+  esac
+done
+
+sed -i -E "s/omp_num_threads = [0-9]+/omp_num_threads = ${THREADS}/g" ../config/mpi_benchmark.txt.test
+
+printf "Running MPI benchmark for\n"
+printf "  MIN_RANKS = $MIN_RANKS, MAX_RANKS = $MAX_RANKS\n"
+printf "  RES = $RES, THREADS = $THREADS (per rank)\n"
+read -r -t 10 -p "Continue? Will automatically proceed in 10 seconds... [Y/n]: " response
+response=${response,,}    # tolower
+if ! [[ $response =~ ^(|y|yes)$ ]] ; then
+  printf "Aborting.\n"
+  exit 1
+fi
+printf "Running...\n"
+printf "\n"
+
+printf "Strong scaling:\n"
+RANKS=$MIN_RANKS
+GRID_FILE=3D_DIFFgamma22_a${STEPS}.3d_grid.h5.gz
+while [ "${RANKS}" -le "${MAX_RANKS}" ]; do
+  RUN_DIR=mpi_benchmark_run_${RANKS}
+  rm -rf $RUN_DIR
+  sed -i -E "s/output_dir = .*/output_dir = ${RUN_DIR}/g" ../config/mpi_benchmark.txt.test
+  COMPILE_RESULT=$(cmake -DCOSMO_USE_MPI=1 -DCOSMO_MPI_RANKS=$RANKS -DCOSMO_N=$RES .. && make -j4)
+  OUTPUT=$($MPIRUN -np $RANKS ./cosmo ../config/mpi_benchmark.txt.test)
+  RK_LOOP_TIME=$(echo "$OUTPUT" | grep RK_steps)
+  HALO_TIME=$(echo "$OUTPUT" | grep halo_ | xargs)
+  echo "RK_steps for $RANKS ranks, N = $RES:  $RK_LOOP_TIME ($HALO_TIME)"
+
+  OUTPUT_PATH=$(grep "3D output:" $RUN_DIR/log.txt | sed -E "s/ *3D output: //")
+  if [ "${RANKS}" -eq "${MIN_RANKS}" ]; then
+    echo "  3D output: $OUTPUT_PATH"
+  elif ! command -v h5diff > /dev/null; then
+    echo "  3D output: $OUTPUT_PATH; not checked (h5diff not found)"
+  elif h5diff -q mpi_benchmark_run_${MIN_RANKS}/$GRID_FILE $RUN_DIR/$GRID_FILE DS1 DS1; then
+    echo "  3D output: $OUTPUT_PATH; matches the ${MIN_RANKS}-rank run"
+  else
+    echo "  3D output: $OUTPUT_PATH; DIFFERS from the ${MIN_RANKS}-rank run"
+  fi
+  ((RANKS=$RANKS*2))
+done
+rm -rf mpi_benchmark_run_*
+sed -i -E "s/output_dir = .*/output_dir = mpi_benchmark_run_weak/g" ../config/mpi_benchmark.txt.test
+
+printf "\nWeak scaling:\n"
+RANKS=$MIN_RANKS
+while [ "${RANKS}" -le "${MAX_RANKS}" ]; do
+  ((NX=$RES*$RANKS))
+  COMPILE_RESULT=$(cmake -DCOSMO_USE_MPI=1 -DCOSMO_MPI_RANKS=$RANKS -DCOSMO_N=$NX -DCOSMO_NY=$RES -DCOSMO_NZ=$RES .. && make -j4)
+  OUTPUT=$($MPIRUN -np $RANKS ./cosmo ../config/mpi_benchmark.txt.test)
+  RK_LOOP_TIME=$(echo "$OUTPUT" | grep RK_steps)
+  HALO_TIME=$(echo "$OUTPUT" | grep halo_ | xargs)
+  echo "RK_steps for $RANKS ranks, N = $NX x $RES x $RES:  $RK_LOOP_TIME ($HALO_TIME)"
+  ((RANKS=$RANKS*2))
+done
+
+rm -rf mpi_benchmark_run_weak*
+rm ../config/mpi_benchmark.txt.test
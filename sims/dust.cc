@@ -5,10 +5,11 @@
 namespace cosmo
 {
 
-DustSim::DustSim()
+DustSim::DustSim(SimContext * ctx_in) :
+  CosmoSim(ctx_in)
 {
   // just check to make sure we can use this class.
-  if(_config("shift", "") != "")
+  if(ctx->config("shift", "") != "")
   {
     iodata->log("Error - non-zero shift not ok for this class!");
     iodata->log("Please change this setting in the config file and re-run.");
@@ -16,21 +17,40 @@ DustSim::DustSim()
   }
 
   take_ray_step = false;
-  raysheet_flip_step = std::stoi(_config("raysheet_flip_step", "-1"));
+  raysheet_flip_step = std::stoi(ctx->config("raysheet_flip_step", "-1"));
+
+  tiles = NULL;
+  if(std::stoi(ctx->config("task_graph", "0")))
+  {
+#if USE_MPI
+    iodata->log("Task-based RK substeps are not supported with MPI; not using them.");
+#else
+    if(std::stod(ctx->config("rescale_metric", "1.0")) != 1.0)
+      iodata->log("Task-based RK substeps are not supported with rescale_metric; not using them.");
+    else if(std::stoi(ctx->config("dust_substeps", "1")) != 1 || std::stoi(ctx->config("ray_substeps", "1")) != 1)
+      iodata->log("Task-based RK substeps are not supported with subcycling; not using them.");
+    else
+      tiles = new GridTiles(std::stoi(ctx->config("task_tile_width", "8")));
+#endif
+  }
 }
 
 void DustSim::init()
 {
-  _timer["init"].start();
+  ctx->timer["init"].start();
 
   // initialize base class
   simInit();
 
   iodata->log("Initializing 'dust' type simulation.");
-  dustSim = new Dust();
+  dustSim = new Dust(ctx);
   lambda = new Lambda();
-  raySheet = new Sheet();
-  _timer["init"].stop();
+  raySheet = new Sheet(ctx, iodata);
+
+  driver = new MatterDriver(bssnSim);
+  driver->addComponent(dustSim, std::stoi(ctx->config("dust_substeps", "1")));
+  driver->addComponent(lambda);
+  ctx->timer["init"].stop();
 }
 
 /**
@@ -39,7 +59,7 @@ void DustSim::init()
  */
 void DustSim::setICs()
 {
-  _timer["ICs"].start();
+  ctx->timer["ICs"].start();
 
   iodata->log("Setting dust initial conditions.");
 
@@ -47,26 +67,36 @@ void DustSim::setICs()
   dust_ic_set_random(bssnSim, dustSim, lambda, fourier, iodata);
   iodata->log("Finished setting ICs.");
   
-  _timer["ICs"].stop();
+  ctx->timer["ICs"].stop();
+}
+
+bool DustSim::syncICCache(ICCache * ic_cache)
+{
+  CosmoSim::syncICCache(ic_cache);
+  ic_cache->syncRegister("D", dustSim->D);
+  ic_cache->syncRegister("S1", dustSim->S1);
+  ic_cache->syncRegister("S2", dustSim->S2);
+  ic_cache->syncRegister("S3", dustSim->S3);
+  real_t rho_L = lambda->getLambda();
+  ic_cache->syncScalar("Lambda", rho_L);
+  lambda->setLambda(rho_L);
+  return true;
 }
 
 void DustSim::initDustStep()
 {
-  _timer["RK_steps"].start();
+  ctx->timer["RK_steps"].start();
     bssnSim->stepInit();
     if(take_ray_step) raySheet->stepInit();
     dustSim->stepInit(bssnSim);
-
-    bssnSim->clearSrc();
-    dustSim->addBSSNSrc(bssnSim);
-    lambda->addBSSNSource(bssnSim);
-  _timer["RK_steps"].stop();
+    driver->setSources();
+  ctx->timer["RK_steps"].stop();
 
 
   arr_t & DIFFr_a = *bssnSim->fields["DIFFr_a"];
   real_t rho_tot_avg = average(DIFFr_a);
   real_t rho_L = lambda->getLambda();
-  real_t Omega_L_flip = std::stod(_config("raysheet_flip_omega_L", "0.0"));
+  real_t Omega_L_flip = std::stod(ctx->config("raysheet_flip_omega_L", "0.0"));
   if(
     (Omega_L_flip > 0.0 && rho_L/rho_tot_avg > Omega_L_flip && take_ray_step == false)
     || (raysheet_flip_step > 0 && step >= raysheet_flip_step && take_ray_step == false) )
@@ -75,8 +105,8 @@ void DustSim::initDustStep()
     iodata->log("\nFlipping sign of dt @ step = " + std::to_string(step) );
     iodata->log("--Omega_L was " + std::to_string(rho_L/rho_tot_avg) );
     iodata->log("--Setting final number of simulation steps to " + std::to_string(num_steps) );
-    dt = -std::abs(dt);
-    iodata->log("--New dt is " + std::to_string(dt) );
+    ctx->setDt(-std::abs(ctx->dt));
+    iodata->log("--New dt is " + std::to_string(ctx->dt) );
 
     take_ray_step = true;
     // Set raytracing initial conditions
@@ -85,15 +115,14 @@ void DustSim::initDustStep()
     raySheet->stepInit();
 
     outputStateInformation();
-    bssnSim->setDt(dt);
-    dustSim->setDt(dt);
-    raySheet->setDt(dt);
+    driver->addComponent(raySheet, std::stoi(ctx->config("ray_substeps", "1")));
+    driver->setDt(ctx->dt);
   }
 }
 
 void DustSim::outputDustStep()
 {
-  _timer["output"].start();
+  ctx->timer["output"].start();
     prepBSSNOutput();
     if(use_bardeen)
       io_svt_violation(iodata, step, bardeen, t);
@@ -108,56 +137,106 @@ void DustSim::outputDustStep()
     }
     if(take_ray_step)
       io_raysheet_dump(iodata, step, raySheet, bssnSim, lambda);
-  _timer["output"].stop();
+  ctx->timer["output"].stop();
+}
+
+/**
+ * @brief      Evolve one RK substep as a graph of tasks operating on tiles
+ *  (blocks of x-planes) of the grid
+ * @details    Tasks on a tile run as soon as the data they read is ready,
+ *  rather than after a full-grid pass of the previous operation:
+ *  - Sources are set in a single pass (MatterDriver::setSources), and
+ *    read by BSSN and dust RHS tasks.
+ *  - Dust::populateDerivedFields overwrites derived fields read when
+ *    setting sources. It only reads BSSN fields, so it can run
+ *    concurrently with BSSN::RKEvolveTile.
+ *  - Dust fluxes are differenced, so dust evolution of a tile waits on
+ *    fluxes of its neighbors.
+ *  - Finalizing a tile only modifies _c, _f, and _p registers there, so it
+ *    can run as soon as the tile is evolved, while other tiles are evolving.
+ *  Register swaps and reductions (BSSN::setExtraFieldData) then need the
+ *  whole grid, and are done after all tasks have completed.
+ *
+ * @param[in]  n            RK substep (1-4)
+ * @param[in]  set_sources  whether to recompute BSSN sources first
+ */
+void DustSim::runDustSubstepTasks(int n, bool set_sources)
+{
+  const int n_tiles = tiles->n_tiles;
+  // dependency sentinels, one per tile
+  std::vector<char> src_deps(n_tiles), derived_deps(n_tiles),
+    bssn_c_deps(n_tiles), dust_c_deps(n_tiles);
+
+  BSSNSrcAssembly sa;
+  if(set_sources)
+    driver->prepareSources(&sa);
+
+#pragma omp parallel default(shared)
+#pragma omp single
+  {
+    for(int t=0; t<n_tiles; ++t)
+    {
+      idx_t x_begin = tiles->begin(t), x_end = tiles->end(t);
+
+      if(set_sources)
+      {
+#pragma omp task depend(out: src_deps.data()[t]) depend(in: derived_deps.data()[t])
+        driver->setSources(&sa, x_begin, x_end);
+      }
+
+#pragma omp task depend(in: src_deps.data()[t]) depend(out: bssn_c_deps.data()[t])
+      bssnSim->RKEvolveTile(x_begin, x_end);
+#pragma omp task depend(in: src_deps.data()[t]) depend(out: derived_deps.data()[t])
+      dustSim->populateDerivedFields(bssnSim, x_begin, x_end);
+    }
+
+    for(int t=0; t<n_tiles; ++t)
+    {
+      idx_t x_begin = tiles->begin(t), x_end = tiles->end(t);
+      int l = tiles->left(t), r = tiles->right(t);
+
+#pragma omp task depend(in: derived_deps.data()[l], derived_deps.data()[t], derived_deps.data()[r]) depend(out: dust_c_deps.data()[t])
+      dustSim->RKEvolveTile(x_begin, x_end);
+#pragma omp task depend(inout: dust_c_deps.data()[t])
+      dustSim->KFinalizeTile(n, x_begin, x_end);
+#pragma omp task depend(inout: bssn_c_deps.data()[t])
+      bssnSim->KFinalizeTile(n, x_begin, x_end);
+    }
+  }
+
+  // rays interpolate the (unmodified) _a register over the whole grid
+  if(take_ray_step) raySheet->RKStep(bssnSim);
+
+  bssnSim->KFinalizeComplete(n);
+  dustSim->KFinalizeComplete();
+  if(take_ray_step)
+  {
+    switch(n)
+    {
+      case 1: raySheet->K1Finalize(); break;
+      case 2: raySheet->K2Finalize(); break;
+      case 3: raySheet->K3Finalize(); break;
+      case 4: raySheet->K4Finalize(); break;
+    }
+  }
 }
 
 void DustSim::runDustStep()
 {
-  _timer["RK_steps"].start();
-    // First RK step
-    // source already set in initDustStep() (used for output)
-    bssnSim->RKEvolve();
-    dustSim->RKEvolve(bssnSim);
-    if(take_ray_step) raySheet->RKStep(bssnSim);
-    bssnSim->K1Finalize();
-    dustSim->K1Finalize();
-    if(take_ray_step) raySheet->K1Finalize();
-
-    // Second RK step
-    bssnSim->clearSrc();
-    dustSim->addBSSNSrc(bssnSim);
-    lambda->addBSSNSource(bssnSim);
-    bssnSim->RKEvolve();
-    dustSim->RKEvolve(bssnSim);
-    if(take_ray_step) raySheet->RKStep(bssnSim);
-    bssnSim->K2Finalize();
-    dustSim->K2Finalize();
-    if(take_ray_step) raySheet->K2Finalize();
-
-    // Third RK step
-    bssnSim->clearSrc();
-    dustSim->addBSSNSrc(bssnSim);
-    lambda->addBSSNSource(bssnSim);
-    bssnSim->RKEvolve();
-    dustSim->RKEvolve(bssnSim);
-    if(take_ray_step) raySheet->RKStep(bssnSim);
-    bssnSim->K3Finalize();
-    dustSim->K3Finalize();
-    if(take_ray_step) raySheet->K3Finalize();
-
-    // Fourth RK step
-    bssnSim->clearSrc();
-    dustSim->addBSSNSrc(bssnSim);
-    lambda->addBSSNSource(bssnSim);
-    bssnSim->RKEvolve();
-    dustSim->RKEvolve(bssnSim);
-    if(take_ray_step) raySheet->RKStep(bssnSim);
-    bssnSim->K4Finalize();
-    dustSim->K4Finalize();
-    if(take_ray_step) raySheet->K4Finalize();
+  ctx->timer["RK_steps"].start();
+  if(tiles)
+  {
+    // source for the first RK step already set in initDustStep()
+    for(int n=1; n<=4; ++n)
+      runDustSubstepTasks(n, n > 1);
+    ctx->timer["RK_steps"].stop();
+    return;
+  }
 
+    // source for the first RK step already set in initDustStep() (used for output)
+    driver->step();
     // "current" data should be in the _p array.
-  _timer["RK_steps"].stop();
+  ctx->timer["RK_steps"].stop();
 }
 
 void DustSim::runStep()
@@ -5,6 +5,8 @@
 #include "../components/dust_fluid/dust.h"
 #include "../components/Lambda/lambda.h"
 #include "../components/phase_space_sheet/sheets.h"
+#include "../components/matter/MatterDriver.h"
+#include "../utils/GridTiles.h"
 
 namespace cosmo
 {
@@ -18,16 +20,22 @@ protected:
   Sheet * raySheet;
   Dust * dustSim;
   Lambda * lambda;
+  MatterDriver * driver;
   bool take_ray_step;
   idx_t raysheet_flip_step;
+  GridTiles * tiles; ///< tiles for task-based RK substeps; NULL if not used
+
+  void runDustSubstepTasks(int n, bool set_sources);
 public:
-  DustSim();
+  DustSim(SimContext * ctx_in);
   ~DustSim()
   {
     std::cout << "Cleaning up...";
     delete iodata;
     delete bssnSim;
     delete fourier;
+    delete tiles;
+    delete driver;
     if(use_bardeen)
     {
       delete bardeen;
@@ -38,6 +46,7 @@ public:
 
   void init();
   void setICs();
+  bool syncICCache(ICCache * ic_cache);
   void initDustStep();
   void outputDustStep();
   void runDustStep();
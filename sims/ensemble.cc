@@ -0,0 +1,319 @@
+#include "ensemble.h"
+#include "../ICs/ic_cache.h"
+#include "../utils/Fourier.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace cosmo
+{
+
+namespace
+{
+
+const useconds_t ENSEMBLE_IC_POLL_US = 100000;
+
+std::vector<std::string> split_list(std::string list)
+{
+  std::vector<std::string> items;
+  std::stringstream ss(list);
+  std::string item;
+  while(std::getline(ss, item, ','))
+    if(item != "")
+      items.push_back(item);
+  return items;
+}
+
+} // anonymous namespace
+
+/**
+ * @brief      Read ensemble settings and members from the ensemble config;
+ *  config files for scanned members are written out.
+ */
+Ensemble::Ensemble(ConfigParser * config)
+{
+#if USE_MPI
+  std::cerr << "Ensembles are not supported with MPI.\n";
+  throw -1;
+#endif
+
+  ensemble_dir = (*config)("ensemble_dir", "ensemble");
+  mkdir(ensemble_dir.c_str(), 0755);
+
+  threads = std::stoi((*config)("ensemble_threads", "1"));
+  if(threads < 1)
+    threads = 1;
+  jobs = std::stoi((*config)("ensemble_jobs",
+    std::to_string(omp_get_num_procs()/threads)));
+  if(jobs < 1)
+    jobs = 1;
+
+  if((*config)("ensemble_base", "") != "")
+  {
+    ConfigParser base;
+    base.parse((*config)["ensemble_base"], false);
+    addScanMembers(config, base);
+  }
+  else
+  {
+    for(std::string config_file : split_list((*config)["ensemble_configs"]))
+      addMember(config_file);
+  }
+
+  if(members.empty())
+  {
+    std::cerr << "Error: ensemble has no members.\n";
+    throw -1;
+  }
+
+  std::cout << "Running ensemble of " << members.size() << " simulations, "
+    << jobs << " at a time with " << threads << " thread(s) each.\n";
+}
+
+void Ensemble::addMember(std::string config_file)
+{
+  EnsembleMember member;
+  member.config_file = config_file;
+  member.ic_hash = "";
+  member.ic_file = "";
+  member.ic_leader = members.size();
+  member.state = MEMBER_WAITING;
+  member.pid = 0;
+  member.exit_status = 0;
+  members.push_back(member);
+}
+
+/**
+ * @brief      Add a member for each combination of values of the
+ *  "ensemble_scan_<param>" parameters, overriding those in the base config.
+ */
+void Ensemble::addScanMembers(ConfigParser * ensemble_config,
+  ConfigParser & base)
+{
+  const std::string prefix = "ensemble_scan_";
+  std::vector<std::string> params;
+  std::vector< std::vector<std::string> > values;
+  for(auto it = ensemble_config->begin(); it != ensemble_config->end(); ++it)
+    if(it->first.compare(0, prefix.length(), prefix) == 0)
+    {
+      params.push_back(it->first.substr(prefix.length()));
+      values.push_back(split_list(it->second));
+      if(values.back().empty())
+      {
+        std::cerr << "Error: no values given for " << it->first << ".\n";
+        throw -1;
+      }
+    }
+
+  idx_t n_members = 1;
+  for(auto & param_values : values)
+    n_members *= param_values.size();
+
+  for(idx_t m=0; m<n_members; ++m)
+  {
+    std::map<std::string, std::string> config(base.begin(), base.end());
+    config["output_dir"] = base("output_dir", "output") + "_" + std::to_string(m);
+
+    // values of the first parameter vary slowest
+    idx_t stride = n_members;
+    std::string description = "";
+    for(size_t p=0; p<params.size(); ++p)
+    {
+      stride /= values[p].size();
+      config[params[p]] = values[p][(m/stride) % values[p].size()];
+      description += " " + params[p] + " = " + config[params[p]] + ";";
+    }
+
+    std::string config_file = ensemble_dir + "/member_" + std::to_string(m) + ".txt";
+    std::ofstream out(config_file.c_str());
+    for(auto & param : config)
+      out << param.first << " = " << param.second << "\n";
+    out.close();
+    if(!out)
+    {
+      std::cerr << "Error: unable to write " << config_file << ".\n";
+      throw -1;
+    }
+
+    std::cout << "Ensemble member " << m << ":" << description << "\n";
+    addMember(config_file);
+  }
+}
+
+/**
+ * @brief      Find members using the same IC cache entry; only the first
+ *  of these (the "leader") runs until it is done.
+ */
+void Ensemble::setICLeaders()
+{
+  std::map<std::string, int> leaders;
+  for(size_t m=0; m<members.size(); ++m)
+  {
+    SimContext ctx;
+    ctx.parse(members[m].config_file, false);
+
+    ICCache ic_cache(&ctx, NULL);
+    if(!ic_cache.isEnabled())
+      continue;
+
+    members[m].ic_hash = ic_cache.getHash();
+    members[m].ic_file = ic_cache.cacheFileName();
+    if(leaders.find(members[m].ic_hash) == leaders.end())
+      leaders[members[m].ic_hash] = m;
+    members[m].ic_leader = leaders[members[m].ic_hash];
+  }
+}
+
+/**
+ * @brief      Whether member m can start: it generates its own ICs, or the
+ *  member generating them has finished or stored them in the cache.
+ * @details    ICCache::store() renames the cache file into place, so the
+ *  file is complete once it exists.
+ */
+bool Ensemble::icsReady(int m)
+{
+  int leader = members[m].ic_leader;
+  if(leader == m || members[leader].state == MEMBER_DONE)
+    return true;
+
+  struct stat ic_stat;
+  return stat(members[m].ic_file.c_str(), &ic_stat) == 0;
+}
+
+/**
+ * @brief      Run member m in a forked process, writing its output to a
+ *  log file in the ensemble directory.
+ */
+void Ensemble::launch(int m, void (*configure)(SimContext *),
+  int (*simulate)(SimContext *))
+{
+  std::cout << std::flush;
+  fflush(NULL);
+
+  pid_t pid = fork();
+  if(pid < 0)
+  {
+    std::cerr << "Error: unable to start ensemble member " << m << ".\n";
+    throw -1;
+  }
+
+  if(pid == 0)
+  {
+    int status = EXIT_FAILURE;
+    std::string log_file = ensemble_dir + "/member_" + std::to_string(m) + ".log";
+    int fd = open(log_file.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(fd >= 0)
+    {
+      dup2(fd, STDOUT_FILENO);
+      dup2(fd, STDERR_FILENO);
+      close(fd);
+    }
+
+    try
+    {
+      SimContext ctx;
+      ctx.parse(members[m].config_file);
+      omp_set_num_threads(threads);
+      configure(&ctx);
+      status = simulate(&ctx);
+    }
+    catch(...)
+    {
+      std::cerr << "Ensemble member " << m << " failed.\n";
+    }
+
+    std::cout << std::flush;
+    fflush(NULL);
+    _exit(status);
+  }
+
+  members[m].pid = pid;
+  members[m].state = MEMBER_RUNNING;
+  std::cout << "Started ensemble member " << m << " ("
+    << members[m].config_file << ").\n";
+}
+
+/**
+ * @brief      Run all members
+ *
+ * @param[in]  configure  function setting process-wide state (eg. number
+ *  of threads) from the context of a member
+ * @param[in]  simulate   function running a simulation with the given
+ *  context; returns an exit status
+ *
+ * @return     EXIT_SUCCESS if all members succeeded
+ */
+int Ensemble::run(void (*configure)(SimContext *),
+  int (*simulate)(SimContext *))
+{
+  setICLeaders();
+
+  // plan FFTs for the grid once; members inherit the accumulated wisdom
+  {
+    Fourier fourier;
+    fourier.Initialize(NX, NY, NZ);
+  }
+
+  int running = 0, failed = 0;
+  size_t done = 0;
+  while(done < members.size())
+  {
+    bool waiting_for_ics = false;
+    for(size_t m=0; m<members.size() && running < jobs; ++m)
+      if(members[m].state == MEMBER_WAITING)
+      {
+        if(icsReady(m))
+        {
+          launch(m, configure, simulate);
+          ++running;
+        }
+        else
+        {
+          waiting_for_ics = true;
+        }
+      }
+
+    // poll while members wait for cached ICs, so they start once stored
+    int status;
+    pid_t pid;
+    if(waiting_for_ics && running < jobs)
+    {
+      pid = waitpid(-1, &status, WNOHANG);
+      if(pid == 0)
+      {
+        usleep(ENSEMBLE_IC_POLL_US);
+        continue;
+      }
+    }
+    else
+    {
+      pid = wait(&status);
+    }
+    if(pid < 0)
+    {
+      std::cerr << "Error: lost track of ensemble members.\n";
+      throw -1;
+    }
+
+    for(size_t m=0; m<members.size(); ++m)
+      if(members[m].state == MEMBER_RUNNING && members[m].pid == pid)
+      {
+        members[m].state = MEMBER_DONE;
+        members[m].exit_status = WIFEXITED(status) ? WEXITSTATUS(status) : EXIT_FAILURE;
+        if(members[m].exit_status != EXIT_SUCCESS)
+          ++failed;
+        --running;
+        ++done;
+        std::cout << "Ensemble member " << m
+          << (members[m].exit_status == EXIT_SUCCESS ? " finished" : " FAILED")
+          << " (" << done << " / " << members.size() << " done).\n";
+      }
+  }
+
+  std::cout << "Ensemble finished; " << failed << " member(s) failed.\n";
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+} // namespace cosmo
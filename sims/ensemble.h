@@ -0,0 +1,69 @@
+#ifndef COSMO_ENSEMBLE_H
+#define COSMO_ENSEMBLE_H
+
+#include "../cosmo_includes.h"
+#include "../cosmo_types.h"
+#include "../utils/ConfigParser.h"
+#include "../utils/SimContext.h"
+
+#include <sys/types.h>
+
+namespace cosmo
+{
+
+/**
+ * @brief Run many (small) simulations concurrently from one process
+ * @details Members are listed in the ensemble config ("simulation_type =
+ *  ensemble") either as "ensemble_configs = a.txt,b.txt,...", or as a base
+ *  config, "ensemble_base = base.txt", plus one or more parameter axes,
+ *  "ensemble_scan_<param> = v1,v2,...", whose cartesian product is run.
+ *  Config files for scanned members are written to "ensemble_dir" (default
+ *  "ensemble"), and their output goes to "<output_dir>_<member>".
+ *
+ *  Up to "ensemble_jobs" members run at once, each in a forked process with
+ *  "ensemble_threads" OpenMP threads (default 1; the number of jobs
+ *  defaults to the number of processors divided by this). Each member has
+ *  its own SimContext; processes keep the remaining process-wide state
+ *  (OpenMP settings, FFTW planner, HDF5 library) separate. FFTW plans for the grid
+ *  are made once, before forking, so members reuse the resulting wisdom.
+ *  Members with the same IC cache entry (see ICCache) wait for the first of
+ *  them to generate and store it, then load it from the cache; they start
+ *  as soon as the cache file appears, while the first member is still
+ *  evolving.
+ *  Output of each member is written to "<ensemble_dir>/member_<n>.log".
+ */
+class Ensemble
+{
+  typedef enum { MEMBER_WAITING, MEMBER_RUNNING, MEMBER_DONE } member_state;
+
+  typedef struct {
+    std::string config_file;
+    std::string ic_hash; ///< IC cache hash; empty if not using a cache
+    std::string ic_file; ///< IC cache file for this hash
+    int ic_leader; ///< member generating the cached ICs used by this one
+    member_state state;
+    pid_t pid;
+    int exit_status;
+  } EnsembleMember;
+
+  std::string ensemble_dir;
+  int jobs; ///< maximum number of members running at once
+  int threads; ///< OpenMP threads per member
+  std::vector<EnsembleMember> members;
+
+  void addMember(std::string config_file);
+  void addScanMembers(ConfigParser * ensemble_config, ConfigParser & base);
+  void setICLeaders();
+  bool icsReady(int m);
+  void launch(int m, void (*configure)(SimContext *),
+    int (*simulate)(SimContext *));
+
+public:
+  Ensemble(ConfigParser * config);
+
+  int run(void (*configure)(SimContext *), int (*simulate)(SimContext *));
+};
+
+} // namespace cosmo
+
+#endif
@@ -6,24 +6,24 @@ namespace cosmo
 
 void ParticleSim::init()
 {
-  _timer["init"].start();
+  ctx->timer["init"].start();
 
   // initialize base class
   simInit();
 
   iodata->log("Running 'particles' type simulation.");
-  particles = new Particles();
+  particles = new Particles(ctx);
 
-  _timer["init"].stop();
+  ctx->timer["init"].stop();
 }
 
 void ParticleSim::setICs()
 {
-  if(_config("ic_type", "") == "vectorpert")
+  if(ctx->config("ic_type", "") == "vectorpert")
   {
     particle_ic_set_vectorpert(bssnSim, particles, iodata);
   }
-  else if(_config("ic_type", "") == "sinusoid")
+  else if(ctx->config("ic_type", "") == "sinusoid")
   {
     particle_ic_set_sinusoid(bssnSim, particles, iodata);
   }
@@ -33,19 +33,27 @@ void ParticleSim::setICs()
   }
 }
 
+/**
+ * @brief      Particle ICs are not gridded and are not cached.
+ */
+bool ParticleSim::syncICCache(ICCache * ic_cache)
+{
+  return false;
+}
+
 void ParticleSim::initParticleStep()
 {
-  _timer["RK_steps"].start();
+  ctx->timer["RK_steps"].start();
     bssnSim->stepInit();
     particles->stepInit(bssnSim->fields);
     bssnSim->clearSrc();
-    particles->addParticlesToBSSNSrc(bssnSim);
-  _timer["RK_steps"].stop();
+    particles->addParticlesToBSSNSrc(bssnSim, fourier);
+  ctx->timer["RK_steps"].stop();
 }
 
 void ParticleSim::outputParticleStep()
 {
-  _timer["output"].start();
+  ctx->timer["output"].start();
     prepBSSNOutput();
     if(use_bardeen)
       io_svt_violation(iodata, step, bardeen, t);
@@ -59,12 +67,12 @@ void ParticleSim::outputParticleStep()
     {
       outputStateInformation();
     }
-  _timer["output"].stop();
+  ctx->timer["output"].stop();
 }
 
 void ParticleSim::runParticleStep()
 {
-  _timer["RK_steps"].start();
+  ctx->timer["RK_steps"].start();
     // First RK step
     bssnSim->RKEvolve();
     particles->RK1Step(bssnSim->fields);
@@ -73,7 +81,7 @@ void ParticleSim::runParticleStep()
 
     // Second RK step source
     bssnSim->clearSrc();
-    particles->addParticlesToBSSNSrc(bssnSim);
+    particles->addParticlesToBSSNSrc(bssnSim, fourier);
     // Second RK step
     bssnSim->RKEvolve();
     particles->RK2Step(bssnSim->fields);
@@ -82,7 +90,7 @@ void ParticleSim::runParticleStep()
 
     // Third RK step source
     bssnSim->clearSrc();
-    particles->addParticlesToBSSNSrc(bssnSim);
+    particles->addParticlesToBSSNSrc(bssnSim, fourier);
     // Third RK step
     bssnSim->RKEvolve();
     particles->RK3Step(bssnSim->fields);
@@ -91,7 +99,7 @@ void ParticleSim::runParticleStep()
 
     // Fourth RK step source
     bssnSim->clearSrc();
-    particles->addParticlesToBSSNSrc(bssnSim);
+    particles->addParticlesToBSSNSrc(bssnSim, fourier);
     // Fourth RK step
     bssnSim->RKEvolve();
     particles->RK4Step(bssnSim->fields);
@@ -99,7 +107,7 @@ void ParticleSim::runParticleStep()
     particles->stepTerm();
     
     // "current" data should be in the _p array.
-  _timer["RK_steps"].stop();
+  ctx->timer["RK_steps"].stop();
 }
 
 void ParticleSim::runStep()
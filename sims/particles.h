@@ -17,7 +17,7 @@ protected:
   Particles * particles;
 
 public:
-  ParticleSim() {}
+  ParticleSim(SimContext * ctx_in) : CosmoSim(ctx_in) {}
   ~ParticleSim()
   {
     std::cout << "Cleaning up...";
@@ -37,6 +37,7 @@ public:
 
   void init();
   void setICs();
+  bool syncICCache(ICCache * ic_cache);
   void initParticleStep();
   void outputParticleStep();
   void runParticleStep();
@@ -6,61 +6,49 @@ namespace cosmo
 
 void ScalarSim::init()
 {
-  _timer["init"].start();
+  ctx->timer["init"].start();
 
   // initialize base class
   simInit();
 
   iodata->log("Running 'scalar' type simulation.");
-  scalarSim = new Scalar();
+  scalarSim = new Scalar(ctx);
 
-  _timer["init"].stop();
+  driver = new MatterDriver(bssnSim);
+  driver->addComponent(scalarSim, std::stoi(ctx->config("scalar_substeps", "1")));
+
+  ctx->timer["init"].stop();
 }
 
 void ScalarSim::setICs()
 {
-  _timer["ICs"].start();
+  ctx->timer["ICs"].start();
   iodata->log("Setting initial conditions (ICs).");
 
-  if(_config["scalar_ic_type"] == "wave")
+  if(ctx->config["scalar_ic_type"] == "wave")
   {
     scalar_ic_set_wave(bssnSim, scalarSim);
   }
-  else if(_config["scalar_ic_type"] == "Lambda")
+  else if(ctx->config["scalar_ic_type"] == "Lambda")
   {
     scalar_ic_set_Lambda(bssnSim, scalarSim);
   }
-  else if(_config["scalar_ic_type"] == "semianalytic_test")
+  else if(ctx->config["scalar_ic_type"] == "semianalytic_test")
   {
     scalar_ic_set_semianalytic_test(bssnSim, scalarSim, iodata);
   }
-  else if(_config["scalar_ic_type"] == "Bowen-York")
+  else if(ctx->config["scalar_ic_type"] == "Bowen-York")
   {
-#   if USE_MULTIGRID
     scalar_ic_set_Bowen_York(bssnSim, scalarSim, iodata);
-#   else
-    iodata->log("Error: Multigrid solver was not compiled.");
-    throw -1;    
-#   endif
   }
-  else if(_config["scalar_ic_type"] == "full_constraints")
+  else if(ctx->config["scalar_ic_type"] == "full_constraints")
   {
-#   if USE_MULTIGRID
     scalar_ic_set_full_equations(bssnSim, scalarSim, iodata);
-#   else
-    iodata->log("Error: Multigrid solver was not compiled.");
-    throw -1;    
-#   endif
     
   }
-  else if(_config["scalar_ic_type"] == "multigrid")
+  else if(ctx->config["scalar_ic_type"] == "multigrid")
   {
-#   if USE_MULTIGRID
     scalar_ic_set_multigrid(bssnSim, scalarSim, iodata);
-#   else
-    iodata->log("Error: Multigrid solver was not compiled.");
-    throw -1;    
-#   endif
   }
   else
   {
@@ -69,85 +57,48 @@ void ScalarSim::setICs()
   }
 
   iodata->log("Finished setting ICs.");
-  _timer["ICs"].stop();
+  ctx->timer["ICs"].stop();
+}
+
+bool ScalarSim::syncICCache(ICCache * ic_cache)
+{
+  CosmoSim::syncICCache(ic_cache);
+  ic_cache->syncRegister("phi", scalarSim->phi);
+  ic_cache->syncRegister("Pi", scalarSim->Pi);
+  ic_cache->syncRegister("psi1", scalarSim->psi1);
+  ic_cache->syncRegister("psi2", scalarSim->psi2);
+  ic_cache->syncRegister("psi3", scalarSim->psi3);
+  return true;
 }
 
 void ScalarSim::initScalarStep()
 {
-  _timer["RK_steps"].start();
+  ctx->timer["RK_steps"].start();
     bssnSim->stepInit();
     scalarSim->stepInit();
-    bssnSim->clearSrc();
-    scalarSim->addBSSNSource(bssnSim);
-  _timer["RK_steps"].stop();
+    driver->setSources();
+  ctx->timer["RK_steps"].stop();
 }
 
 void ScalarSim::outputScalarStep()
 {
-  _timer["output"].start();
+  ctx->timer["output"].start();
     prepBSSNOutput();
     io_bssn_fields_snapshot(iodata, step, bssnSim->fields);
     io_bssn_fields_powerdump(iodata, step, bssnSim->fields, fourier);
     io_bssn_dump_statistics(iodata, step, bssnSim->fields, bssnSim->frw);
     io_bssn_constraint_violation(iodata, step, bssnSim);
     io_scalar_snapshot(iodata, step, scalarSim);
-  _timer["output"].stop();
+  ctx->timer["output"].stop();
 }
 
 void ScalarSim::runScalarStep()
 {
-  idx_t i=0, j=0, k=0;
-  BSSNData b_data;
-  _timer["RK_steps"].start();
-
-    // First RK step
-    #pragma omp parallel for  firstprivate(j, k, b_data)
-    LOOP3(i,j,k)
-    {
-      bssnSim->RKEvolvePt(i, j, k, &b_data);
-      scalarSim->RKEvolvePt(&b_data);
-    }
-    bssnSim->K1Finalize();
-    scalarSim->K1Finalize();
-
-    // Second RK step
-    bssnSim->clearSrc();
-    scalarSim->addBSSNSource(bssnSim);
-    #pragma omp parallel for firstprivate(j, k, b_data)
-    LOOP3(i,j,k)
-    {
-      bssnSim->RKEvolvePt(i, j, k, &b_data);
-      scalarSim->RKEvolvePt(&b_data);  
-    }
-    bssnSim->K2Finalize();
-    scalarSim->K2Finalize();
-
-    // Third RK step
-    bssnSim->clearSrc();
-    scalarSim->addBSSNSource(bssnSim);
-    #pragma omp parallel for  firstprivate(j, k, b_data)
-    LOOP3(i,j,k)
-    {
-      bssnSim->RKEvolvePt(i, j, k, &b_data);
-      scalarSim->RKEvolvePt(&b_data);
-    }
-    bssnSim->K3Finalize();
-    scalarSim->K3Finalize();
-
-    // Fourth RK step
-    bssnSim->clearSrc();
-    scalarSim->addBSSNSource(bssnSim);
-    #pragma omp parallel for firstprivate(j, k, b_data)
-    LOOP3(i,j,k)
-    {
-      bssnSim->RKEvolvePt(i, j, k, &b_data);
-      scalarSim->RKEvolvePt(&b_data);
-    }
-    bssnSim->K4Finalize();
-    scalarSim->K4Finalize();
-
+  ctx->timer["RK_steps"].start();
+    // source for the first RK step already set in initScalarStep()
+    driver->step();
     // "current" data should be in the _p array.
-  _timer["RK_steps"].stop();
+  ctx->timer["RK_steps"].stop();
 }
 
 void ScalarSim::runStep()
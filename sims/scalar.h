@@ -7,6 +7,7 @@
 
 #include "sim.h"
 #include "../components/scalar/scalar.h"
+#include "../components/matter/MatterDriver.h"
 
 namespace cosmo
 {
@@ -18,14 +19,16 @@ class ScalarSim : public CosmoSim
 {
 protected:
   Scalar * scalarSim;
+  MatterDriver * driver;
 
 public:
-  ScalarSim(){}
+  ScalarSim(SimContext * ctx_in) : CosmoSim(ctx_in) {}
   ~ScalarSim()
   {
     delete iodata;
     delete bssnSim;
     delete fourier;
+    delete driver;
     if(use_bardeen)
     {
       delete bardeen;
@@ -36,6 +39,7 @@ public:
 
   void init();
   void setICs();
+  bool syncICCache(ICCache * ic_cache);
   void initScalarStep();
   void outputScalarStep();
   void runScalarStep();
@@ -4,40 +4,45 @@
 namespace cosmo
 {
 
-SheetSim::SheetSim()
+SheetSim::SheetSim(SimContext * ctx_in) :
+  CosmoSim(ctx_in)
 {
   tot_mass = 0;
 }
 
 void SheetSim::init()
 {
-  _timer["init"].start();
+  ctx->timer["init"].start();
 
   // initialize base class
   simInit();
 
   iodata->log("Running phase space sheet type simulation.");
-  sheetSim = new Sheet();
+  sheetSim = new Sheet(ctx, iodata);
   lambda = new Lambda();
+
+  driver = new MatterDriver(bssnSim);
+  driver->addComponent(sheetSim, std::stoi(ctx->config("sheet_substeps", "1")));
+  driver->addComponent(lambda);
   
-  _timer["init"].stop();
+  ctx->timer["init"].stop();
 }
 
 void SheetSim::setICs()
 {
-  if(_config("ic_type", "") == "sinusoid")
+  if(ctx->config("ic_type", "") == "sinusoid")
   {
     sheets_ic_sinusoid(bssnSim, sheetSim, lambda, iodata, tot_mass);
   }
-  else if(_config("ic_type", "") == "semianalytic")
+  else if(ctx->config("ic_type", "") == "semianalytic")
   {
     sheets_ic_semianalytic(bssnSim, sheetSim, lambda, iodata, tot_mass);
   }
-  else if(_config("ic_type", "") == "sinusoid_3d")
+  else if(ctx->config("ic_type", "") == "sinusoid_3d")
   {
     sheets_ic_sinusoid_3d_diffusion(bssnSim, sheetSim, lambda, iodata, tot_mass);
   }
-  else if(_config("ic_type", "") == "sinusoid_diffusion")
+  else if(ctx->config("ic_type", "") == "sinusoid_diffusion")
   {
     sheets_ic_sinusoid_1d_diffusion(bssnSim, sheetSim, lambda, iodata, tot_mass);
   }
@@ -49,20 +54,35 @@ void SheetSim::setICs()
 
 }
 
+bool SheetSim::syncICCache(ICCache * ic_cache)
+{
+  CosmoSim::syncICCache(ic_cache);
+  ic_cache->syncRegister("Sheet_Dx", sheetSim->Dx);
+  ic_cache->syncRegister("Sheet_Dy", sheetSim->Dy);
+  ic_cache->syncRegister("Sheet_Dz", sheetSim->Dz);
+  ic_cache->syncRegister("Sheet_vx", sheetSim->vx);
+  ic_cache->syncRegister("Sheet_vy", sheetSim->vy);
+  ic_cache->syncRegister("Sheet_vz", sheetSim->vz);
+  ic_cache->syncScalar("tot_mass", tot_mass);
+  real_t rho_L = lambda->getLambda();
+  ic_cache->syncScalar("Lambda", rho_L);
+  lambda->setLambda(rho_L);
+  return true;
+}
+
 void SheetSim::initSheetStep()
 {
-  _timer["RK_steps"].start();
+  ctx->timer["RK_steps"].start();
     bssnSim->stepInit();
     sheetSim->stepInit();
-    bssnSim->clearSrc();
-    sheetSim->addBSSNSource(bssnSim, tot_mass);
-    lambda->addBSSNSource(bssnSim);
-  _timer["RK_steps"].stop();
+    sheetSim->source_mass = tot_mass;
+    driver->setSources();
+  ctx->timer["RK_steps"].stop();
 }
 
 void SheetSim::outputSheetStep()
 {
-  _timer["output"].start();
+  ctx->timer["output"].start();
     prepBSSNOutput();
     if(use_bardeen)
       io_svt_violation(iodata, step, bardeen, t);
@@ -75,59 +95,16 @@ void SheetSim::outputSheetStep()
     {
       outputStateInformation();
     }
-  _timer["output"].stop();
+  ctx->timer["output"].stop();
 }
 
 void SheetSim::runSheetStep()
 {
-  _timer["RK_steps"].start();
-    // First RK step
-    bssnSim->RKEvolve();
-    sheetSim->RKStep(bssnSim);
-    
-    bssnSim->K1Finalize();
-    sheetSim->K1Finalize();
-
-
-    
-    // Second RK step source
-    bssnSim->clearSrc();
-    sheetSim->addBSSNSource(bssnSim, tot_mass);
-    lambda->addBSSNSource(bssnSim);
-    
-    // Second RK step
-    bssnSim->RKEvolve();
-    sheetSim->RKStep(bssnSim);
-
-    bssnSim->K2Finalize();
-    sheetSim->K2Finalize();
-
-    // Third RK step source
-    bssnSim->clearSrc();
-    sheetSim->addBSSNSource(bssnSim, tot_mass);
-    lambda->addBSSNSource(bssnSim);
-    
-    // Third RK step
-    bssnSim->RKEvolve();
-    sheetSim->RKStep(bssnSim);
-    
-    bssnSim->K3Finalize();
-    sheetSim->K3Finalize();
-    
-    // Fourth RK step source
-    bssnSim->clearSrc();
-    sheetSim->addBSSNSource(bssnSim, tot_mass);
-    lambda->addBSSNSource(bssnSim);
-    
-    // Fourth RK step
-    bssnSim->RKEvolve();
-    sheetSim->RKStep(bssnSim);
-
-    bssnSim->K4Finalize();
-    sheetSim->K4Finalize();
-        
+  ctx->timer["RK_steps"].start();
+    // source for the first RK step already set in initSheetStep()
+    driver->step();
     // "current" data should be in the _p array.
-  _timer["RK_steps"].stop();
+  ctx->timer["RK_steps"].stop();
 }
 
 void SheetSim::runStep()
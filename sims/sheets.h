@@ -4,6 +4,7 @@
 #include "sim.h"
 #include "../components/phase_space_sheet/sheets.h"
 #include "../components/Lambda/lambda.h"
+#include "../components/matter/MatterDriver.h"
 
 
 namespace cosmo
@@ -17,10 +18,11 @@ class SheetSim : public CosmoSim
 protected:
   Sheet * sheetSim;
   Lambda * lambda;
+  MatterDriver * driver;
   real_t tot_mass;
   
 public:
-  SheetSim();
+  SheetSim(SimContext * ctx_in);
   ~SheetSim()
   {
     delete iodata;
@@ -30,12 +32,14 @@ public:
     {
       delete bardeen;
     }
+    delete driver;
     delete sheetSim;
     delete lambda;
   }
 
   void init();
   void setICs();
+  bool syncICCache(ICCache * ic_cache);
   void initSheetStep();
   void outputSheetStep();
   void runSheetStep();
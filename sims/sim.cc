@@ -1,36 +1,50 @@
 #include "sim.h"
 #include "../ICs/ICs.h"
-#include "../cosmo_globals.h"
 
 namespace cosmo
 {
 
-CosmoSim::CosmoSim()
+CosmoSim::CosmoSim(SimContext * ctx_in)
 {
-  // Initialize iodata first
-  iodata = new IOData(_config["output_dir"]);
-  // save a copy of config.txt; print defines
-  log_defines(iodata);
-  iodata->backupFile(_config.getFileName());
+  ctx = ctx_in;
+
+  // Initialize iodata first; with MPI, rank 0 creates the output directory
+  // and other processes write their own log files to it.
+  if(decomposition_rank() == 0)
+  {
+    iodata = new IOData(ctx, ctx->config["output_dir"]);
+    // save a copy of config.txt; print defines
+    log_defines(iodata);
+    iodata->backupFile(ctx->config.getFileName());
+  }
+#if USE_MPI
+  std::string output_dir = decomposition_rank() == 0 ? iodata->dir() : "";
+  decomposition_broadcast(output_dir);
+  if(decomposition_rank() != 0)
+  {
+    iodata = new IOData(ctx, output_dir, COSMO_IODATA_VERBOSITY_OFF,
+      "log.rank_" + std::to_string(decomposition_rank()) + ".txt");
+  }
+#endif
 
   // fix number of simulation steps
   step = 0;
   t = 0;
-  num_steps = stoi(_config["steps"]);
+  num_steps = stoi(ctx->config["steps"]);
 
 # if USE_COSMOTRACE
   // integrating any light rays?
-  if( stoi(_config("ray_integrate", "0")) )
+  if( stoi(ctx->config("ray_integrate", "0")) )
   {
     ray_integrate = true;
-    ray_flip_step = stoi(_config["ray_flip_step"]);
+    ray_flip_step = stoi(ctx->config["ray_flip_step"]);
   }
   else
   {
     ray_integrate = false;
   }
 
-  if( stoi(_config("simple_raytrace", "0")) )
+  if( stoi(ctx->config("simple_raytrace", "0")) )
   {
     simple_raytrace = true;
   }
@@ -40,7 +54,7 @@ CosmoSim::CosmoSim()
   }
 # endif
 
-  if( stoi(_config("use_bardeen", "0")) )
+  if( stoi(ctx->config("use_bardeen", "0")) )
   {
     use_bardeen = true;
   }
@@ -50,7 +64,19 @@ CosmoSim::CosmoSim()
   }
 
   // Store simulation type
-  simulation_type = _config["simulation_type"];
+  simulation_type = ctx->config["simulation_type"];
+
+#if USE_MPI
+  bool mpi_unsupported = use_bardeen;
+# if USE_COSMOTRACE
+  mpi_unsupported = mpi_unsupported || ray_integrate;
+# endif
+  if(mpi_unsupported)
+  {
+    iodata->log("Error - raytracing and Bardeen calculations are not supported with MPI.");
+    throw -1;
+  }
+#endif
 }
 
 /**
@@ -60,31 +86,32 @@ void CosmoSim::simInit()
 {
   // FFT helper
   fourier = new Fourier();
-  fourier->Initialize(NX, NY, NZ);
+  fourier->Initialize(NX, NY, NZ,
+    std::stoi(ctx->config("fft_pencil_columns", "1")));
 
   // Always use GR fields
-  bssnSim = new BSSN(&_config, fourier);
+  bssnSim = new BSSN(ctx, fourier);
 
 # if USE_COSMOTRACE
   // initialize raytracing if needed
   if(ray_integrate)
   {
-    if(_config("lapse", "") != "" && _config("lapse", "") != "Static" && _config("lapse", "") != "ConformalFLRW")
+    if(ctx->config("lapse", "") != "" && ctx->config("lapse", "") != "Static" && ctx->config("lapse", "") != "ConformalFLRW")
     {
       iodata->log("Error - not using synchronous gauge! You must use it for raytracing sims.");
       iodata->log("Please change this setting in the config file and re-run.");
       throw -1;
     }
-    init_ray_vector(&rays);
+    init_ray_vector(ctx, &rays);
   }
 # endif
 
   if(use_bardeen)
   {
     bardeen = new Bardeen(bssnSim, fourier);
-    bool use_ML_scale_factor = !!std::stoi(_config("use_ML_scale_factor", "1"));
+    bool use_ML_scale_factor = !!std::stoi(ctx->config("use_ML_scale_factor", "1"));
     bardeen->setUseMLScaleFactor(use_ML_scale_factor);
-    real_t Omega_L = std::stod(_config("Omega_L", "0.0"));
+    real_t Omega_L = std::stod(ctx->config("Omega_L", "0.0"));
     bardeen->useMLScaleFactor(Omega_L);
     if(use_ML_scale_factor)
     {
@@ -95,6 +122,62 @@ void CosmoSim::simInit()
   }
 }
 
+/**
+ * @brief      Set ICs, using the IC cache if "ic_cache_dir" is set.
+ * @details    If a cache entry matching the config hash exists, load it
+ *  instead of calling setICs(); otherwise call setICs() and store the result.
+ */
+void CosmoSim::generateICs()
+{
+#if USE_MPI
+  if(ctx->config("ic_cache_dir", "") != "")
+    iodata->log("IC caching is not supported with MPI; generating ICs.");
+  setICs();
+  return;
+#endif
+
+  ICCache ic_cache(ctx, iodata);
+  if(!ic_cache.isEnabled())
+  {
+    setICs();
+    return;
+  }
+
+  if(ic_cache.load())
+  {
+    bool supported = syncICCache(&ic_cache);
+    bool loaded = supported && !ic_cache.loadFailed();
+    ic_cache.finishLoad();
+    if(loaded)
+    {
+      iodata->log("Loaded ICs from cache, hash " + ic_cache.getHash() + ".");
+      return;
+    }
+    iodata->log("Unable to use IC cache entry; regenerating ICs.");
+  }
+
+  setICs();
+
+  if(syncICCache(&ic_cache))
+  {
+    ic_cache.store();
+  }
+  else
+  {
+    iodata->log("IC caching is not supported for this simulation type.");
+  }
+}
+
+/**
+ * @brief      Sync base (BSSN and reference FRW) IC state with the IC cache.
+ */
+bool CosmoSim::syncICCache(ICCache * ic_cache)
+{
+  ic_cache->syncFields(bssnSim->fields);
+  ic_cache->syncFRW(bssnSim->frw);
+  return true;
+}
+
 /**
  * @brief      Run the simulation.
  */
@@ -102,19 +185,19 @@ void CosmoSim::run()
 {
   iodata->log("Running simulation...");
 
-  _timer["loop"].start();
+  ctx->timer["loop"].start();
   real_t avg_vol_i = 1.0;
   while(step <= num_steps)
   {
     runStep();
-    t += dt;
+    t += ctx->dt;
 
     if(step == 0)
     {
       avg_vol_i = bssnSim->avg_vol;
     }
-    else if( !!std::stod(_config("stop_at_expansion_goal", "0"))
-      && std::pow(bssnSim->avg_vol / avg_vol_i, 1.0/3.0) >= std::stod(_config("expansion_goal", "100.0")) )
+    else if( !!std::stod(ctx->config("stop_at_expansion_goal", "0"))
+      && std::pow(bssnSim->avg_vol / avg_vol_i, 1.0/3.0) >= std::stod(ctx->config("expansion_goal", "100.0")) )
     {
       iodata->log("Target expasion reached, run ending.");
       break;
@@ -122,11 +205,13 @@ void CosmoSim::run()
 
     step++;
   }
-  _timer["loop"].stop();
+  ctx->timer["loop"].stop();
+
+  io_finish_particle_output(iodata);
 
   iodata->log("\nEnding simulation.");
   outputStateInformation();
-  iodata->log(_timer.getStateString());
+  iodata->log(ctx->timer.getStateString());
   std::cout << std::flush;
 }
 
@@ -134,7 +219,7 @@ void CosmoSim::run()
 void CosmoSim::runRayTraceStep()
 {
   // evolve any light rays
-  _timer["Raytrace_step"].start();
+  ctx->timer["Raytrace_step"].start();
 
   idx_t n = 0;
   idx_t num_rays = rays.size();
@@ -157,19 +242,19 @@ void CosmoSim::runRayTraceStep()
       ray->evolveRay();
     }
   }
-  _timer["Raytrace_step"].stop();
+  ctx->timer["Raytrace_step"].stop();
 }
 
 void CosmoSim::outputRayTraceStep()
 {
-  _timer["output"].start();
+  ctx->timer["output"].start();
   
   io_raytrace_dump(iodata, step, &rays);
   
   if(use_bardeen)
     io_raytrace_bardeen_dump(iodata, step, &rays, bardeen, t);
 
-  _timer["output"].stop();
+  ctx->timer["output"].stop();
 }
 #endif
 
@@ -183,15 +268,15 @@ void CosmoSim::runCommonStepTasks()
   }
 
   // progress bar in terminal
-  if(step % 100 == 0)
+  if(step % 100 == 0 && decomposition_rank() == 0)
     io_show_progress(step, num_steps);
 
 // # if USE_GENERALIZED_NEWTON
-//   real_t dt0 = std::stold(_config( "dt_frac", "0.1" ))*dx;
+//   real_t dt0 = std::stold(ctx->config( "dt_frac", "0.1" ))*ctx->dx;
 //   real_t frac_done = (num_steps - step) / (real_t) num_steps;
 
-//   dt = dt0 + frac_done*frac_done*100*dt0;
-//   bssnSim->setDt(dt);
+//   ctx->setDt(dt0 + frac_done*frac_done*100*dt0);
+//   bssnSim->setDt(ctx->dt);
 // # endif
 
 # if USE_COSMOTRACE
@@ -200,8 +285,8 @@ void CosmoSim::runCommonStepTasks()
   {
     if(step == ray_flip_step) {
       iodata->log("\nFlipping sign of dt @ step = " + std::to_string(step) );
-      dt = -std::abs(dt);
-      bssnSim->setDt(dt);
+      ctx->setDt(-std::abs(ctx->dt));
+      bssnSim->setDt(ctx->dt);
     }
     if(step >= ray_flip_step) {
       outputRayTraceStep();
@@ -221,7 +306,7 @@ void CosmoSim::prepBSSNOutput()
     // set_bd_values calculates ricci_a and AijAij_a data, needed for output
     // and potentially subsequent Killing calculations
     BSSNData b_data = {0}; // data structure associated with bssn sim
-    bssnSim->set_bd_values(i, j, k, &b_data);
+    bssnSim->set_bd_values<BD_ACONT | BD_RICCI>(i, j, k, &b_data);
   }
 
   if(use_bardeen)
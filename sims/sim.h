@@ -6,10 +6,12 @@
 
 #include "../utils/Fourier.h"
 #include "../utils/FRW.h"
+#include "../utils/SimContext.h"
 
 #include "../IO/io.h"
 #include "../components/bssn/bssn.h"
 #include "../components/bssn/bardeen.h"
+#include "../ICs/ic_cache.h"
 
 namespace cosmo
 {
@@ -17,6 +19,8 @@ namespace cosmo
 class CosmoSim
 {
 protected:
+  SimContext * ctx; ///< configuration, timers, dx, and dt of this simulation
+
   idx_t step;
   idx_t num_steps;
   bool dt_flip;
@@ -42,7 +46,7 @@ protected:
 # endif
 
 public:
-  CosmoSim();
+  CosmoSim(SimContext * ctx_in);
   virtual ~CosmoSim() {};
 
   // These functions will be called in main();
@@ -51,7 +55,11 @@ public:
   virtual void runStep() = 0;
   virtual void setICs() = 0;
 
+  // Sync IC state with an IC cache; return false if unsupported.
+  virtual bool syncICCache(ICCache * ic_cache);
+
   void simInit();
+  void generateICs();
   void run();
   void runCommonStepTasks();
 
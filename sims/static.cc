@@ -5,10 +5,11 @@
 namespace cosmo
 {
 
-StaticSim::StaticSim()
+StaticSim::StaticSim(SimContext * ctx_in) :
+  CosmoSim(ctx_in)
 {
   // just check to make sure we can use this class.
-  if(_config("lapse", "") != "" && _config("lapse", "") != "Static" && _config("lapse", "") != "ConformalFLRW")
+  if(ctx->config("lapse", "") != "" && ctx->config("lapse", "") != "Static" && ctx->config("lapse", "") != "ConformalFLRW")
   {
     iodata->log("Error - not using a constant lapse gauge! You must use it for 'static' sims.");
     iodata->log("Please change this setting in the config file and re-run.");
@@ -16,12 +17,12 @@ StaticSim::StaticSim()
   }
 
   take_ray_step = false;
-  raysheet_flip_step = std::stoi(_config("raysheet_flip_step", "-1"));
+  raysheet_flip_step = std::stoi(ctx->config("raysheet_flip_step", "-1"));
 }
 
 void StaticSim::init()
 {
-  _timer["init"].start();
+  ctx->timer["init"].start();
 
   // initialize base class
   simInit();
@@ -30,8 +31,12 @@ void StaticSim::init()
   staticSim = new Static();
   staticSim->init();
   lambda = new Lambda();
-  raySheet = new Sheet();
-  _timer["init"].stop();
+  raySheet = new Sheet(ctx, iodata);
+
+  driver = new MatterDriver(bssnSim);
+  driver->addComponent(staticSim);
+  driver->addComponent(lambda);
+  ctx->timer["init"].stop();
 }
 
 /**
@@ -40,23 +45,23 @@ void StaticSim::init()
  */
 void StaticSim::setICs()
 {
-  _timer["ICs"].start();
+  ctx->timer["ICs"].start();
 
   iodata->log("Setting static initial conditions (ICs).");
 
-  if(_config("ic_type", "") == "shell")
+  if(ctx->config("ic_type", "") == "shell")
   {
     static_ic_set_sphere(bssnSim, staticSim, iodata);
   }
-  else if(_config("ic_type", "") == "sinusoid")
+  else if(ctx->config("ic_type", "") == "sinusoid")
   {
     static_ic_set_sinusoid(bssnSim, staticSim, lambda, fourier, iodata);
   }
-  else if(_config("ic_type", "") == "semianalytic")
+  else if(ctx->config("ic_type", "") == "semianalytic")
   {
     static_ic_set_semianalytic(bssnSim, staticSim, lambda, fourier, iodata);
   }
-  else if(_config("ic_type", "") == "sinusoid_3d")
+  else if(ctx->config("ic_type", "") == "sinusoid_3d")
   {
     static_ic_set_sinusoid_3d(bssnSim, staticSim, lambda, fourier, iodata);
   }
@@ -68,23 +73,31 @@ void StaticSim::setICs()
 
   iodata->log("Finished setting ICs.");
   
-  _timer["ICs"].stop();
+  ctx->timer["ICs"].stop();
+}
+
+bool StaticSim::syncICCache(ICCache * ic_cache)
+{
+  CosmoSim::syncICCache(ic_cache);
+  ic_cache->syncFields(staticSim->fields);
+  real_t rho_L = lambda->getLambda();
+  ic_cache->syncScalar("Lambda", rho_L);
+  lambda->setLambda(rho_L);
+  return true;
 }
 
 void StaticSim::initStaticStep()
 {
-  _timer["RK_steps"].start();
+  ctx->timer["RK_steps"].start();
     bssnSim->stepInit();
-    bssnSim->clearSrc();
     if(take_ray_step) raySheet->stepInit();
-    staticSim->addBSSNSrc(bssnSim->fields, bssnSim->frw);
-    lambda->addBSSNSource(bssnSim);
-  _timer["RK_steps"].stop();
+    driver->setSources();
+  ctx->timer["RK_steps"].stop();
 
   arr_t & DIFFr_a = *bssnSim->fields["DIFFr_a"];
   real_t rho_tot_avg = average(DIFFr_a);
   real_t rho_L = lambda->getLambda();
-  real_t Omega_L_flip = std::stod(_config("raysheet_flip_omega_L", "0.0"));
+  real_t Omega_L_flip = std::stod(ctx->config("raysheet_flip_omega_L", "0.0"));
   if(
     (Omega_L_flip > 0.0 && rho_L/rho_tot_avg > Omega_L_flip && take_ray_step == false)
     || (raysheet_flip_step > 0 && step >= raysheet_flip_step && take_ray_step == false) )
@@ -93,8 +106,8 @@ void StaticSim::initStaticStep()
     iodata->log("\nFlipping sign of dt @ step = " + std::to_string(step) );
     iodata->log("--Omega_L was " + std::to_string(rho_L/rho_tot_avg) );
     iodata->log("--Setting final number of simulation steps to " + std::to_string(num_steps) );
-    dt = -std::abs(dt);
-    iodata->log("--New dt is " + std::to_string(dt) );
+    ctx->setDt(-std::abs(ctx->dt));
+    iodata->log("--New dt is " + std::to_string(ctx->dt) );
 
     take_ray_step = true;
     // Set raytracing initial conditions
@@ -103,14 +116,14 @@ void StaticSim::initStaticStep()
     raySheet->stepInit();
 
     outputStateInformation();
-    bssnSim->setDt(dt);
-    raySheet->setDt(dt);
+    driver->addComponent(raySheet, std::stoi(ctx->config("ray_substeps", "1")));
+    driver->setDt(ctx->dt);
   }
 }
 
 void StaticSim::outputStaticStep()
 {
-  _timer["output"].start();
+  ctx->timer["output"].start();
     prepBSSNOutput();
     if(use_bardeen)
       io_svt_violation(iodata, step, bardeen, t);
@@ -125,48 +138,16 @@ void StaticSim::outputStaticStep()
     }
     if(take_ray_step)
       io_raysheet_dump(iodata, step, raySheet, bssnSim, lambda);
-  _timer["output"].stop();
+  ctx->timer["output"].stop();
 }
 
 void StaticSim::runStaticStep()
 {
-  _timer["RK_steps"].start();
-    // First RK step
-    // source already set in initStaticStep() (used for output)
-    bssnSim->RKEvolve();
-    if(take_ray_step) raySheet->RKStep(bssnSim);
-    bssnSim->K1Finalize();
-    if(take_ray_step) raySheet->K1Finalize();
-
-    // Second RK step
-    bssnSim->clearSrc();
-    staticSim->addBSSNSrc(bssnSim->fields, bssnSim->frw);
-    lambda->addBSSNSource(bssnSim);
-    bssnSim->RKEvolve();
-    if(take_ray_step) raySheet->RKStep(bssnSim);
-    bssnSim->K2Finalize();
-    if(take_ray_step) raySheet->K2Finalize();
-
-    // Third RK step
-    bssnSim->clearSrc();
-    staticSim->addBSSNSrc(bssnSim->fields, bssnSim->frw);
-    lambda->addBSSNSource(bssnSim);
-    bssnSim->RKEvolve();
-    if(take_ray_step) raySheet->RKStep(bssnSim);
-    bssnSim->K3Finalize();
-    if(take_ray_step) raySheet->K3Finalize();
-
-    // Fourth RK step
-    bssnSim->clearSrc();
-    staticSim->addBSSNSrc(bssnSim->fields, bssnSim->frw);
-    lambda->addBSSNSource(bssnSim);
-    bssnSim->RKEvolve();
-    if(take_ray_step) raySheet->RKStep(bssnSim);
-    bssnSim->K4Finalize();
-    if(take_ray_step) raySheet->K4Finalize();
-
+  ctx->timer["RK_steps"].start();
+    // source for the first RK step already set in initStaticStep() (used for output)
+    driver->step();
     // "current" data should be in the _p array.
-  _timer["RK_steps"].stop();
+  ctx->timer["RK_steps"].stop();
 }
 
 void StaticSim::runStep()
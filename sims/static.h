@@ -5,6 +5,7 @@
 #include "../components/static/static.h"
 #include "../components/Lambda/lambda.h"
 #include "../components/phase_space_sheet/sheets.h"
+#include "../components/matter/MatterDriver.h"
 
 namespace cosmo
 {
@@ -18,10 +19,11 @@ protected:
   Sheet * raySheet;
   Static * staticSim;
   Lambda * lambda;
+  MatterDriver * driver;
   bool take_ray_step;
   idx_t raysheet_flip_step;
 public:
-  StaticSim();
+  StaticSim(SimContext * ctx_in);
   ~StaticSim()
   {
     std::cout << "Cleaning up...";
@@ -38,6 +40,7 @@ public:
 
   void init();
   void setICs();
+  bool syncICCache(ICCache * ic_cache);
   void initStaticStep();
   void outputStaticStep();
   void runStaticStep();
@@ -12,7 +12,7 @@ namespace cosmo
 class VacuumSim : public CosmoSim
 {
 public:
-  VacuumSim(){}
+  VacuumSim(SimContext * ctx_in) : CosmoSim(ctx_in) {}
   ~VacuumSim()
   {
     delete iodata;
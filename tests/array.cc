@@ -4,10 +4,8 @@
 #include <iostream>
 #include "../utils/Array.h"
 #include "../utils/math.h"
-#include "../cosmo_globals.h"
 
 using namespace cosmo;
-real_t dx;
 
 #define N_SMALL 10
 #define N_LARGE 500
@@ -55,8 +53,6 @@ void performSomeComputationAlt(arr_t & arr)
 
 int main()
 {
-  dx = 1.0;
-
   arr_t myArr1, myArr2;
   myArr1.init(1, 1, N_SMALL);
   myArr2.init(1, 1, N_SMALL);
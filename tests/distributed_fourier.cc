@@ -0,0 +1,80 @@
+// mpicxx --std=c++11 -DUSE_MPI=1 -DCOSMO_MPI_RANKS=4 -DCOSMO_N=24 -DNY=12 -DNZ=10 distributed_fourier.cc ../utils/DistributedFourier.cc ../utils/Decomposition.cc ../utils/Timer.cc ../utils/ConfigParser.cc -lfftw3 -lrt -O0 && mpirun -np 4 ./a.out 2
+// (the argument is the number of pencil columns; 1 for slabs)
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include "../utils/DistributedFourier.h"
+
+using namespace cosmo;
+
+// an arbitrary function of global grid position
+real_t test_field(idx_t i, idx_t j, idx_t k)
+{
+  return std::sin(2.0*PI*i/GLOBAL_NX) + 0.5*std::cos(4.0*PI*j/NY + 0.3)
+    + 0.25*std::sin(2.0*PI*(i + 2*k)/NZ) + 1.0e-3*((i*31 + j*17 + k*7) % 13);
+}
+
+int main(int argc, char **argv)
+{
+  decomposition_init(&argc, &argv);
+  int p_cols = argc > 1 ? std::stoi(argv[1]) : 1;
+  int rank = decomposition_rank();
+
+  DistributedFourier * fourier = new DistributedFourier(p_cols);
+
+  // decomposed array, with garbage in halos
+  std::vector<real_t> field(POINTS, 1.0e10);
+  for(idx_t i=OWNED_X_BEGIN; i<OWNED_X_END; ++i)
+    for(idx_t j=0; j<NY; ++j)
+      for(idx_t k=0; k<NZ; ++k)
+        field[NP_INDEX(i,j,k)] = test_field(GLOBAL_X_INDEX(i), j, k);
+
+  // reference transform of the full grid
+  std::vector<double> full(GLOBAL_POINTS);
+  fftw_complex * full_k = (fftw_complex *) fftw_malloc(
+    GLOBAL_NX*NY*(NZ/2+1)*sizeof(fftw_complex));
+  for(idx_t i=0; i<GLOBAL_NX; ++i)
+    for(idx_t j=0; j<NY; ++j)
+      for(idx_t k=0; k<NZ; ++k)
+        full[(i*NY + j)*NZ + k] = test_field(i, j, k);
+  fftw_plan p = fftw_plan_dft_r2c_3d(GLOBAL_NX, NY, NZ, &full[0], full_k, FFTW_ESTIMATE);
+  fftw_execute(p);
+  fftw_destroy_plan(p);
+
+  // compare modes held by this process
+  fourier->forward(&field[0]);
+  real_t max_mode_err = 0.0;
+  for(idx_t j=0; j<fourier->ny_k; ++j)
+    for(idx_t k=0; k<fourier->nz_k; ++k)
+      for(idx_t i=0; i<GLOBAL_NX; ++i)
+      {
+        idx_t ref = (i*NY + fourier->ky_begin + j)*(NZ/2+1) + fourier->kz_begin + k;
+        for(int c=0; c<2; ++c)
+          max_mode_err = std::max(max_mode_err, (real_t) std::fabs(
+            fourier->f_field[fourier->k_index(j, k, i)][c] - full_k[ref][c] ));
+      }
+
+  // round trip
+  fourier->backward(&field[0]);
+  real_t max_roundtrip_err = 0.0;
+  for(idx_t i=OWNED_X_BEGIN; i<OWNED_X_END; ++i)
+    for(idx_t j=0; j<NY; ++j)
+      for(idx_t k=0; k<NZ; ++k)
+        max_roundtrip_err = std::max(max_roundtrip_err, (real_t) std::fabs(
+          field[NP_INDEX(i,j,k)]/GLOBAL_POINTS - test_field(GLOBAL_X_INDEX(i), j, k) ));
+
+  max_mode_err = decomposition_max(max_mode_err);
+  max_roundtrip_err = decomposition_max(max_roundtrip_err);
+  if(rank == 0)
+  {
+    std::cout << fourier->p_rows << " x " << fourier->p_cols << " process grid:\n"
+      << "  max. mode error: " << max_mode_err << "\n"
+      << "  max. round-trip error: " << max_roundtrip_err << "\n";
+  }
+
+  fftw_free(full_k);
+  delete fourier;
+  decomposition_finalize();
+  exit(EXIT_SUCCESS);
+}
@@ -2,7 +2,7 @@
 
 #include "../cosmo_includes.h"
 #include "../cosmo_types.h"
-#include "../cosmo_globals.h"
+#include "../utils/SimContext.h"
 
 #include "../components/particles/particles.h"
 #include "../components/bssn/bssn.h"
@@ -10,29 +10,20 @@
 using namespace std;
 using namespace cosmo;
 
-/* global definitions */
-TimerManager _timer;
-ConfigParser _config;
-#ifndef dt
-  real_t dt;
-#endif
-#ifndef dx
-  real_t dx;
-#endif
-
 int main()
 {
-  dt = 0.5;
-  dx = 1.0;
+  SimContext ctx;
+  ctx.setDx(1.0);
+  ctx.setDt(0.5);
 
   std::cout << "Creating BSSN class..." << std::endl;
   // initialize GR sim; particles needs to reference this
   // but - don't evolve, remaining Minkowski/flat
-  BSSN bssnSim(&_config);
+  BSSN bssnSim(&ctx, NULL);
 
   // make a particle
   std::cout << "Creating Particles class..." << std::endl;
-  Particles particles;
+  Particles particles(&ctx);
   particles.init(1);
 
   std::cout << "Integrating Particle EOMs..." << std::endl;
@@ -2,7 +2,7 @@
 
 #include "../cosmo_includes.h"
 #include "../cosmo_types.h"
-#include "../cosmo_globals.h"
+#include "../utils/SimContext.h"
 
 #include "../scalar/scalar.h"
 #include "../bssn/bssn.h"
@@ -10,32 +10,23 @@
 using namespace std;
 using namespace cosmo;
 
-/* global definitions */
-TimerManager _timer;
-ConfigParser _config;
-#ifndef dt
-  real_t dt;
-#endif
-#ifndef dx
-  real_t dx;
-#endif
-
 int main()
 {
   idx_t i=0, j=0, k=0;
-  dx = 1.0;
-  dt = 0.1;
+  SimContext ctx;
+  ctx.setDx(1.0);
+  ctx.setDt(0.1);
 
   std::cout << "Creating BSSN and Scalar classes..." << std::endl;
 
   // initialize GR sim; Scalar needs to reference this
   // but - don't evolve, remaining Minkowski/flat
-  BSSN bssnSim;
+  BSSN bssnSim(&ctx, NULL);
   BSSNData bd;
   bssnSim.set_bd_values(0,0,0,&bd);
 
   // make a scalar field class
-  Scalar scalarSim;
+  Scalar scalarSim(&ctx);
 
   // initialize with \phi = x^2 + y^2 + z^2
   std::cout << "Initializing scalar field..." << std::endl;
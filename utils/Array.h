@@ -6,6 +6,7 @@
 #include <iostream>
 
 #include "TriCubicInterpolator.h"
+#include "TriCubicStencil.h"
 
 namespace cosmo
 {
@@ -233,31 +234,8 @@ class CosmoArray
             _array[idx(il+1, 0, 0)], _array[idx(il+2, 0, 0)]);
       }
 
-      IT jl = j_in < 0 ? (IT) j_in - 1 : (IT) j_in; // same as ^ but j
-      RT jd = j_in - jl;
-      IT kl = k_in < 0 ? (IT) k_in - 1 : (IT) k_in; // same as ^ but k
-      RT kd = k_in - kl;
-
-      // interpolated value at (i*, j*, k_in)
-      RT * F_i_j_kd = new RT[16];
-      for(IT i=0; i<4; ++i)
-        for(IT j=0; j<4; ++j)
-          F_i_j_kd[i*4+j] = CINT(kd,
-            _array[idx(il+i-1, jl+j-1, kl-1)], _array[idx(il+i-1, jl+j-1, kl+0)],
-            _array[idx(il+i-1, jl+j-1, kl+1)], _array[idx(il+i-1, jl+j-1, kl+2)]);
-
-      // interpolated value at (i*, j_in, k_in)
-      RT * F_i_jd_kd = new RT[4];
-      for(IT i=0; i<4; ++i)
-        F_i_jd_kd[i] = CINT(jd, F_i_j_kd[i*4+0], F_i_j_kd[i*4+1], F_i_j_kd[i*4+2], F_i_j_kd[i*4+3]);
-
-      // interpolated value at (i_in, j_in, k_in)
-      RT Fijk = CINT(id, F_i_jd_kd[0], F_i_jd_kd[1], F_i_jd_kd[2], F_i_jd_kd[3]);
-
-      delete [] F_i_j_kd;
-      delete [] F_i_jd_kd;
-
-      return Fijk;
+      TriCubicStencil<IT, RT> stencil(i_in, j_in, k_in, nx, ny, nz);
+      return stencil.interpolate(_array);
     }
 };
 
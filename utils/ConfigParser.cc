@@ -16,7 +16,13 @@ ConfigParser::ConfigParser(std::string fname)
   parse(fname);
 }
 
-void ConfigParser::parse(std::string fname)
+/**
+ * @brief      Read "param = val" lines from a file
+ *
+ * @param[in]  fname  config file name
+ * @param[in]  echo   print parameters as they are read
+ */
+void ConfigParser::parse(std::string fname, bool echo)
 {
   fileName = fname;
   
@@ -36,7 +42,8 @@ void ConfigParser::parse(std::string fname)
 
   fin >> param >> eq >> val;
   while(fin) {
-    std::cout << "config[" << param << "] = " << val << std::endl;
+    if(echo)
+      std::cout << "config[" << param << "] = " << val << std::endl;
     config[param] = val;
     fin >> param >> eq >> val;
   }
@@ -82,4 +89,17 @@ std::string ConfigParser::operator()(std::string param,
   return config[param];
 }
 
+/**
+ * @brief      Iterators over all (param, value) pairs, in sorted param order
+ */
+std::map<std::string, std::string>::const_iterator ConfigParser::begin() const
+{
+  return config.begin();
+}
+
+std::map<std::string, std::string>::const_iterator ConfigParser::end() const
+{
+  return config.end();
+}
+
 } /* namespace */
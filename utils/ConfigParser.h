@@ -12,12 +12,15 @@ class ConfigParser
 public:
   ConfigParser();
   ConfigParser(std::string fname);
-  void parse(std::string fname);
+  void parse(std::string fname, bool echo = true);
   std::string getFileName();
 
   std::string operator[](std::string param);
   std::string operator()(std::string param, std::string default_val);
 
+  std::map<std::string, std::string>::const_iterator begin() const;
+  std::map<std::string, std::string>::const_iterator end() const;
+
 private:
   std::map<std::string, std::string> config;
   std::string fileName;
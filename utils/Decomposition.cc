@@ -0,0 +1,180 @@
+#include "Decomposition.h"
+
+#if USE_MPI
+
+#include <iostream>
+
+#if USE_LONG_DOUBLES
+# define COSMO_MPI_REAL_T MPI_LONG_DOUBLE
+#else
+# define COSMO_MPI_REAL_T MPI_DOUBLE
+#endif
+
+namespace cosmo
+{
+
+namespace
+{
+
+int mpi_rank = 0;
+int mpi_n_ranks = 1;
+
+} // anonymous namespace
+
+/**
+ * @brief      Initialize MPI; the number of processes must match the
+ *  COSMO_MPI_RANKS the code was compiled with.
+ * @details    MPI is only called from outside of OpenMP parallel regions.
+ */
+void decomposition_init(int * argc, char *** argv)
+{
+  int provided;
+  MPI_Init_thread(argc, argv, MPI_THREAD_FUNNELED, &provided);
+  MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &mpi_n_ranks);
+
+  if(mpi_n_ranks != COSMO_MPI_RANKS)
+  {
+    if(mpi_rank == 0)
+      std::cerr << "Error: compiled for COSMO_MPI_RANKS = " << COSMO_MPI_RANKS
+        << " but running with " << mpi_n_ranks << " MPI processes.\n";
+    MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+  }
+}
+
+void decomposition_finalize()
+{
+  MPI_Finalize();
+}
+
+int decomposition_rank()
+{
+  return mpi_rank;
+}
+
+int decomposition_n_ranks()
+{
+  return mpi_n_ranks;
+}
+
+/**
+ * @brief      Global x-index of the first plane owned by this process
+ */
+idx_t decomposition_x_offset()
+{
+  return mpi_rank*(GLOBAL_NX/COSMO_MPI_RANKS);
+}
+
+/**
+ * @brief      Post a non-blocking fill of the halo planes of fields from
+ *  neighboring slabs
+ * @details    Slabs are contiguous in memory, so each field sends its first
+ *  and last COSMO_HALO_WIDTH owned planes to the left and right neighbors
+ *  and receives into its halos directly. Neither owned boundary planes nor
+ *  halos may be modified until decomposition_finish_halo_exchange returns.
+ */
+void decomposition_start_halo_exchange(std::vector<arr_t *> & fields,
+  HaloExchange & exchange)
+{
+  const int left = (mpi_rank - 1 + mpi_n_ranks) % mpi_n_ranks;
+  const int right = (mpi_rank + 1) % mpi_n_ranks;
+  const int halo_size = COSMO_HALO_WIDTH*NY*NZ;
+  const int n_fields = fields.size();
+
+  std::vector<MPI_Request> & requests = exchange.requests;
+  requests.resize(4*n_fields);
+  for(int f=0; f<n_fields; ++f)
+  {
+    real_t * a = fields[f]->_array;
+    MPI_Irecv(a + NP_INDEX(0,0,0), halo_size, COSMO_MPI_REAL_T,
+      left, 2*f+1, MPI_COMM_WORLD, &requests[4*f+0]);
+    MPI_Irecv(a + NP_INDEX(OWNED_X_END,0,0), halo_size, COSMO_MPI_REAL_T,
+      right, 2*f, MPI_COMM_WORLD, &requests[4*f+1]);
+    MPI_Isend(a + NP_INDEX(OWNED_X_BEGIN,0,0), halo_size, COSMO_MPI_REAL_T,
+      left, 2*f, MPI_COMM_WORLD, &requests[4*f+2]);
+    MPI_Isend(a + NP_INDEX(OWNED_X_END - COSMO_HALO_WIDTH,0,0), halo_size, COSMO_MPI_REAL_T,
+      right, 2*f+1, MPI_COMM_WORLD, &requests[4*f+3]);
+  }
+}
+
+/**
+ * @brief      Wait for a posted halo exchange to complete
+ */
+void decomposition_finish_halo_exchange(HaloExchange & exchange)
+{
+  if(!exchange.requests.empty())
+    MPI_Waitall(exchange.requests.size(), &exchange.requests[0],
+      MPI_STATUSES_IGNORE);
+  exchange.requests.clear();
+}
+
+/**
+ * @brief      Fill the halo planes of fields from neighboring slabs,
+ *  blocking until done
+ */
+void decomposition_exchange_halos(std::vector<arr_t *> & fields)
+{
+  HaloExchange exchange;
+  decomposition_start_halo_exchange(fields, exchange);
+  decomposition_finish_halo_exchange(exchange);
+}
+
+real_t decomposition_sum(real_t value)
+{
+  real_t result;
+  MPI_Allreduce(&value, &result, 1, COSMO_MPI_REAL_T, MPI_SUM, MPI_COMM_WORLD);
+  return result;
+}
+
+idx_t decomposition_sum(idx_t value)
+{
+  long result, l_value = value;
+  MPI_Allreduce(&l_value, &result, 1, MPI_LONG, MPI_SUM, MPI_COMM_WORLD);
+  return result;
+}
+
+real_t decomposition_max(real_t value)
+{
+  real_t result;
+  MPI_Allreduce(&value, &result, 1, COSMO_MPI_REAL_T, MPI_MAX, MPI_COMM_WORLD);
+  return result;
+}
+
+real_t decomposition_min(real_t value)
+{
+  real_t result;
+  MPI_Allreduce(&value, &result, 1, COSMO_MPI_REAL_T, MPI_MIN, MPI_COMM_WORLD);
+  return result;
+}
+
+/**
+ * @brief      Broadcast a string from rank 0 to all processes
+ */
+void decomposition_broadcast(std::string & value)
+{
+  int len = value.size();
+  MPI_Bcast(&len, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  std::vector<char> buf(value.begin(), value.end());
+  buf.resize(len + 1);
+  MPI_Bcast(&buf[0], len, MPI_CHAR, 0, MPI_COMM_WORLD);
+  value.assign(&buf[0], len);
+}
+
+/**
+ * @brief      Gather owned x-planes of plane_size points from all processes
+ *  into global (GLOBAL_NX*plane_size points) on rank 0
+ *
+ * @param[in]  local       first owned plane of local data
+ * @param[in]  plane_size  points per x-plane
+ * @param      global      output buffer; only used on rank 0
+ */
+void decomposition_gather_x(const real_t * local, idx_t plane_size, real_t * global)
+{
+  const int count = (GLOBAL_NX/COSMO_MPI_RANKS)*plane_size;
+  MPI_Gather(local, count, COSMO_MPI_REAL_T, global, count,
+    COSMO_MPI_REAL_T, 0, MPI_COMM_WORLD);
+}
+
+} // namespace cosmo
+
+#endif
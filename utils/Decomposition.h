@@ -0,0 +1,148 @@
+#ifndef COSMO_UTILS_DECOMPOSITION_H
+#define COSMO_UTILS_DECOMPOSITION_H
+
+#include "../cosmo_macros.h"
+#include "../cosmo_types.h"
+#include "Timer.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#if USE_MPI
+# include <mpi.h>
+#endif
+
+namespace cosmo
+{
+
+/**
+ * MPI domain decomposition helpers.
+ *
+ * With USE_MPI, the periodic box is split along x into COSMO_MPI_RANKS slabs
+ * of GLOBAL_NX/COSMO_MPI_RANKS planes. Each process stores its slab plus
+ * COSMO_HALO_WIDTH halo planes on either side, so that local arrays are
+ * NX*NY*NZ and owned points are x-indices [OWNED_X_BEGIN, OWNED_X_END).
+ * Without USE_MPI these functions reduce to no-ops on a single process.
+ */
+
+/**
+ * @brief Requests of a halo exchange that has been posted but not completed
+ */
+struct HaloExchange
+{
+#if USE_MPI
+  std::vector<MPI_Request> requests;
+#endif
+};
+
+#if USE_MPI
+
+void decomposition_init(int * argc, char *** argv);
+void decomposition_finalize();
+
+int decomposition_rank();
+int decomposition_n_ranks();
+idx_t decomposition_x_offset();
+
+void decomposition_start_halo_exchange(std::vector<arr_t *> & fields,
+  HaloExchange & exchange);
+void decomposition_finish_halo_exchange(HaloExchange & exchange);
+void decomposition_exchange_halos(std::vector<arr_t *> & fields);
+
+real_t decomposition_sum(real_t value);
+idx_t decomposition_sum(idx_t value);
+real_t decomposition_max(real_t value);
+real_t decomposition_min(real_t value);
+
+void decomposition_broadcast(std::string & value);
+void decomposition_gather_x(const real_t * local, idx_t plane_size, real_t * global);
+
+#else
+
+inline void decomposition_init(int * argc, char *** argv) {}
+inline void decomposition_finalize() {}
+
+inline int decomposition_rank() { return 0; }
+inline int decomposition_n_ranks() { return 1; }
+inline idx_t decomposition_x_offset() { return 0; }
+
+inline void decomposition_start_halo_exchange(std::vector<arr_t *> & fields,
+  HaloExchange & exchange) {}
+inline void decomposition_finish_halo_exchange(HaloExchange & exchange) {}
+inline void decomposition_exchange_halos(std::vector<arr_t *> & fields) {}
+
+inline real_t decomposition_sum(real_t value) { return value; }
+inline idx_t decomposition_sum(idx_t value) { return value; }
+inline real_t decomposition_max(real_t value) { return value; }
+inline real_t decomposition_min(real_t value) { return value; }
+
+inline void decomposition_broadcast(std::string & value) {}
+inline void decomposition_gather_x(const real_t * local, idx_t plane_size, real_t * global)
+{
+  std::copy(local, local + NX*plane_size, global);
+}
+
+#endif
+
+/**
+ * @brief      Call evolve_pt(i, j, k) at every point with x-index in
+ *  [x_begin, x_end), in parallel
+ */
+template<typename F>
+void decomposition_x_range_loop(idx_t x_begin, idx_t x_end, F & evolve_pt)
+{
+  idx_t i, j, k;
+#pragma omp parallel for default(shared) private(i, j, k) collapse(2)
+  for(i=x_begin; i<x_end; ++i)
+    for(j=0; j<NY; ++j)
+      for(k=0; k<NZ; ++k)
+        evolve_pt(i, j, k);
+}
+
+/**
+ * @brief      Call evolve_pt(i, j, k) at every owned point while the halos of
+ *  fields are being exchanged
+ * @details    The exchange is posted first; evolve_pt is then evaluated on
+ *  interior planes, whose stencils (of width up to COSMO_HALO_WIDTH) only
+ *  reach owned points. After waiting on the exchange, the boundary shells
+ *  next to either halo are finished. Interior compute, wait, and boundary
+ *  compute are timed separately. Without USE_MPI, this is a single loop
+ *  over the grid. evolve_pt must not depend on the order points are visited.
+ *
+ * @param      timer      timers of the simulation
+ * @param      fields     fields whose halos are stale (may be empty)
+ * @param      evolve_pt  function to call at each point
+ */
+template<typename F>
+void decomposition_loop_overlapping_halos(TimerManager & timer,
+  std::vector<arr_t *> & fields, F evolve_pt)
+{
+#if USE_MPI
+  HaloExchange exchange;
+  decomposition_start_halo_exchange(fields, exchange);
+
+  const idx_t interior_begin = std::min<idx_t>(
+    OWNED_X_BEGIN + COSMO_HALO_WIDTH, OWNED_X_END);
+  const idx_t interior_end = std::max<idx_t>(
+    OWNED_X_END - COSMO_HALO_WIDTH, interior_begin);
+
+  timer["halo_interior_compute"].start();
+  decomposition_x_range_loop(interior_begin, interior_end, evolve_pt);
+  timer["halo_interior_compute"].stop();
+
+  timer["halo_wait"].start();
+  decomposition_finish_halo_exchange(exchange);
+  timer["halo_wait"].stop();
+
+  timer["halo_boundary_compute"].start();
+  decomposition_x_range_loop(OWNED_X_BEGIN, interior_begin, evolve_pt);
+  decomposition_x_range_loop(interior_end, OWNED_X_END, evolve_pt);
+  timer["halo_boundary_compute"].stop();
+#else
+  decomposition_x_range_loop(0, NX, evolve_pt);
+#endif
+}
+
+} // namespace cosmo
+
+#endif
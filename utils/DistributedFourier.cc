@@ -0,0 +1,274 @@
+#include "DistributedFourier.h"
+
+#if USE_MPI
+
+#include <iostream>
+#include <algorithm>
+
+#if USE_LONG_DOUBLES
+# define COSMO_MPI_FFT_REAL_T MPI_LONG_DOUBLE
+#else
+# define COSMO_MPI_FFT_REAL_T MPI_DOUBLE
+#endif
+
+namespace cosmo
+{
+
+/**
+ * @brief Set up the process grid, buffers, and FFTW plans
+ *
+ * @param p_cols_in number of process grid columns; COSMO_MPI_RANKS must be
+ *  divisible by this. 1 gives a slab decomposition.
+ */
+DistributedFourier::DistributedFourier(int p_cols_in)
+{
+  p_cols = p_cols_in;
+  p_rows = p_cols > 0 ? COSMO_MPI_RANKS/p_cols : 0;
+
+  if(p_cols < 1 || p_rows*p_cols != COSMO_MPI_RANKS
+    || NY % p_rows != 0 || NY % p_cols != 0 || p_cols > NZ/2+1)
+  {
+    if(decomposition_rank() == 0)
+      std::cerr << "Error: cannot arrange " << COSMO_MPI_RANKS
+        << " MPI processes into " << p_cols << " FFT pencil columns; the"
+        << " number of rows and columns must divide both the ranks and NY.\n";
+    throw -1;
+  }
+
+  // rank = row*p_cols + col, so the x-slabs of a process row make up
+  // the x-extent of its z-pencils.
+  row = decomposition_rank() / p_cols;
+  col = decomposition_rank() % p_cols;
+  MPI_Comm_split(MPI_COMM_WORLD, row, col, &row_comm);
+  MPI_Comm_split(MPI_COMM_WORLD, col, row, &col_comm);
+
+  MPI_Type_contiguous(2, COSMO_MPI_FFT_REAL_T, &complex_type);
+  MPI_Type_commit(&complex_type);
+
+  nx_s = GLOBAL_NX/COSMO_MPI_RANKS;
+  nx_p = GLOBAL_NX/p_rows;
+  ny_p = NY/p_cols;
+  nz_c = NZ/2+1;
+
+  ny_k = NY/p_rows;
+  ky_begin = row*ny_k;
+  nz_k = kzCount(col);
+  kz_begin = kzBegin(col);
+
+  row_counts.resize(p_cols);
+  row_displs.resize(p_cols);
+  for(int c=0; c<p_cols; ++c)
+  {
+    row_counts[c] = nx_p*ny_p*kzCount(c);
+    row_displs[c] = nx_p*ny_p*kzBegin(c);
+  }
+
+  idx_t c_size = std::max(nx_p*ny_p*nz_c, nx_p*nz_k*NY);
+  real_slab = (fft_rt *) COSMO_FFTW(malloc)(nx_s*NY*NZ*((long long) sizeof(fft_rt)));
+  real_z = (fft_rt *) COSMO_FFTW(malloc)(nx_p*ny_p*NZ*((long long) sizeof(fft_rt)));
+  c_z = (fft_ct *) COSMO_FFTW(malloc)(nx_p*ny_p*nz_c*((long long) sizeof(fft_ct)));
+  c_y = (fft_ct *) COSMO_FFTW(malloc)(nx_p*nz_k*NY*((long long) sizeof(fft_ct)));
+  f_field = (fft_ct *) COSMO_FFTW(malloc)(ny_k*nz_k*GLOBAL_NX*((long long) sizeof(fft_ct)));
+  send_buf = (fft_ct *) COSMO_FFTW(malloc)(c_size*((long long) sizeof(fft_ct)));
+  recv_buf = (fft_ct *) COSMO_FFTW(malloc)(c_size*((long long) sizeof(fft_ct)));
+
+  // 1-d transforms along each (contiguous) pencil direction
+  int n_z = NZ, n_y = NY, n_x = GLOBAL_NX;
+  p_z_r2c = COSMO_FFTW(plan_many_dft_r2c)(1, &n_z, nx_p*ny_p,
+    real_z, NULL, 1, NZ, c_z, NULL, 1, nz_c, FFTW_MEASURE);
+  p_z_c2r = COSMO_FFTW(plan_many_dft_c2r)(1, &n_z, nx_p*ny_p,
+    c_z, NULL, 1, nz_c, real_z, NULL, 1, NZ, FFTW_MEASURE);
+  p_y_forward = COSMO_FFTW(plan_many_dft)(1, &n_y, nx_p*nz_k,
+    c_y, NULL, 1, NY, c_y, NULL, 1, NY, FFTW_FORWARD, FFTW_MEASURE);
+  p_y_backward = COSMO_FFTW(plan_many_dft)(1, &n_y, nx_p*nz_k,
+    c_y, NULL, 1, NY, c_y, NULL, 1, NY, FFTW_BACKWARD, FFTW_MEASURE);
+  p_x_forward = COSMO_FFTW(plan_many_dft)(1, &n_x, ny_k*nz_k,
+    f_field, NULL, 1, GLOBAL_NX, f_field, NULL, 1, GLOBAL_NX, FFTW_FORWARD, FFTW_MEASURE);
+  p_x_backward = COSMO_FFTW(plan_many_dft)(1, &n_x, ny_k*nz_k,
+    f_field, NULL, 1, GLOBAL_NX, f_field, NULL, 1, GLOBAL_NX, FFTW_BACKWARD, FFTW_MEASURE);
+}
+
+DistributedFourier::~DistributedFourier()
+{
+  COSMO_FFTW(destroy_plan)(p_z_r2c);
+  COSMO_FFTW(destroy_plan)(p_z_c2r);
+  COSMO_FFTW(destroy_plan)(p_y_forward);
+  COSMO_FFTW(destroy_plan)(p_y_backward);
+  COSMO_FFTW(destroy_plan)(p_x_forward);
+  COSMO_FFTW(destroy_plan)(p_x_backward);
+
+  COSMO_FFTW(free)(real_slab);
+  COSMO_FFTW(free)(real_z);
+  COSMO_FFTW(free)(c_z);
+  COSMO_FFTW(free)(c_y);
+  COSMO_FFTW(free)(f_field);
+  COSMO_FFTW(free)(send_buf);
+  COSMO_FFTW(free)(recv_buf);
+
+  MPI_Type_free(&complex_type);
+  MPI_Comm_free(&row_comm);
+  MPI_Comm_free(&col_comm);
+}
+
+/**
+ * @brief First z-wavenumber held by process grid column c
+ */
+idx_t DistributedFourier::kzBegin(int c)
+{
+  return c*(nz_c/p_cols) + std::min<idx_t>(c, nz_c % p_cols);
+}
+
+/**
+ * @brief Number of z-wavenumbers held by process grid column c
+ */
+idx_t DistributedFourier::kzCount(int c)
+{
+  return nz_c/p_cols + (c < nz_c % p_cols ? 1 : 0);
+}
+
+/**
+ * @brief Transform real_slab into f_field
+ */
+void DistributedFourier::forwardTransform()
+{
+  idx_t c, r, x, y, k, n;
+  const int slab_count = nx_s*ny_p*NZ;
+  const int col_count = nx_p*nz_k*ny_k;
+  std::vector<int> z_counts(p_cols, nx_p*ny_p*nz_k), z_displs(p_cols);
+  for(c=0; c<p_cols; ++c)
+    z_displs[c] = c*nx_p*ny_p*nz_k;
+
+  // x-slabs -> z-pencils: blocks arrive ordered by x
+  MPI_Alltoall(real_slab, slab_count, COSMO_MPI_FFT_REAL_T,
+    real_z, slab_count, COSMO_MPI_FFT_REAL_T, row_comm);
+  COSMO_FFTW(execute)(p_z_r2c);
+
+  // z-pencils -> y-pencils, within process rows
+  n = 0;
+  for(c=0; c<p_cols; ++c)
+    for(x=0; x<nx_p; ++x)
+      for(y=0; y<ny_p; ++y)
+        for(k=kzBegin(c); k<kzBegin(c)+kzCount(c); ++k, ++n)
+        {
+          send_buf[n][0] = c_z[(x*ny_p + y)*nz_c + k][0];
+          send_buf[n][1] = c_z[(x*ny_p + y)*nz_c + k][1];
+        }
+  MPI_Alltoallv(send_buf, &row_counts[0], &row_displs[0], complex_type,
+    recv_buf, &z_counts[0], &z_displs[0], complex_type, row_comm);
+  n = 0;
+  for(c=0; c<p_cols; ++c)
+    for(x=0; x<nx_p; ++x)
+      for(y=c*ny_p; y<(c+1)*ny_p; ++y)
+        for(k=0; k<nz_k; ++k, ++n)
+        {
+          c_y[(x*nz_k + k)*NY + y][0] = recv_buf[n][0];
+          c_y[(x*nz_k + k)*NY + y][1] = recv_buf[n][1];
+        }
+  COSMO_FFTW(execute)(p_y_forward);
+
+  // y-pencils -> x-pencils, within process columns
+  n = 0;
+  for(r=0; r<p_rows; ++r)
+    for(x=0; x<nx_p; ++x)
+      for(k=0; k<nz_k; ++k)
+        for(y=r*ny_k; y<(r+1)*ny_k; ++y, ++n)
+        {
+          send_buf[n][0] = c_y[(x*nz_k + k)*NY + y][0];
+          send_buf[n][1] = c_y[(x*nz_k + k)*NY + y][1];
+        }
+  MPI_Alltoall(send_buf, col_count, complex_type,
+    recv_buf, col_count, complex_type, col_comm);
+  n = 0;
+  for(r=0; r<p_rows; ++r)
+    for(x=r*nx_p; x<(r+1)*nx_p; ++x)
+      for(k=0; k<nz_k; ++k)
+        for(y=0; y<ny_k; ++y, ++n)
+        {
+          f_field[k_index(y, k, x)][0] = recv_buf[n][0];
+          f_field[k_index(y, k, x)][1] = recv_buf[n][1];
+        }
+  COSMO_FFTW(execute)(p_x_forward);
+}
+
+/**
+ * @brief Transform f_field into real_slab; reverses forwardTransform
+ */
+void DistributedFourier::backwardTransform()
+{
+  idx_t c, r, x, y, k, n;
+  const int slab_count = nx_s*ny_p*NZ;
+  const int col_count = nx_p*nz_k*ny_k;
+  std::vector<int> z_counts(p_cols, nx_p*ny_p*nz_k), z_displs(p_cols);
+  for(c=0; c<p_cols; ++c)
+    z_displs[c] = c*nx_p*ny_p*nz_k;
+
+  // x-pencils -> y-pencils
+  COSMO_FFTW(execute)(p_x_backward);
+  n = 0;
+  for(r=0; r<p_rows; ++r)
+    for(x=r*nx_p; x<(r+1)*nx_p; ++x)
+      for(k=0; k<nz_k; ++k)
+        for(y=0; y<ny_k; ++y, ++n)
+        {
+          send_buf[n][0] = f_field[k_index(y, k, x)][0];
+          send_buf[n][1] = f_field[k_index(y, k, x)][1];
+        }
+  MPI_Alltoall(send_buf, col_count, complex_type,
+    recv_buf, col_count, complex_type, col_comm);
+  n = 0;
+  for(r=0; r<p_rows; ++r)
+    for(x=0; x<nx_p; ++x)
+      for(k=0; k<nz_k; ++k)
+        for(y=r*ny_k; y<(r+1)*ny_k; ++y, ++n)
+        {
+          c_y[(x*nz_k + k)*NY + y][0] = recv_buf[n][0];
+          c_y[(x*nz_k + k)*NY + y][1] = recv_buf[n][1];
+        }
+
+  // y-pencils -> z-pencils
+  COSMO_FFTW(execute)(p_y_backward);
+  n = 0;
+  for(c=0; c<p_cols; ++c)
+    for(x=0; x<nx_p; ++x)
+      for(y=c*ny_p; y<(c+1)*ny_p; ++y)
+        for(k=0; k<nz_k; ++k, ++n)
+        {
+          send_buf[n][0] = c_y[(x*nz_k + k)*NY + y][0];
+          send_buf[n][1] = c_y[(x*nz_k + k)*NY + y][1];
+        }
+  MPI_Alltoallv(send_buf, &z_counts[0], &z_displs[0], complex_type,
+    recv_buf, &row_counts[0], &row_displs[0], complex_type, row_comm);
+  n = 0;
+  for(c=0; c<p_cols; ++c)
+    for(x=0; x<nx_p; ++x)
+      for(y=0; y<ny_p; ++y)
+        for(k=kzBegin(c); k<kzBegin(c)+kzCount(c); ++k, ++n)
+        {
+          c_z[(x*ny_p + y)*nz_c + k][0] = recv_buf[n][0];
+          c_z[(x*ny_p + y)*nz_c + k][1] = recv_buf[n][1];
+        }
+
+  // z-pencils -> x-slabs
+  COSMO_FFTW(execute)(p_z_c2r);
+  MPI_Alltoall(real_z, slab_count, COSMO_MPI_FFT_REAL_T,
+    real_slab, slab_count, COSMO_MPI_FFT_REAL_T, row_comm);
+}
+
+/**
+ * @brief Sum power spectrum bins from all processes onto rank 0
+ */
+void DistributedFourier::reduceBins(int numbins, fft_rt *f2, int *numpoints)
+{
+  std::vector<fft_rt> f2_sum(numbins);
+  std::vector<int> numpoints_sum(numbins);
+
+  MPI_Reduce(f2, &f2_sum[0], numbins, COSMO_MPI_FFT_REAL_T, MPI_SUM, 0, MPI_COMM_WORLD);
+  MPI_Reduce(numpoints, &numpoints_sum[0], numbins, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+
+  std::copy(f2_sum.begin(), f2_sum.end(), f2);
+  std::copy(numpoints_sum.begin(), numpoints_sum.end(), numpoints);
+}
+
+} // namespace cosmo
+
+#endif
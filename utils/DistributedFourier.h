@@ -0,0 +1,282 @@
+#ifndef COSMO_UTILS_DISTRIBUTED_FOURIER_H
+#define COSMO_UTILS_DISTRIBUTED_FOURIER_H
+
+#include "../cosmo_macros.h"
+#include "../cosmo_types.h"
+
+#if USE_MPI
+
+#include <fftw3.h>
+#include <mpi.h>
+#include <zlib.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include "Decomposition.h"
+
+#if USE_LONG_DOUBLES
+# define COSMO_FFTW(name) fftwl_##name
+#else
+# define COSMO_FFTW(name) fftw_##name
+#endif
+
+namespace cosmo
+{
+
+/**
+ * @brief Distributed 3D real-to-complex FFTs of the decomposed grid
+ * @details Processes form a p_rows x p_cols grid; p_cols = 1 gives a slab
+ *  decomposition, otherwise a pencil decomposition is used. Real-space data
+ *  is read from the owned x-planes of each process and redistributed into
+ *  z-pencils. Transforms are then taken along z, y, and x using local FFTW
+ *  plans, separated by all-to-all transposes within process rows (z to y
+ *  pencils) and columns (y to x pencils).
+ *
+ *  Fourier-space data ends up in x-pencils: each process holds all kx for
+ *  ky in [ky_begin, ky_begin + ny_k) and kz in [kz_begin, kz_begin + nz_k),
+ *  stored in f_field at k_index(j - ky_begin, k - kz_begin, i). As with FFTW,
+ *  transforms are not normalized.
+ */
+class DistributedFourier
+{
+public:
+#if USE_LONG_DOUBLES
+  typedef long double fft_rt;
+#else
+  typedef double fft_rt;
+#endif
+  typedef COSMO_FFTW(complex) fft_ct;
+
+  int p_rows, p_cols; ///< process grid dimensions
+  int row, col; ///< position of this process in the process grid
+
+  idx_t ky_begin, ny_k; ///< y-wavenumbers held in Fourier space
+  idx_t kz_begin, nz_k; ///< z-wavenumbers held in Fourier space
+
+  fft_ct *f_field; ///< Fourier-space data (x-pencils)
+
+  DistributedFourier(int p_cols_in);
+  ~DistributedFourier();
+
+  idx_t k_index(idx_t j, idx_t k, idx_t i)
+  {
+    return (j*nz_k + k)*GLOBAL_NX + i;
+  }
+
+  template<typename RT>
+  void forward(const RT *field);
+
+  template<typename RT>
+  void backward(RT *field);
+
+  template<typename RT, typename IOT>
+  void powerDump(RT *in, IOT *iodata);
+
+  template<typename IT, typename RT>
+  void inverseLaplacian(RT *field);
+
+  template<typename IT, typename RT>
+  void deconvolveWindow(RT *field, int order);
+
+private:
+  MPI_Comm row_comm, col_comm;
+  MPI_Datatype complex_type;
+
+  idx_t nx_s; ///< x-planes owned in real space
+  idx_t nx_p, ny_p; ///< x, y extent of z-pencils
+  idx_t nz_c; ///< complex points along z, NZ/2+1
+
+  fft_rt *real_slab; ///< owned planes, ordered by destination y-chunk
+  fft_rt *real_z; ///< real z-pencils
+  fft_ct *c_z; ///< complex z-pencils
+  fft_ct *c_y; ///< complex y-pencils
+  fft_ct *send_buf, *recv_buf;
+
+  std::vector<int> row_counts, row_displs; ///< z-pencil transpose blocks
+
+  COSMO_FFTW(plan) p_z_r2c, p_z_c2r;
+  COSMO_FFTW(plan) p_y_forward, p_y_backward;
+  COSMO_FFTW(plan) p_x_forward, p_x_backward;
+
+  idx_t kzBegin(int c);
+  idx_t kzCount(int c);
+
+  void forwardTransform();
+  void backwardTransform();
+  void reduceBins(int numbins, fft_rt *f2, int *numpoints);
+};
+
+
+/**
+ * @brief Transform the owned points of a decomposed array into f_field
+ *
+ * @param field local array (including halos)
+ */
+template<typename RT>
+void DistributedFourier::forward(const RT *field)
+{
+  idx_t b, x, y, z, n = 0;
+
+  for(b=0; b<p_cols; ++b)
+    for(x=0; x<nx_s; ++x)
+      for(y=b*ny_p; y<(b+1)*ny_p; ++y)
+        for(z=0; z<NZ; ++z)
+          real_slab[n++] = (fft_rt) field[NP_INDEX(OWNED_X_BEGIN + x, y, z)];
+
+  forwardTransform();
+}
+
+/**
+ * @brief Transform f_field back into the owned points of a decomposed array
+ * @details f_field is overwritten. Halo planes of field are not set.
+ *
+ * @param field local array (including halos)
+ */
+template<typename RT>
+void DistributedFourier::backward(RT *field)
+{
+  idx_t b, x, y, z, n = 0;
+
+  backwardTransform();
+
+  for(b=0; b<p_cols; ++b)
+    for(x=0; x<nx_s; ++x)
+      for(y=b*ny_p; y<(b+1)*ny_p; ++y)
+        for(z=0; z<NZ; ++z)
+          field[NP_INDEX(OWNED_X_BEGIN + x, y, z)] = (RT) real_slab[n++];
+}
+
+/**
+ * @brief Compute a power spectrum and write to file, see Fourier::powerDump
+ * @details Must be called by all processes; rank 0 writes the spectrum.
+ */
+template<typename RT, typename IOT>
+void DistributedFourier::powerDump(RT *in, IOT *iodata)
+{
+  forward(in);
+
+  const int numbins = (int) (sqrt(GLOBAL_NX*GLOBAL_NX + NY*NY + NZ*NZ)/2.0) + 1;
+  std::vector<fft_rt> f2(numbins, 0.0);
+  std::vector<int> numpoints(numbins, 0);
+
+  for(idx_t j=0; j<ny_k; j++)
+  {
+    int py = (ky_begin + j <= NY/2 ? ky_begin + j : ky_begin + j - NY);
+    for(idx_t k=0; k<nz_k; k++)
+    {
+      int pz = kz_begin + k;
+      // modes with 0 < pz < NZ/2 stand in for their complex conjugates
+      int weight = (pz == 0 || pz == NZ/2) ? 1 : 2;
+      for(idx_t i=0; i<GLOBAL_NX; i++)
+      {
+        int px = (i <= GLOBAL_NX/2 ? i : i - GLOBAL_NX);
+        fft_rt pmagnitude = sqrt((RT) (pw2(px) + pw2(py) + pw2(pz)));
+        idx_t fft_index = k_index(j, k, i);
+        fft_rt fp2 = pw2(C_RE(f_field[fft_index])) + pw2(C_IM(f_field[fft_index]));
+        numpoints[(int) pmagnitude] += weight;
+        f2[(int) pmagnitude] += weight*fp2;
+      }
+    }
+  }
+
+  reduceBins(numbins, &f2[0], &numpoints[0]);
+  if(decomposition_rank() != 0)
+    return;
+
+  std::string filename = iodata->dir() + "spec.dat.gz";
+  char data[20];
+
+  gzFile datafile = gzopen(filename.c_str(), "ab");
+  if(datafile == Z_NULL) {
+    printf("Error opening file: %s\n", filename.c_str());
+    return;
+  }
+
+  for(int i=0; i<numbins; i++)
+  {
+    fft_rt value = numpoints[i] > 0 ? f2[i]/((fft_rt) numpoints[i]) : 0.0;
+    sprintf(data, "%g\t", value);
+    gzwrite(datafile, data, std::char_traits<char>::length(data));
+  }
+  gzwrite(datafile, "\n", std::char_traits<char>::length("\n"));
+
+  gzclose(datafile);
+}
+
+/**
+ * @brief Compute the inverse laplacian of the owned points of an array,
+ *  see Fourier::inverseLaplacian. Halo planes are not updated.
+ */
+template<typename IT, typename RT>
+void DistributedFourier::inverseLaplacian(RT *field)
+{
+  forward(field);
+
+  for(IT j=0; j<ny_k; j++)
+  {
+    RT py = (RT) (ky_begin + j <= NY/2 ? ky_begin + j : ky_begin + j - NY);
+    for(IT k=0; k<nz_k; k++)
+    {
+      RT pz = (RT) (kz_begin + k);
+      for(IT i=0; i<GLOBAL_NX; i++)
+      {
+        RT px = (RT) (i <= GLOBAL_NX/2 ? i : i - GLOBAL_NX);
+        RT pmag = sqrt( pw2(px) + pw2(py) + pw2(pz) )*2.0*PI/H_LEN_FRAC;
+
+        IT fft_index = k_index(j, k, i);
+        f_field[fft_index][0] /= -pmag*pmag*GLOBAL_POINTS;
+        f_field[fft_index][1] /= -pmag*pmag*GLOBAL_POINTS;
+      }
+    }
+  }
+  // zero mode
+  if(ky_begin == 0 && kz_begin == 0)
+  {
+    f_field[0][0] = 0;
+    f_field[0][1] = 0;
+  }
+
+  backward(field);
+}
+
+/**
+ * @brief Deconvolve the window of a separable mass-assignment scheme from
+ *  the owned points of an array, see Fourier::deconvolveWindow. Halo planes
+ *  are not updated.
+ */
+template<typename IT, typename RT>
+void DistributedFourier::deconvolveWindow(RT *field, int order)
+{
+  forward(field);
+
+  for(IT j=0; j<ny_k; j++)
+  {
+    IT jj = ky_begin + j;
+    RT ay = PI*(RT) (jj<=NY/2 ? jj : jj-NY)/NY;
+    RT wy = ay == 0 ? 1.0 : std::sin(ay)/ay;
+    for(IT k=0; k<nz_k; k++)
+    {
+      RT az = PI*(RT) (kz_begin + k)/NZ;
+      RT wz = az == 0 ? 1.0 : std::sin(az)/az;
+      for(IT i=0; i<GLOBAL_NX; i++)
+      {
+        RT ax = PI*(RT) (i<=GLOBAL_NX/2 ? i : i-GLOBAL_NX)/GLOBAL_NX;
+        RT wx = ax == 0 ? 1.0 : std::sin(ax)/ax;
+
+        IT fft_index = k_index(j, k, i);
+        RT window = std::pow(wx*wy*wz, order);
+
+        f_field[fft_index][0] /= window*GLOBAL_POINTS;
+        f_field[fft_index][1] /= window*GLOBAL_POINTS;
+      }
+    }
+  }
+
+  backward(field);
+}
+
+} // namespace cosmo
+
+#endif
+
+#endif
@@ -0,0 +1,683 @@
+#include "FASMultigrid.h"
+
+namespace cosmo
+{
+
+/**
+ * @brief Construct solver for num_vars equations / variables
+ *
+ * @param iodata_in simulation log; its context provides grid spacing
+ *  and timers
+ * @param u_in array of num_vars fields to solve for; values on input are
+ *  used as an initial guess
+ * @param molecule_n number of molecules (terms) in each equation
+ * @param max_depth maximum number of grid levels (including the finest)
+ * @param relax_iters number of pre- and post-smoothing sweeps per level
+ *  (at least 1)
+ * @param relaxation_tolerance RMS residual at which to stop cycling
+ */
+FASMultigrid::FASMultigrid(IOData * iodata_in, arr_t * u_in, idx_t num_vars_in,
+  idx_t molecule_n[], idx_t max_depth_in, idx_t relax_iters_in,
+  real_t relaxation_tolerance_in)
+{
+  iodata = iodata_in;
+  ctx = iodata->ctx;
+  if(relax_iters_in < 1)
+  {
+    iodata->log("Error: multigrid needs at least one relaxation sweep per level.");
+    throw -1;
+  }
+  u_user = u_in;
+  num_vars = num_vars_in;
+  relax_iters = relax_iters_in;
+  relaxation_tolerance = relaxation_tolerance_in;
+  src_restricted = false;
+  zero_mean.assign(num_vars, false);
+
+  eqns.resize(num_vars);
+  for(idx_t e=0; e<num_vars; ++e)
+    eqns[e].resize(molecule_n[e]);
+
+  // Grid hierarchy: coarsen by 2 in every non-trivial direction while
+  // all such directions are divisible by 4, so that coarse levels remain
+  // even (as multi-colored relaxation requires on a periodic grid).
+  level_t lv;
+  lv.nx = u_in[0].nx;
+  lv.ny = u_in[0].ny;
+  lv.nz = u_in[0].nz;
+  lv.hx = lv.hy = lv.hz = ctx->dx;
+  while(true)
+  {
+    lv.pts = lv.nx*lv.ny*lv.nz;
+    levels.push_back(lv);
+
+    bool coarsenable = (idx_t) levels.size() < max_depth_in;
+    if(lv.nx > 1) coarsenable = coarsenable && lv.nx % 4 == 0;
+    if(lv.ny > 1) coarsenable = coarsenable && lv.ny % 4 == 0;
+    if(lv.nz > 1) coarsenable = coarsenable && lv.nz % 4 == 0;
+    if(!coarsenable)
+      break;
+
+    if(lv.nx > 1) { lv.nx /= 2; lv.hx *= 2.0; }
+    if(lv.ny > 1) { lv.ny /= 2; lv.hy *= 2.0; }
+    if(lv.nz > 1) { lv.nz /= 2; lv.hz *= 2.0; }
+  }
+  num_levels = levels.size();
+
+  for(idx_t l=0; l<num_levels; ++l)
+  {
+    level_t & lvl = levels[l];
+    lvl.u.resize(num_vars);
+    lvl.u_tilde.resize(num_vars);
+    lvl.rho.resize(num_vars);
+    lvl.res.resize(num_vars);
+    for(idx_t v=0; v<num_vars; ++v)
+    {
+      lvl.u[v] = (l == 0) ? u_user[v]._array : new real_t[lvl.pts]();
+      lvl.u_tilde[v] = new real_t[lvl.pts]();
+      lvl.rho[v] = new real_t[lvl.pts]();
+      lvl.res[v] = new real_t[lvl.pts]();
+    }
+  }
+}
+
+FASMultigrid::~FASMultigrid()
+{
+  for(idx_t l=0; l<num_levels; ++l)
+  {
+    for(idx_t v=0; v<num_vars; ++v)
+    {
+      if(l > 0)
+        delete [] levels[l].u[v];
+      delete [] levels[l].u_tilde[v];
+      delete [] levels[l].rho[v];
+      delete [] levels[l].res[v];
+    }
+  }
+
+  for(auto & eqn : eqns)
+    for(auto & mol : eqn)
+      for(real_t * src : mol.src)
+        delete [] src;
+}
+
+/**
+ * @brief Set the value of the "const_f" atom in a molecule at a point on
+ *  the finest grid.
+ */
+void FASMultigrid::setPolySrcAtPt(idx_t eqn_id, idx_t mol_id,
+  idx_t i, idx_t j, idx_t k, real_t value)
+{
+  molecule & mol = eqns[eqn_id][mol_id];
+  if(mol.src.empty())
+  {
+    mol.src.resize(num_levels);
+    for(idx_t l=0; l<num_levels; ++l)
+      mol.src[l] = new real_t[levels[l].pts]();
+  }
+
+  level_t & lv = levels[0];
+  mol.src[0][H_INDEX(i, j, k, lv.nx, lv.ny, lv.nz)] = value;
+  src_restricted = false;
+}
+
+/**
+ * @brief Restrict "const_f" coefficients to all coarse levels; call after
+ *  all sources have been set (cycles call this automatically if needed).
+ */
+void FASMultigrid::initializeRhoHeirarchy()
+{
+  for(auto & eqn : eqns)
+    for(auto & mol : eqn)
+      if(!mol.src.empty())
+        for(idx_t l=0; l<num_levels-1; ++l)
+          restrictField(l, mol.src[l], mol.src[l+1]);
+
+  setColors();
+  src_restricted = true;
+}
+
+/**
+ * @brief Project out the mean of a variable after each cycle; needed for
+ *  eg. linear Poisson problems, whose solutions are defined up to a constant.
+ */
+void FASMultigrid::enforceZeroMean(idx_t u_id)
+{
+  zero_mean[u_id] = true;
+}
+
+void FASMultigrid::setColors()
+{
+  // Mixed derivatives couple diagonal neighbors, which share a red-black
+  // color; use 8 colors (parity in each direction) in that case.
+  num_colors = 2;
+  for(auto & eqn : eqns)
+    for(auto & mol : eqn)
+      for(auto & a : mol.atoms)
+        if(a.type == der12 || a.type == der13 || a.type == der23)
+          num_colors = 8;
+}
+
+/**
+ * @brief Value of an atom at a point
+ */
+real_t FASMultigrid::atomValue(level_t & lv, const atom & a, molecule & mol,
+  idx_t lvl, idx_t i, idx_t j, idx_t k, idx_t idx)
+{
+  if(a.type == const_f)
+    return mol.src.empty() ? 0.0 : mol.src[lvl][idx];
+
+  const real_t * RESTRICT u = lv.u[a.u_id];
+  const idx_t nx = lv.nx, ny = lv.ny, nz = lv.nz;
+
+#define MG_U(di,dj,dk) u[H_INDEX(i+(di), j+(dj), k+(dk), nx, ny, nz)]
+#define MG_D2(di,dj,dk,h) ( (MG_U(di,dj,dk) - 2.0*u[idx] + MG_U(-(di),-(dj),-(dk)))/(h)/(h) )
+
+  switch(a.type)
+  {
+    case poly:
+      return std::pow(u[idx], a.value);
+    case der1:
+      return nx > 1 ? (MG_U(1,0,0) - MG_U(-1,0,0))/2.0/lv.hx : 0.0;
+    case der2:
+      return ny > 1 ? (MG_U(0,1,0) - MG_U(0,-1,0))/2.0/lv.hy : 0.0;
+    case der3:
+      return nz > 1 ? (MG_U(0,0,1) - MG_U(0,0,-1))/2.0/lv.hz : 0.0;
+    case der11:
+      return nx > 1 ? MG_D2(1,0,0,lv.hx) : 0.0;
+    case der22:
+      return ny > 1 ? MG_D2(0,1,0,lv.hy) : 0.0;
+    case der33:
+      return nz > 1 ? MG_D2(0,0,1,lv.hz) : 0.0;
+    case lap:
+      return (nx > 1 ? MG_D2(1,0,0,lv.hx) : 0.0)
+        + (ny > 1 ? MG_D2(0,1,0,lv.hy) : 0.0)
+        + (nz > 1 ? MG_D2(0,0,1,lv.hz) : 0.0);
+    case der12:
+      return (nx > 1 && ny > 1) ? (MG_U(1,1,0) - MG_U(1,-1,0) - MG_U(-1,1,0)
+        + MG_U(-1,-1,0))/4.0/lv.hx/lv.hy : 0.0;
+    case der13:
+      return (nx > 1 && nz > 1) ? (MG_U(1,0,1) - MG_U(1,0,-1) - MG_U(-1,0,1)
+        + MG_U(-1,0,-1))/4.0/lv.hx/lv.hz : 0.0;
+    case der23:
+      return (ny > 1 && nz > 1) ? (MG_U(0,1,1) - MG_U(0,1,-1) - MG_U(0,-1,1)
+        + MG_U(0,-1,-1))/4.0/lv.hy/lv.hz : 0.0;
+  }
+
+#undef MG_U
+#undef MG_D2
+
+  return 0.0;
+}
+
+/**
+ * @brief Derivative of an atom with respect to variable u_id at the
+ *  central point of its stencil
+ */
+real_t FASMultigrid::atomDiagDerivative(level_t & lv, const atom & a,
+  idx_t u_id, idx_t idx)
+{
+  if(a.type == const_f || a.u_id != u_id)
+    return 0.0;
+
+  switch(a.type)
+  {
+    case poly:
+      return a.value*std::pow(lv.u[u_id][idx], a.value - 1.0);
+    case der11:
+      return lv.nx > 1 ? -2.0/lv.hx/lv.hx : 0.0;
+    case der22:
+      return lv.ny > 1 ? -2.0/lv.hy/lv.hy : 0.0;
+    case der33:
+      return lv.nz > 1 ? -2.0/lv.hz/lv.hz : 0.0;
+    case lap:
+      return (lv.nx > 1 ? -2.0/lv.hx/lv.hx : 0.0)
+        + (lv.ny > 1 ? -2.0/lv.hy/lv.hy : 0.0)
+        + (lv.nz > 1 ? -2.0/lv.hz/lv.hz : 0.0);
+  }
+
+  // first and mixed derivative stencils do not involve the central point
+  return 0.0;
+}
+
+/**
+ * @brief Evaluate equation e at a point, optionally also computing the
+ *  derivative of the equation with respect to u_e at that point.
+ */
+real_t FASMultigrid::evalEquation(idx_t lvl, idx_t e, idx_t i, idx_t j,
+  idx_t k, real_t * jacobian)
+{
+  level_t & lv = levels[lvl];
+  idx_t idx = H_INDEX(i, j, k, lv.nx, lv.ny, lv.nz);
+
+  real_t value = 0.0, jac = 0.0;
+  for(auto & mol : eqns[e])
+  {
+    idx_t n_atoms = mol.atoms.size();
+    real_t vals[MG_MAX_ATOMS];
+    real_t prod = mol.coef;
+    for(idx_t a=0; a<n_atoms; ++a)
+    {
+      vals[a] = atomValue(lv, mol.atoms[a], mol, lvl, i, j, k, idx);
+      prod *= vals[a];
+    }
+    value += prod;
+
+    if(jacobian != nullptr)
+    {
+      // product rule
+      for(idx_t a=0; a<n_atoms; ++a)
+      {
+        real_t d = atomDiagDerivative(lv, mol.atoms[a], e, idx);
+        if(d == 0.0)
+          continue;
+        real_t others = mol.coef;
+        for(idx_t b=0; b<n_atoms; ++b)
+          if(b != a)
+            others *= vals[b];
+        jac += d*others;
+      }
+    }
+  }
+
+  if(jacobian != nullptr)
+    *jacobian = jac;
+  return value;
+}
+
+/**
+ * @brief Multi-colored nonlinear Gauss-Seidel-Newton sweeps
+ * @details Points of a color only couple to other colors if every
+ *  non-trivial direction has an even number of points; a level with an
+ *  odd direction (only possible on the finest grid) is relaxed serially,
+ *  in lexicographic order.
+ */
+void FASMultigrid::relax(idx_t lvl, idx_t sweeps)
+{
+  level_t & lv = levels[lvl];
+  idx_t i, j, k;
+
+  if( (lv.nx > 1 && lv.nx % 2 != 0) || (lv.ny > 1 && lv.ny % 2 != 0)
+    || (lv.nz > 1 && lv.nz % 2 != 0) )
+  {
+    for(idx_t s=0; s<sweeps; ++s)
+      for(idx_t e=0; e<num_vars; ++e)
+      {
+        real_t * RESTRICT u = lv.u[e];
+        real_t * RESTRICT rho = lv.rho[e];
+        for(i=0; i<lv.nx; ++i)
+          for(j=0; j<lv.ny; ++j)
+            for(k=0; k<lv.nz; ++k)
+            {
+              idx_t idx = H_INDEX(i, j, k, lv.nx, lv.ny, lv.nz);
+              real_t jac = 0.0;
+              real_t r = evalEquation(lvl, e, i, j, k, &jac) - rho[idx];
+              if(jac != 0.0)
+                u[idx] -= r/jac;
+            }
+      }
+    return;
+  }
+
+  for(idx_t s=0; s<sweeps; ++s)
+    for(idx_t color=0; color<num_colors; ++color)
+      for(idx_t e=0; e<num_vars; ++e)
+      {
+        real_t * RESTRICT u = lv.u[e];
+        real_t * RESTRICT rho = lv.rho[e];
+        if(num_colors == 2)
+        {
+          // red-black: (i + j + k) % 2 == color
+#         pragma omp parallel for default(shared) private(i,j,k) collapse(2)
+          for(i=0; i<lv.nx; ++i)
+            for(j=0; j<lv.ny; ++j)
+              for(k=(color + i + j) % 2; k<lv.nz; k+=2)
+              {
+                idx_t idx = H_INDEX(i, j, k, lv.nx, lv.ny, lv.nz);
+                real_t jac = 0.0;
+                real_t r = evalEquation(lvl, e, i, j, k, &jac) - rho[idx];
+                if(jac != 0.0)
+                  u[idx] -= r/jac;
+              }
+        }
+        else
+        {
+          // color given by parity in each direction
+#         pragma omp parallel for default(shared) private(i,j,k) collapse(2)
+          for(i=color % 2; i<lv.nx; i+=2)
+            for(j=(color/2) % 2; j<lv.ny; j+=2)
+              for(k=color/4; k<lv.nz; k+=2)
+              {
+                idx_t idx = H_INDEX(i, j, k, lv.nx, lv.ny, lv.nz);
+                real_t jac = 0.0;
+                real_t r = evalEquation(lvl, e, i, j, k, &jac) - rho[idx];
+                if(jac != 0.0)
+                  u[idx] -= r/jac;
+              }
+        }
+      }
+}
+
+/**
+ * @brief Evaluate the (nonlinear) operator of each equation into out
+ */
+void FASMultigrid::computeOperator(idx_t lvl, std::vector<real_t *> & out)
+{
+  level_t & lv = levels[lvl];
+  idx_t i, j, k;
+
+  for(idx_t e=0; e<num_vars; ++e)
+  {
+    real_t * RESTRICT o = out[e];
+#   pragma omp parallel for default(shared) private(i,j,k) collapse(2)
+    for(i=0; i<lv.nx; ++i)
+      for(j=0; j<lv.ny; ++j)
+        for(k=0; k<lv.nz; ++k)
+          o[H_INDEX(i, j, k, lv.nx, lv.ny, lv.nz)] = evalEquation(lvl, e, i, j, k, nullptr);
+  }
+}
+
+/**
+ * @brief res = rho - L(u)
+ */
+void FASMultigrid::computeResidual(idx_t lvl)
+{
+  level_t & lv = levels[lvl];
+  computeOperator(lvl, lv.res);
+
+  idx_t idx;
+  for(idx_t e=0; e<num_vars; ++e)
+  {
+    real_t * RESTRICT res = lv.res[e];
+    real_t * RESTRICT rho = lv.rho[e];
+#   pragma omp parallel for default(shared) private(idx)
+    for(idx=0; idx<lv.pts; ++idx)
+      res[idx] = rho[idx] - res[idx];
+  }
+}
+
+/**
+ * @brief RMS residual over all equations on a level
+ */
+real_t FASMultigrid::residualNorm(idx_t lvl)
+{
+  level_t & lv = levels[lvl];
+  computeResidual(lvl);
+
+  real_t sum = 0.0;
+  idx_t idx;
+  for(idx_t e=0; e<num_vars; ++e)
+  {
+    real_t * RESTRICT res = lv.res[e];
+#   pragma omp parallel for default(shared) private(idx) reduction(+:sum)
+    for(idx=0; idx<lv.pts; ++idx)
+      sum += res[idx]*res[idx];
+  }
+
+  return std::sqrt(sum/lv.pts/num_vars);
+}
+
+real_t FASMultigrid::getResidualNorm()
+{
+  if(!src_restricted)
+    initializeRhoHeirarchy();
+  return residualNorm(0);
+}
+
+/**
+ * @brief Full-weighting restriction from level fine_lvl to fine_lvl+1
+ */
+void FASMultigrid::restrictField(idx_t fine_lvl, real_t * fine, real_t * coarse)
+{
+  level_t & f = levels[fine_lvl];
+  level_t & c = levels[fine_lvl+1];
+  const idx_t sx = f.nx > 1, sy = f.ny > 1, sz = f.nz > 1;
+  const real_t w[3] = {0.25, 0.5, 0.25};
+  idx_t I, J, K;
+
+# pragma omp parallel for default(shared) private(I,J,K) collapse(2)
+  for(I=0; I<c.nx; ++I)
+    for(J=0; J<c.ny; ++J)
+      for(K=0; K<c.nz; ++K)
+      {
+        real_t sum = 0.0;
+        for(idx_t di=-sx; di<=sx; ++di)
+          for(idx_t dj=-sy; dj<=sy; ++dj)
+            for(idx_t dk=-sz; dk<=sz; ++dk)
+            {
+              real_t wt = (sx ? w[di+1] : 1.0)*(sy ? w[dj+1] : 1.0)*(sz ? w[dk+1] : 1.0);
+              sum += wt*fine[H_INDEX((1+sx)*I+di, (1+sy)*J+dj, (1+sz)*K+dk, f.nx, f.ny, f.nz)];
+            }
+        coarse[H_INDEX(I, J, K, c.nx, c.ny, c.nz)] = sum;
+      }
+}
+
+/**
+ * @brief Trilinear prolongation from level coarse_lvl to coarse_lvl-1,
+ *  added to the fine field
+ */
+void FASMultigrid::prolongAddField(idx_t coarse_lvl, real_t * coarse, real_t * fine)
+{
+  level_t & f = levels[coarse_lvl-1];
+  level_t & c = levels[coarse_lvl];
+  const bool sx = f.nx > 1, sy = f.ny > 1, sz = f.nz > 1;
+  idx_t i, j, k;
+
+# pragma omp parallel for default(shared) private(i,j,k) collapse(2)
+  for(i=0; i<f.nx; ++i)
+    for(j=0; j<f.ny; ++j)
+      for(k=0; k<f.nz; ++k)
+      {
+        // coarse neighbors and weights in each direction
+        idx_t ci[2] = {sx ? i/2 : i, sx ? (i+1)/2 : i};
+        idx_t cj[2] = {sy ? j/2 : j, sy ? (j+1)/2 : j};
+        idx_t ck[2] = {sz ? k/2 : k, sz ? (k+1)/2 : k};
+        idx_t ni = (sx && i % 2) ? 2 : 1;
+        idx_t nj = (sy && j % 2) ? 2 : 1;
+        idx_t nk = (sz && k % 2) ? 2 : 1;
+        real_t wt = 1.0/(ni*nj*nk);
+
+        real_t sum = 0.0;
+        for(idx_t a=0; a<ni; ++a)
+          for(idx_t b=0; b<nj; ++b)
+            for(idx_t d=0; d<nk; ++d)
+              sum += coarse[H_INDEX(ci[a], cj[b], ck[d], c.nx, c.ny, c.nz)];
+        fine[H_INDEX(i, j, k, f.nx, f.ny, f.nz)] += wt*sum;
+      }
+}
+
+void FASMultigrid::removeMeans(idx_t lvl)
+{
+  level_t & lv = levels[lvl];
+  idx_t idx;
+  for(idx_t v=0; v<num_vars; ++v)
+  {
+    if(!zero_mean[v])
+      continue;
+
+    real_t * RESTRICT u = lv.u[v];
+    real_t mean = 0.0;
+#   pragma omp parallel for default(shared) private(idx) reduction(+:mean)
+    for(idx=0; idx<lv.pts; ++idx)
+      mean += u[idx];
+    mean /= lv.pts;
+#   pragma omp parallel for default(shared) private(idx)
+    for(idx=0; idx<lv.pts; ++idx)
+      u[idx] -= mean;
+  }
+}
+
+/**
+ * @brief Relax on the coarsest level until the residual drops well below
+ *  tolerance (or a fixed sweep limit is reached)
+ */
+void FASMultigrid::coarseSolve(idx_t lvl)
+{
+  ctx->timer["multigrid_level_" + std::to_string(lvl)].start();
+  idx_t max_sweeps = 50*relax_iters + 50;
+  for(idx_t s=0; s<max_sweeps; s += relax_iters)
+  {
+    relax(lvl, relax_iters);
+    if(residualNorm(lvl) < relaxation_tolerance/10.0)
+      break;
+  }
+  ctx->timer["multigrid_level_" + std::to_string(lvl)].stop();
+}
+
+/**
+ * @brief One FAS cycle starting from level lvl; gamma = 1 for a V-cycle,
+ *  2 for a W-cycle.
+ */
+void FASMultigrid::cycle(idx_t lvl, idx_t gamma)
+{
+  if(lvl == num_levels-1)
+  {
+    coarseSolve(lvl);
+    return;
+  }
+
+  level_t & f = levels[lvl];
+  level_t & c = levels[lvl+1];
+  std::string timer_name = "multigrid_level_" + std::to_string(lvl);
+
+  ctx->timer[timer_name].start();
+  relax(lvl, relax_iters);
+  computeResidual(lvl);
+
+  // coarse-grid FAS right-hand side: L_c(R u) + R(rho - L u)
+  for(idx_t v=0; v<num_vars; ++v)
+  {
+    restrictField(lvl, f.u[v], c.u[v]);
+    std::copy(c.u[v], c.u[v] + c.pts, c.u_tilde[v]);
+    restrictField(lvl, f.res[v], c.res[v]);
+  }
+  computeOperator(lvl+1, c.rho);
+  idx_t idx;
+  for(idx_t v=0; v<num_vars; ++v)
+  {
+    real_t * RESTRICT rho = c.rho[v];
+    real_t * RESTRICT res = c.res[v];
+#   pragma omp parallel for default(shared) private(idx)
+    for(idx=0; idx<c.pts; ++idx)
+      rho[idx] += res[idx];
+  }
+  ctx->timer[timer_name].stop();
+
+  for(idx_t g=0; g<gamma; ++g)
+    cycle(lvl+1, gamma);
+
+  ctx->timer[timer_name].start();
+  // coarse-grid correction
+  for(idx_t v=0; v<num_vars; ++v)
+  {
+    real_t * RESTRICT u = c.u[v];
+    real_t * RESTRICT u_tilde = c.u_tilde[v];
+#   pragma omp parallel for default(shared) private(idx)
+    for(idx=0; idx<c.pts; ++idx)
+      u_tilde[idx] = u[idx] - u_tilde[idx];
+    prolongAddField(lvl+1, c.u_tilde[v], f.u[v]);
+  }
+  relax(lvl, relax_iters);
+  ctx->timer[timer_name].stop();
+}
+
+real_t FASMultigrid::runCycles(idx_t num_cycles, idx_t gamma, std::string name)
+{
+  if(!src_restricted)
+    initializeRhoHeirarchy();
+
+  real_t res = residualNorm(0);
+  iodata->log("Multigrid: " + stringify(num_levels)
+    + " levels, initial residual " + stringify(res));
+  for(idx_t n=0; n<num_cycles && res > relaxation_tolerance; ++n)
+  {
+    cycle(0, gamma);
+    removeMeans(0);
+    res = residualNorm(0);
+    iodata->log("  " + name + "-cycle " + stringify(n+1) + ": residual "
+      + stringify(res));
+  }
+
+  return res;
+}
+
+/**
+ * @brief Perform up to num_cycles V-cycles
+ * @return final RMS residual
+ */
+real_t FASMultigrid::VCycles(idx_t num_cycles)
+{
+  return runCycles(num_cycles, 1, "V");
+}
+
+/**
+ * @brief Perform up to num_cycles W-cycles
+ * @return final RMS residual
+ */
+real_t FASMultigrid::WCycles(idx_t num_cycles)
+{
+  return runCycles(num_cycles, 2, "W");
+}
+
+/**
+ * @brief Full multigrid: solve on the coarsest grid, then interpolate and
+ *  V-cycle on each successively finer grid; follow with up to num_cycles
+ *  V-cycles on the finest grid.
+ * @return final RMS residual
+ */
+real_t FASMultigrid::FMGCycle(idx_t num_cycles)
+{
+  if(!src_restricted)
+    initializeRhoHeirarchy();
+
+  // restrict initial guess to all levels
+  for(idx_t l=0; l<num_levels-1; ++l)
+    for(idx_t v=0; v<num_vars; ++v)
+      restrictField(l, levels[l].u[v], levels[l+1].u[v]);
+
+  // each level solves the discrete problem directly (rho = 0)
+  for(idx_t l=num_levels-1; l>=0; --l)
+  {
+    level_t & lv = levels[l];
+    for(idx_t v=0; v<num_vars; ++v)
+      std::fill(lv.rho[v], lv.rho[v] + lv.pts, 0.0);
+
+    if(l == num_levels-1)
+    {
+      coarseSolve(l);
+      continue;
+    }
+
+    level_t & c = levels[l+1];
+    idx_t idx;
+    for(idx_t v=0; v<num_vars; ++v)
+    {
+      restrictField(l, lv.u[v], c.u_tilde[v]);
+      real_t * RESTRICT u = c.u[v];
+      real_t * RESTRICT u_tilde = c.u_tilde[v];
+#     pragma omp parallel for default(shared) private(idx)
+      for(idx=0; idx<c.pts; ++idx)
+        u_tilde[idx] = u[idx] - u_tilde[idx];
+      prolongAddField(l+1, c.u_tilde[v], lv.u[v]);
+    }
+    cycle(l, 1);
+    removeMeans(l);
+  }
+
+  return runCycles(num_cycles, 1, "V");
+}
+
+/**
+ * @brief Solve using the given cycle type ("V", "W", or "FMG")
+ * @return final RMS residual
+ */
+real_t FASMultigrid::solve(std::string cycle_type, idx_t num_cycles)
+{
+  if(cycle_type == "W")
+    return WCycles(num_cycles);
+  if(cycle_type == "FMG")
+    return FMGCycle(num_cycles);
+  return VCycles(num_cycles);
+}
+
+} // namespace cosmo
@@ -0,0 +1,141 @@
+#ifndef COSMO_UTILS_FAS_MULTIGRID_H
+#define COSMO_UTILS_FAS_MULTIGRID_H
+
+#include "../cosmo_includes.h"
+#include "../cosmo_types.h"
+#include "../cosmo_macros.h"
+#include "SimContext.h"
+#include "../IO/IOData.h"
+
+#define MG_MAX_ATOMS 16
+
+namespace cosmo
+{
+
+/**
+ * @brief A single factor in a term ("molecule") of an elliptic equation.
+ * @details type is one of FASMultigrid::atom_type; u_id is the variable the
+ *  atom acts on; value is the exponent of a "poly" atom.
+ */
+typedef struct {
+  int type;
+  idx_t u_id;
+  real_t value;
+} atom;
+
+/**
+ * @brief A term in an elliptic equation: coefficient times a product of atoms
+ */
+class molecule
+{
+public:
+  real_t coef;
+  std::vector<atom> atoms;
+  std::vector<real_t *> src; ///< per-level values of a "const_f" atom
+
+  molecule() : coef(0) {}
+
+  void init(idx_t n_atoms, real_t coef_in)
+  {
+    coef = coef_in;
+    atoms.clear();
+    atoms.reserve(n_atoms);
+  }
+
+  void add_atom(atom atom_in)
+  {
+    if(atoms.size() >= MG_MAX_ATOMS)
+    {
+      std::cerr << "Error: too many atoms in multigrid molecule.\n";
+      throw -1;
+    }
+    atoms.push_back(atom_in);
+  }
+};
+
+/**
+ * @brief Full-approximation-scheme (FAS) multigrid solver for systems of
+ *  nonlinear elliptic equations on a periodic grid.
+ * @details Equation e is written as a sum of molecules,
+ *    \sum_m coef_m \prod_a atom_a = 0,
+ *  and is relaxed for variable u_e. Atoms are derivatives (2nd-order
+ *  stencils), powers of a variable, or a spatially varying coefficient set
+ *  using setPolySrcAtPt. Smoothing is multi-colored (red-black, or 8 colors
+ *  when mixed derivatives are present) nonlinear Gauss-Seidel-Newton.
+ *  V, W, and full multigrid (FMG) cycles are supported; cycling stops once
+ *  the RMS residual on the finest grid drops below relaxation_tolerance.
+ *  Time spent on each level is recorded in the timers of the simulation context,
+ *  ctx->timer["multigrid_level_<l>"], and cycle progress is written to the
+ *  simulation log.
+ */
+class FASMultigrid
+{
+public:
+  enum atom_type { const_f = 0, poly = 1, der1 = 2, der2 = 3, der3 = 4,
+    lap = 5, der11 = 6, der12 = 7, der13 = 8, der22 = 9, der23 = 10, der33 = 11 };
+
+  std::vector< std::vector<molecule> > eqns; ///< eqns[eqn][molecule]
+
+  FASMultigrid(IOData * iodata_in, arr_t * u_in, idx_t num_vars_in,
+    idx_t molecule_n[], idx_t max_depth_in, idx_t relax_iters_in,
+    real_t relaxation_tolerance_in);
+  ~FASMultigrid();
+
+  void setPolySrcAtPt(idx_t eqn_id, idx_t mol_id, idx_t i, idx_t j, idx_t k,
+    real_t value);
+  void initializeRhoHeirarchy();
+  void enforceZeroMean(idx_t u_id);
+
+  real_t VCycles(idx_t num_cycles);
+  real_t WCycles(idx_t num_cycles);
+  real_t FMGCycle(idx_t num_cycles);
+  real_t solve(std::string cycle_type, idx_t num_cycles);
+
+  real_t getResidualNorm();
+  idx_t getNumLevels() { return num_levels; }
+
+private:
+  struct level_t {
+    idx_t nx, ny, nz, pts;
+    real_t hx, hy, hz;
+    std::vector<real_t *> u;       ///< solution (user arrays on the finest level)
+    std::vector<real_t *> u_tilde; ///< restricted fine-grid solution
+    std::vector<real_t *> rho;     ///< FAS right-hand side
+    std::vector<real_t *> res;     ///< residual scratch space
+  };
+
+  IOData * iodata;
+  SimContext * ctx;
+  arr_t * u_user;
+  idx_t num_vars;
+  idx_t num_levels;
+  idx_t relax_iters;
+  real_t relaxation_tolerance;
+  idx_t num_colors;
+  bool src_restricted;
+  std::vector<level_t> levels;
+  std::vector<bool> zero_mean;
+
+  real_t atomValue(level_t & lv, const atom & a, molecule & mol, idx_t lvl,
+    idx_t i, idx_t j, idx_t k, idx_t idx);
+  real_t atomDiagDerivative(level_t & lv, const atom & a, idx_t u_id,
+    idx_t idx);
+  real_t evalEquation(idx_t lvl, idx_t e, idx_t i, idx_t j, idx_t k,
+    real_t * jacobian);
+
+  void setColors();
+  void relax(idx_t lvl, idx_t sweeps);
+  void computeResidual(idx_t lvl);
+  void computeOperator(idx_t lvl, std::vector<real_t *> & out);
+  real_t residualNorm(idx_t lvl);
+  void restrictField(idx_t fine_lvl, real_t * fine, real_t * coarse);
+  void prolongAddField(idx_t coarse_lvl, real_t * coarse, real_t * fine);
+  void removeMeans(idx_t lvl);
+  void coarseSolve(idx_t lvl);
+  void cycle(idx_t lvl, idx_t gamma);
+  real_t runCycles(idx_t num_cycles, idx_t gamma, std::string name);
+};
+
+} // namespace cosmo
+
+#endif
@@ -81,6 +81,28 @@ public:
   RT get_alpha() { return alpha_get; }
   RT get_rho() { return rho_get; }
   RT get_S() { return S_get; }
+  int get_num_fluids() { return num_fluids; }
+  std::pair<RT,RT> get_fluid(int n) { return fluids[n]; }
+
+  /**
+   * @brief Set returned ("get") variables to a linear interpolation between
+   * those of a previous state (theta = 0) and the current state (theta = 1);
+   * the integrator state is unchanged.
+   */
+  void set_interpolated(FRW<RT> & start, RT theta)
+  {
+    phi_get = (1.0 - theta)*start.phi + theta*phi;
+    K_get = (1.0 - theta)*start.K + theta*K;
+    alpha_get = (1.0 - theta)*start.alpha + theta*alpha;
+    rho_get = 0.0;
+    S_get = 0.0;
+    for(int n=0; n<num_fluids; ++n)
+    {
+      RT rho = (1.0 - theta)*start.fluids[n].first + theta*fluids[n].first;
+      rho_get += rho;
+      S_get += 3.0*rho*fluids[n].second;
+    }
+  }
 
   // RK calculations
   void P1_step(RT h);
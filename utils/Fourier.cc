@@ -7,10 +7,21 @@ namespace cosmo
 Fourier::Fourier()
 {
   // template for initialization; see Fourier::Initialize.
+#if USE_MPI
+  distributed = nullptr;
+#endif
 }
 
 Fourier::~Fourier()
 {
+#if USE_MPI
+  if(distributed != nullptr)
+  {
+    delete distributed;
+    return;
+  }
+#endif
+
   // dealloc
 #if USE_LONG_DOUBLES
   fftwl_free(f_field);
@@ -13,7 +13,7 @@
 #include <iostream>
 #include "../cosmo_macros.h"
 #include "../cosmo_types.h"
-#include "../cosmo_globals.h"
+#include "DistributedFourier.h"
 
 namespace cosmo
 {
@@ -42,11 +42,16 @@ public:
   fftw_plan p_r2c;
 #endif
 
+#if USE_MPI
+  // transforms of the decomposed grid; set by Initialize
+  DistributedFourier *distributed;
+#endif
+
   Fourier();
   ~Fourier();
 
   template<typename IT>
-  void Initialize(IT nx, IT ny, IT nz);
+  void Initialize(IT nx, IT ny, IT nz, int pencil_columns = 1);
   
   template<typename IT>
   void Initialize_1D(IT n);
@@ -64,6 +69,9 @@ public:
 
   template<typename IT, typename RT>
   void inverseLaplacian(RT *field);
+
+  template<typename IT, typename RT>
+  void deconvolveWindow(RT *field, int order);
 };
 
 
@@ -74,10 +82,19 @@ public:
  * @param nx points in x-direction
  * @param ny points in y-direction
  * @param nz points in z-direction
+ * @param pencil_columns with MPI, number of columns in the process grid
+ *  transforms are distributed over (1: slabs)
  */
 template<typename IT>
-void Fourier::Initialize(IT nx, IT ny, IT nz)
+void Fourier::Initialize(IT nx, IT ny, IT nz, int pencil_columns)
 {
+#if USE_MPI
+  // the grid is decomposed across processes; transforms are distributed
+  // over a process grid with pencil_columns columns
+  distributed = new DistributedFourier(pencil_columns);
+  return;
+#endif
+
   // create plans
 #if USE_LONG_DOUBLES
   //fftw_malloc
@@ -146,6 +163,14 @@ void Fourier::Initialize_1D(IT n)
 template<typename RT, typename IOT>
 void Fourier::powerDump(RT *in, IOT *iodata)
 {
+#if USE_MPI
+  if(distributed != nullptr)
+  {
+    distributed->powerDump(in, iodata);
+    return;
+  }
+#endif
+
   // Transform input array
   for(long int i=0; i<POINTS; ++i)
     double_field[i] = (fft_rt) in[i];
@@ -251,6 +276,14 @@ void Fourier::powerDump(RT *in, IOT *iodata)
 template<typename IT, typename RT>
 void Fourier::inverseLaplacian(RT *field)
 {
+#if USE_MPI
+  if(distributed != nullptr)
+  {
+    distributed->inverseLaplacian<IT, RT>(field);
+    return;
+  }
+#endif
+
   IT i, j, k;
   RT px, py, pz, pmag;
 
@@ -297,6 +330,71 @@ void Fourier::inverseLaplacian(RT *field)
     field[i] = (RT) double_field[i];
 }
 
+
+/**
+ * @brief Deconvolve the window of a separable mass-assignment scheme
+ * @details Divides a field by the Fourier transform of an order-p
+ *  B-spline assignment window, prod_d sinc(pi k_d / N_d)^p, where
+ *  p = 1, 2, 3, 4 for NGP, CIC, TSC, and PCS respectively.
+ *
+ * @param field field to deconvolve (in place)
+ * @param order order p of the assignment scheme
+ */
+template<typename IT, typename RT>
+void Fourier::deconvolveWindow(RT *field, int order)
+{
+#if USE_MPI
+  if(distributed != nullptr)
+  {
+    distributed->deconvolveWindow<IT, RT>(field, order);
+    return;
+  }
+#endif
+
+  IT i, j, k;
+
+  for(long int i=0; i<POINTS; ++i)
+    double_field[i] = (fft_rt) field[i];
+
+#if USE_LONG_DOUBLES
+  fftwl_execute_dft_r2c(p_r2c, double_field, f_field);
+#else
+  fftw_execute_dft_r2c(p_r2c, double_field, f_field);
+#endif
+
+  for(i=0; i<NX; i++)
+  {
+    RT ax = PI*(RT) (i<=NX/2 ? i : i-NX)/NX;
+    RT wx = ax == 0 ? 1.0 : std::sin(ax)/ax;
+    for(j=0; j<NY; j++)
+    {
+      RT ay = PI*(RT) (j<=NY/2 ? j : j-NY)/NY;
+      RT wy = ay == 0 ? 1.0 : std::sin(ay)/ay;
+      for(k=0; k<NZ/2+1; k++)
+      {
+        RT az = PI*(RT) k/NZ;
+        RT wz = az == 0 ? 1.0 : std::sin(az)/az;
+
+        IT fft_index = FFT_NP_INDEX(i,j,k);
+
+        RT window = std::pow(wx*wy*wz, order);
+
+        f_field[fft_index][0] /= window*POINTS;
+        f_field[fft_index][1] /= window*POINTS;
+      }
+    }
+  }
+
+#if USE_LONG_DOUBLES
+  fftwl_execute_dft_c2r(p_c2r, f_field, double_field);
+#else
+  fftw_execute_dft_c2r(p_c2r, f_field, double_field);
+#endif
+
+  for(long int i=0; i<POINTS; ++i)
+    field[i] = (RT) double_field[i];
+}
+
 } // namespace cosmo
 
 #endif
@@ -0,0 +1,64 @@
+#ifndef COSMO_UTILS_GRID_TILES_H
+#define COSMO_UTILS_GRID_TILES_H
+
+#include "../cosmo_macros.h"
+#include "../cosmo_types.h"
+
+namespace cosmo
+{
+
+/**
+ * @brief Partition of the grid into contiguous blocks of x-planes ("tiles")
+ * for task-based evolution
+ * @details Tiles are at least STENCIL_ORDER/2 planes wide, so a first
+ * derivative taken in a tile only reads points from that tile and its left
+ * and right neighbors (periodically). Tasks operating on tiles can then
+ * declare dependencies on one sentinel per tile and group of arrays, eg.
+ * depend(in: flux[tiles.left(t)], flux[t], flux[tiles.right(t)]).
+ */
+class GridTiles
+{
+  idx_t width;
+
+public:
+  int n_tiles;
+
+  /**
+   * @param tile_width requested number of x-planes per tile; the last tile
+   * absorbs any remainder.
+   */
+  GridTiles(idx_t tile_width)
+  {
+    if(tile_width < STENCIL_ORDER/2)
+      tile_width = STENCIL_ORDER/2;
+
+    n_tiles = NX/tile_width;
+    if(n_tiles < 1)
+      n_tiles = 1;
+    width = NX/n_tiles;
+  }
+
+  idx_t begin(int t)
+  {
+    return t*width;
+  }
+
+  idx_t end(int t)
+  {
+    return t == n_tiles - 1 ? NX : (t+1)*width;
+  }
+
+  int left(int t)
+  {
+    return (t - 1 + n_tiles) % n_tiles;
+  }
+
+  int right(int t)
+  {
+    return (t + 1) % n_tiles;
+  }
+};
+
+} // namespace cosmo
+
+#endif
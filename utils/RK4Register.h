@@ -175,6 +175,51 @@ class RK4Register
       swap_a_c();
     }
 
+    /**
+     * @brief Apply the update of K<n>Finalize to points in [begin, end)
+     * @details Registers are not swapped; call swap_a_c once all points
+     * have been finalized. Intended for use within a task, so no OpenMP
+     * loop is used.
+     *
+     * @param n RK substep (1-4)
+     */
+    void KFinalizePoints(int n, IT begin, IT end)
+    {
+      IT i;
+      switch(n)
+      {
+        case 1:
+          for(i=begin; i<end; ++i)
+          {
+            _array_f[i] += sim_dt*_array_c[i]/6.0;
+            _array_c[i] = _array_p[i] + sim_dt*_array_c[i]/2.0;
+          }
+          break;
+        case 2:
+          for(i=begin; i<end; ++i)
+          {
+            _array_f[i] += sim_dt*_array_c[i]/3.0;
+            _array_c[i] = _array_p[i] + sim_dt*_array_c[i]/2.0;
+          }
+          break;
+        case 3:
+          for(i=begin; i<end; ++i)
+          {
+            _array_f[i] += sim_dt*_array_c[i]/3.0;
+            _array_c[i] = _array_p[i] + sim_dt*_array_c[i];
+          }
+          break;
+        case 4:
+          for(i=begin; i<end; ++i)
+          {
+            _array_f[i] += sim_dt*_array_c[i]/6.0 + _array_p[i];
+            _array_c[i] = _array_f[i];
+            _array_p[i] = _array_f[i];
+          }
+          break;
+      }
+    }
+
     RT& _p(const IT & i, const IT & j, const IT & k) { return _array_p(i, j, k); }
     RT& _a(const IT & i, const IT & j, const IT & k) { return _array_a(i, j, k); }
     RT& _c(const IT & i, const IT & j, const IT & k) { return _array_c(i, j, k); }
@@ -0,0 +1,69 @@
+#ifndef COSMO_UTILS_SIM_CONTEXT_H
+#define COSMO_UTILS_SIM_CONTEXT_H
+
+#include "../cosmo_macros.h"
+#include "../cosmo_types.h"
+#include "ConfigParser.h"
+#include "Timer.h"
+
+#include <string>
+
+namespace cosmo
+{
+
+/**
+ * @brief State belonging to a single simulation: configuration, timers,
+ * grid spacing, and step size
+ * @details A context is created for each simulation and passed explicitly
+ *  to the simulation, its components, IO, and ICs; stencils (utils/math.h)
+ *  take the inverse grid spacing as an argument. Several simulations can
+ *  therefore coexist in one process. dx and dt should be changed through
+ *  setDx and setDt, which keep derived values up to date.
+ */
+class SimContext
+{
+public:
+  ConfigParser config;
+  TimerManager timer;
+
+  real_t dx; ///< grid spacing
+  real_t inv_dx; ///< 1/dx
+  real_t dt; ///< RK step size
+
+  SimContext()
+  {
+    setDx(H_LEN_FRAC/(1.0*COSMO_N));
+    setDt(0.1*dx);
+  }
+
+  /**
+   * @brief Read a config file, and set dx ("dx", default H_LEN_FRAC/N)
+   * and dt ("dt_frac" times dx, default 0.1) from it
+   *
+   * @param echo print parameters as they are read
+   */
+  void parse(std::string config_file, bool echo = true)
+  {
+    config.parse(config_file, echo);
+    if(config("dx", "") != "")
+      setDx(std::stold(config["dx"]));
+    else
+      setDx(H_LEN_FRAC/(1.0*COSMO_N));
+    setDt(std::stold(config("dt_frac", "0.1"))*dx);
+  }
+
+  void setDx(real_t dx_in)
+  {
+    dx = dx_in;
+    inv_dx = 1.0/dx;
+  }
+
+  void setDt(real_t dt_in)
+  {
+    dt = dt_in;
+  }
+};
+
+} // namespace cosmo
+
+#endif
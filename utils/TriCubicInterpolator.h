@@ -94,4 +94,96 @@ RT evaluate_interpolation(RT * a, RT x, RT y, RT z)
     + a[61]*P3(x)*P3(y)*z + a[62]*P3(x)*P3(y)*P2(z) + a[63]*P3(x)*P3(y)*P3(z);
 }
 
+/**
+ * @brief Power-basis matrices of 1D cubic interpolants through the values at
+ *  -1, 0, 1, 2: on [0, 1), f(u) = sum_p u^p sum_i M[p][i] f_i.
+ */
+template<typename RT>
+struct TriCubicBasis
+{
+  /// Lagrange interpolant, as in compute_tricubic_coeffs
+  static constexpr RT lagrange[4][4] = {
+    {      0.0,  1.0,  0.0,      0.0 },
+    { -1.0/3.0, -0.5,  1.0, -1.0/6.0 },
+    {      0.5, -1.0,  0.5,      0.0 },
+    { -1.0/6.0,  0.5, -0.5,  1.0/6.0 }
+  };
+  /// Catmull-Rom interpolant, as in CosmoArray::getTriCubicInterpolatedValue
+  static constexpr RT catmull_rom[4][4] = {
+    {  0.0,  1.0,  0.0,  0.0 },
+    { -0.5,  0.0,  0.5,  0.0 },
+    {  1.0, -2.5,  2.0, -0.5 },
+    { -0.5,  1.5, -1.5,  0.5 }
+  };
+};
+
+template<typename RT>
+constexpr RT TriCubicBasis<RT>::lagrange[4][4];
+template<typename RT>
+constexpr RT TriCubicBasis<RT>::catmull_rom[4][4];
+
+/**
+ * @brief Tricubic coefficients (same layout as compute_tricubic_coeffs) for
+ *  the tensor product of a 1D basis M, applied one direction at a time.
+ */
+template<typename RT>
+void compute_tricubic_coeffs_separable(RT * __restrict__ a,
+  const RT * __restrict__ f, const RT (&M)[4][4])
+{
+  RT t1[64], t2[64];
+  // z, then y, then x
+  for(int ij=0; ij<16; ++ij)
+    for(int p=0; p<4; ++p)
+      t1[4*ij + p] = M[p][0]*f[4*ij] + M[p][1]*f[4*ij+1]
+        + M[p][2]*f[4*ij+2] + M[p][3]*f[4*ij+3];
+  for(int i=0; i<4; ++i)
+    for(int p=0; p<4; ++p)
+      for(int k=0; k<4; ++k)
+        t2[16*i + 4*p + k] = M[p][0]*t1[16*i + k] + M[p][1]*t1[16*i + 4 + k]
+          + M[p][2]*t1[16*i + 8 + k] + M[p][3]*t1[16*i + 12 + k];
+  for(int p=0; p<4; ++p)
+    for(int jk=0; jk<16; ++jk)
+      a[16*p + jk] = M[p][0]*t2[jk] + M[p][1]*t2[16 + jk]
+        + M[p][2]*t2[32 + jk] + M[p][3]*t2[48 + jk];
+}
+
+/**
+ * @brief Evaluate n_fields tricubic polynomials (64 coefficients each, in a)
+ *  on the lattice (i/n1, j/n2, k/n3), 0 <= i < n1, etc.
+ * @details Powers of x and y are eliminated by Horner's rule once per
+ *  lattice line; the innermost loop over k is vectorizable. Results for
+ *  field f are stored at out[f*n1*n2*n3 + (i*n2 + j)*n3 + k].
+ */
+template<typename IT, typename RT>
+void evaluate_interpolation_lattice(IT n_fields, const RT * a,
+  IT n1, IT n2, IT n3, RT * __restrict__ out)
+{
+  const IT n_pts = n1*n2*n3;
+  for(IT f=0; f<n_fields; ++f)
+  {
+    const RT * af = a + 64*f;
+    for(IT i=0; i<n1; ++i)
+    {
+      RT x = (RT) i / (RT) n1;
+      RT b[16];
+      for(int q=0; q<16; ++q)
+        b[q] = ((af[48+q]*x + af[32+q])*x + af[16+q])*x + af[q];
+      for(IT j=0; j<n2; ++j)
+      {
+        RT y = (RT) j / (RT) n2;
+        RT c[4];
+        for(int r=0; r<4; ++r)
+          c[r] = ((b[12+r]*y + b[8+r])*y + b[4+r])*y + b[r];
+        RT * o = out + f*n_pts + (i*n2 + j)*n3;
+#pragma omp simd
+        for(IT k=0; k<n3; ++k)
+        {
+          RT z = (RT) k / (RT) n3;
+          o[k] = ((c[3]*z + c[2])*z + c[1])*z + c[0];
+        }
+      }
+    }
+  }
+}
+
 #endif
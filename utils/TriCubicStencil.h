@@ -0,0 +1,180 @@
+#ifndef COSMO_UTILS_TRICUBIC_STENCIL_H
+#define COSMO_UTILS_TRICUBIC_STENCIL_H
+
+namespace cosmo
+{
+
+/**
+ * @brief Precomputed Catmull-Rom (tricubic) interpolation stencil for a point
+ *  on a periodic grid.
+ * @details Computes the 4x4x4 periodic stencil offsets and separable weights
+ *  for a point once, so that any number of fields sharing the grid can be
+ *  interpolated there without heap allocation or repeated index wrapping.
+ *  Gives the same interpolant as CosmoArray::getTriCubicInterpolatedValue
+ *  (up to round-off). Coordinates are in grid-index units, as are the
+ *  gradients returned by interpolateWithGradient.
+ */
+template<typename IT, typename RT>
+class TriCubicStencil
+{
+public:
+  IT ox[4], oy[4], oz[4]; ///< flattened offsets along each direction
+  RT wx[4], wy[4], wz[4]; ///< interpolation weights
+  RT dwx[4], dwy[4], dwz[4]; ///< weight derivatives (if requested)
+
+  TriCubicStencil() {}
+
+  TriCubicStencil(RT x, RT y, RT z, IT nx, IT ny, IT nz,
+    bool with_gradient = false)
+  {
+    set(x, y, z, nx, ny, nz, with_gradient);
+  }
+
+  static void weights(RT u, RT * w)
+  {
+    w[0] = 0.5*(u*u*(2.0 - u) - u);
+    w[1] = 0.5*(u*u*(3.0*u - 5.0) + 2.0);
+    w[2] = 0.5*(u*u*(4.0 - 3.0*u) + u);
+    w[3] = 0.5*u*u*(u - 1.0);
+  }
+
+  static void weightDerivatives(RT u, RT * dw)
+  {
+    dw[0] = 0.5*(u*(4.0 - 3.0*u) - 1.0);
+    dw[1] = 0.5*u*(9.0*u - 10.0);
+    dw[2] = 0.5*(u*(8.0 - 9.0*u) + 1.0);
+    dw[3] = 0.5*u*(3.0*u - 2.0);
+  }
+
+  /**
+   * @brief Set periodic offsets and weights along one direction
+   */
+  static void setAxis(RT x, IT n, IT stride, IT * o, RT * w, RT * dw)
+  {
+    IT l = x < 0 ? (IT) x - 1 : (IT) x; // Index "left" of x
+    RT d = x - l;
+    for(IT a=0; a<4; ++a)
+    {
+      IT i = (l - 1 + a) % n;
+      if(i < 0) i += n;
+      o[a] = i*stride;
+    }
+    weights(d, w);
+    if(dw != nullptr)
+      weightDerivatives(d, dw);
+  }
+
+  void set(RT x, RT y, RT z, IT nx, IT ny, IT nz, bool with_gradient = false)
+  {
+    setAxis(x, nx, ny*nz, ox, wx, with_gradient ? dwx : nullptr);
+    setAxis(y, ny, nz, oy, wy, with_gradient ? dwy : nullptr);
+    setAxis(z, nz, 1, oz, wz, with_gradient ? dwz : nullptr);
+  }
+
+  /**
+   * @brief Interpolate a single field at the stencil point
+   */
+  RT interpolate(const RT * f) const
+  {
+    RT res = 0.0;
+    for(IT a=0; a<4; ++a)
+    {
+      RT res_y = 0.0;
+      for(IT b=0; b<4; ++b)
+      {
+        const RT * f_ab = f + ox[a] + oy[b];
+        res_y += wy[b]*( wz[0]*f_ab[oz[0]] + wz[1]*f_ab[oz[1]]
+                         + wz[2]*f_ab[oz[2]] + wz[3]*f_ab[oz[3]] );
+      }
+      res += wx[a]*res_y;
+    }
+    return res;
+  }
+
+  /**
+   * @brief Interpolate n_fields fields at the stencil point in one pass
+   */
+  void interpolate(IT n_fields, const RT * const * fields, RT * out) const
+  {
+    for(IT n=0; n<n_fields; ++n)
+      out[n] = 0.0;
+
+    for(IT a=0; a<4; ++a)
+      for(IT b=0; b<4; ++b)
+      {
+        const RT wab = wx[a]*wy[b];
+        const IT o_ab = ox[a] + oy[b];
+        for(IT n=0; n<n_fields; ++n)
+        {
+          const RT * f_ab = fields[n] + o_ab;
+          out[n] += wab*( wz[0]*f_ab[oz[0]] + wz[1]*f_ab[oz[1]]
+                          + wz[2]*f_ab[oz[2]] + wz[3]*f_ab[oz[3]] );
+        }
+      }
+  }
+
+  /**
+   * @brief Interpolate a field and its gradient (in index units); the
+   *  stencil must have been set with with_gradient = true.
+   */
+  void interpolateWithGradient(const RT * f, RT & val, RT * grad) const
+  {
+    val = 0.0;
+    grad[0] = 0.0; grad[1] = 0.0; grad[2] = 0.0;
+    for(IT a=0; a<4; ++a)
+      for(IT b=0; b<4; ++b)
+      {
+        const RT * f_ab = f + ox[a] + oy[b];
+        RT fz = 0.0, dfz = 0.0;
+        for(IT c=0; c<4; ++c)
+        {
+          fz += wz[c]*f_ab[oz[c]];
+          dfz += dwz[c]*f_ab[oz[c]];
+        }
+        val += wx[a]*wy[b]*fz;
+        grad[0] += dwx[a]*wy[b]*fz;
+        grad[1] += wx[a]*dwy[b]*fz;
+        grad[2] += wx[a]*wy[b]*dfz;
+      }
+  }
+
+  /**
+   * @brief Interpolate n_fields fields and their gradients (in index units)
+   *  in one pass; gradients of field n are stored in grads[3*n + 0..2].
+   *  The stencil must have been set with with_gradient = true.
+   */
+  void interpolateWithGradient(IT n_fields, const RT * const * fields,
+    RT * vals, RT * grads) const
+  {
+    for(IT n=0; n<n_fields; ++n)
+    {
+      vals[n] = 0.0;
+      grads[3*n] = 0.0; grads[3*n+1] = 0.0; grads[3*n+2] = 0.0;
+    }
+
+    for(IT a=0; a<4; ++a)
+      for(IT b=0; b<4; ++b)
+      {
+        const RT wab = wx[a]*wy[b], dxab = dwx[a]*wy[b], dyab = wx[a]*dwy[b];
+        const IT o_ab = ox[a] + oy[b];
+        for(IT n=0; n<n_fields; ++n)
+        {
+          const RT * f_ab = fields[n] + o_ab;
+          RT fz = 0.0, dfz = 0.0;
+          for(IT c=0; c<4; ++c)
+          {
+            fz += wz[c]*f_ab[oz[c]];
+            dfz += dwz[c]*f_ab[oz[c]];
+          }
+          vals[n] += wab*fz;
+          grads[3*n] += dxab*fz;
+          grads[3*n+1] += dyab*fz;
+          grads[3*n+2] += wab*dfz;
+        }
+      }
+  }
+};
+
+} // namespace cosmo
+
+#endif
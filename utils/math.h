@@ -4,7 +4,7 @@
 #include "../cosmo_macros.h"
 #include "../cosmo_types.h"
 #include "../cosmo_includes.h"
-#include "../cosmo_globals.h"
+#include "Decomposition.h"
 
 namespace cosmo
 {
@@ -31,9 +31,10 @@ namespace cosmo
  * @param j gridpoint in y-dir
  * @param k gridpoint in z-dir
  * @param field releavnt field
+ * @param inv_dx inverse grid spacing, 1/dx
  * @return dissipation factor
  */
-inline real_t KO_dissipation_Q(idx_t i, idx_t j, idx_t k, arr_t & field, real_t ko_coeff)
+inline real_t KO_dissipation_Q(idx_t i, idx_t j, idx_t k, arr_t & field, real_t ko_coeff, real_t inv_dx)
 {
   if(ko_coeff == 0)
     return 0;
@@ -45,8 +46,8 @@ inline real_t KO_dissipation_Q(idx_t i, idx_t j, idx_t k, arr_t & field, real_t
       + 6.0*field[INDEX(i  ,j,k)] + 6.0*field[INDEX(i,j  ,k)] + 6.0*field[INDEX(i,j,k  )]
       - 4.0*field[INDEX(i+1,j,k)] - 4.0*field[INDEX(i,j+1,k)] - 4.0*field[INDEX(i,j,k+1)]
       + 1.0*field[INDEX(i+2,j,k)] + 1.0*field[INDEX(i,j+2,k)] + 1.0*field[INDEX(i,j,k+2)]
-    )/pow(dx, 4.0);
-    real_t dissipation = ko_coeff*pow(dx, 3.0)/64.0*stencil;
+    );
+    real_t dissipation = ko_coeff*inv_dx/64.0*stencil;
     return dissipation;
 # endif
 
@@ -63,8 +64,8 @@ inline real_t KO_dissipation_Q(idx_t i, idx_t j, idx_t k, arr_t & field, real_t
       +  45.0*field[INDEX(i+3,j,k)] +  45.0*field[INDEX(i,j+3,k)] +  45.0*field[INDEX(i,j,k+3)]
       -  10.0*field[INDEX(i+4,j,k)] -  10.0*field[INDEX(i,j+4,k)] -  10.0*field[INDEX(i,j,k+4)]
       +   1.0*field[INDEX(i+5,j,k)] +   1.0*field[INDEX(i,j+5,k)] +   1.0*field[INDEX(i,j,k+5)]
-    )/pow(dx, 10.0);
-    real_t dissipation = -ko_coeff*pow(dx, 9.0)/1024.0*stencil;
+    );
+    real_t dissipation = -ko_coeff*inv_dx/1024.0*stencil;
     return dissipation;
 # endif
 
@@ -72,26 +73,26 @@ inline real_t KO_dissipation_Q(idx_t i, idx_t j, idx_t k, arr_t & field, real_t
 }
 
 inline real_t derivative_Odx2(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
   switch (d) {
     case 1:
       return ((
         - 1.0/2.0*field[INDEX(i-1,j,k)]
         + 1.0/2.0*field[INDEX(i+1,j,k)]
-      )/dx);
+      )*inv_dx);
       break;
     case 2:
       return ((
         - 1.0/2.0*field[INDEX(i,j-1,k)]
         + 1.0/2.0*field[INDEX(i,j+1,k)]
-      )/dx);
+      )*inv_dx);
       break;
     case 3:
       return ((
         - 1.0/2.0*field[INDEX(i,j,k-1)]
         + 1.0/2.0*field[INDEX(i,j,k+1)]
-      )/dx);
+      )*inv_dx);
       break;
   }
 
@@ -100,7 +101,7 @@ inline real_t derivative_Odx2(idx_t i, idx_t j, idx_t k, int d,
 }
 
 inline real_t forward_derivative_Odx2(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
   switch (d) {
     case 1:
@@ -108,21 +109,21 @@ inline real_t forward_derivative_Odx2(idx_t i, idx_t j, idx_t k, int d,
         - 1.0/2.0*field[INDEX(i+2,j,k)]
         + 2.0*field[INDEX(i+1,j,k)]
         - 3.0/2.0*field[INDEX(i,j,k)]
-      )/dx);
+      )*inv_dx);
       break;
     case 2:
       return ((
         - 1.0/2.0*field[INDEX(i,j+2,k)]
         + 2.0*field[INDEX(i,j+1,k)]
         - 3.0/2.0*field[INDEX(i,j,k)]
-      )/dx);
+      )*inv_dx);
       break;
     case 3:
       return ((
         - 1.0/2.0*field[INDEX(i,j,k+2)]
         + 2.0*field[INDEX(i,j,k+1)]
         - 3.0/2.0*field[INDEX(i,j,k)]
-      )/dx);
+      )*inv_dx);
       break;
   }
 
@@ -133,7 +134,7 @@ inline real_t forward_derivative_Odx2(idx_t i, idx_t j, idx_t k, int d,
 
 
 inline real_t backward_derivative_Odx2(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
   switch (d) {
     case 1:
@@ -141,21 +142,21 @@ inline real_t backward_derivative_Odx2(idx_t i, idx_t j, idx_t k, int d,
         + 1.0/2.0*field[INDEX(i-2,j,k)]
         - 2.0*field[INDEX(i-1,j,k)]
         + 3.0/2.0*field[INDEX(i,j,k)]
-      )/dx);
+      )*inv_dx);
       break;
     case 2:
       return ((
         + 1.0/2.0*field[INDEX(i,j-2,k)]
         - 2.0*field[INDEX(i,j-1,k)]
         + 3.0/2.0*field[INDEX(i,j,k)]
-      )/dx);
+      )*inv_dx);
       break;
     case 3:
       return ((
         + 1.0/2.0*field[INDEX(i,j,k-2)]
         - 2.0*field[INDEX(i,j,k-1)]
         + 3.0/2.0*field[INDEX(i,j,k)]
-      )/dx);
+      )*inv_dx);
       break;
   }
 
@@ -164,7 +165,7 @@ inline real_t backward_derivative_Odx2(idx_t i, idx_t j, idx_t k, int d,
 }
 
 inline real_t lop_forward_derivative_Odx2(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
   switch (d) {
     case 1:
@@ -172,21 +173,21 @@ inline real_t lop_forward_derivative_Odx2(idx_t i, idx_t j, idx_t k, int d,
         - 1.0/2.0*field[INDEX(i+2,j,k)]
         + 2.0*field[INDEX(i+1,j,k)]
         - 3.0/2.0*field[INDEX(i,j,k)]
-      )/dx);
+      )*inv_dx);
       break;
     case 2:
       return ((
         - 1.0/2.0*field[INDEX(i,j+2,k)]
         + 2.0*field[INDEX(i,j+1,k)]
         - 3.0/2.0*field[INDEX(i,j,k)]
-      )/dx);
+      )*inv_dx);
       break;
     case 3:
       return ((
         - 1.0/2.0*field[INDEX(i,j,k+2)]
         + 2.0*field[INDEX(i,j,k+1)]
         - 3.0/2.0*field[INDEX(i,j,k)]
-      )/dx);
+      )*inv_dx);
       break;
   }
 
@@ -197,7 +198,7 @@ inline real_t lop_forward_derivative_Odx2(idx_t i, idx_t j, idx_t k, int d,
 
 
 inline real_t lop_backward_derivative_Odx2(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
   switch (d) {
     case 1:
@@ -205,21 +206,21 @@ inline real_t lop_backward_derivative_Odx2(idx_t i, idx_t j, idx_t k, int d,
         + 1.0/2.0*field[INDEX(i-2,j,k)]
         - 2.0*field[INDEX(i-1,j,k)]
         + 3.0/2.0*field[INDEX(i,j,k)]
-      )/dx);
+      )*inv_dx);
       break;
     case 2:
       return ((
         + 1.0/2.0*field[INDEX(i,j-2,k)]
         - 2.0*field[INDEX(i,j-1,k)]
         + 3.0/2.0*field[INDEX(i,j,k)]
-      )/dx);
+      )*inv_dx);
       break;
     case 3:
       return ((
         + 1.0/2.0*field[INDEX(i,j,k-2)]
         - 2.0*field[INDEX(i,j,k-1)]
         + 3.0/2.0*field[INDEX(i,j,k)]
-      )/dx);
+      )*inv_dx);
       break;
   }
 
@@ -229,7 +230,7 @@ inline real_t lop_backward_derivative_Odx2(idx_t i, idx_t j, idx_t k, int d,
 
  
 inline real_t derivative_Odx4(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
   switch (d) {
     case 1:
@@ -238,7 +239,7 @@ inline real_t derivative_Odx4(idx_t i, idx_t j, idx_t k, int d,
         - 2.0/3.0*field[INDEX(i-1,j,k)]
         + 2.0/3.0*field[INDEX(i+1,j,k)]
         - 1.0/12.0*field[INDEX(i+2,j,k)]
-      )/dx;
+      )*inv_dx;
       break;
     case 2:
       return (
@@ -246,7 +247,7 @@ inline real_t derivative_Odx4(idx_t i, idx_t j, idx_t k, int d,
         - 2.0/3.0*field[INDEX(i,j-1,k)]
         + 2.0/3.0*field[INDEX(i,j+1,k)]
         - 1.0/12.0*field[INDEX(i,j+2,k)]
-      )/dx;
+      )*inv_dx;
       break;
     case 3:
       return (
@@ -254,7 +255,7 @@ inline real_t derivative_Odx4(idx_t i, idx_t j, idx_t k, int d,
         - 2.0/3.0*field[INDEX(i,j,k-1)]
         + 2.0/3.0*field[INDEX(i,j,k+1)]
         - 1.0/12.0*field[INDEX(i,j,k+2)]
-      )/dx;
+      )*inv_dx;
       break;
   }
 
@@ -263,7 +264,7 @@ inline real_t derivative_Odx4(idx_t i, idx_t j, idx_t k, int d,
 }
 
 inline real_t lop_forward_derivative_Odx4(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
   switch (d) {
     case 1:
@@ -273,7 +274,7 @@ inline real_t lop_forward_derivative_Odx4(idx_t i, idx_t j, idx_t k, int d,
         + 3.0/2.0*field[INDEX(i+1,j,k)]
         - 5.0/6.0*field[INDEX(i,j,k)]
         - 1.0/4.0*field[INDEX(i-1,j,k)]
-      )/dx;
+      )*inv_dx;
       break;
     case 2:
       return (
@@ -282,7 +283,7 @@ inline real_t lop_forward_derivative_Odx4(idx_t i, idx_t j, idx_t k, int d,
         + 3.0/2.0*field[INDEX(i,j+1,k)]
         - 5.0/6.0*field[INDEX(i,j,k)]
         - 1.0/4.0*field[INDEX(i,j-1,k)]
-      )/dx;
+      )*inv_dx;
       break;
     case 3:
       return (
@@ -291,7 +292,7 @@ inline real_t lop_forward_derivative_Odx4(idx_t i, idx_t j, idx_t k, int d,
         + 3.0/2.0*field[INDEX(i,j,k+1)]
         - 5.0/6.0*field[INDEX(i,j,k)]
         - 1.0/4.0*field[INDEX(i,j,k-1)]
-      )/dx;
+      )*inv_dx;
       break;
   }
 
@@ -300,7 +301,7 @@ inline real_t lop_forward_derivative_Odx4(idx_t i, idx_t j, idx_t k, int d,
 }
  
 inline real_t lop_backward_derivative_Odx4(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
   switch (d) {
     case 1:
@@ -310,7 +311,7 @@ inline real_t lop_backward_derivative_Odx4(idx_t i, idx_t j, idx_t k, int d,
         - 3.0/2.0*field[INDEX(i-1,j,k)]
         + 5.0/6.0*field[INDEX(i,j,k)]
         + 1.0/4.0*field[INDEX(i+1,j,k)]
-      )/dx;
+      )*inv_dx;
       break;
     case 2:
       return (
@@ -319,7 +320,7 @@ inline real_t lop_backward_derivative_Odx4(idx_t i, idx_t j, idx_t k, int d,
         - 3.0/2.0*field[INDEX(i,j-1,k)]
         + 5.0/6.0*field[INDEX(i,j,k)]
         + 1.0/4.0*field[INDEX(i,j+1,k)]
-      )/dx;
+      )*inv_dx;
       break;
     case 3:
       return (
@@ -328,7 +329,7 @@ inline real_t lop_backward_derivative_Odx4(idx_t i, idx_t j, idx_t k, int d,
         - 3.0/2.0*field[INDEX(i,j,k-1)]
         + 5.0/6.0*field[INDEX(i,j,k)]
         + 1.0/4.0*field[INDEX(i,j,k+1)]
-      )/dx;
+      )*inv_dx;
       break;
   }
 
@@ -337,7 +338,7 @@ inline real_t lop_backward_derivative_Odx4(idx_t i, idx_t j, idx_t k, int d,
 
 }
 inline real_t forward_derivative_Odx4(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
   switch (d) {
     case 1:
@@ -347,7 +348,7 @@ inline real_t forward_derivative_Odx4(idx_t i, idx_t j, idx_t k, int d,
         - 3.0*field[INDEX(i+2,j,k)]
         + 4.0*field[INDEX(i+1,j,k)]
         - 25.0/12.0*field[INDEX(i,j,k)]
-      )/dx;
+      )*inv_dx;
       break;
     case 2:
       return (
@@ -356,7 +357,7 @@ inline real_t forward_derivative_Odx4(idx_t i, idx_t j, idx_t k, int d,
         - 3.0*field[INDEX(i,j+2,k)]
         + 4.0*field[INDEX(i,j+1,k)]
         - 25.0/12.0*field[INDEX(i,j,k)]
-      )/dx;
+      )*inv_dx;
       break;
     case 3:
       return (
@@ -365,7 +366,7 @@ inline real_t forward_derivative_Odx4(idx_t i, idx_t j, idx_t k, int d,
         - 3.0*field[INDEX(i,j,k+2)]
         + 4.0*field[INDEX(i,j,k+1)]
         - 25.0/12.0*field[INDEX(i,j,k)]
-      )/dx;
+      )*inv_dx;
       break;
   }
 
@@ -374,7 +375,7 @@ inline real_t forward_derivative_Odx4(idx_t i, idx_t j, idx_t k, int d,
 }
 
 inline real_t backward_derivative_Odx4(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
   switch (d) {
     case 1:
@@ -384,7 +385,7 @@ inline real_t backward_derivative_Odx4(idx_t i, idx_t j, idx_t k, int d,
         + 3.0*field[INDEX(i-2,j,k)]
         - 4.0*field[INDEX(i-1,j,k)]
         + 25.0/12.0*field[INDEX(i,j,k)]
-      )/dx;
+      )*inv_dx;
       break;
     case 2:
       return (
@@ -393,7 +394,7 @@ inline real_t backward_derivative_Odx4(idx_t i, idx_t j, idx_t k, int d,
         + 3.0*field[INDEX(i,j-2,k)]
         - 4.0*field[INDEX(i,j-1,k)]
         + 25.0/12.0*field[INDEX(i,j,k)]
-      )/dx;
+      )*inv_dx;
       break;
     case 3:
       return (
@@ -402,7 +403,7 @@ inline real_t backward_derivative_Odx4(idx_t i, idx_t j, idx_t k, int d,
         + 3.0*field[INDEX(i,j,k-2)]
         - 4.0*field[INDEX(i,j,k-1)]
         + 25.0/12.0*field[INDEX(i,j,k)]
-      )/dx;
+      )*inv_dx;
       break;
   }
   return 0;
@@ -410,7 +411,7 @@ inline real_t backward_derivative_Odx4(idx_t i, idx_t j, idx_t k, int d,
 
               
 inline real_t derivative_Odx6(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
   switch (d) {
     case 1:
@@ -421,7 +422,7 @@ inline real_t derivative_Odx6(idx_t i, idx_t j, idx_t k, int d,
         + 3.0/4.0*field[INDEX(i+1,j,k)]
         - 3.0/20.0*field[INDEX(i+2,j,k)]
         + 1.0/60.0*field[INDEX(i+3,j,k)]
-      )/dx;
+      )*inv_dx;
       break;
     case 2:
       return (
@@ -431,7 +432,7 @@ inline real_t derivative_Odx6(idx_t i, idx_t j, idx_t k, int d,
         + 3.0/4.0*field[INDEX(i,j+1,k)]
         - 3.0/20.0*field[INDEX(i,j+2,k)]
         + 1.0/60.0*field[INDEX(i,j+3,k)]
-      )/dx;
+      )*inv_dx;
       break;
     case 3:
       return (
@@ -441,7 +442,7 @@ inline real_t derivative_Odx6(idx_t i, idx_t j, idx_t k, int d,
         + 3.0/4.0*field[INDEX(i,j,k+1)]
         - 3.0/20.0*field[INDEX(i,j,k+2)]
         + 1.0/60.0*field[INDEX(i,j,k+3)]
-      )/dx;
+      )*inv_dx;
       break;
   }
 
@@ -451,7 +452,7 @@ inline real_t derivative_Odx6(idx_t i, idx_t j, idx_t k, int d,
 
  
 inline real_t forward_derivative_Odx6(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
   switch (d) {
     case 1:
@@ -463,7 +464,7 @@ inline real_t forward_derivative_Odx6(idx_t i, idx_t j, idx_t k, int d,
         - 15.0/4.0*field[INDEX(i+4,j,k)]
         + 6.0/5.0*field[INDEX(i+5,j,k)]
         - 1.0/6.0*field[INDEX(i+6,j,k)]
-      )/dx;
+      )*inv_dx;
       break;
     case 2:
       return (
@@ -474,7 +475,7 @@ inline real_t forward_derivative_Odx6(idx_t i, idx_t j, idx_t k, int d,
         - 15.0/4.0*field[INDEX(i,j+4,k)]
         + 6.0/5.0*field[INDEX(i,j+5,k)]
         - 1.0/6.0*field[INDEX(i,j+6,k)]
-      )/dx;
+      )*inv_dx;
       break;
     case 3:
       return (
@@ -485,7 +486,7 @@ inline real_t forward_derivative_Odx6(idx_t i, idx_t j, idx_t k, int d,
         - 15.0/4.0*field[INDEX(i,j,k+4)]
         + 6.0/5.0*field[INDEX(i,j,k+5)]
         - 1.0/6.0*field[INDEX(i,j,k+6)]
-      )/dx;
+      )*inv_dx;
       break;
   }
 
@@ -494,7 +495,7 @@ inline real_t forward_derivative_Odx6(idx_t i, idx_t j, idx_t k, int d,
 }
 
 inline real_t backward_derivative_Odx6(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
   switch (d) {
     case 1:
@@ -506,7 +507,7 @@ inline real_t backward_derivative_Odx6(idx_t i, idx_t j, idx_t k, int d,
         + 15.0/4.0*field[INDEX(i-4,j,k)]
         - 6.0/5.0*field[INDEX(i-5,j,k)]
         + 1.0/6.0*field[INDEX(i-6,j,k)]
-      )/dx;
+      )*inv_dx;
       break;
     case 2:
       return (
@@ -517,7 +518,7 @@ inline real_t backward_derivative_Odx6(idx_t i, idx_t j, idx_t k, int d,
         + 15.0/4.0*field[INDEX(i,j-4,k)]
         - 6.0/5.0*field[INDEX(i,j-5,k)]
         + 1.0/6.0*field[INDEX(i,j-6,k)]
-      )/dx;
+      )*inv_dx;
       break;
     case 3:
       return (
@@ -528,7 +529,7 @@ inline real_t backward_derivative_Odx6(idx_t i, idx_t j, idx_t k, int d,
         + 15.0/4.0*field[INDEX(i,j,k-4)]
         - 6.0/5.0*field[INDEX(i,j,k-5)]
         + 1.0/6.0*field[INDEX(i,j,k-6)]
-      )/dx;
+      )*inv_dx;
       break;
   }
 
@@ -537,13 +538,13 @@ inline real_t backward_derivative_Odx6(idx_t i, idx_t j, idx_t k, int d,
 }
 
 inline real_t lop_forward_derivative_Odx6(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
   /* XXX */
   return 0;
 }
 inline real_t lop_backward_derivative_Odx6(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
   return 0;
 }
@@ -552,7 +553,7 @@ inline real_t lop_backward_derivative_Odx6(idx_t i, idx_t j, idx_t k, int d,
 
               
 inline real_t derivative_Odx8(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
   switch (d) {
     case 1:
@@ -561,7 +562,7 @@ inline real_t derivative_Odx8(idx_t i, idx_t j, idx_t k, int d,
         - ( 4.0/105.0*field[INDEX(i-3,j,k)] - 4.0/105.0*field[INDEX(i+3,j,k)] )
         + ( 1.0/5.0*field[INDEX(i-2,j,k)] - 1.0/5.0*field[INDEX(i+2,j,k)] )
         - ( 4.0/5.0*field[INDEX(i-1,j,k)] - 4.0/5.0*field[INDEX(i+1,j,k)] )
-      )/dx;
+      )*inv_dx;
       break;
     case 2:
       return (
@@ -569,7 +570,7 @@ inline real_t derivative_Odx8(idx_t i, idx_t j, idx_t k, int d,
         - ( 4.0/105.0*field[INDEX(i,j-3,k)] - 4.0/105.0*field[INDEX(i,j+3,k)] )
         + ( 1.0/5.0*field[INDEX(i,j-2,k)] - 1.0/5.0*field[INDEX(i,j+2,k)] )
         - ( 4.0/5.0*field[INDEX(i,j-1,k)] - 4.0/5.0*field[INDEX(i,j+1,k)] )
-      )/dx;
+      )*inv_dx;
       break;
     case 3:
       return (
@@ -577,7 +578,7 @@ inline real_t derivative_Odx8(idx_t i, idx_t j, idx_t k, int d,
         - ( 4.0/105.0*field[INDEX(i,j,k-3)] - 4.0/105.0*field[INDEX(i,j,k+3)] )
         + ( 1.0/5.0*field[INDEX(i,j,k-2)] - 1.0/5.0*field[INDEX(i,j,k+2)] )
         - ( 4.0/5.0*field[INDEX(i,j,k-1)] - 4.0/5.0*field[INDEX(i,j,k+1)] )
-      )/dx;
+      )*inv_dx;
       break;
   }
 
@@ -586,7 +587,7 @@ inline real_t derivative_Odx8(idx_t i, idx_t j, idx_t k, int d,
 }
 
 inline real_t forward_derivative_Odx8(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
   switch (d) {
     case 1:
@@ -596,7 +597,7 @@ inline real_t forward_derivative_Odx8(idx_t i, idx_t j, idx_t k, int d,
         - 35.0/2.0*field[INDEX(i+4,j,k)] + 56.0/5.0*field[INDEX(i+5,j,k)] 
         - 14.0/3.0*field[INDEX(i+6,j,k)] + 8.0/7.0*field[INDEX(i+7,j,k)]
         - 1.0/8.0*field[INDEX(i+8,j,k)]
-      )/dx;
+      )*inv_dx;
       break;
     case 2:
       return (
@@ -605,7 +606,7 @@ inline real_t forward_derivative_Odx8(idx_t i, idx_t j, idx_t k, int d,
         - 35.0/2.0*field[INDEX(i,j+4,k)] + 56.0/5.0*field[INDEX(i,j+5,k)] 
         - 14.0/3.0*field[INDEX(i,j+6,k)] + 8.0/7.0*field[INDEX(i,j+7,k)]
         - 1.0/8.0*field[INDEX(i,j+8,k)]
-      )/dx;
+      )*inv_dx;
       break;
     case 3:
       return (
@@ -614,7 +615,7 @@ inline real_t forward_derivative_Odx8(idx_t i, idx_t j, idx_t k, int d,
         - 35.0/2.0*field[INDEX(i,j,k+4)] + 56.0/5.0*field[INDEX(i,j,k+5)] 
         - 14.0/3.0*field[INDEX(i,j,k+6)] + 8.0/7.0*field[INDEX(i,j,k+7)]
         - 1.0/8.0*field[INDEX(i,j,k+8)]
-      )/dx;
+      )*inv_dx;
       break;
   }
 
@@ -623,7 +624,7 @@ inline real_t forward_derivative_Odx8(idx_t i, idx_t j, idx_t k, int d,
 }
 
 inline real_t backward_derivative_Odx8(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
   switch (d) {
     case 1:
@@ -633,7 +634,7 @@ inline real_t backward_derivative_Odx8(idx_t i, idx_t j, idx_t k, int d,
         + 35.0/2.0*field[INDEX(i-4,j,k)] - 56.0/5.0*field[INDEX(i-5,j,k)] 
         + 14.0/3.0*field[INDEX(i-6,j,k)] - 8.0/7.0*field[INDEX(i-7,j,k)]
         + 1.0/8.0*field[INDEX(i-8,j,k)]
-      )/dx;
+      )*inv_dx;
       break;
     case 2:
       return (
@@ -642,7 +643,7 @@ inline real_t backward_derivative_Odx8(idx_t i, idx_t j, idx_t k, int d,
         + 35.0/2.0*field[INDEX(i,j-4,k)] - 56.0/5.0*field[INDEX(i,j-5,k)] 
         + 14.0/3.0*field[INDEX(i,j-6,k)] - 8.0/7.0*field[INDEX(i,j-7,k)]
         + 1.0/8.0*field[INDEX(i,j-8,k)]
-      )/dx;
+      )*inv_dx;
       break;
     case 3:
       return (
@@ -651,7 +652,7 @@ inline real_t backward_derivative_Odx8(idx_t i, idx_t j, idx_t k, int d,
         + 35.0/2.0*field[INDEX(i,j,k-4)] - 56.0/5.0*field[INDEX(i,j,k-5)] 
         + 14.0/3.0*field[INDEX(i,j,k-6)] - 8.0/7.0*field[INDEX(i,j,k-7)]
         + 1.0/8.0*field[INDEX(i,j,k-8)]
-      )/dx;
+      )*inv_dx;
       break;
   }
 
@@ -659,48 +660,48 @@ inline real_t backward_derivative_Odx8(idx_t i, idx_t j, idx_t k, int d,
   return 0;
 }
 inline real_t lop_forward_derivative_Odx8(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
 
   /* XXX */
   return 0;
 }
 inline real_t lop_backward_derivative_Odx8(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
 
   return 0;
 }
  
 
-inline real_t mixed_derivative_stencil_Odx2(idx_t i, idx_t j, idx_t k, int d1, int d2, arr_t & field)
+inline real_t mixed_derivative_stencil_Odx2(idx_t i, idx_t j, idx_t k, int d1, int d2, arr_t & field, real_t inv_dx)
 {
   if( (d1 == 1 && d2 == 2) || (d1 == 2 && d2 == 1) ) {
     return (
       - field[INDEX(i+1,j-1,k)] + field[INDEX(i+1,j+1,k)]
       + field[INDEX(i-1,j-1,k)] - field[INDEX(i-1,j+1,k)]
-    )/4.0/dx/dx;
+    )/4.0*inv_dx*inv_dx;
   }
 
   if( (d1 == 1 && d2 == 3) || (d1 == 3 && d2 == 1) ) {
     return (
       - field[INDEX(i+1,j,k-1)] + field[INDEX(i+1,j,k+1)]
       + field[INDEX(i-1,j,k-1)] - field[INDEX(i-1,j,k+1)]
-    )/4.0/dx/dx;
+    )/4.0*inv_dx*inv_dx;
   }
 
   if( (d1 == 3 && d2 == 2) || (d1 == 2 && d2 == 3) ) {
     return (
       - field[INDEX(i,j+1,k-1)] + field[INDEX(i,j+1,k+1)]
       + field[INDEX(i,j-1,k-1)] - field[INDEX(i,j-1,k+1)]
-    )/4.0/dx/dx;
+    )/4.0*inv_dx*inv_dx;
   }
 
   /* XXX */
   return 0;
 }
 
-inline real_t mixed_derivative_stencil_Odx4(idx_t i, idx_t j, idx_t k, int d1, int d2, arr_t & field)
+inline real_t mixed_derivative_stencil_Odx4(idx_t i, idx_t j, idx_t k, int d1, int d2, arr_t & field, real_t inv_dx)
 {
   if( (d1 == 1 && d2 == 2) || (d1 == 2 && d2 == 1) ) {
     return (
@@ -711,7 +712,7 @@ inline real_t mixed_derivative_stencil_Odx4(idx_t i, idx_t j, idx_t k, int d1, i
         - field[INDEX(i+2,j-2,k)] + field[INDEX(i+2,j+2,k)]
         + field[INDEX(i-2,j-2,k)] - field[INDEX(i-2,j+2,k)]
       )
-    )/3.0/dx/dx;
+    )/3.0*inv_dx*inv_dx;
   }
 
   if( (d1 == 1 && d2 == 3) || (d1 == 3 && d2 == 1) ) {
@@ -723,7 +724,7 @@ inline real_t mixed_derivative_stencil_Odx4(idx_t i, idx_t j, idx_t k, int d1, i
         - field[INDEX(i+2,j,k-2)] + field[INDEX(i+2,j,k+2)]
         + field[INDEX(i-2,j,k-2)] - field[INDEX(i-2,j,k+2)]
       )
-    )/3.0/dx/dx;
+    )/3.0*inv_dx*inv_dx;
   }
 
   if( (d1 == 3 && d2 == 2) || (d1 == 2 && d2 == 3) ) {
@@ -735,14 +736,14 @@ inline real_t mixed_derivative_stencil_Odx4(idx_t i, idx_t j, idx_t k, int d1, i
         - field[INDEX(i,j+2,k-2)] + field[INDEX(i,j+2,k+2)]
         + field[INDEX(i,j-2,k-2)] - field[INDEX(i,j-2,k+2)]
       )
-    )/3.0/dx/dx;
+    )/3.0*inv_dx*inv_dx;
   }
 
   /* XXX */
   return 0;
 }
 
-inline real_t mixed_derivative_stencil_Odx6(idx_t i, idx_t j, idx_t k, int d1, int d2, arr_t & field)
+inline real_t mixed_derivative_stencil_Odx6(idx_t i, idx_t j, idx_t k, int d1, int d2, arr_t & field, real_t inv_dx)
 {
   if( (d1 == 1 && d2 == 2) || (d1 == 2 && d2 == 1) ) {
     return (
@@ -756,7 +757,7 @@ inline real_t mixed_derivative_stencil_Odx6(idx_t i, idx_t j, idx_t k, int d1, i
         - field[INDEX(i+3,j-3,k)] + field[INDEX(i+3,j+3,k)]
         + field[INDEX(i-3,j-3,k)] - field[INDEX(i-3,j+3,k)]
       )
-    )/360.0/dx/dx;
+    )/360.0*inv_dx*inv_dx;
   }
 
   if( (d1 == 1 && d2 == 3) || (d1 == 3 && d2 == 1) ) {
@@ -771,7 +772,7 @@ inline real_t mixed_derivative_stencil_Odx6(idx_t i, idx_t j, idx_t k, int d1, i
         - field[INDEX(i+3,j,k-3)] + field[INDEX(i+3,j,k+3)]
         + field[INDEX(i-3,j,k-3)] - field[INDEX(i-3,j,k+3)]
       )
-    )/360.0/dx/dx;
+    )/360.0*inv_dx*inv_dx;
   }
 
   if( (d1 == 3 && d2 == 2) || (d1 == 2 && d2 == 3) ) {
@@ -786,7 +787,7 @@ inline real_t mixed_derivative_stencil_Odx6(idx_t i, idx_t j, idx_t k, int d1, i
         - field[INDEX(i,j+3,k-3)] + field[INDEX(i,j+3,k+3)]
         + field[INDEX(i,j-3,k-3)] - field[INDEX(i,j-3,k+3)]
       )
-    )/360.0/dx/dx;
+    )/360.0*inv_dx*inv_dx;
   }
 
   /* XXX */
@@ -794,7 +795,7 @@ inline real_t mixed_derivative_stencil_Odx6(idx_t i, idx_t j, idx_t k, int d1, i
 }
 
 inline real_t mixed_derivative_stencil_Odx8(idx_t i, idx_t j, idx_t k, int d1,
- int d2, arr_t & field)
+ int d2, arr_t & field, real_t inv_dx)
 {
   if( (d1 == 1 && d2 == 2) || (d1 == 2 && d2 == 1) ) {
     return (
@@ -811,7 +812,7 @@ inline real_t mixed_derivative_stencil_Odx8(idx_t i, idx_t j, idx_t k, int d1,
         - field[INDEX(i+4,j-4,k)] + field[INDEX(i+4,j+4,k)]
         + field[INDEX(i-4,j-4,k)] - field[INDEX(i-4,j+4,k)]
       )
-    )/dx/dx;
+    )*inv_dx*inv_dx;
   }
 
   if( (d1 == 1 && d2 == 3) || (d1 == 3 && d2 == 1) ) {
@@ -829,7 +830,7 @@ inline real_t mixed_derivative_stencil_Odx8(idx_t i, idx_t j, idx_t k, int d1,
         - field[INDEX(i+4,j,k-4)] + field[INDEX(i+4,j,k+4)]
         + field[INDEX(i-4,j,k-4)] - field[INDEX(i-4,j,k+4)]
       )
-    )/dx/dx;
+    )*inv_dx*inv_dx;
   }
 
   if( (d1 == 3 && d2 == 2) || (d1 == 2 && d2 == 3) ) {
@@ -847,7 +848,7 @@ inline real_t mixed_derivative_stencil_Odx8(idx_t i, idx_t j, idx_t k, int d1,
         - field[INDEX(i,j+4,k-4)] + field[INDEX(i,j+4,k+4)]
         + field[INDEX(i,j-4,k-4)] - field[INDEX(i,j-4,k+4)]
       )
-    )/dx/dx;
+    )*inv_dx*inv_dx;
   }
 
   /* XXX */
@@ -855,7 +856,7 @@ inline real_t mixed_derivative_stencil_Odx8(idx_t i, idx_t j, idx_t k, int d1,
 }
 
 inline real_t double_derivative_stencil_Odx2(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
   switch (d) {
     case 1:
@@ -863,21 +864,21 @@ inline real_t double_derivative_stencil_Odx2(idx_t i, idx_t j, idx_t k, int d,
           field[INDEX(i-1,j,k)]
           - 2.0*field[INDEX(i-0,j,k)]
           + field[INDEX(i+1,j,k)]
-        )/dx/dx;
+        )*inv_dx*inv_dx;
       break;
     case 2:
       return (
           field[INDEX(i,j-1,k)]
           - 2.0*field[INDEX(i,j-0,k)]
           + field[INDEX(i,j+1,k)]
-        )/dx/dx;
+        )*inv_dx*inv_dx;
       break;
     case 3:
       return (
           field[INDEX(i,j,k-1)]
           - 2.0*field[INDEX(i,j,k-0)]
           + field[INDEX(i,j,k+1)]
-        )/dx/dx;
+        )*inv_dx*inv_dx;
       break;
   }
 
@@ -886,7 +887,7 @@ inline real_t double_derivative_stencil_Odx2(idx_t i, idx_t j, idx_t k, int d,
 }
 
 inline real_t forward_double_derivative_stencil_Odx2(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
   switch (d) {
     case 1:
@@ -895,7 +896,7 @@ inline real_t forward_double_derivative_stencil_Odx2(idx_t i, idx_t j, idx_t k,
           - 5.0*field[INDEX(i+1,j,k)]
           + 4.0*field[INDEX(i+2,j,k)]
           - 1.0*field[INDEX(i+3,j,k)]
-        )/dx/dx;
+        )*inv_dx*inv_dx;
       break;
     case 2:
       return (
@@ -903,7 +904,7 @@ inline real_t forward_double_derivative_stencil_Odx2(idx_t i, idx_t j, idx_t k,
           - 5.0*field[INDEX(i,j+1,k)]
           + 4.0*field[INDEX(i,j+2,k)]
           - 1.0*field[INDEX(i,j+3,k)]
-        )/dx/dx;
+        )*inv_dx*inv_dx;
       break;
     case 3:
       return (
@@ -911,7 +912,7 @@ inline real_t forward_double_derivative_stencil_Odx2(idx_t i, idx_t j, idx_t k,
           - 5.0*field[INDEX(i,j,k+1)]
           + 4.0*field[INDEX(i,j,k+2)]
           - 1.0*field[INDEX(i,j,k+3)]
-        )/dx/dx;
+        )*inv_dx*inv_dx;
       break;
   }
 
@@ -921,7 +922,7 @@ inline real_t forward_double_derivative_stencil_Odx2(idx_t i, idx_t j, idx_t k,
 
 
 inline real_t backward_double_derivative_stencil_Odx2(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
   switch (d) {
     case 1:
@@ -930,7 +931,7 @@ inline real_t backward_double_derivative_stencil_Odx2(idx_t i, idx_t j, idx_t k,
           - 5.0*field[INDEX(i-1,j,k)]
           + 4.0*field[INDEX(i-2,j,k)]
           - 1.0*field[INDEX(i-3,j,k)]
-        )/dx/dx;
+        )*inv_dx*inv_dx;
       break;
     case 2:
       return (
@@ -938,7 +939,7 @@ inline real_t backward_double_derivative_stencil_Odx2(idx_t i, idx_t j, idx_t k,
           - 5.0*field[INDEX(i,j-1,k)]
           + 4.0*field[INDEX(i,j-2,k)]
           - 1.0*field[INDEX(i,j-3,k)]
-        )/dx/dx;
+        )*inv_dx*inv_dx;
       break;
     case 3:
       return (
@@ -946,7 +947,7 @@ inline real_t backward_double_derivative_stencil_Odx2(idx_t i, idx_t j, idx_t k,
           - 5.0*field[INDEX(i,j,k-1)]
           + 4.0*field[INDEX(i,j,k-2)]
           - 1.0*field[INDEX(i,j,k-3)]
-        )/dx/dx;
+        )*inv_dx*inv_dx;
       break;
   }
 
@@ -956,7 +957,7 @@ inline real_t backward_double_derivative_stencil_Odx2(idx_t i, idx_t j, idx_t k,
 
  
 inline real_t double_derivative_stencil_Odx4(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
   switch (d) {
     case 1:
@@ -966,7 +967,7 @@ inline real_t double_derivative_stencil_Odx4(idx_t i, idx_t j, idx_t k, int d,
           - 5.0/2.0*field[INDEX(i-0,j,k)]
           + 4.0/3.0*field[INDEX(i+1,j,k)]
           - 1.0/12.0*field[INDEX(i+2,j,k)]
-        )/dx/dx;
+        )*inv_dx*inv_dx;
       break;
     case 2:
       return (
@@ -975,7 +976,7 @@ inline real_t double_derivative_stencil_Odx4(idx_t i, idx_t j, idx_t k, int d,
           - 5.0/2.0*field[INDEX(i,j-0,k)]
           + 4.0/3.0*field[INDEX(i,j+1,k)]
           - 1.0/12.0*field[INDEX(i,j+2,k)]
-        )/dx/dx;
+        )*inv_dx*inv_dx;
       break;
     case 3:
       return (
@@ -984,7 +985,7 @@ inline real_t double_derivative_stencil_Odx4(idx_t i, idx_t j, idx_t k, int d,
           - 5.0/2.0*field[INDEX(i,j,k-0)]
           + 4.0/3.0*field[INDEX(i,j,k+1)]
           - 1.0/12.0*field[INDEX(i,j,k+2)]
-        )/dx/dx;
+        )*inv_dx*inv_dx;
       break;
   }
 
@@ -993,7 +994,7 @@ inline real_t double_derivative_stencil_Odx4(idx_t i, idx_t j, idx_t k, int d,
 }
 
 inline real_t double_derivative_stencil_Odx6(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
   switch (d) {
     case 1:
@@ -1005,7 +1006,7 @@ inline real_t double_derivative_stencil_Odx6(idx_t i, idx_t j, idx_t k, int d,
           + 3.0/2.0*field[INDEX(i+1,j,k)]
           - 3.0/20.0*field[INDEX(i+2,j,k)]
           + 1.0/90.0*field[INDEX(i+3,j,k)]
-        )/dx/dx;
+        )*inv_dx*inv_dx;
       break;
     case 2:
       return (
@@ -1016,7 +1017,7 @@ inline real_t double_derivative_stencil_Odx6(idx_t i, idx_t j, idx_t k, int d,
           + 3.0/2.0*field[INDEX(i,j+1,k)]
           - 3.0/20.0*field[INDEX(i,j+2,k)]
           + 1.0/90.0*field[INDEX(i,j+3,k)]
-        )/dx/dx;
+        )*inv_dx*inv_dx;
       break;
     case 3:
       return (
@@ -1027,7 +1028,7 @@ inline real_t double_derivative_stencil_Odx6(idx_t i, idx_t j, idx_t k, int d,
           + 3.0/2.0*field[INDEX(i,j,k+1)]
           - 3.0/20.0*field[INDEX(i,j,k+2)]
           + 1.0/90.0*field[INDEX(i,j,k+3)]
-        )/dx/dx;
+        )*inv_dx*inv_dx;
       break;
   }
 
@@ -1036,7 +1037,7 @@ inline real_t double_derivative_stencil_Odx6(idx_t i, idx_t j, idx_t k, int d,
 }
 
 inline real_t double_derivative_stencil_Odx8(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
   switch (d) {
     case 1:
@@ -1050,7 +1051,7 @@ inline real_t double_derivative_stencil_Odx8(idx_t i, idx_t j, idx_t k, int d,
           - 1.0/5.0*field[INDEX(i+2,j,k)]
           + 8.0/315.0*field[INDEX(i+3,j,k)]
           - 1.0/560.0*field[INDEX(i+4,j,k)]
-        )/dx/dx;
+        )*inv_dx*inv_dx;
       break;
     case 2:
       return (
@@ -1063,7 +1064,7 @@ inline real_t double_derivative_stencil_Odx8(idx_t i, idx_t j, idx_t k, int d,
           - 1.0/5.0*field[INDEX(i,j+2,k)]
           + 8.0/315.0*field[INDEX(i,j+3,k)]
           - 1.0/560.0*field[INDEX(i,j+4,k)]
-        )/dx/dx;
+        )*inv_dx*inv_dx;
       break;
     case 3:
       return (
@@ -1076,7 +1077,7 @@ inline real_t double_derivative_stencil_Odx8(idx_t i, idx_t j, idx_t k, int d,
           - 1.0/5.0*field[INDEX(i,j,k+2)]
           + 8.0/315.0*field[INDEX(i,j,k+3)]
           - 1.0/560.0*field[INDEX(i,j,k+4)]
-        )/dx/dx;
+        )*inv_dx*inv_dx;
       break;
   }
 
@@ -1085,20 +1086,20 @@ inline real_t double_derivative_stencil_Odx8(idx_t i, idx_t j, idx_t k, int d,
 }
 
 inline real_t forward_dissipation_stencil_Odx2(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
   switch (d) {
     case 1:
-      return -1.0/2.0*dx*
-        forward_double_derivative_stencil_Odx2(i,j,k,d,field);
+      return -1.0/2.0*inv_dx*
+        forward_double_derivative_stencil_Odx2(i,j,k,d,field,1.0);
       break;
     case 2:
-      return -1.0/2.0*dx*
-        forward_double_derivative_stencil_Odx2(i,j,k,d,field);
+      return -1.0/2.0*inv_dx*
+        forward_double_derivative_stencil_Odx2(i,j,k,d,field,1.0);
       break;
     case 3:
-      return -1.0/2.0*dx*
-        forward_double_derivative_stencil_Odx2(i,j,k,d,field);
+      return -1.0/2.0*inv_dx*
+        forward_double_derivative_stencil_Odx2(i,j,k,d,field,1.0);
       break;
   }
 
@@ -1108,20 +1109,20 @@ inline real_t forward_dissipation_stencil_Odx2(idx_t i, idx_t j, idx_t k, int d,
 
 
 inline real_t backward_dissipation_stencil_Odx2(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
   switch (d) {
     case 1:
-      return +1.0/2.0*dx*
-        backward_double_derivative_stencil_Odx2(i,j,k,d,field);
+      return +1.0/2.0*inv_dx*
+        backward_double_derivative_stencil_Odx2(i,j,k,d,field,1.0);
       break;
     case 2:
-      return +1.0/2.0*dx*
-        backward_double_derivative_stencil_Odx2(i,j,k,d,field);
+      return +1.0/2.0*inv_dx*
+        backward_double_derivative_stencil_Odx2(i,j,k,d,field,1.0);
       break;
     case 3:
-      return +1.0/2.0*dx*
-        backward_double_derivative_stencil_Odx2(i,j,k,d,field);
+      return +1.0/2.0*inv_dx*
+        backward_double_derivative_stencil_Odx2(i,j,k,d,field,1.0);
       break;
   }
 
@@ -1130,7 +1131,7 @@ inline real_t backward_dissipation_stencil_Odx2(idx_t i, idx_t j, idx_t k, int d
 }
 
 inline real_t forward_dissipation_stencil_Odx4(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
   /* XXX */
   return 0;
@@ -1138,7 +1139,7 @@ inline real_t forward_dissipation_stencil_Odx4(idx_t i, idx_t j, idx_t k, int d,
 
 
 inline real_t backward_dissipation_stencil_Odx4(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
   /* XXX */
   return 0;
@@ -1146,7 +1147,7 @@ inline real_t backward_dissipation_stencil_Odx4(idx_t i, idx_t j, idx_t k, int d
 
 
 inline real_t forward_dissipation_stencil_Odx6(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
   /* XXX */
   return 0;
@@ -1154,7 +1155,7 @@ inline real_t forward_dissipation_stencil_Odx6(idx_t i, idx_t j, idx_t k, int d,
 
 
 inline real_t backward_dissipation_stencil_Odx6(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
   /* XXX */
   return 0;
@@ -1162,7 +1163,7 @@ inline real_t backward_dissipation_stencil_Odx6(idx_t i, idx_t j, idx_t k, int d
 
 
 inline real_t forward_dissipation_stencil_Odx8(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
   /* XXX */
   return 0;
@@ -1170,7 +1171,7 @@ inline real_t forward_dissipation_stencil_Odx8(idx_t i, idx_t j, idx_t k, int d,
 
 
 inline real_t backward_dissipation_stencil_Odx8(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
   /* XXX */
   return 0;
@@ -1178,16 +1179,16 @@ inline real_t backward_dissipation_stencil_Odx8(idx_t i, idx_t j, idx_t k, int d
 
  
 inline real_t forward_dissipation(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
-  return STENCIL_ORDER_FUNCTION(forward_dissipation_stencil_Odx)(i, j, k, d, field);
+  return STENCIL_ORDER_FUNCTION(forward_dissipation_stencil_Odx)(i, j, k, d, field, inv_dx);
 }
 
 
 inline real_t backward_dissipation(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
-  return STENCIL_ORDER_FUNCTION(backward_dissipation_stencil_Odx)(i, j, k, d, field);
+  return STENCIL_ORDER_FUNCTION(backward_dissipation_stencil_Odx)(i, j, k, d, field, inv_dx);
 }
 
               
@@ -1200,10 +1201,11 @@ inline real_t backward_dissipation(idx_t i, idx_t j, idx_t k, int d,
  * @param k x-index
  * @param d direction of derivative
  * @param field field to differentiate
+ * @param inv_dx inverse grid spacing, 1/dx
  * @return derivative
  */
 inline real_t derivative(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
 
 #if NY == 1
@@ -1214,41 +1216,41 @@ inline real_t derivative(idx_t i, idx_t j, idx_t k, int d,
   if(d == 3) return 0;
 #endif
 
-  return STENCIL_ORDER_FUNCTION(derivative_Odx)(i, j, k, d, field);
+  return STENCIL_ORDER_FUNCTION(derivative_Odx)(i, j, k, d, field, inv_dx);
 }
 
 inline real_t lop_forward_derivative(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
-  return STENCIL_ORDER_FUNCTION(lop_forward_derivative_Odx)(i, j, k, d, field)
-    + STENCIL_ORDER_FUNCTION(forward_dissipation_stencil_Odx)(i, j, k, d, field);
+  return STENCIL_ORDER_FUNCTION(lop_forward_derivative_Odx)(i, j, k, d, field, inv_dx)
+    + STENCIL_ORDER_FUNCTION(forward_dissipation_stencil_Odx)(i, j, k, d, field, inv_dx);
 }
 
 inline real_t lop_backward_derivative(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
-  return STENCIL_ORDER_FUNCTION(lop_backward_derivative_Odx)(i, j, k, d, field)
-    + STENCIL_ORDER_FUNCTION(backward_dissipation_stencil_Odx)(i, j, k, d, field);
+  return STENCIL_ORDER_FUNCTION(lop_backward_derivative_Odx)(i, j, k, d, field, inv_dx)
+    + STENCIL_ORDER_FUNCTION(backward_dissipation_stencil_Odx)(i, j, k, d, field, inv_dx);
 }
 inline real_t forward_derivative(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
-  return STENCIL_ORDER_FUNCTION(forward_derivative_Odx)(i, j, k, d, field)
-    + STENCIL_ORDER_FUNCTION(forward_dissipation_stencil_Odx)(i, j, k, d, field);
+  return STENCIL_ORDER_FUNCTION(forward_derivative_Odx)(i, j, k, d, field, inv_dx)
+    + STENCIL_ORDER_FUNCTION(forward_dissipation_stencil_Odx)(i, j, k, d, field, inv_dx);
 }
 
 inline real_t backward_derivative(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
-  return STENCIL_ORDER_FUNCTION(backward_derivative_Odx)(i, j, k, d, field)
-    + STENCIL_ORDER_FUNCTION(backward_dissipation_stencil_Odx)(i, j, k, d, field);
+  return STENCIL_ORDER_FUNCTION(backward_derivative_Odx)(i, j, k, d, field, inv_dx)
+    + STENCIL_ORDER_FUNCTION(backward_dissipation_stencil_Odx)(i, j, k, d, field, inv_dx);
 }
 
 inline real_t upwind_derivative(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field, real_t c)
+    arr_t & field, real_t c, real_t inv_dx)
 {
-  if( c > 0) return c * lop_forward_derivative(i,j,k,d,field);
-  else return c * lop_backward_derivative(i,j,k,d,field);
+  if( c > 0) return c * lop_forward_derivative(i,j,k,d,field,inv_dx);
+  else return c * lop_backward_derivative(i,j,k,d,field,inv_dx);
 }
 
  
@@ -1262,9 +1264,10 @@ inline real_t upwind_derivative(idx_t i, idx_t j, idx_t k, int d,
  * @param d1 direction of derivative in one direction
  * @param d2 direction of derivative in another direction
  * @param field field to differentiate
+ * @param inv_dx inverse grid spacing, 1/dx
  * @return derivative
  */
-inline real_t mixed_derivative_stencil(idx_t i, idx_t j, idx_t k, int d1, int d2, arr_t & field)
+inline real_t mixed_derivative_stencil(idx_t i, idx_t j, idx_t k, int d1, int d2, arr_t & field, real_t inv_dx)
 {
 
 #if NY == 1
@@ -1275,7 +1278,7 @@ inline real_t mixed_derivative_stencil(idx_t i, idx_t j, idx_t k, int d1, int d2
   if(d1 == 3 || d2 == 3) return 0;
 #endif
 
-  return STENCIL_ORDER_FUNCTION(mixed_derivative_stencil_Odx)(i, j, k, d1, d2, field);
+  return STENCIL_ORDER_FUNCTION(mixed_derivative_stencil_Odx)(i, j, k, d1, d2, field, inv_dx);
 }
 
 /**
@@ -1287,10 +1290,11 @@ inline real_t mixed_derivative_stencil(idx_t i, idx_t j, idx_t k, int d1, int d2
  * @param k x-index
  * @param d direction of 2nd order derivative to compute
  * @param field field to differentiate
+ * @param inv_dx inverse grid spacing, 1/dx
  * @return derivative
  */
 inline real_t double_derivative_stencil(idx_t i, idx_t j, idx_t k, int d,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
 
 #if NY == 1
@@ -1301,7 +1305,7 @@ inline real_t double_derivative_stencil(idx_t i, idx_t j, idx_t k, int d,
   if(d == 3) return 0;
 #endif
 
-  return STENCIL_ORDER_FUNCTION(double_derivative_stencil_Odx)(i, j, k, d, field);
+  return STENCIL_ORDER_FUNCTION(double_derivative_stencil_Odx)(i, j, k, d, field, inv_dx);
 }
 
 /**
@@ -1314,15 +1318,16 @@ inline real_t double_derivative_stencil(idx_t i, idx_t j, idx_t k, int d,
  * @param d1 direction of first derivative
  * @param d2 direction of second derivative
  * @param field field to differentiate
+ * @param inv_dx inverse grid spacing, 1/dx
  * @return derivative
  */
 inline real_t double_derivative(idx_t i, idx_t j, idx_t k, int d1, int d2,
-    arr_t & field)
+    arr_t & field, real_t inv_dx)
 {
   if(d1 == d2) {
-    return double_derivative_stencil(i, j, k, d1, field);
+    return double_derivative_stencil(i, j, k, d1, field, inv_dx);
   } else {
-    return mixed_derivative_stencil(i, j, k, d1, d2, field);
+    return mixed_derivative_stencil(i, j, k, d1, d2, field, inv_dx);
   }
 
   /* XXX */
@@ -1341,12 +1346,12 @@ inline real_t double_derivative(idx_t i, idx_t j, idx_t k, int d1, int d2,
  * @param k x-index
  * @return laplacian
  */
-inline real_t laplacian(idx_t i, idx_t j, idx_t k, arr_t & field)
+inline real_t laplacian(idx_t i, idx_t j, idx_t k, arr_t & field, real_t inv_dx)
 {
   return (
-    double_derivative(i, j, k, 1, 1, field)
-    + double_derivative(i, j, k, 2, 2, field)
-    + double_derivative(i, j, k, 3, 3, field)
+    double_derivative(i, j, k, 1, 1, field, inv_dx)
+    + double_derivative(i, j, k, 2, 2, field, inv_dx)
+    + double_derivative(i, j, k, 3, 3, field, inv_dx)
   );
 }
 
@@ -1363,11 +1368,11 @@ inline real_t average(arr_t & field)
   idx_t i=0, j=0, k=0;
   
   #pragma omp parallel for default(shared) private(i, j, k) reduction(+:sum)
-  LOOP3(i, j, k)
+  OWNED_LOOP3(i, j, k)
   {
     sum += field[NP_INDEX(i,j,k)];
   }
-  return sum/POINTS;
+  return decomposition_sum(sum)/GLOBAL_POINTS;
 }
 
 
@@ -1385,11 +1390,11 @@ inline real_t volume_average(arr_t & DIFFphi, real_t phi_FRW)
   idx_t i=0, j=0, k=0;
 
   #pragma omp parallel for default(shared) private(i, j, k) reduction(+:sum)
-  LOOP3(i, j, k)
+  OWNED_LOOP3(i, j, k)
   {
     sum += exp(6.0*(DIFFphi[NP_INDEX(i,j,k)] + phi_FRW));
   }
-  return sum/POINTS;
+  return decomposition_sum(sum)/GLOBAL_POINTS;
 }
 
 /**
@@ -1406,12 +1411,12 @@ inline real_t conformal_average(arr_t & field, arr_t & DIFFphi, real_t phi_FRW)
   idx_t i=0, j=0, k=0;
 
   #pragma omp parallel for default(shared) private(i, j, k) reduction(+:sum)
-  LOOP3(i, j, k)
+  OWNED_LOOP3(i, j, k)
   {
     sum += exp(6.0*(DIFFphi[NP_INDEX(i,j,k)] + phi_FRW))*field[NP_INDEX(i,j,k)];
   }
   real_t vol = volume_average(DIFFphi, phi_FRW);
-  return sum/POINTS/vol;
+  return decomposition_sum(sum)/GLOBAL_POINTS/vol;
 }
 
 /**
@@ -1427,11 +1432,11 @@ inline real_t standard_deviation(arr_t & field, real_t avg)
   idx_t i=0, j=0, k=0;
   real_t sum = 0.0;
   #pragma omp parallel for default(shared) private(i, j, k) reduction(+:sum)
-  LOOP3(i, j, k)
+  OWNED_LOOP3(i, j, k)
   {
     sum += pw2(avg - field[NP_INDEX(i,j,k)]);
   }
-  return sqrt(sum/(POINTS-1));
+  return sqrt(decomposition_sum(sum)/(GLOBAL_POINTS-1));
 }
 
 /**
@@ -1461,12 +1466,12 @@ inline real_t conformal_standard_deviation(arr_t & field, arr_t & DIFFphi, real_
   idx_t i=0, j=0, k=0;
 
   #pragma omp parallel for default(shared) private(i, j, k) reduction(+:sum)
-  LOOP3(i, j, k)
+  OWNED_LOOP3(i, j, k)
   {
     sum += exp(6.0*(DIFFphi[NP_INDEX(i,j,k)] + phi_FRW))*pw2(avg - field[NP_INDEX(i,j,k)]);
   }
   real_t vol = volume_average(DIFFphi, phi_FRW);
-  return sqrt(sum/(POINTS-1)/vol);
+  return sqrt(decomposition_sum(sum)/(GLOBAL_POINTS-1)/vol);
 }
 
 /**
@@ -1489,15 +1494,15 @@ inline real_t conformal_standard_deviation(arr_t & field, arr_t & DIFFphi, real_
 inline real_t max(arr_t & field)
 {
   idx_t i=0, j=0, k=0;
-  real_t max_val = field[0];
+  real_t max_val = field[NP_INDEX(OWNED_X_BEGIN,0,0)];
 #pragma omp parallel for default(shared) private(i, j, k) reduction(max:max_val)
-  LOOP3(i, j, k)
+  OWNED_LOOP3(i, j, k)
   {
     if(field[INDEX(i,j,k)] > max_val) {
       max_val = field[INDEX(i,j,k)];
     }
   }
-  return max_val;
+  return decomposition_max(max_val);
 }
 
 /**
@@ -1506,15 +1511,15 @@ inline real_t max(arr_t & field)
 inline real_t min(arr_t & field)
 {
   idx_t i=0, j=0, k=0;
-  real_t min_val = field[0];
+  real_t min_val = field[NP_INDEX(OWNED_X_BEGIN,0,0)];
 #pragma omp parallel for default(shared) private(i, j, k) reduction(min:min_val)
-  LOOP3(i, j, k)
+  OWNED_LOOP3(i, j, k)
   {
     if(field[INDEX(i,j,k)] < min_val) {
       min_val = field[INDEX(i,j,k)];
     }
   }
-  return min_val;
+  return decomposition_min(min_val);
 }
 
 /**
@@ -1527,7 +1532,7 @@ inline idx_t numNaNs(arr_t & field)
   idx_t NaNs = 0;
   
   #pragma omp parallel for default(shared) private(i, j, k) reduction(+:NaNs)
-  LOOP3(i,j,k)
+  OWNED_LOOP3(i,j,k)
   {
     real_t val = field[NP_INDEX(i,j,k)];
     union { float val; uint32_t x; } u = { (float) val };
@@ -1537,7 +1542,7 @@ inline idx_t numNaNs(arr_t & field)
     }
   }
 
-  return NaNs;
+  return decomposition_sum(NaNs);
 }
 
 
@@ -1549,6 +1554,21 @@ inline idx_t idx_t_mod(idx_t n, idx_t d)
   return mod;
 }
 
+/**
+ * @brief Interleave the low bits of (i, j, k) into a Morton (Z-order) key
+ */
+inline idx_t morton_key(idx_t i, idx_t j, idx_t k, idx_t bits)
+{
+  idx_t key = 0;
+  for(idx_t b=0; b<bits; ++b)
+  {
+    key |= ((i >> b) & 1) << (3*b + 2);
+    key |= ((j >> b) & 1) << (3*b + 1);
+    key |= ((k >> b) & 1) << (3*b);
+  }
+  return key;
+}
+
 inline real_t real_t_mod(real_t n, real_t d)
 {
   // is there a (small) chance of this not actually working due to roundoff?